@@ -141,17 +141,15 @@ typedef struct
   GESAsset *asset;
 } GESAssetCacheEntry;
 
-/* Also protect all the entries in the cache */
-static GMutex asset_cache_lock;
 /* We are mapping entries by types and ID, such as:
  *
  * {
- *   first_extractable_type_name1 :
+ *   first_extractable_type1 :
  *      {
  *        "some ID": GESAssetCacheEntry,
  *        "some other ID": GESAssetCacheEntry 2
  *      },
- *   second_extractable_type_name :
+ *   second_extractable_type :
  *      {
  *        "some ID": GESAssetCacheEntry,
  *        "some other ID": GESAssetCacheEntry 2
@@ -164,10 +162,31 @@ static GMutex asset_cache_lock;
  *
  * This is in order to be able to have 2 Asset with the same ID but
  * different extractable types.
+ *
+ * The entries of each type are split in shards, depending on the hash of
+ * their ID, each protected by its own read-write lock which also protects
+ * the entries it contains. The table of a type is set as qdata on all the
+ * types that have been looked up so we do not need to walk the type
+ * hierarchy each time.
  **/
-static GHashTable *type_entries_table = NULL;
-#define LOCK_CACHE   (g_mutex_lock (&asset_cache_lock))
-#define UNLOCK_CACHE (g_mutex_unlock (&asset_cache_lock))
+#define CACHE_N_SHARDS 16
+
+typedef struct
+{
+  GRWLock lock;
+  GHashTable *entries;
+} GESAssetCacheShard;
+
+typedef struct
+{
+  GType type;
+  GESAssetCacheShard shards[CACHE_N_SHARDS];
+} GESAssetTypeCache;
+
+/* Protects the creation of the type caches and type_caches */
+static GMutex type_caches_lock;
+static GPtrArray *type_caches = NULL;
+static GQuark type_cache_quark = 0;
 
 static gchar *
 _check_and_update_parameters (GType * extractable_type, const gchar * id,
@@ -454,34 +473,61 @@ ges_asset_init (GESAsset * self)
 /* Internal methods */
 
 /* Find the type that implemented the GESExtractable interface */
-static inline const gchar *
-_extractable_type_name (GType type)
+static inline GType
+_extractable_root_type (GType type)
 {
-  while (1) {
-    if (g_type_is_a (g_type_parent (type), GES_TYPE_EXTRACTABLE))
-      type = g_type_parent (type);
-    else
-      return g_type_name (type);
-  }
+  while (g_type_is_a (g_type_parent (type), GES_TYPE_EXTRACTABLE))
+    type = g_type_parent (type);
+
+  return type;
+}
+
+static void
+_free_entries (gpointer entry)
+{
+  g_slice_free (GESAssetCacheEntry, entry);
 }
 
-static inline GESAssetCacheEntry *
-_lookup_entry (GType extractable_type, const gchar * id)
+static GESAssetTypeCache *
+_get_type_cache (GType extractable_type)
 {
-  GHashTable *entries_table;
+  guint i;
+  GType root_type;
+  GESAssetTypeCache *cache;
+
+  cache = g_type_get_qdata (extractable_type, type_cache_quark);
+  if (G_LIKELY (cache))
+    return cache;
+
+  g_mutex_lock (&type_caches_lock);
+  root_type = _extractable_root_type (extractable_type);
+  cache = g_type_get_qdata (root_type, type_cache_quark);
+  if (!cache) {
+    cache = g_slice_new0 (GESAssetTypeCache);
+    cache->type = root_type;
+    for (i = 0; i < CACHE_N_SHARDS; i++) {
+      g_rw_lock_init (&cache->shards[i].lock);
+      cache->shards[i].entries = g_hash_table_new_full (g_str_hash,
+          g_str_equal, g_free, _free_entries);
+    }
 
-  entries_table = g_hash_table_lookup (type_entries_table,
-      _extractable_type_name (extractable_type));
-  if (entries_table)
-    return g_hash_table_lookup (entries_table, id);
+    g_type_set_qdata (root_type, type_cache_quark, cache);
+    g_ptr_array_add (type_caches, cache);
+  }
 
-  return NULL;
+  if (root_type != extractable_type)
+    g_type_set_qdata (extractable_type, type_cache_quark, cache);
+  g_mutex_unlock (&type_caches_lock);
+
+  return cache;
 }
 
-static void
-_free_entries (gpointer entry)
+static inline GESAssetCacheShard *
+_get_shard (GType extractable_type, const gchar * id)
 {
-  g_slice_free (GESAssetCacheEntry, entry);
+  GESAssetTypeCache *cache = _get_type_cache (extractable_type);
+
+  return &cache->shards[g_str_hash (id) % CACHE_N_SHARDS];
 }
 
 static void
@@ -509,15 +555,17 @@ GESAsset *
 ges_asset_cache_lookup (GType extractable_type, const gchar * id)
 {
   GESAsset *asset = NULL;
+  GESAssetCacheShard *shard;
   GESAssetCacheEntry *entry = NULL;
 
   g_return_val_if_fail (id, NULL);
 
-  LOCK_CACHE;
-  entry = _lookup_entry (extractable_type, id);
+  shard = _get_shard (extractable_type, id);
+  g_rw_lock_reader_lock (&shard->lock);
+  entry = g_hash_table_lookup (shard->entries, id);
   if (entry)
     asset = entry->asset;
-  UNLOCK_CACHE;
+  g_rw_lock_reader_unlock (&shard->lock);
 
   return asset;
 }
@@ -527,11 +575,12 @@ ges_asset_cache_append_task (GType extractable_type,
     const gchar * id, GTask * task)
 {
   GESAssetCacheEntry *entry = NULL;
+  GESAssetCacheShard *shard = _get_shard (extractable_type, id);
 
-  LOCK_CACHE;
-  if ((entry = _lookup_entry (extractable_type, id)))
+  g_rw_lock_writer_lock (&shard->lock);
+  if ((entry = g_hash_table_lookup (shard->entries, id)))
     entry->results = g_list_append (entry->results, task);
-  UNLOCK_CACHE;
+  g_rw_lock_writer_unlock (&shard->lock);
 }
 
 gboolean
@@ -543,10 +592,11 @@ ges_asset_cache_set_loaded (GType extractable_type, const gchar * id,
   GList *results = NULL;
   GFunc user_func = NULL;
   gpointer user_data = NULL;
+  GESAssetCacheShard *shard = _get_shard (extractable_type, id);
 
-  LOCK_CACHE;
-  if ((entry = _lookup_entry (extractable_type, id)) == NULL) {
-    UNLOCK_CACHE;
+  g_rw_lock_writer_lock (&shard->lock);
+  if ((entry = g_hash_table_lookup (shard->entries, id)) == NULL) {
+    g_rw_lock_writer_unlock (&shard->lock);
     GST_ERROR ("Calling but type %s ID: %s not in cached, "
         "something massively screwed", g_type_name (extractable_type), id);
 
@@ -577,7 +627,7 @@ ges_asset_cache_set_loaded (GType extractable_type, const gchar * id,
     user_func = (GFunc) _gtask_return_true;
     GST_DEBUG_OBJECT (asset, "initialized");
   }
-  UNLOCK_CACHE;
+  g_rw_lock_writer_unlock (&shard->lock);
 
   g_list_foreach (results, user_func, user_data);
   g_list_free_full (results, g_object_unref);
@@ -588,34 +638,22 @@ ges_asset_cache_set_loaded (GType extractable_type, const gchar * id,
 void
 ges_asset_cache_put (GESAsset * asset, GTask * task)
 {
-  GType extractable_type;
   const gchar *asset_id;
+  GESAssetCacheShard *shard;
   GESAssetCacheEntry *entry;
 
   /* Needing to work with the cache, taking the lock */
   asset_id = ges_asset_get_id (asset);
-  extractable_type = asset->priv->extractable_type;
-
-  LOCK_CACHE;
-  if (!(entry = _lookup_entry (extractable_type, asset_id))) {
-    GHashTable *entries_table;
-
-    entries_table = g_hash_table_lookup (type_entries_table,
-        _extractable_type_name (extractable_type));
-    if (entries_table == NULL) {
-      entries_table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
-          _free_entries);
-
-      g_hash_table_insert (type_entries_table,
-          g_strdup (_extractable_type_name (extractable_type)), entries_table);
-    }
+  shard = _get_shard (asset->priv->extractable_type, asset_id);
 
+  g_rw_lock_writer_lock (&shard->lock);
+  if (!(entry = g_hash_table_lookup (shard->entries, asset_id))) {
     entry = g_slice_new0 (GESAssetCacheEntry);
 
     entry->asset = asset;
     if (task)
       entry->results = g_list_prepend (entry->results, task);
-    g_hash_table_insert (entries_table, (gpointer) g_strdup (asset_id),
+    g_hash_table_insert (shard->entries, (gpointer) g_strdup (asset_id),
         (gpointer) entry);
   } else {
     if (task) {
@@ -623,15 +661,15 @@ ges_asset_cache_put (GESAsset * asset, GTask * task)
       entry->results = g_list_prepend (entry->results, task);
     }
   }
-  UNLOCK_CACHE;
+  g_rw_lock_writer_unlock (&shard->lock);
 }
 
 void
 ges_asset_cache_init (void)
 {
-  g_mutex_init (&asset_cache_lock);
-  type_entries_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-      NULL, (GDestroyNotify) g_hash_table_unref);
+  g_mutex_init (&type_caches_lock);
+  type_caches = g_ptr_array_new ();
+  type_cache_quark = g_quark_from_static_string ("ges-asset-type-cache");
 
   _init_formatter_assets ();
   _init_standard_transition_assets ();
@@ -733,20 +771,25 @@ ges_asset_set_proxy (GESAsset * asset, GESAsset * proxy)
   }
 
   if (asset == NULL) {
-    GHashTable *entries_table;
-    GESAssetCacheEntry *entry;
-
-    entries_table = g_hash_table_lookup (type_entries_table,
-        _extractable_type_name (proxy->priv->extractable_type));
-    entry = g_hash_table_find (entries_table, (GHRFunc) _lookup_proxied_asset,
-        (gpointer) ges_asset_get_id (proxy));
+    guint i;
+    GESAssetTypeCache *cache;
+    GESAssetCacheEntry *entry = NULL;
+
+    cache = _get_type_cache (proxy->priv->extractable_type);
+    for (i = 0; i < CACHE_N_SHARDS && !entry; i++) {
+      g_rw_lock_reader_lock (&cache->shards[i].lock);
+      entry = g_hash_table_find (cache->shards[i].entries,
+          (GHRFunc) _lookup_proxied_asset, (gpointer) ges_asset_get_id (proxy));
+      if (entry)
+        asset = entry->asset;
+      g_rw_lock_reader_unlock (&cache->shards[i].lock);
+    }
 
     if (!entry) {
       GST_DEBUG_OBJECT (asset, "Not proxying any asset");
       return FALSE;
     }
 
-    asset = entry->asset;
     while (asset->priv->proxies)
       asset = asset->priv->proxies->data;
   }
@@ -868,7 +911,7 @@ ges_asset_get_proxy_target (GESAsset * proxy)
 void
 ges_asset_set_id (GESAsset * asset, const gchar * id)
 {
-  GHashTable *entries;
+  GESAssetCacheShard *shard, *new_shard;
 
   gpointer orig_id = NULL;
   GESAssetCacheEntry *entry = NULL;
@@ -890,21 +933,33 @@ ges_asset_set_id (GESAsset * asset, const gchar * id)
     return;
   }
 
-  LOCK_CACHE;
-  entries = g_hash_table_lookup (type_entries_table,
-      _extractable_type_name (asset->priv->extractable_type));
+  shard = _get_shard (priv->extractable_type, priv->id);
+  new_shard = _get_shard (priv->extractable_type, id);
+
+  /* Always lock the shards in the same order to avoid deadlocks */
+  g_rw_lock_writer_lock (&MIN (shard, new_shard)->lock);
+  if (new_shard != shard)
+    g_rw_lock_writer_lock (&MAX (shard, new_shard)->lock);
 
-  g_return_if_fail (g_hash_table_lookup_extended (entries, priv->id, &orig_id,
-          (gpointer *) & entry));
+  if (!g_hash_table_lookup_extended (shard->entries, priv->id, &orig_id,
+          (gpointer *) & entry)) {
+    GST_ERROR_OBJECT (asset, "%s not in cache, something massively screwed",
+        priv->id);
+    goto done;
+  }
 
-  g_hash_table_steal (entries, priv->id);
-  g_hash_table_insert (entries, g_strdup (id), entry);
+  g_hash_table_steal (shard->entries, priv->id);
+  g_hash_table_insert (new_shard->entries, g_strdup (id), entry);
 
   GST_DEBUG_OBJECT (asset, "Changing id from %s to %s", priv->id, id);
   g_free (priv->id);
   g_free (orig_id);
   priv->id = g_strdup (id);
-  UNLOCK_CACHE;
+
+done:
+  if (new_shard != shard)
+    g_rw_lock_writer_unlock (&new_shard->lock);
+  g_rw_lock_writer_unlock (&shard->lock);
 }
 
 static GESAsset *
@@ -1325,28 +1380,34 @@ ges_asset_request_finish (GAsyncResult * res, GError ** error)
 GList *
 ges_list_assets (GType filter)
 {
+  guint i, j;
   GList *ret = NULL;
   GESAsset *asset;
-  GHashTableIter iter, types_iter;
-  gpointer key, value, typename, assets;
+  GHashTableIter iter;
+  gpointer key, value;
 
   g_return_val_if_fail (g_type_is_a (filter, GES_TYPE_EXTRACTABLE), NULL);
 
-  LOCK_CACHE;
-  g_hash_table_iter_init (&types_iter, type_entries_table);
-  while (g_hash_table_iter_next (&types_iter, &typename, &assets)) {
-    if (g_type_is_a (filter, g_type_from_name ((gchar *) typename)) == FALSE)
+  g_mutex_lock (&type_caches_lock);
+  for (i = 0; i < type_caches->len; i++) {
+    GESAssetTypeCache *cache = g_ptr_array_index (type_caches, i);
+
+    if (g_type_is_a (filter, cache->type) == FALSE)
       continue;
 
-    g_hash_table_iter_init (&iter, (GHashTable *) assets);
-    while (g_hash_table_iter_next (&iter, &key, &value)) {
-      asset = ((GESAssetCacheEntry *) value)->asset;
+    for (j = 0; j < CACHE_N_SHARDS; j++) {
+      g_rw_lock_reader_lock (&cache->shards[j].lock);
+      g_hash_table_iter_init (&iter, cache->shards[j].entries);
+      while (g_hash_table_iter_next (&iter, &key, &value)) {
+        asset = ((GESAssetCacheEntry *) value)->asset;
 
-      if (g_type_is_a (asset->priv->extractable_type, filter))
-        ret = g_list_append (ret, asset);
+        if (g_type_is_a (asset->priv->extractable_type, filter))
+          ret = g_list_prepend (ret, asset);
+      }
+      g_rw_lock_reader_unlock (&cache->shards[j].lock);
     }
   }
-  UNLOCK_CACHE;
+  g_mutex_unlock (&type_caches_lock);
 
   return ret;
 }
@@ -66,25 +66,12 @@ ges_audio_uri_source_track_set_cb (GESAudioUriSource * self,
 static GstElement *
 ges_audio_uri_source_create_source (GESTrackElement * trksrc)
 {
-  GESAudioUriSource *self;
-  GESTrack *track;
-  GstElement *decodebin;
-  const GstCaps *caps = NULL;
-
-  self = (GESAudioUriSource *) trksrc;
-
-  track = ges_track_element_get_track (trksrc);
-
-  self->priv->decodebin = decodebin =
-      gst_element_factory_make ("uridecodebin", NULL);
-
-  if (track)
-    caps = ges_track_get_caps (track);
+  GESAudioUriSource *self = (GESAudioUriSource *) trksrc;
 
-  g_object_set (decodebin, "caps", caps,
-      "expose-all-streams", FALSE, "uri", self->uri, NULL);
+  self->priv->decodebin = ges_source_create_uri_decoder (GES_SOURCE (trksrc),
+      self->uri);
 
-  return decodebin;
+  return self->priv->decodebin;
 }
 
 /* Extractable interface implementation */
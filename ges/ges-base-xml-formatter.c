@@ -34,6 +34,7 @@ G_DEFINE_ABSTRACT_TYPE (GESBaseXmlFormatter, ges_base_xml_formatter,
 
 
 static gboolean _loading_done_cb (GESFormatter * self);
+static void _create_queued_assets (GESBaseXmlFormatter * self);
 
 typedef struct PendingEffects
 {
@@ -98,6 +99,8 @@ typedef struct LayerEntry
 typedef struct PendingAsset
 {
   GESFormatter *formatter;
+  gchar *id;
+  GType extractable_type;
   gchar *metadatas;
   GstStructure *properties;
   gchar *proxy_id;
@@ -126,6 +129,9 @@ struct _GESBaseXmlFormatterPrivate
   /* List of asset waited to be created */
   GList *pending_assets;
 
+  /* List of asset to be created all at once, before the first clip */
+  GList *queued_assets;
+
   /* current track element */
   GESTrackElement *current_track_element;
 
@@ -257,6 +263,7 @@ _load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
   if (!priv->parsecontext)
     return FALSE;
 
+  _create_queued_assets (GES_BASE_XML_FORMATTER (self));
   if (g_hash_table_size (priv->assetid_pendingclips) == 0 &&
       priv->pending_assets == NULL)
     g_idle_add ((GSourceFunc) _loading_done_cb, g_object_ref (self));
@@ -380,6 +387,7 @@ ges_base_xml_formatter_init (GESBaseXmlFormatter * self)
   priv->check_only = FALSE;
   priv->parsecontext = NULL;
   priv->pending_assets = NULL;
+  priv->queued_assets = NULL;
 
   /* The PendingClip are owned by the assetid_pendingclips table */
   priv->assetid_pendingclips = g_hash_table_new_full (g_str_hash,
@@ -640,6 +648,7 @@ _free_pending_clip (GESBaseXmlFormatterPrivate * priv, PendingClip * pend)
 static void
 _free_pending_asset (GESBaseXmlFormatterPrivate * priv, PendingAsset * passet)
 {
+  g_free (passet->id);
   g_free (passet->metadatas);
   g_free (passet->proxy_id);
   if (passet->properties)
@@ -683,59 +692,21 @@ _add_pending_bindings (GESBaseXmlFormatterPrivate * priv, GList * bindings,
 }
 
 static void
-new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
+_create_pending_clips (GESFormatter * self, PendingAsset * passet)
 {
-  GError *error = NULL;
-  gchar *possible_id = NULL;
-  GList *tmp, *pendings = NULL;
-  GESFormatter *self = passet->formatter;
-  const gchar *id = ges_asset_get_id (source);
+  GList *tmp, *pendings;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
-  GESAsset *asset = ges_asset_request_finish (res, &error);
-
-  if (error) {
-    GST_LOG_OBJECT (self, "Error %s creating asset id: %s", error->message, id);
-
-    /* We set the metas on the Asset to give hints to the user */
-    if (passet->metadatas)
-      ges_meta_container_add_metas_from_string (GES_META_CONTAINER (source),
-          passet->metadatas);
-    if (passet->properties)
-      gst_structure_foreach (passet->properties,
-          (GstStructureForeachFunc) set_property_foreach, source);
-
-    possible_id = ges_project_try_updating_id (GES_FORMATTER (self)->project,
-        source, error);
+  GESAsset *asset = ges_asset_request (passet->extractable_type, passet->id,
+      NULL);
 
-    if (possible_id == NULL) {
-      GST_WARNING_OBJECT (self, "Abandoning creation of asset %s with ID %s"
-          "- Error: %s", g_type_name (G_OBJECT_TYPE (source)), id,
-          error->message);
-
-      pendings = g_hash_table_lookup (priv->assetid_pendingclips, id);
-      for (tmp = pendings; tmp; tmp = tmp->next)
-        _free_pending_clip (priv, (PendingClip *) tmp->data);
+  pendings = g_hash_table_lookup (priv->assetid_pendingclips, passet->id);
+  if (asset == NULL) {
+    GST_WARNING_OBJECT (self, "Abandoning creation of asset %s with ID %s",
+        g_type_name (passet->extractable_type), passet->id);
 
-      _free_pending_asset (priv, passet);
-      goto done;
-    }
+    for (tmp = pendings; tmp; tmp = tmp->next)
+      _free_pending_clip (priv, (PendingClip *) tmp->data);
 
-    /* We got a possible ID replacement for that asset, create it, and
-     * make sure the assetid_pendingclips will use it */
-    ges_asset_request_async (ges_asset_get_extractable_type (source),
-        possible_id, NULL, (GAsyncReadyCallback) new_asset_cb, passet);
-    ges_project_add_loading_asset (GES_FORMATTER (self)->project,
-        ges_asset_get_extractable_type (source), possible_id);
-
-    pendings = g_hash_table_lookup (priv->assetid_pendingclips, id);
-    if (pendings) {
-      g_hash_table_remove (priv->assetid_pendingclips, id);
-      g_hash_table_insert (priv->assetid_pendingclips,
-          g_strdup (possible_id), pendings);
-
-      /* pendings should no be freed */
-      pendings = NULL;
-    }
     goto done;
   }
 
@@ -747,9 +718,8 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
   }
 
   /* now that we have the GESAsset, we create the GESClips */
-  pendings = g_hash_table_lookup (priv->assetid_pendingclips, id);
   GST_DEBUG_OBJECT (self, "Asset created with ID %s, now creating pending "
-      " Clips, nb pendings: %i", id, g_list_length (pendings));
+      " Clips, nb pendings: %i", passet->id, g_list_length (pendings));
   for (tmp = pendings; tmp; tmp = tmp->next) {
     GList *tmpeffect;
     GESClip *clip;
@@ -777,27 +747,99 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
     }
     _free_pending_clip (priv, pend);
   }
+  gst_object_unref (asset);
 
-  /* And now add to the project */
-  ges_project_add_asset (self->project, asset);
-  gst_object_unref (self);
+done:
+  g_hash_table_remove (priv->assetid_pendingclips, passet->id);
+  g_list_free (pendings);
+}
 
-  _free_pending_asset (priv, passet);
+static void
+_assets_created_cb (GESProject * project, GAsyncResult * res, GList * passets)
+{
+  GList *tmp, *assets;
+  GError *error = NULL;
+  GESFormatter *self = ((PendingAsset *) passets->data)->formatter;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
-done:
-  if (asset)
-    gst_object_unref (asset);
-  if (possible_id)
-    g_free (possible_id);
+  if (!ges_project_create_assets_finish (project, res, &error)) {
+    GST_INFO_OBJECT (self, "Could not create all assets: %s", error->message);
+    g_error_free (error);
+  }
+
+  /* Assets that got a new ID are proxied by their replacement, make sure
+   * requesting them by their original ID returns it */
+  assets = ges_project_list_assets (project, GES_TYPE_EXTRACTABLE);
+  for (tmp = assets; tmp; tmp = tmp->next)
+    ges_asset_set_proxy (NULL, tmp->data);
+  g_list_free_full (assets, gst_object_unref);
 
-  if (pendings) {
-    g_hash_table_remove (priv->assetid_pendingclips, id);
-    g_list_free (pendings);
+  for (tmp = passets; tmp; tmp = tmp->next) {
+    _create_pending_clips (self, tmp->data);
+    _free_pending_asset (priv, tmp->data);
   }
+  g_list_free (passets);
 
   if (g_hash_table_size (priv->assetid_pendingclips) == 0 &&
-      priv->pending_assets == NULL)
+      priv->pending_assets == NULL && priv->queued_assets == NULL)
     _loading_done (self);
+
+  gst_object_unref (self);
+}
+
+/* Creates all the assets queued so far at once */
+static void
+_create_queued_assets (GESBaseXmlFormatter * self)
+{
+  guint i, n_assets;
+  GList *tmp, *passets;
+  const gchar **ids;
+  GType *extractable_types;
+  GESProject *project = GES_FORMATTER (self)->project;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (priv->queued_assets == NULL)
+    return;
+
+  passets = g_list_reverse (priv->queued_assets);
+  priv->queued_assets = NULL;
+
+  n_assets = g_list_length (passets);
+  ids = g_new (const gchar *, n_assets);
+  extractable_types = g_new (GType, n_assets);
+  for (tmp = passets, i = 0; tmp; tmp = tmp->next, i++) {
+    PendingAsset *passet = tmp->data;
+
+    ids[i] = passet->id;
+    extractable_types[i] = passet->extractable_type;
+    priv->pending_assets = g_list_prepend (priv->pending_assets, passet);
+  }
+
+  GST_DEBUG_OBJECT (self, "Creating %u assets", n_assets);
+  gst_object_ref (self);
+  ges_project_create_assets_async (project, ids, extractable_types, n_assets,
+      NULL, (GAsyncReadyCallback) _assets_created_cb, passets);
+
+  /* We set the metas on the Assets to give hints to the user in case they
+   * can not be loaded */
+  for (tmp = passets; tmp; tmp = tmp->next) {
+    PendingAsset *passet = tmp->data;
+    GESAsset *asset = ges_asset_cache_lookup (passet->extractable_type,
+        passet->id);
+
+    if (asset == NULL)
+      continue;
+
+    if (passet->metadatas)
+      ges_meta_container_add_metas_from_string (GES_META_CONTAINER (asset),
+          passet->metadatas);
+    if (passet->properties)
+      gst_structure_foreach (passet->properties,
+          (GstStructureForeachFunc) set_property_foreach, asset);
+  }
+
+  g_free (ids);
+  g_free (extractable_types);
 }
 
 GstElement *
@@ -917,26 +959,47 @@ _create_profile (GESBaseXmlFormatter * self,
 void
 ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
     const gchar * id, GType extractable_type, GstStructure * properties,
-    const gchar * metadatas, const gchar * proxy_id, GError ** error)
+    const gchar * metadatas, const gchar * proxy_id,
+    const gchar * stream_info, GError ** error)
 {
+  GESAsset *asset;
   PendingAsset *passet;
+  GESProject *project = GES_FORMATTER (self)->project;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
   if (priv->check_only)
     return;
 
+  /* Trust the serialized stream information so that the clips can be
+   * created right away, the project checks it once loaded. Proxied assets
+   * are resolved with the pending ones. */
+  if (stream_info && !proxy_id && extractable_type == GES_TYPE_URI_CLIP &&
+      ges_project_get_lazy_loading (project) &&
+      (asset = ges_uri_clip_asset_new_from_serialized_info (id,
+              stream_info))) {
+    GST_DEBUG_OBJECT (self, "Created %s from its serialized info", id);
+
+    if (metadatas)
+      ges_meta_container_add_metas_from_string (GES_META_CONTAINER (asset),
+          metadatas);
+
+    ges_project_add_lazy_asset (project, asset);
+    gst_object_unref (asset);
+
+    return;
+  }
+
+  /* The assets are all created at once by _create_queued_assets() */
   passet = g_slice_new0 (PendingAsset);
+  passet->id = g_strdup (id);
+  passet->extractable_type = extractable_type;
   passet->metadatas = g_strdup (metadatas);
   passet->proxy_id = g_strdup (proxy_id);
-  passet->formatter = gst_object_ref (self);
+  passet->formatter = GES_FORMATTER (self);
   if (properties)
     passet->properties = gst_structure_copy (properties);
 
-  ges_asset_request_async (extractable_type, id, NULL,
-      (GAsyncReadyCallback) new_asset_cb, passet);
-  ges_project_add_loading_asset (GES_FORMATTER (self)->project,
-      extractable_type, id);
-  priv->pending_assets = g_list_prepend (priv->pending_assets, passet);
+  priv->queued_assets = g_list_prepend (priv->queued_assets, passet);
 }
 
 void
@@ -968,6 +1031,7 @@ ges_base_xml_formatter_add_clip (GESBaseXmlFormatter * self,
     gst_structure_remove_fields (properties, "supported-formats",
         "inpoint", "start", "duration", NULL);
 
+  _create_queued_assets (self);
   asset = ges_asset_request (type, asset_id, NULL);
   if (asset == NULL) {
     gchar *real_id;
@@ -1254,6 +1318,7 @@ ges_base_xml_formatter_add_track_element (GESBaseXmlFormatter * self,
     goto out;
   }
 
+  _create_queued_assets (self);
   asset = ges_asset_request (track_element_type, asset_id, &err);
   if (asset == NULL) {
     GST_DEBUG_OBJECT (self, "Can not create trackelement %s", asset_id);
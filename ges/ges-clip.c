@@ -779,6 +779,7 @@ ges_clip_finalize (GObject * object)
   GESClip *self = GES_CLIP (object);
 
   g_list_free_full (self->priv->copied_track_elements, g_object_unref);
+  g_clear_object (&self->priv->copied_layer);
 
   G_OBJECT_CLASS (ges_clip_parent_class)->finalize (object);
 }
@@ -985,6 +986,25 @@ ges_clip_create_track_elements_func (GESClip * clip, GESTrackType type)
   return g_list_append (NULL, result);
 }
 
+/* Adds a copy of @clip and of its children to @layer at the same position,
+ * used to copy whole timelines */
+GESClip *
+ges_clip_copy_to_layer (GESClip * clip, GESLayer * layer)
+{
+  GESClip *ret, *copy =
+      GES_CLIP (ges_timeline_element_copy (GES_TIMELINE_ELEMENT (clip), TRUE));
+
+  gst_object_ref_sink (copy);
+  g_clear_object (&copy->priv->copied_layer);
+  copy->priv->copied_layer = g_object_ref (layer);
+
+  ret = GES_CLIP (_paste (GES_TIMELINE_ELEMENT (copy),
+          GES_TIMELINE_ELEMENT (clip), GES_TIMELINE_ELEMENT_START (clip)));
+  gst_object_unref (copy);
+
+  return ret;
+}
+
 void
 ges_clip_set_layer (GESClip * clip, GESLayer * layer)
 {
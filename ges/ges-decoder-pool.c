@@ -0,0 +1,573 @@
+/* GStreamer Editing Services
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * ges-decoder-pool.c: Decoders shared between the sources of a track
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* A GESPooledDecoder only holds an uridecodebin while it is at least
+ * PAUSED, that is while the NleSource it lives in is part of the active
+ * stack of its composition. When the source gets deactivated, the decoder
+ * is handed to the pool of its track, still PAUSED, so that its demuxer and
+ * decoders stay opened. The next source of that track reading the same
+ * stream borrows it and only needs to seek it, instead of opening and
+ * parsing the container again.
+ *
+ * The file that gets decoded is also chosen at that point: the proxy of the
+ * asset when previewing, and the original file when rendering. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "ges-internal.h"
+#include "ges-decoder-pool.h"
+
+/* Maximum number of unused decoders a pool keeps opened */
+#define DECODER_POOL_MAX_SIZE 8
+
+typedef struct
+{
+  gchar *key;
+  GstCaps *caps;
+  GstElement *decoder;
+} IdleDecoder;
+
+struct _GESDecoderPool
+{
+  gint refcount;
+
+  GMutex lock;
+  GQueue idle;                  /* IdleDecoder-s, most recently used first */
+
+  guint created;
+  guint reused;
+  guint live;                   /* Decoders currently in use or idle */
+
+  gboolean use_proxies;
+};
+
+static void
+_destroy_decoder (GstElement * decoder)
+{
+  gst_element_set_state (decoder, GST_STATE_NULL);
+  gst_object_unref (decoder);
+}
+
+static void
+_idle_decoder_free (IdleDecoder * idle)
+{
+  g_free (idle->key);
+  if (idle->caps)
+    gst_caps_unref (idle->caps);
+  g_slice_free (IdleDecoder, idle);
+}
+
+static inline gboolean
+_caps_equal (GstCaps * caps, GstCaps * other)
+{
+  if (!caps || !other)
+    return caps == other;
+
+  return gst_caps_is_equal (caps, other);
+}
+
+GESDecoderPool *
+ges_decoder_pool_new (void)
+{
+  GESDecoderPool *pool = g_slice_new0 (GESDecoderPool);
+
+  pool->refcount = 1;
+  pool->use_proxies = TRUE;
+  g_mutex_init (&pool->lock);
+  g_queue_init (&pool->idle);
+
+  return pool;
+}
+
+GESDecoderPool *
+ges_decoder_pool_ref (GESDecoderPool * pool)
+{
+  g_atomic_int_inc (&pool->refcount);
+
+  return pool;
+}
+
+void
+ges_decoder_pool_unref (GESDecoderPool * pool)
+{
+  if (!g_atomic_int_dec_and_test (&pool->refcount))
+    return;
+
+  ges_decoder_pool_clear (pool);
+  g_mutex_clear (&pool->lock);
+  g_slice_free (GESDecoderPool, pool);
+}
+
+/* Destroys the unused decoders */
+void
+ges_decoder_pool_clear (GESDecoderPool * pool)
+{
+  IdleDecoder *idle;
+  GQueue idles = G_QUEUE_INIT;
+
+  g_mutex_lock (&pool->lock);
+  idles = pool->idle;
+  g_queue_init (&pool->idle);
+  pool->live -= idles.length;
+  g_mutex_unlock (&pool->lock);
+
+  while ((idle = g_queue_pop_head (&idles))) {
+    _destroy_decoder (idle->decoder);
+    _idle_decoder_free (idle);
+  }
+}
+
+GstStructure *
+ges_decoder_pool_get_stats (GESDecoderPool * pool)
+{
+  GstStructure *stats;
+
+  g_mutex_lock (&pool->lock);
+  stats = gst_structure_new ("decoder-pool-stats",
+      "created", G_TYPE_UINT, pool->created,
+      "reused", G_TYPE_UINT, pool->reused,
+      "live", G_TYPE_UINT, pool->live,
+      "idle", G_TYPE_UINT, pool->idle.length, NULL);
+  g_mutex_unlock (&pool->lock);
+
+  return stats;
+}
+
+/* Whether the sources should decode the proxies of their assets instead of
+ * the original files, taken into account by the sources activated later */
+void
+ges_decoder_pool_set_use_proxies (GESDecoderPool * pool, gboolean use_proxies)
+{
+  g_atomic_int_set (&pool->use_proxies, use_proxies);
+}
+
+/* Returns an unused decoder for @key, or %NULL if a new one has to be
+ * created */
+static GstElement *
+_decoder_pool_acquire (GESDecoderPool * pool, const gchar * key,
+    GstCaps * caps)
+{
+  GList *tmp;
+  GstElement *decoder = NULL;
+
+  g_mutex_lock (&pool->lock);
+  for (tmp = pool->idle.head; tmp; tmp = tmp->next) {
+    IdleDecoder *idle = tmp->data;
+
+    if (g_strcmp0 (idle->key, key) == 0 && _caps_equal (idle->caps, caps)) {
+      decoder = idle->decoder;
+      g_queue_delete_link (&pool->idle, tmp);
+      _idle_decoder_free (idle);
+      pool->reused++;
+      break;
+    }
+  }
+
+  if (!decoder) {
+    pool->created++;
+    pool->live++;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  return decoder;
+}
+
+static void
+_decoder_pool_release (GESDecoderPool * pool, const gchar * key,
+    GstCaps * caps, GstElement * decoder)
+{
+  IdleDecoder *idle = g_slice_new0 (IdleDecoder), *evicted = NULL;
+
+  idle->key = g_strdup (key);
+  idle->caps = caps ? gst_caps_ref (caps) : NULL;
+  idle->decoder = decoder;
+
+  g_mutex_lock (&pool->lock);
+  g_queue_push_head (&pool->idle, idle);
+  if (pool->idle.length > DECODER_POOL_MAX_SIZE) {
+    evicted = g_queue_pop_tail (&pool->idle);
+    pool->live--;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (evicted) {
+    GST_DEBUG ("Evicting decoder for %s", evicted->key);
+    _destroy_decoder (evicted->decoder);
+    _idle_decoder_free (evicted);
+  }
+}
+
+static void
+_decoder_pool_discard (GESDecoderPool * pool, GstElement * decoder)
+{
+  g_mutex_lock (&pool->lock);
+  pool->live--;
+  g_mutex_unlock (&pool->lock);
+
+  if (decoder)
+    _destroy_decoder (decoder);
+}
+
+/**************************************************
+ *                                                *
+ *                GESPooledDecoder                *
+ *                                                *
+ **************************************************/
+
+G_DEFINE_TYPE (GESPooledDecoder, ges_pooled_decoder, GST_TYPE_BIN);
+
+enum
+{
+  PROP_0,
+  PROP_CAPS,
+};
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static void
+_decoder_pad_added_cb (GstElement * decoder, GstPad * pad,
+    GESPooledDecoder * self)
+{
+  GstPad *target = gst_ghost_pad_get_target (GST_GHOST_PAD (self->srcpad));
+
+  if (target) {
+    GST_DEBUG_OBJECT (self, "Already using %" GST_PTR_FORMAT, target);
+    gst_object_unref (target);
+
+    return;
+  }
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->srcpad), pad);
+}
+
+/* Borrowed decoders already exposed their pads */
+static void
+_target_decoder_srcpad (GESPooledDecoder * self)
+{
+  GValue item = G_VALUE_INIT;
+  GstIterator *pads = gst_element_iterate_src_pads (self->decoder);
+
+  if (gst_iterator_next (pads, &item) == GST_ITERATOR_OK) {
+    gst_ghost_pad_set_target (GST_GHOST_PAD (self->srcpad),
+        g_value_get_object (&item));
+    g_value_reset (&item);
+  }
+  gst_iterator_free (pads);
+}
+
+static const gchar *
+_get_uri_to_decode (GESPooledDecoder * self)
+{
+  GESAsset *asset;
+
+  if (!self->pool || !self->asset)
+    return self->uri;
+
+  if (g_atomic_int_get (&self->pool->use_proxies))
+    asset = ges_asset_get_proxy (self->asset);
+  else
+    asset = ges_asset_get_proxy_target (self->asset);
+
+  if (asset && GES_IS_URI_CLIP_ASSET (asset))
+    return ges_asset_get_id (asset);
+
+  return self->uri;
+}
+
+static gboolean
+_acquire_decoder (GESPooledDecoder * self)
+{
+  GstCaps *caps, *passthrough_caps;
+  GstElement *decoder = NULL;
+  const gchar *uri = _get_uri_to_decode (self);
+
+  g_free (self->key);
+  self->key = g_strdup_printf ("%s %s", uri,
+      self->stream_id ? self->stream_id : "");
+
+  GST_OBJECT_LOCK (self);
+  passthrough_caps = self->passthrough_caps ?
+      gst_caps_ref (self->passthrough_caps) : NULL;
+  caps = gst_caps_ref (passthrough_caps ? passthrough_caps : self->caps);
+  GST_OBJECT_UNLOCK (self);
+
+  /* Our output changes from now on, let the element using it adapt */
+  if (self->prepare_func)
+    self->prepare_func (self, passthrough_caps, self->prepare_data);
+  if (passthrough_caps)
+    gst_caps_unref (passthrough_caps);
+
+  if (self->pool)
+    decoder = _decoder_pool_acquire (self->pool, self->key, caps);
+
+  self->reused = decoder != NULL;
+  if (!decoder) {
+    decoder = gst_element_factory_make ("uridecodebin", NULL);
+    if (!decoder) {
+      GST_ERROR_OBJECT (self, "Could not create uridecodebin");
+      if (self->pool)
+        _decoder_pool_discard (self->pool, NULL);
+      gst_caps_unref (caps);
+
+      return FALSE;
+    }
+
+    gst_object_ref_sink (decoder);
+    g_object_set (decoder, "caps", caps, "expose-all-streams", FALSE,
+        "uri", uri, NULL);
+  }
+  gst_caps_replace (&self->decoder_caps, caps);
+  gst_caps_unref (caps);
+
+  GST_DEBUG_OBJECT (self, "%s decoder %" GST_PTR_FORMAT " for %s",
+      self->reused ? "Reusing" : "Created", decoder, self->key);
+
+  self->decoder = decoder;
+  self->pad_added_id = g_signal_connect (decoder, "pad-added",
+      G_CALLBACK (_decoder_pad_added_cb), self);
+  gst_bin_add (GST_BIN (self), decoder);
+
+  if (self->reused) {
+    _target_decoder_srcpad (self);
+    gst_element_set_locked_state (decoder, FALSE);
+  }
+
+  return TRUE;
+}
+
+static void
+_release_decoder (GESPooledDecoder * self)
+{
+  GstState state;
+  GstElement *decoder = self->decoder;
+
+  if (!decoder)
+    return;
+
+  self->decoder = NULL;
+  g_signal_handler_disconnect (decoder, self->pad_added_id);
+  self->pad_added_id = 0;
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->srcpad), NULL);
+
+  /* Keep it opened once out of the bin */
+  gst_element_set_locked_state (decoder, TRUE);
+  gst_bin_remove (GST_BIN (self), decoder);
+
+  /* Only fully prerolled decoders can be reused */
+  if (self->pool &&
+      gst_element_get_state (decoder, &state, NULL, 0) ==
+      GST_STATE_CHANGE_SUCCESS && state == GST_STATE_PAUSED) {
+    GST_DEBUG_OBJECT (self, "Releasing decoder %" GST_PTR_FORMAT, decoder);
+    _decoder_pool_release (self->pool, self->key, self->decoder_caps,
+        decoder);
+  } else if (self->pool) {
+    _decoder_pool_discard (self->pool, decoder);
+  } else {
+    _destroy_decoder (decoder);
+  }
+  gst_caps_replace (&self->decoder_caps, NULL);
+}
+
+static GstStateChangeReturn
+ges_pooled_decoder_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+  GESPooledDecoder *self = GES_POOLED_DECODER (element);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      if (!_acquire_decoder (self))
+        return GST_STATE_CHANGE_FAILURE;
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      _release_decoder (self);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (ges_pooled_decoder_parent_class)->change_state
+      (element, transition);
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED) {
+    if (ret == GST_STATE_CHANGE_FAILURE) {
+      _release_decoder (self);
+    } else if (self->reused) {
+      /* The streaming threads of a borrowed decoder stopped when it got
+       * unlinked and will not reach the NleSource blocking probe on their
+       * own. Let that probe see an event so that the NleSource sends its
+       * seek, which restarts them right where it needs them, instead of
+       * decoding from the start first */
+      gst_pad_push_event (self->srcpad,
+          gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+              gst_structure_new_empty ("GESPooledDecoderReused")));
+    }
+  }
+
+  return ret;
+}
+
+static void
+ges_pooled_decoder_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESPooledDecoder *self = GES_POOLED_DECODER (object);
+
+  switch (property_id) {
+    case PROP_CAPS:
+      GST_OBJECT_LOCK (self);
+      gst_value_set_caps (value, self->caps);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_pooled_decoder_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESPooledDecoder *self = GES_POOLED_DECODER (object);
+
+  switch (property_id) {
+    case PROP_CAPS:
+    {
+      gboolean decoding;
+
+      GST_OBJECT_LOCK (self);
+      /* Passthrough decoders keep the compressed caps */
+      decoding = self->decoder && self->decoder_caps &&
+          self->decoder_caps == self->caps;
+      gst_caps_replace (&self->caps, (GstCaps *) gst_value_get_caps (value));
+      if (decoding)
+        gst_caps_replace (&self->decoder_caps, self->caps);
+      GST_OBJECT_UNLOCK (self);
+      if (decoding)
+        g_object_set (self->decoder, "caps", self->caps, NULL);
+      break;
+    }
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_pooled_decoder_finalize (GObject * object)
+{
+  GESPooledDecoder *self = GES_POOLED_DECODER (object);
+
+  if (self->pool)
+    ges_decoder_pool_unref (self->pool);
+  if (self->asset)
+    gst_object_unref (self->asset);
+  if (self->caps)
+    gst_caps_unref (self->caps);
+  if (self->passthrough_caps)
+    gst_caps_unref (self->passthrough_caps);
+  if (self->decoder_caps)
+    gst_caps_unref (self->decoder_caps);
+  g_free (self->uri);
+  g_free (self->stream_id);
+  g_free (self->key);
+
+  G_OBJECT_CLASS (ges_pooled_decoder_parent_class)->finalize (object);
+}
+
+static void
+ges_pooled_decoder_class_init (GESPooledDecoderClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  object_class->get_property = ges_pooled_decoder_get_property;
+  object_class->set_property = ges_pooled_decoder_set_property;
+  object_class->finalize = ges_pooled_decoder_finalize;
+
+  g_object_class_install_property (object_class, PROP_CAPS,
+      g_param_spec_boxed ("caps", "Caps", "The caps to decode to",
+          GST_TYPE_CAPS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_set_static_metadata (element_class,
+      "GES pooled decoder", "Generic/Bin/Decoder",
+      "Decodes a stream with decoders shared across sources",
+      "agent <agent@local>");
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (ges_pooled_decoder_change_state);
+}
+
+static void
+ges_pooled_decoder_init (GESPooledDecoder * self)
+{
+  GstPadTemplate *template = gst_static_pad_template_get (&src_template);
+
+  self->srcpad = gst_ghost_pad_new_no_target_from_template ("src", template);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+  gst_object_unref (template);
+}
+
+/* Creates an element decoding the stream @stream_id of @uri, sharing its
+ * decoders with the other elements of @pool reading the same stream. If
+ * @pool is %NULL, the decoders are not shared. @asset is the asset @uri
+ * comes from, to decode its proxy or proxy target depending on @pool. */
+GstElement *
+ges_pooled_decoder_new (GESDecoderPool * pool, GESAsset * asset,
+    const gchar * uri, const gchar * stream_id)
+{
+  GESPooledDecoder *self = g_object_new (GES_TYPE_POOLED_DECODER, NULL);
+
+  self->pool = pool ? ges_decoder_pool_ref (pool) : NULL;
+  self->asset = asset ? gst_object_ref (asset) : NULL;
+  self->uri = g_strdup (uri);
+  self->stream_id = g_strdup (stream_id);
+
+  return GST_ELEMENT (self);
+}
+
+/* Makes @self output the compressed stream matching @caps instead of
+ * decoding it, or decode it again if @caps is %NULL. Applied the next time
+ * @self goes to PAUSED, see ges_pooled_decoder_set_prepare_func(). */
+void
+ges_pooled_decoder_set_passthrough_caps (GESPooledDecoder * self,
+    GstCaps * caps)
+{
+  GST_OBJECT_LOCK (self);
+  gst_caps_replace (&self->passthrough_caps, caps);
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* Sets the function called each time @self goes to PAUSED, with the
+ * passthrough caps it is going to use from then on. */
+void
+ges_pooled_decoder_set_prepare_func (GESPooledDecoder * self,
+    GESPooledDecoderPrepareFunc func, gpointer user_data)
+{
+  self->prepare_func = func;
+  self->prepare_data = user_data;
+}
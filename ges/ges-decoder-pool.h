@@ -0,0 +1,99 @@
+/* GStreamer Editing Services
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * ges-decoder-pool.h: Decoders shared between the sources of a track
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_DECODER_POOL_H_
+#define _GES_DECODER_POOL_H_
+
+#include <gst/gst.h>
+#include <ges/ges-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GESDecoderPool GESDecoderPool;
+
+#define GES_TYPE_POOLED_DECODER             (ges_pooled_decoder_get_type ())
+#define GES_POOLED_DECODER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_POOLED_DECODER, GESPooledDecoder))
+#define GES_IS_POOLED_DECODER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_POOLED_DECODER))
+
+typedef struct _GESPooledDecoderClass GESPooledDecoderClass;
+typedef struct _GESPooledDecoder GESPooledDecoder;
+
+/* Called while the decoder goes to PAUSED, with the passthrough caps it is
+ * about to use, or %NULL if it decodes its stream */
+typedef void (*GESPooledDecoderPrepareFunc) (GESPooledDecoder *decoder,
+                                             GstCaps *passthrough_caps,
+                                             gpointer user_data);
+
+struct _GESPooledDecoderClass
+{
+  GstBinClass parent_class;
+};
+
+struct _GESPooledDecoder
+{
+  GstBin parent_instance;
+
+  GESDecoderPool *pool;
+  GESAsset *asset;
+  gchar *uri;
+  gchar *stream_id;
+  gchar *key;
+  GstCaps *caps;
+  /* Set when rendering the compressed stream as is */
+  GstCaps *passthrough_caps;
+
+  GstPad *srcpad;
+
+  GESPooledDecoderPrepareFunc prepare_func;
+  gpointer prepare_data;
+
+  /* The uridecodebin borrowed from the pool while we are at least PAUSED,
+   * and the caps it was configured with, which is its key in the pool */
+  GstElement *decoder;
+  GstCaps *decoder_caps;
+  gulong pad_added_id;
+  gboolean reused;
+};
+
+GES_API
+GType ges_pooled_decoder_get_type (void) G_GNUC_CONST;
+
+G_GNUC_INTERNAL GstElement *
+ges_pooled_decoder_new (GESDecoderPool *pool, GESAsset *asset,
+                        const gchar *uri, const gchar *stream_id);
+G_GNUC_INTERNAL void
+ges_pooled_decoder_set_passthrough_caps (GESPooledDecoder *self,
+                                         GstCaps *caps);
+G_GNUC_INTERNAL void
+ges_pooled_decoder_set_prepare_func (GESPooledDecoder *self,
+                                     GESPooledDecoderPrepareFunc func,
+                                     gpointer user_data);
+
+G_GNUC_INTERNAL GESDecoderPool * ges_decoder_pool_new   (void);
+G_GNUC_INTERNAL GESDecoderPool * ges_decoder_pool_ref   (GESDecoderPool *pool);
+G_GNUC_INTERNAL void             ges_decoder_pool_unref (GESDecoderPool *pool);
+G_GNUC_INTERNAL void             ges_decoder_pool_clear (GESDecoderPool *pool);
+G_GNUC_INTERNAL GstStructure *   ges_decoder_pool_get_stats (GESDecoderPool *pool);
+G_GNUC_INTERNAL void             ges_decoder_pool_set_use_proxies (GESDecoderPool *pool,
+                                                                   gboolean use_proxies);
+
+G_END_DECLS
+#endif /* _GES_DECODER_POOL_H_ */
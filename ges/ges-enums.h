@@ -338,7 +338,8 @@ GType ges_video_test_pattern_get_type (void);
  * @GES_PIPELINE_MODE_PREVIEW_VIDEO: output video to the screen
  * @GES_PIPELINE_MODE_PREVIEW: output audio/video to soundcard/screen (default)
  * @GES_PIPELINE_MODE_RENDER: render timeline (forces decoding)
- * @GES_PIPELINE_MODE_SMART_RENDER: render timeline (tries to avoid decoding/reencoding)
+ * @GES_PIPELINE_MODE_SMART_RENDER: render timeline, passing the compressed
+ *   streams of unmodified sources through (only re-encoding what changed)
  *
  * The various modes the #GESPipeline can be configured to.
  */
@@ -30,6 +30,7 @@
 
 #include "ges-asset.h"
 #include "ges-base-xml-formatter.h"
+#include "ges-decoder-pool.h"
 
 G_BEGIN_DECLS
 
@@ -128,6 +129,10 @@ timeline_fill_gaps            (GESTimeline *timeline);
 G_GNUC_INTERNAL void
 timeline_create_transitions (GESTimeline * timeline, GESTrackElement * track_element);
 
+GES_API
+GESTimeline *
+timeline_copy                 (GESTimeline *timeline);
+
 G_GNUC_INTERNAL
 void
 track_resort_and_fill_gaps    (GESTrack *track);
@@ -136,6 +141,22 @@ G_GNUC_INTERNAL
 void
 track_disable_last_gap        (GESTrack *track, gboolean disabled);
 
+G_GNUC_INTERNAL
+void
+track_set_lookahead           (GESTrack *track, gboolean lookahead);
+
+G_GNUC_INTERNAL
+void
+track_set_use_proxies         (GESTrack *track, gboolean use_proxies);
+
+GES_API
+void
+track_set_passthrough_caps    (GESTrack *track, GstCaps *caps);
+
+G_GNUC_INTERNAL
+void
+track_defer_resort            (GESTrack *track, gboolean defer);
+
 G_GNUC_INTERNAL void
 ges_asset_cache_init (void);
 
@@ -163,6 +184,15 @@ ges_effect_assect_id_get_type_and_bindesc (const char    *id,
                                            GError       **error);
 
 G_GNUC_INTERNAL void _ges_uri_asset_cleanup (void);
+G_GNUC_INTERNAL gchar * ges_uri_clip_asset_serialize_info (GESUriClipAsset *self);
+G_GNUC_INTERNAL GESAsset * ges_uri_clip_asset_new_from_serialized_info (const gchar *uri,
+                                                                        const gchar *serialized_info);
+G_GNUC_INTERNAL void ges_uri_clip_asset_check_info_async (GESUriClipAsset *self,
+                                                         GAsyncReadyCallback callback,
+                                                         gpointer user_data);
+G_GNUC_INTERNAL gboolean ges_uri_clip_asset_check_info_finish (GESUriClipAsset *self,
+                                                              GAsyncResult *result,
+                                                              GError **error);
 
 /* GESExtractable internall methods
  *
@@ -214,6 +244,8 @@ G_GNUC_INTERNAL  gchar * ges_project_try_updating_id              (GESProject *s
 G_GNUC_INTERNAL  void ges_project_add_loading_asset               (GESProject *project,
                                                                    GType extractable_type,
                                                                    const gchar *id);
+G_GNUC_INTERNAL  void ges_project_add_lazy_asset                  (GESProject *project,
+                                                                   GESAsset *asset);
 /************************************************
  *                                              *
  *   GESBaseXmlFormatter internal methods       *
@@ -240,6 +272,7 @@ G_GNUC_INTERNAL void ges_base_xml_formatter_add_asset        (GESBaseXmlFormatte
                                                                  GstStructure *properties,
                                                                  const gchar *metadatas,
                                                                  const gchar *proxy_id,
+                                                                 const gchar *stream_info,
                                                                  GError **error);
 G_GNUC_INTERNAL void ges_base_xml_formatter_add_layer           (GESBaseXmlFormatter *self,
                                                                  GType extractable_type,
@@ -349,6 +382,7 @@ G_GNUC_INTERNAL guint32           ges_clip_get_layer_priority     (GESClip *clip
 G_GNUC_INTERNAL void              ges_clip_set_moving_from_layer  (GESClip *clip, gboolean is_moving);
 G_GNUC_INTERNAL GESTrackElement*  ges_clip_create_track_element   (GESClip *clip, GESTrackType type);
 G_GNUC_INTERNAL GList*            ges_clip_create_track_elements  (GESClip *clip, GESTrackType type);
+G_GNUC_INTERNAL GESClip*          ges_clip_copy_to_layer          (GESClip *clip, GESLayer *layer);
 
 /****************************************************
  *              GESLayer                            *
@@ -370,9 +404,12 @@ G_GNUC_INTERNAL void ges_track_element_copy_bindings (GESTrackElement *element,
 						       guint64 position);
 
 G_GNUC_INTERNAL GstElement *ges_source_create_topbin (const gchar * bin_name, GstElement * sub_element, ...);
+G_GNUC_INTERNAL GstElement *ges_source_create_uri_decoder (GESSource *source, const gchar *uri);
+G_GNUC_INTERNAL void ges_source_set_passthrough_caps (GESSource *source, GstCaps *caps);
 G_GNUC_INTERNAL void ges_track_set_caps                (GESTrack *track,
                                                         const GstCaps *caps);
 G_GNUC_INTERNAL GstElement * ges_track_get_composition (GESTrack *track);
+G_GNUC_INTERNAL GESDecoderPool * ges_track_get_decoder_pool (GESTrack *track);
 
 
 /*********************************************
@@ -47,8 +47,12 @@ G_DEFINE_TYPE_WITH_CODE (GESLayer, ges_layer,
 struct _GESLayerPrivate
 {
   /*< private > */
-  GList *clips_start;           /* The Clips sorted by start and
+  GSequence *clips_start;       /* The LayerClip-s sorted by start and
                                  * priority */
+  GHashTable *clips;            /* {GESClip: GSequenceIter in clips_start} */
+  /* Biggest duration of the clips, never shrinks unless the layer is
+   * emptied */
+  GstClockTime max_duration;
 
   guint32 priority;             /* The priority of the layer within the
                                  * containing timeline */
@@ -61,6 +65,15 @@ typedef struct
   GESLayer *layer;
 } NewAssetUData;
 
+/* A clip as stored in the layer, its start and priority are cached so
+ * that it can be resorted when they change */
+typedef struct
+{
+  GstClockTime start;
+  guint32 priority;
+  GESClip *clip;
+} LayerClip;
+
 enum
 {
   PROP_0,
@@ -78,6 +91,102 @@ enum
 
 static guint ges_layer_signals[LAST_SIGNAL] = { 0 };
 
+/* Clips are sorted by start and then by priority. A LayerClip without clip is used to look up the first clip
+ * starting at or after a given time */
+static gint
+layer_clip_compare (LayerClip * a, LayerClip * b, gpointer udata)
+{
+  if (a->start != b->start)
+    return a->start < b->start ? -1 : 1;
+
+  if (!a->clip)
+    return -1;
+
+  if (!b->clip)
+    return 1;
+
+  if (a->priority != b->priority)
+    return a->priority < b->priority ? -1 : 1;
+
+  return 0;
+}
+
+static void
+layer_clip_free (LayerClip * lclip)
+{
+  g_slice_free (LayerClip, lclip);
+}
+
+static void
+clip_start_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
+    GESLayer * layer)
+{
+  GSequenceIter *iter = g_hash_table_lookup (layer->priv->clips, clip);
+  LayerClip *lclip = g_sequence_get (iter);
+
+  lclip->start = _START (clip);
+  g_sequence_sort_changed (iter, (GCompareDataFunc) layer_clip_compare, NULL);
+}
+
+static void
+clip_priority_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
+    GESLayer * layer)
+{
+  GSequenceIter *iter = g_hash_table_lookup (layer->priv->clips, clip);
+  LayerClip *lclip = g_sequence_get (iter);
+
+  lclip->priority = _PRIORITY (clip);
+  g_sequence_sort_changed (iter, (GCompareDataFunc) layer_clip_compare, NULL);
+}
+
+static void
+clip_duration_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
+    GESLayer * layer)
+{
+  layer->priv->max_duration = MAX (layer->priv->max_duration,
+      _DURATION (clip));
+}
+
+static void
+layer_track_clip (GESLayer * layer, GESClip * clip)
+{
+  GESLayerPrivate *priv = layer->priv;
+  LayerClip *lclip = g_slice_new (LayerClip);
+
+  lclip->start = _START (clip);
+  lclip->priority = _PRIORITY (clip);
+  lclip->clip = clip;
+  g_hash_table_insert (priv->clips, clip,
+      g_sequence_insert_sorted (priv->clips_start, lclip,
+          (GCompareDataFunc) layer_clip_compare, NULL));
+  priv->max_duration = MAX (priv->max_duration, _DURATION (clip));
+
+  g_signal_connect (clip, "notify::start",
+      G_CALLBACK (clip_start_changed_cb), layer);
+  g_signal_connect (clip, "notify::priority",
+      G_CALLBACK (clip_priority_changed_cb), layer);
+  g_signal_connect (clip, "notify::duration",
+      G_CALLBACK (clip_duration_changed_cb), layer);
+}
+
+static void
+layer_untrack_clip (GESLayer * layer, GESClip * clip)
+{
+  GESLayerPrivate *priv = layer->priv;
+
+  g_signal_handlers_disconnect_by_func (clip, clip_start_changed_cb, layer);
+  g_signal_handlers_disconnect_by_func (clip, clip_priority_changed_cb,
+      layer);
+  g_signal_handlers_disconnect_by_func (clip, clip_duration_changed_cb, layer);
+
+  g_sequence_remove (g_hash_table_lookup (priv->clips, clip));
+  g_hash_table_remove (priv->clips, clip);
+  if (g_sequence_is_empty (priv->clips_start))
+    priv->max_duration = 0;
+}
+
+#define LAYER_CLIP(iter) (((LayerClip *) g_sequence_get (iter))->clip)
+
 /* GObject standard vmethods */
 static void
 ges_layer_get_property (GObject * object, guint property_id,
@@ -124,12 +233,24 @@ ges_layer_dispose (GObject * object)
 
   GST_DEBUG ("Disposing layer");
 
-  while (priv->clips_start)
-    ges_layer_remove_clip (layer, (GESClip *) priv->clips_start->data);
+  while (!g_sequence_is_empty (priv->clips_start))
+    ges_layer_remove_clip (layer,
+        LAYER_CLIP (g_sequence_get_begin_iter (priv->clips_start)));
 
   G_OBJECT_CLASS (ges_layer_parent_class)->dispose (object);
 }
 
+static void
+ges_layer_finalize (GObject * object)
+{
+  GESLayerPrivate *priv = GES_LAYER (object)->priv;
+
+  g_sequence_free (priv->clips_start);
+  g_hash_table_unref (priv->clips);
+
+  G_OBJECT_CLASS (ges_layer_parent_class)->finalize (object);
+}
+
 static gboolean
 _register_metas (GESLayer * layer)
 {
@@ -155,6 +276,7 @@ ges_layer_class_init (GESLayerClass * klass)
   object_class->get_property = ges_layer_get_property;
   object_class->set_property = ges_layer_set_property;
   object_class->dispose = ges_layer_dispose;
+  object_class->finalize = ges_layer_finalize;
 
   /**
    * GESLayer:priority:
@@ -218,6 +340,9 @@ ges_layer_init (GESLayer * self)
 
   self->priv->priority = 0;
   self->priv->auto_transition = FALSE;
+  self->priv->clips_start =
+      g_sequence_new ((GDestroyNotify) layer_clip_free);
+  self->priv->clips = g_hash_table_new (g_direct_hash, g_direct_equal);
   self->min_nle_priority = MIN_NLE_PRIO;
   self->max_nle_priority = LAYER_HEIGHT + MIN_NLE_PRIO;
 
@@ -230,12 +355,13 @@ ges_layer_resync_priorities_by_type (GESLayer * layer,
 {
   GstClockTime next_reset = 0;
   gint priority = starting_priority, max_priority = priority;
-  GList *tmp;
+  GSequenceIter *iter;
   GESTimelineElement *element;
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
+  for (iter = g_sequence_get_begin_iter (layer->priv->clips_start);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
 
-    element = GES_TIMELINE_ELEMENT (tmp->data);
+    element = GES_TIMELINE_ELEMENT (LAYER_CLIP (iter));
 
     if (GES_IS_TRANSITION_CLIP (element)) {
       /* Blindly set transitions priorities to 0 */
@@ -363,13 +489,14 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, NewAssetUData * udata)
 GstClockTime
 ges_layer_get_duration (GESLayer * layer)
 {
-  GList *tmp;
+  GSequenceIter *iter;
   GstClockTime duration = 0;
 
   g_return_val_if_fail (GES_IS_LAYER (layer), 0);
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
-    duration = MAX (duration, _END (tmp->data));
+  for (iter = g_sequence_get_begin_iter (layer->priv->clips_start);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    duration = MAX (duration, _END (LAYER_CLIP (iter)));
   }
 
   return duration;
@@ -411,7 +538,7 @@ ges_layer_remove_clip (GESLayer * layer, GESClip * clip)
   gst_object_unref (current_layer);
 
   /* Remove it from our list of controlled objects */
-  layer->priv->clips_start = g_list_remove (layer->priv->clips_start, clip);
+  layer_untrack_clip (layer, clip);
 
   /* emit 'clip-removed' */
   g_signal_emit (layer, ges_layer_signals[OBJECT_REMOVED], 0, clip);
@@ -515,6 +642,8 @@ ges_layer_get_priority (GESLayer * layer)
 GList *
 ges_layer_get_clips (GESLayer * layer)
 {
+  GList *clips = NULL;
+  GSequenceIter *iter;
   GESLayerClass *klass;
 
   g_return_val_if_fail (GES_IS_LAYER (layer), NULL);
@@ -525,9 +654,14 @@ ges_layer_get_clips (GESLayer * layer)
     return klass->get_objects (layer);
   }
 
-  return g_list_sort (g_list_copy_deep (layer->priv->clips_start,
-          (GCopyFunc) gst_object_ref, NULL),
-      (GCompareFunc) element_start_compare);
+  iter = g_sequence_get_end_iter (layer->priv->clips_start);
+  while (!g_sequence_iter_is_begin (iter)) {
+    iter = g_sequence_iter_prev (iter);
+    clips = g_list_prepend (clips, gst_object_ref (LAYER_CLIP (iter)));
+  }
+
+  /* Priorities might have changed since the clips got sorted */
+  return g_list_sort (clips, (GCompareFunc) element_start_compare);
 }
 
 /**
@@ -545,47 +679,30 @@ ges_layer_is_empty (GESLayer * layer)
 {
   g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
 
-  return (layer->priv->clips_start == NULL);
+  return g_sequence_is_empty (layer->priv->clips_start);
 }
 
-/**
- * ges_layer_add_clip:
- * @layer: a #GESLayer
- * @clip: (transfer floating): the #GESClip to add.
- *
- * Adds the given clip to the layer. Sets the clip's parent, and thus
- * takes ownership of the clip.
- *
- * An clip can only be added to one layer.
- *
- * Calling this method will construct and properly set all the media related
- * elements on @clip. If you need to know when those objects (actually #GESTrackElement)
- * are constructed, you should connect to the container::child-added signal which
- * is emited right after those elements are ready to be used.
- *
- * Returns: %TRUE if the clip was properly added to the layer, or %FALSE
- * if the @layer refuses to add the clip.
- */
-gboolean
-ges_layer_add_clip (GESLayer * layer, GESClip * clip)
+typedef enum
+{
+  CLIP_ADD_ERROR,
+  CLIP_ADD_ASYNC,
+  CLIP_ADD_READY
+} ClipAddResult;
+
+/* Takes ownership of @clip and makes sure it has an asset */
+static ClipAddResult
+_prepare_clip (GESLayer * layer, GESClip * clip)
 {
   GESAsset *asset;
-  GESLayerPrivate *priv;
   GESLayer *current_layer;
 
-  g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
-  g_return_val_if_fail (GES_IS_CLIP (clip), FALSE);
-
-  GST_DEBUG_OBJECT (layer, "adding clip:%p", clip);
-
-  priv = layer->priv;
   current_layer = ges_clip_get_layer (clip);
   if (G_UNLIKELY (current_layer)) {
     GST_WARNING ("Clip %p already belongs to another layer", clip);
     gst_object_ref_sink (clip);
     gst_object_unref (current_layer);
 
-    return FALSE;
+    return CLIP_ADD_ERROR;
   }
 
   asset = ges_extractable_get_asset (GES_EXTRACTABLE (clip));
@@ -614,7 +731,7 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
       g_free (id);
 
       GST_LOG_OBJECT (layer, "Object added async");
-      return TRUE;
+      return CLIP_ADD_ASYNC;
     }
     g_free (id);
 
@@ -625,9 +742,14 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
     gst_object_ref_sink (clip);
   }
 
+  return CLIP_ADD_READY;
+}
+
+static void
+_insert_clip (GESLayer * layer, GESClip * clip)
+{
   /* Take a reference to the clip and store it stored by start/priority */
-  priv->clips_start = g_list_insert_sorted (priv->clips_start, clip,
-      (GCompareFunc) element_start_compare);
+  layer_track_clip (layer, clip);
 
   /* Inform the clip it's now in this layer */
   ges_clip_set_layer (clip, layer);
@@ -643,6 +765,44 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
         _PRIORITY (clip), LAYER_HEIGHT - 1);
     _set_priority0 (GES_TIMELINE_ELEMENT (clip), LAYER_HEIGHT - 1);
   }
+}
+
+/**
+ * ges_layer_add_clip:
+ * @layer: a #GESLayer
+ * @clip: (transfer floating): the #GESClip to add.
+ *
+ * Adds the given clip to the layer. Sets the clip's parent, and thus
+ * takes ownership of the clip.
+ *
+ * An clip can only be added to one layer.
+ *
+ * Calling this method will construct and properly set all the media related
+ * elements on @clip. If you need to know when those objects (actually #GESTrackElement)
+ * are constructed, you should connect to the container::child-added signal which
+ * is emited right after those elements are ready to be used.
+ *
+ * Returns: %TRUE if the clip was properly added to the layer, or %FALSE
+ * if the @layer refuses to add the clip.
+ */
+gboolean
+ges_layer_add_clip (GESLayer * layer, GESClip * clip)
+{
+  g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
+  g_return_val_if_fail (GES_IS_CLIP (clip), FALSE);
+
+  GST_DEBUG_OBJECT (layer, "adding clip:%p", clip);
+
+  switch (_prepare_clip (layer, clip)) {
+    case CLIP_ADD_ERROR:
+      return FALSE;
+    case CLIP_ADD_ASYNC:
+      return TRUE;
+    case CLIP_ADD_READY:
+      break;
+  }
+
+  _insert_clip (layer, clip);
 
   ges_layer_resync_priorities (layer);
 
@@ -655,6 +815,76 @@ ges_layer_add_clip (GESLayer * layer, GESClip * clip)
   return TRUE;
 }
 
+/**
+ * ges_layer_add_clips:
+ * @layer: a #GESLayer
+ * @clips: (element-type GESClip) (transfer none): the #GESClip-s to add,
+ * floating references are taken like in #ges_layer_add_clip
+ *
+ * Adds all the given clips to the layer, like #ges_layer_add_clip would do
+ * for each of them, but sorting them and resyncing the clips priorities only
+ * once. The #GESLayer::clip-added signal is then emitted for each of them,
+ * in order.
+ *
+ * Each clip can only appear once in @clips.
+ *
+ * Returns: %TRUE if all the clips were properly added to the layer, or
+ * %FALSE if the @layer refused to add some of them.
+ *
+ * Since: 1.16
+ */
+gboolean
+ges_layer_add_clips (GESLayer * layer, GList * clips)
+{
+  GList *tmp, *sorted, *added = NULL;
+  gboolean res = TRUE;
+
+  g_return_val_if_fail (GES_IS_LAYER (layer), FALSE);
+
+  GST_DEBUG_OBJECT (layer, "adding %d clips", g_list_length (clips));
+
+  sorted = g_list_sort (g_list_copy (clips),
+      (GCompareFunc) element_start_compare);
+  for (tmp = sorted; tmp; tmp = tmp->next) {
+    GESClip *clip = tmp->data;
+
+    if (!GES_IS_CLIP (clip)) {
+      GST_WARNING_OBJECT (layer, "%p is not a clip, not adding it", clip);
+      res = FALSE;
+      continue;
+    }
+
+    switch (_prepare_clip (layer, clip)) {
+      case CLIP_ADD_ERROR:
+        res = FALSE;
+        break;
+      case CLIP_ADD_ASYNC:
+        break;
+      case CLIP_ADD_READY:
+        _insert_clip (layer, clip);
+        added = g_list_prepend (added, clip);
+        break;
+    }
+  }
+  g_list_free (sorted);
+
+  if (!added)
+    return res;
+
+  added = g_list_reverse (added);
+  ges_layer_resync_priorities (layer);
+
+  for (tmp = added; tmp; tmp = tmp->next)
+    ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (tmp->data),
+        layer->timeline);
+
+  for (tmp = added; tmp; tmp = tmp->next)
+    g_signal_emit (layer, ges_layer_signals[OBJECT_ADDED], 0, tmp->data);
+  g_list_free (added);
+
+  return res;
+}
+
 /**
  * ges_layer_add_asset:
  * @layer: a #GESLayer
@@ -748,14 +978,16 @@ ges_layer_get_timeline (GESLayer * layer)
 void
 ges_layer_set_timeline (GESLayer * layer, GESTimeline * timeline)
 {
-  GList *tmp;
+  GSequenceIter *iter;
 
   g_return_if_fail (GES_IS_LAYER (layer));
 
   GST_DEBUG ("layer:%p, timeline:%p", layer, timeline);
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
-    ges_timeline_element_set_timeline (tmp->data, timeline);
+  for (iter = g_sequence_get_begin_iter (layer->priv->clips_start);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (LAYER_CLIP
+            (iter)), timeline);
   }
 
   layer->timeline = timeline;
@@ -775,17 +1007,30 @@ GList *
 ges_layer_get_clips_in_interval (GESLayer * layer, GstClockTime start,
     GstClockTime end)
 {
-  GList *tmp;
+  GSequenceIter *iter;
   GList *intersecting_clips = NULL;
   GstClockTime clip_start, clip_end;
   gboolean clip_intersects;
+  LayerClip first = { 0, 0, NULL };
 
   g_return_val_if_fail (GES_IS_LAYER (layer), NULL);
 
-  for (tmp = layer->priv->clips_start; tmp; tmp = tmp->next) {
+  /* Clips starting before that can not reach @start */
+  if (start > layer->priv->max_duration)
+    first.start = start - layer->priv->max_duration;
+
+  for (iter = g_sequence_search (layer->priv->clips_start, &first,
+          (GCompareDataFunc) layer_clip_compare, NULL);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    GESClip *clip = LAYER_CLIP (iter);
+
     clip_intersects = FALSE;
-    clip_start = ges_timeline_element_get_start (tmp->data);
-    clip_end = clip_start + ges_timeline_element_get_duration (tmp->data);
+    clip_start = ges_timeline_element_get_start (GES_TIMELINE_ELEMENT (clip));
+    clip_end = clip_start +
+        ges_timeline_element_get_duration (GES_TIMELINE_ELEMENT (clip));
+    if (clip_start > end)
+      break;
+
     if (start <= clip_start && clip_start < end)
       clip_intersects = TRUE;
     else if (start < clip_end && clip_end <= end)
@@ -795,8 +1040,9 @@ ges_layer_get_clips_in_interval (GESLayer * layer, GstClockTime start,
 
     if (clip_intersects)
       intersecting_clips =
-          g_list_insert_sorted (intersecting_clips,
-          gst_object_ref (tmp->data), (GCompareFunc) element_start_compare);
+          g_list_prepend (intersecting_clips, gst_object_ref (clip));
   }
-  return intersecting_clips;
+
+  return g_list_sort (intersecting_clips,
+      (GCompareFunc) element_start_compare);
 }
@@ -106,6 +106,9 @@ GES_API
 gboolean ges_layer_add_clip    (GESLayer * layer,
 					   GESClip * clip);
 GES_API
+gboolean ges_layer_add_clips   (GESLayer * layer,
+					   GList * clips);
+GES_API
 GESClip * ges_layer_add_asset   (GESLayer *layer,
                                                        GESAsset *asset,
                                                        GstClockTime start,
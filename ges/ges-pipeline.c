@@ -30,6 +30,7 @@
 
 #include <gst/gst.h>
 #include <gst/video/videooverlay.h>
+#include <glib/gstdio.h>
 #include <stdio.h>
 
 #include "ges-internal.h"
@@ -90,6 +91,14 @@ enum
 
 static GParamSpec *properties[PROP_LAST];
 
+enum
+{
+  SEGMENT_PROGRESS,
+  LAST_SIGNAL
+};
+
+static guint ges_pipeline_signals[LAST_SIGNAL] = { 0 };
+
 static GstStateChangeReturn ges_pipeline_change_state (GstElement *
     element, GstStateChange transition);
 
@@ -230,6 +239,12 @@ _timeline_track_added_cb (GESTimeline * timeline, GESTrack * track,
   track_disable_last_gap (track,
       ! !(pipeline->priv->mode & (GES_PIPELINE_MODE_RENDER |
               GES_PIPELINE_MODE_SMART_RENDER)));
+  track_set_lookahead (track,
+      ! !(pipeline->priv->mode & (GES_PIPELINE_MODE_RENDER |
+              GES_PIPELINE_MODE_SMART_RENDER)));
+  track_set_use_proxies (track,
+      !(pipeline->priv->mode & (GES_PIPELINE_MODE_RENDER |
+              GES_PIPELINE_MODE_SMART_RENDER)));
   _link_track (pipeline, track);
 }
 
@@ -358,6 +373,25 @@ ges_pipeline_class_init (GESPipelineClass * klass)
 
   g_object_class_install_properties (object_class, PROP_LAST, properties);
 
+  /**
+   * GESPipeline::segment-progress:
+   * @pipeline: the #GESPipeline
+   * @segment: the index of the segment
+   * @position: the position reached in the segment
+   * @duration: the duration of the segment
+   *
+   * Reports the progress of the segments rendered by
+   * ges_pipeline_render_segmented_async(). It is emitted regularly for each
+   * segment being rendered, and a last time with @position equal to
+   * @duration when the segment is done.
+   *
+   * Since: 1.16
+   */
+  ges_pipeline_signals[SEGMENT_PROGRESS] =
+      g_signal_new ("segment-progress", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 3, G_TYPE_UINT, GST_TYPE_CLOCK_TIME, GST_TYPE_CLOCK_TIME);
+
   element_class->change_state = GST_DEBUG_FUNCPTR (ges_pipeline_change_state);
 
   /* TODO : Add state_change handlers
@@ -421,7 +455,7 @@ _track_is_compatible_with_profile (GESPipeline * self, GESTrack * track,
 {
   if (TRACK_COMPATIBLE_PROFILE (track->type, prof)) {
     if (self->priv->mode == GES_PIPELINE_MODE_SMART_RENDER) {
-      GstCaps *ocaps, *rcaps;
+      GstCaps *ocaps, *rcaps, *format;
 
       GST_DEBUG ("Smart Render mode, setting input caps");
       ocaps = gst_encoding_profile_get_input_caps (prof);
@@ -433,9 +467,16 @@ _track_is_compatible_with_profile (GESPipeline * self, GESTrack * track,
       gst_caps_append (ocaps, rcaps);
       ges_track_set_caps (track, ocaps);
       gst_caps_unref (ocaps);
+
+      /* Let the unmodified sources output their compressed streams */
+      format = gst_encoding_profile_get_format (prof);
+      track_set_passthrough_caps (track, format);
+      gst_caps_unref (format);
     } else {
       GstCaps *caps = NULL;
 
+      track_set_passthrough_caps (track, NULL);
+
       /* Raw preview or rendering mode */
       if (track->type == GES_TRACK_TYPE_VIDEO)
         caps = gst_caps_new_empty_simple ("video/x-raw");
@@ -760,6 +801,148 @@ _query_position_cb (GstElement * composition, GESPipeline * self)
   return GST_CLOCK_TIME_NONE;
 }
 
+/* Whether the output of @track is shown or played when in @mode */
+static gboolean
+_track_needs_playsink (GESPipelineFlags mode, GESTrack * track)
+{
+  switch (track->type) {
+    case GES_TRACK_TYPE_VIDEO:
+      return ! !(mode & GES_PIPELINE_MODE_PREVIEW_VIDEO);
+    case GES_TRACK_TYPE_AUDIO:
+      return ! !(mode & GES_PIPELINE_MODE_PREVIEW_AUDIO);
+    default:
+      return ! !(mode & GES_PIPELINE_MODE_PREVIEW);
+  }
+}
+
+static gboolean
+_link_playsink (GESPipeline * self, OutputChain * chain)
+{
+  const gchar *sinkpad_name;
+  GstPad *tmppad, *sinkpad;
+  GstPadLinkReturn lret;
+  gboolean reconfigured = FALSE;
+
+  GST_DEBUG_OBJECT (self, "Connecting to playsink");
+
+  switch (chain->track->type) {
+    case GES_TRACK_TYPE_VIDEO:
+      sinkpad_name = "video_sink";
+      break;
+    case GES_TRACK_TYPE_AUDIO:
+      sinkpad_name = "audio_sink";
+      break;
+    case GES_TRACK_TYPE_TEXT:
+      sinkpad_name = "text_sink";
+      break;
+    default:
+      GST_WARNING_OBJECT (self, "Can't handle tracks of type %d yet",
+          chain->track->type);
+      return FALSE;
+  }
+
+  /* Request a sinkpad from playsink */
+  if (G_UNLIKELY (!(sinkpad =
+              gst_element_get_request_pad (self->priv->playsink,
+                  sinkpad_name)))) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
+        (NULL), ("Could not get a pad from playsink for %s", sinkpad_name));
+    return FALSE;
+  }
+
+  tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
+  lret = gst_pad_link_full (tmppad, sinkpad, GST_PAD_LINK_CHECK_NOTHING);
+  if (G_UNLIKELY (lret != GST_PAD_LINK_OK)) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
+        (NULL),
+        ("Could not link %" GST_PTR_FORMAT " and %" GST_PTR_FORMAT " (%s)",
+            tmppad, sinkpad, gst_pad_link_get_name (lret)));
+    gst_element_release_request_pad (chain->tee, tmppad);
+    gst_object_unref (tmppad);
+    gst_element_release_request_pad (self->priv->playsink, sinkpad);
+    gst_object_unref (sinkpad);
+    return FALSE;
+  }
+  gst_object_unref (tmppad);
+
+  GST_DEBUG ("Reconfiguring playsink");
+
+  /* reconfigure playsink */
+  g_signal_emit_by_name (self->priv->playsink, "reconfigure", &reconfigured);
+  GST_DEBUG ("'reconfigure' returned %d", reconfigured);
+
+  /* We still hold a reference on the sinkpad */
+  chain->playsinkpad = sinkpad;
+
+  return TRUE;
+}
+
+static gboolean
+_link_encodebin (GESPipeline * self, OutputChain * chain)
+{
+  GstPad *tmppad, *sinkpad;
+
+  GST_DEBUG_OBJECT (self, "Connecting to encodebin");
+
+  if (!chain->encodebinpad) {
+    /* Check for unused static pads */
+    sinkpad = get_compatible_unlinked_pad (self->priv->encodebin, chain->track);
+
+    if (sinkpad == NULL) {
+      GstCaps *caps = gst_pad_query_caps (chain->srcpad, NULL);
+
+      /* If no compatible static pad is available, request a pad */
+      g_signal_emit_by_name (self->priv->encodebin, "request-pad", caps,
+          &sinkpad);
+
+      if (G_UNLIKELY (sinkpad == NULL)) {
+        gst_element_set_locked_state (GST_ELEMENT (chain->track), TRUE);
+
+        self->priv->not_rendered_tracks =
+            g_list_append (self->priv->not_rendered_tracks, chain->track);
+
+        GST_INFO_OBJECT (self,
+            "Couldn't get a pad from encodebin for: %" GST_PTR_FORMAT, caps);
+        gst_caps_unref (caps);
+        return FALSE;
+      }
+
+      gst_caps_unref (caps);
+    }
+    chain->encodebinpad = sinkpad;
+    GST_INFO_OBJECT (chain->track, "Linked to %" GST_PTR_FORMAT, sinkpad);
+  }
+
+  tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
+  if (G_UNLIKELY (gst_pad_link_full (tmppad, chain->encodebinpad,
+              GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK)) {
+    GST_ERROR_OBJECT (self, "Couldn't link track pad to encodebin");
+    gst_element_release_request_pad (chain->tee, tmppad);
+    gst_object_unref (tmppad);
+    return FALSE;
+  }
+  gst_object_unref (tmppad);
+
+  return TRUE;
+}
+
+/* Unlinks the tee branch feeding @sinkpad and releases the pads of both
+ * sides */
+static void
+_unlink_tee_branch (OutputChain * chain, GstElement * sink, GstPad ** sinkpad)
+{
+  GstPad *peer = gst_pad_get_peer (*sinkpad);
+
+  if (peer) {
+    gst_pad_unlink (peer, *sinkpad);
+    gst_element_release_request_pad (chain->tee, peer);
+    gst_object_unref (peer);
+  }
+  gst_element_release_request_pad (sink, *sinkpad);
+  gst_object_unref (*sinkpad);
+  *sinkpad = NULL;
+}
+
 static void
 _link_track (GESPipeline * self, GESTrack * track)
 {
@@ -768,7 +951,6 @@ _link_track (GESPipeline * self, GESTrack * track)
   GstPad *sinkpad;
   GstCaps *caps;
   GstPadLinkReturn lret;
-  gboolean reconfigured = FALSE;
 
   pad = ges_timeline_get_pad_for_track (self->priv->timeline, track);
   caps = gst_pad_query_caps (pad, NULL);
@@ -817,119 +999,31 @@ _link_track (GESPipeline * self, GESTrack * track)
   chain->srcpad = pad;
   gst_object_unref (pad);
 
-  /* Adding tee */
+  /* Adding tee, its branches can be (un)linked when switching modes, so it
+   * must not error out while the track has no output */
   chain->tee = gst_element_factory_make ("tee", NULL);
+  g_object_set (chain->tee, "allow-not-linked", TRUE, NULL);
   gst_bin_add (GST_BIN_CAST (self), chain->tee);
   gst_element_sync_state_with_parent (chain->tee);
 
   /* Linking pad to tee */
   sinkpad = gst_element_get_static_pad (chain->tee, "sink");
   lret = gst_pad_link (pad, sinkpad);
+  gst_object_unref (sinkpad);
   if (lret != GST_PAD_LINK_OK) {
     GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
         (NULL), ("Could not link the tee (%s)", gst_pad_link_get_name (lret)));
     goto error;
   }
 
-  gst_object_unref (sinkpad);
-
   /* Connect playsink */
-  if (self->priv->mode & GES_PIPELINE_MODE_PREVIEW) {
-    const gchar *sinkpad_name;
-    GstPad *tmppad;
-
-    GST_DEBUG_OBJECT (self, "Connecting to playsink");
-
-    switch (track->type) {
-      case GES_TRACK_TYPE_VIDEO:
-        sinkpad_name = "video_sink";
-        break;
-      case GES_TRACK_TYPE_AUDIO:
-        sinkpad_name = "audio_sink";
-        break;
-      case GES_TRACK_TYPE_TEXT:
-        sinkpad_name = "text_sink";
-        break;
-      default:
-        GST_WARNING_OBJECT (self, "Can't handle tracks of type %d yet",
-            track->type);
-        goto error;
-    }
-
-    /* Request a sinkpad from playsink */
-    if (G_UNLIKELY (!(sinkpad =
-                gst_element_get_request_pad (self->priv->playsink,
-                    sinkpad_name)))) {
-      GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
-          (NULL), ("Could not get a pad from playsink for %s", sinkpad_name));
-      goto error;
-    }
-
-    tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
-    lret = gst_pad_link_full (tmppad, sinkpad, GST_PAD_LINK_CHECK_NOTHING);
-    if (G_UNLIKELY (lret != GST_PAD_LINK_OK)) {
-      gst_object_unref (tmppad);
-      GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
-          (NULL),
-          ("Could not link %" GST_PTR_FORMAT " and %" GST_PTR_FORMAT " (%s)",
-              tmppad, sinkpad, gst_pad_link_get_name (lret)));
-      goto error;
-    }
-    gst_object_unref (tmppad);
-
-    GST_DEBUG ("Reconfiguring playsink");
-
-    /* reconfigure playsink */
-    g_signal_emit_by_name (self->priv->playsink, "reconfigure", &reconfigured);
-    GST_DEBUG ("'reconfigure' returned %d", reconfigured);
-
-    /* We still hold a reference on the sinkpad */
-    chain->playsinkpad = sinkpad;
-  }
+  if (_track_needs_playsink (self->priv->mode, track) &&
+      !_link_playsink (self, chain))
+    goto error;
 
   /* Connect to encodebin */
-  if (IN_RENDERING_MODE (self)) {
-    GstPad *tmppad;
-    GST_DEBUG_OBJECT (self, "Connecting to encodebin");
-
-    if (!chain->encodebinpad) {
-      /* Check for unused static pads */
-      sinkpad = get_compatible_unlinked_pad (self->priv->encodebin, track);
-
-      if (sinkpad == NULL) {
-        GstCaps *caps = gst_pad_query_caps (pad, NULL);
-
-        /* If no compatible static pad is available, request a pad */
-        g_signal_emit_by_name (self->priv->encodebin, "request-pad", caps,
-            &sinkpad);
-
-        if (G_UNLIKELY (sinkpad == NULL)) {
-          gst_element_set_locked_state (GST_ELEMENT (track), TRUE);
-
-          self->priv->not_rendered_tracks =
-              g_list_append (self->priv->not_rendered_tracks, track);
-
-          GST_INFO_OBJECT (self,
-              "Couldn't get a pad from encodebin for: %" GST_PTR_FORMAT, caps);
-          gst_caps_unref (caps);
-          goto error;
-        }
-
-        gst_caps_unref (caps);
-      }
-      chain->encodebinpad = sinkpad;
-      GST_INFO_OBJECT (track, "Linked to %" GST_PTR_FORMAT, sinkpad);
-    }
-
-    tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
-    if (G_UNLIKELY (gst_pad_link_full (tmppad, chain->encodebinpad,
-                GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK)) {
-      GST_ERROR_OBJECT (self, "Couldn't link track pad to encodebin");
-      goto error;
-    }
-    gst_object_unref (tmppad);
-
-  }
+  if (IN_RENDERING_MODE (self) && !_link_encodebin (self, chain))
+    goto error;
 
   /* If chain wasn't already present, insert it in list */
   if (!get_output_chain_for_track (self, track))
@@ -940,12 +1034,16 @@ _link_track (GESPipeline * self, GESTrack * track)
 
 error:
   {
+    if (chain->playsinkpad)
+      _unlink_tee_branch (chain, self->priv->playsink, &chain->playsinkpad);
+    if (chain->encodebinpad)
+      _unlink_tee_branch (chain, self->priv->encodebin, &chain->encodebinpad);
     if (chain->tee) {
       gst_element_set_state (chain->tee, GST_STATE_NULL);
       gst_bin_remove (GST_BIN_CAST (self), chain->tee);
     }
-    if (sinkpad)
-      gst_object_unref (sinkpad);
+    g_signal_handler_disconnect (ges_track_get_composition (track),
+        chain->query_position_id);
 
     g_free (chain);
   }
@@ -964,23 +1062,12 @@ _unlink_track (GESPipeline * self, GESTrack * track)
   }
 
   /* Unlink encodebin */
-  if (chain->encodebinpad) {
-    GstPad *peer = gst_pad_get_peer (chain->encodebinpad);
-    gst_pad_unlink (peer, chain->encodebinpad);
-    gst_object_unref (peer);
-    gst_element_release_request_pad (self->priv->encodebin,
-        chain->encodebinpad);
-    gst_object_unref (chain->encodebinpad);
-  }
+  if (chain->encodebinpad)
+    _unlink_tee_branch (chain, self->priv->encodebin, &chain->encodebinpad);
 
   /* Unlink playsink */
-  if (chain->playsinkpad) {
-    GstPad *peer = gst_pad_get_peer (chain->playsinkpad);
-    gst_pad_unlink (peer, chain->playsinkpad);
-    gst_object_unref (peer);
-    gst_element_release_request_pad (self->priv->playsink, chain->playsinkpad);
-    gst_object_unref (chain->playsinkpad);
-  }
+  if (chain->playsinkpad)
+    _unlink_tee_branch (chain, self->priv->playsink, &chain->playsinkpad);
 
   gst_element_set_state (chain->tee, GST_STATE_NULL);
   gst_bin_remove (GST_BIN (self), chain->tee);
@@ -1137,65 +1224,44 @@ ges_pipeline_get_mode (GESPipeline * pipeline)
   return pipeline->priv->mode;
 }
 
-/**
- * ges_pipeline_set_mode:
- * @pipeline: a #GESPipeline
- * @mode: the #GESPipelineFlags to use
- *
- * switches the @pipeline to the specified @mode. The default mode when
- * creating a #GESPipeline is #GES_PIPELINE_MODE_PREVIEW.
- *
- * Note: The @pipeline will be set to #GST_STATE_NULL during this call due to
- * the internal changes that happen. The caller will therefore have to
- * set the @pipeline to the requested state after calling this method.
- *
- * Returns: %TRUE if the mode was properly set, else %FALSE.
- **/
-gboolean
-ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
+/* Applies the track side configuration of @mode */
+static void
+_configure_tracks_for_mode (GESPipeline * self, GESPipelineFlags mode)
 {
-
   GList *tmp;
-  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
-
-  GST_DEBUG_OBJECT (pipeline, "current mode : %d, mode : %d",
-      pipeline->priv->mode, mode);
-
-  /* fast-path, nothing to change */
-  if (mode == pipeline->priv->mode)
-    return TRUE;
-
-  /* FIXME: It would be nice if we are only (de)activating preview
-   * modes to not set the whole pipeline to NULL, but instead just
-   * do the proper (un)linking to playsink. */
-
-  /* Switch pipeline to NULL since we're changing the configuration */
-  gst_element_set_state (GST_ELEMENT_CAST (pipeline), GST_STATE_NULL);
-
-
-  if (pipeline->priv->timeline) {
-    gboolean disabled =
-        ! !(mode & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER));
-
-    for (tmp = pipeline->priv->timeline->tracks; tmp; tmp = tmp->next)
-      track_disable_last_gap (GES_TRACK (tmp->data), disabled);
+  gboolean disabled =
+      ! !(mode & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER));
+
+  for (tmp = self->priv->timeline->tracks; tmp; tmp = tmp->next) {
+    track_disable_last_gap (GES_TRACK (tmp->data), disabled);
+    track_set_lookahead (GES_TRACK (tmp->data), disabled);
+    track_set_use_proxies (GES_TRACK (tmp->data), !disabled);
+    if (!(mode & GES_PIPELINE_MODE_SMART_RENDER))
+      track_set_passthrough_caps (GES_TRACK (tmp->data), NULL);
   }
+}
 
+/* Adds the output bins @mode needs to the pipeline and removes the ones it
+ * does not need anymore */
+static gboolean
+_update_output_bins (GESPipeline * self, GESPipelineFlags mode)
+{
   /* remove no-longer needed components */
-  if (pipeline->priv->mode & GES_PIPELINE_MODE_PREVIEW &&
+  if (self->priv->mode & GES_PIPELINE_MODE_PREVIEW &&
       !(mode & GES_PIPELINE_MODE_PREVIEW)) {
     /* Disable playsink */
     GST_DEBUG ("Disabling playsink");
-    gst_object_ref (pipeline->priv->playsink);
-    gst_bin_remove (GST_BIN_CAST (pipeline), pipeline->priv->playsink);
+    gst_object_ref (self->priv->playsink);
+    gst_bin_remove (GST_BIN_CAST (self), self->priv->playsink);
+    gst_element_set_state (self->priv->playsink, GST_STATE_NULL);
   }
-  if ((pipeline->priv->mode &
+  if ((self->priv->mode &
           (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER)) &&
       !(mode & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER))) {
     GList *tmp;
     GstCaps *caps;
 
-    for (tmp = pipeline->priv->timeline->tracks; tmp; tmp = tmp->next) {
+    for (tmp = self->priv->timeline->tracks; tmp; tmp = tmp->next) {
       GESTrackType type = GES_TRACK (tmp->data)->type;
 
       if (type == GES_TRACK_TYPE_AUDIO)
@@ -1211,46 +1277,232 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
 
     /* Disable render bin */
     GST_DEBUG ("Disabling rendering bin");
-    gst_object_ref (pipeline->priv->encodebin);
-    gst_object_ref (pipeline->priv->urisink);
-    gst_bin_remove_many (GST_BIN_CAST (pipeline),
-        pipeline->priv->encodebin, pipeline->priv->urisink, NULL);
+    gst_object_ref (self->priv->encodebin);
+    gst_object_ref (self->priv->urisink);
+    gst_bin_remove_many (GST_BIN_CAST (self),
+        self->priv->encodebin, self->priv->urisink, NULL);
+    gst_element_set_state (self->priv->encodebin, GST_STATE_NULL);
+    gst_element_set_state (self->priv->urisink, GST_STATE_NULL);
   }
 
   /* Add new elements */
-  if (!(pipeline->priv->mode & GES_PIPELINE_MODE_PREVIEW) &&
+  if (!(self->priv->mode & GES_PIPELINE_MODE_PREVIEW) &&
       (mode & GES_PIPELINE_MODE_PREVIEW)) {
     /* Add playsink */
     GST_DEBUG ("Adding playsink");
-    if (!gst_bin_add (GST_BIN_CAST (pipeline), pipeline->priv->playsink)) {
-      GST_ERROR_OBJECT (pipeline, "Couldn't add playsink");
+    if (!gst_bin_add (GST_BIN_CAST (self), self->priv->playsink)) {
+      GST_ERROR_OBJECT (self, "Couldn't add playsink");
       return FALSE;
     }
   }
-  if (!(pipeline->priv->mode &
+  if (!(self->priv->mode &
           (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER)) &&
       (mode & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER))) {
     /* Adding render bin */
     GST_DEBUG ("Adding render bin");
 
-    if (G_UNLIKELY (pipeline->priv->urisink == NULL)) {
-      GST_ERROR_OBJECT (pipeline, "Output URI not set !");
+    if (G_UNLIKELY (self->priv->urisink == NULL)) {
+      GST_ERROR_OBJECT (self, "Output URI not set !");
       return FALSE;
     }
-    if (!gst_bin_add (GST_BIN_CAST (pipeline), pipeline->priv->encodebin)) {
-      GST_ERROR_OBJECT (pipeline, "Couldn't add encodebin");
+    if (!gst_bin_add (GST_BIN_CAST (self), self->priv->encodebin)) {
+      GST_ERROR_OBJECT (self, "Couldn't add encodebin");
       return FALSE;
     }
-    if (!gst_bin_add (GST_BIN_CAST (pipeline), pipeline->priv->urisink)) {
-      GST_ERROR_OBJECT (pipeline, "Couldn't add URI sink");
+    if (!gst_bin_add (GST_BIN_CAST (self), self->priv->urisink)) {
+      GST_ERROR_OBJECT (self, "Couldn't add URI sink");
       return FALSE;
     }
-    g_object_set (pipeline->priv->encodebin, "avoid-reencoding",
+    g_object_set (self->priv->encodebin, "avoid-reencoding",
         !(!(mode & GES_PIPELINE_MODE_SMART_RENDER)), NULL);
 
-    gst_element_link_pads_full (pipeline->priv->encodebin, "src",
-        pipeline->priv->urisink, "sink", GST_PAD_LINK_CHECK_NOTHING);
+    gst_element_link_pads_full (self->priv->encodebin, "src",
+        self->priv->urisink, "sink", GST_PAD_LINK_CHECK_NOTHING);
+  }
+
+  return TRUE;
+}
+
+/* Flushes the output of all the tracks, so that no data flows through the
+ * tees while their branches are being relinked */
+static void
+_flush_chains (GESPipeline * self, gboolean start)
+{
+  GList *tmp;
+
+  for (tmp = self->priv->chains; tmp; tmp = tmp->next) {
+    OutputChain *chain = (OutputChain *) tmp->data;
+    GstPad *sinkpad = gst_element_get_static_pad (chain->tee, "sink");
+
+    gst_pad_send_event (sinkpad, start ? gst_event_new_flush_start () :
+        gst_event_new_flush_stop (TRUE));
+    gst_object_unref (sinkpad);
   }
+}
+
+/* Whether some clip of @timeline has a proxy, or is itself the proxy of
+ * another asset, so that the decoded files depend on the mode */
+static gboolean
+_timeline_has_proxies (GESTimeline * timeline)
+{
+  GList *ltmp, *ctmp;
+
+  for (ltmp = timeline->layers; ltmp; ltmp = ltmp->next) {
+    GList *clips = ges_layer_get_clips (ltmp->data);
+
+    for (ctmp = clips; ctmp; ctmp = ctmp->next) {
+      GESAsset *asset = ges_extractable_get_asset (ctmp->data);
+
+      if (asset && (ges_asset_get_proxy (asset) ||
+              ges_asset_get_proxy_target (asset)))
+        break;
+    }
+    g_list_free_full (clips, gst_object_unref);
+
+    if (ctmp)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Relinks the tees of the tracks to the outputs of @mode while the pipeline
+ * keeps running, then restarts the tracks with a flushing seek. The
+ * compositions keep their current stack and sources, so this is much faster
+ * than going through NULL. */
+static gboolean
+_set_mode_dynamically (GESPipeline * self, GESPipelineFlags mode)
+{
+  GList *tmp;
+  gint64 position = 0;
+  gboolean res = TRUE;
+  gboolean rendering =
+      ! !(mode & (GES_PIPELINE_MODE_RENDER | GES_PIPELINE_MODE_SMART_RENDER));
+  gboolean rendering_changed = rendering != ! !IN_RENDERING_MODE (self);
+
+  /* An export always starts from the beginning of the timeline */
+  if ((!rendering || IN_RENDERING_MODE (self)) &&
+      !gst_element_query_position (GST_ELEMENT (self), GST_FORMAT_TIME,
+          &position))
+    position = 0;
+
+  GST_DEBUG_OBJECT (self, "Switching to mode %d while running, restarting "
+      "from %" GST_TIME_FORMAT, mode, GST_TIME_ARGS (position));
+
+  /* Unblocks the sinks and stops the streaming threads */
+  _flush_chains (self, TRUE);
+
+  for (tmp = self->priv->chains; tmp; tmp = tmp->next) {
+    OutputChain *chain = (OutputChain *) tmp->data;
+
+    if (chain->playsinkpad && !_track_needs_playsink (mode, chain->track))
+      _unlink_tee_branch (chain, self->priv->playsink, &chain->playsinkpad);
+    if (chain->encodebinpad && !rendering)
+      _unlink_tee_branch (chain, self->priv->encodebin, &chain->encodebinpad);
+  }
+
+  if (!_update_output_bins (self, mode)) {
+    _flush_chains (self, FALSE);
+
+    return FALSE;
+  }
+
+  _configure_tracks_for_mode (self, mode);
+  self->priv->mode = mode;
+  if (rendering)
+    ges_pipeline_update_caps (self);
+
+  for (tmp = self->priv->chains; tmp; tmp = tmp->next) {
+    OutputChain *chain = (OutputChain *) tmp->data;
+
+    if (!chain->playsinkpad && _track_needs_playsink (mode, chain->track)
+        && !_link_playsink (self, chain))
+      res = FALSE;
+    if (!chain->encodebinpad && rendering && !_link_encodebin (self, chain))
+      res = FALSE;
+  }
+
+  if (mode & GES_PIPELINE_MODE_PREVIEW)
+    gst_element_sync_state_with_parent (self->priv->playsink);
+  if (rendering) {
+    gst_element_sync_state_with_parent (self->priv->urisink);
+    gst_element_sync_state_with_parent (self->priv->encodebin);
+  }
+
+  _flush_chains (self, FALSE);
+
+  if (!res) {
+    GST_ERROR_OBJECT (self, "Could not link the outputs of mode %d", mode);
+
+    return FALSE;
+  }
+
+  /* The trailing gaps of the tracks depend on whether we render */
+  if (rendering_changed)
+    ges_timeline_commit (self->priv->timeline);
+
+  return gst_element_seek_simple (GST_ELEMENT (self), GST_FORMAT_TIME,
+      GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position);
+}
+
+/**
+ * ges_pipeline_set_mode:
+ * @pipeline: a #GESPipeline
+ * @mode: the #GESPipelineFlags to use
+ *
+ * switches the @pipeline to the specified @mode. The default mode when
+ * creating a #GESPipeline is #GES_PIPELINE_MODE_PREVIEW.
+ *
+ * If the @pipeline is paused or playing, and neither the current nor the
+ * new mode is #GES_PIPELINE_MODE_SMART_RENDER, the outputs are relinked
+ * without changing the state of the @pipeline. The timeline keeps its
+ * current position, unless a render mode gets enabled in which case the
+ * rendering starts from the beginning of the timeline. This is not possible
+ * when switching between previewing and rendering a timeline that uses
+ * proxies, as the sources have to decode other files.
+ *
+ * Note: Otherwise, the @pipeline will be set to #GST_STATE_NULL during this
+ * call due to the internal changes that happen. The caller will therefore
+ * have to set the @pipeline to the requested state after calling this
+ * method.
+ *
+ * Returns: %TRUE if the mode was properly set, else %FALSE.
+ **/
+gboolean
+ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
+{
+  GstState state;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
+
+  GST_DEBUG_OBJECT (pipeline, "current mode : %d, mode : %d",
+      pipeline->priv->mode, mode);
+
+  /* fast-path, nothing to change */
+  if (mode == pipeline->priv->mode)
+    return TRUE;
+
+  GST_OBJECT_LOCK (pipeline);
+  state = GST_STATE (pipeline);
+  GST_OBJECT_UNLOCK (pipeline);
+
+  /* Smart rendering changes the sources themselves when prerolling, and the
+   * running sources keep the decoders of the files they were started with */
+  if (state >= GST_STATE_PAUSED && pipeline->priv->timeline &&
+      !((pipeline->priv->mode | mode) & GES_PIPELINE_MODE_SMART_RENDER) &&
+      (!(mode & GES_PIPELINE_MODE_RENDER) || pipeline->priv->urisink) &&
+      (!IN_RENDERING_MODE (pipeline) == !(mode & GES_PIPELINE_MODE_RENDER) ||
+          !_timeline_has_proxies (pipeline->priv->timeline)))
+    return _set_mode_dynamically (pipeline, mode);
+
+  /* Switch pipeline to NULL since we're changing the configuration */
+  gst_element_set_state (GST_ELEMENT_CAST (pipeline), GST_STATE_NULL);
+
+  if (pipeline->priv->timeline)
+    _configure_tracks_for_mode (pipeline, mode);
+
+  if (!_update_output_bins (pipeline, mode))
+    return FALSE;
 
   /* FIXUPS */
   /* FIXME
@@ -1262,6 +1514,581 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
   return TRUE;
 }
 
+/****************************************************
+ *              Segmented rendering                 *
+ ****************************************************/
+
+typedef enum
+{
+  SEGMENT_PENDING,
+  SEGMENT_PREROLLING,
+  SEGMENT_SEEKING,
+  SEGMENT_RENDERING,
+  SEGMENT_DONE,
+} SegmentState;
+
+typedef struct _SegmentedRender SegmentedRender;
+
+typedef struct
+{
+  SegmentedRender *render;
+  guint index;
+  GstClockTime start;
+  GstClockTime stop;
+  gchar *location;
+
+  SegmentState state;
+  GESPipeline *pipeline;
+  guint bus_watch_id;
+} RenderSegment;
+
+struct _SegmentedRender
+{
+  GTask *task;
+  GESPipelineFlags mode;
+  GstEncodingProfile *profile;
+  gchar *output_uri;
+  gchar *directory;
+
+  GPtrArray *segments;
+  guint max_jobs;
+  guint next;                   /* Index of the next segment to start */
+  guint running;
+  guint done;
+
+  /* Concatenates the segments into @output_uri */
+  GstElement *concat;
+  guint concat_watch_id;
+
+  GSource *progress_source;
+};
+
+static void
+_render_segment_stop (RenderSegment * segment)
+{
+  if (segment->bus_watch_id) {
+    g_source_remove (segment->bus_watch_id);
+    segment->bus_watch_id = 0;
+  }
+
+  if (segment->pipeline) {
+    gst_element_set_state (GST_ELEMENT (segment->pipeline), GST_STATE_NULL);
+    gst_object_unref (segment->pipeline);
+    segment->pipeline = NULL;
+  }
+}
+
+static void
+_render_segment_free (RenderSegment * segment)
+{
+  _render_segment_stop (segment);
+  g_unlink (segment->location);
+  g_free (segment->location);
+  g_slice_free (RenderSegment, segment);
+}
+
+/* Stops everything, the segments files are removed when @render is freed */
+static void
+_segmented_render_stop (SegmentedRender * render)
+{
+  guint i;
+
+  for (i = 0; i < render->segments->len; i++)
+    _render_segment_stop (g_ptr_array_index (render->segments, i));
+
+  if (render->concat_watch_id) {
+    g_source_remove (render->concat_watch_id);
+    render->concat_watch_id = 0;
+  }
+
+  if (render->concat) {
+    gst_element_set_state (render->concat, GST_STATE_NULL);
+    gst_object_unref (render->concat);
+    render->concat = NULL;
+  }
+
+  if (render->progress_source) {
+    g_source_destroy (render->progress_source);
+    g_source_unref (render->progress_source);
+    render->progress_source = NULL;
+  }
+}
+
+static void
+_segmented_render_free (SegmentedRender * render)
+{
+  _segmented_render_stop (render);
+
+  g_ptr_array_unref (render->segments);
+  g_rmdir (render->directory);
+  g_free (render->directory);
+  g_free (render->output_uri);
+  gst_encoding_profile_unref (render->profile);
+  g_slice_free (SegmentedRender, render);
+}
+
+static void
+_segmented_render_return_error (SegmentedRender * render, GError * error)
+{
+  GTask *task = render->task;
+
+  _segmented_render_stop (render);
+  g_task_return_error (task, error);
+  g_object_unref (task);
+}
+
+static void
+_segmented_render_return_message_error (SegmentedRender * render,
+    GstMessage * message)
+{
+  GError *error = NULL;
+  gchar *debug = NULL;
+
+  gst_message_parse_error (message, &error, &debug);
+  GST_ERROR_OBJECT (g_task_get_source_object (render->task),
+      "Segmented rendering failed: %s (%s)", error->message, debug);
+  g_free (debug);
+
+  _segmented_render_return_error (render, error);
+}
+
+static void
+_emit_segment_progress (RenderSegment * segment, GstClockTime position)
+{
+  g_signal_emit (g_task_get_source_object (segment->render->task),
+      ges_pipeline_signals[SEGMENT_PROGRESS], 0, segment->index,
+      MIN (position, segment->stop - segment->start),
+      segment->stop - segment->start);
+}
+
+static gboolean
+_report_progress_cb (SegmentedRender * render)
+{
+  guint i;
+
+  if (g_cancellable_is_cancelled (g_task_get_cancellable (render->task))) {
+    GError *error = NULL;
+
+    g_cancellable_set_error_if_cancelled (g_task_get_cancellable
+        (render->task), &error);
+    _segmented_render_return_error (render, error);
+
+    return G_SOURCE_REMOVE;
+  }
+
+  for (i = 0; i < render->segments->len; i++) {
+    gint64 position;
+    RenderSegment *segment = g_ptr_array_index (render->segments, i);
+
+    if (segment->state == SEGMENT_RENDERING &&
+        gst_element_query_position (GST_ELEMENT (segment->pipeline),
+            GST_FORMAT_TIME, &position) && position >= segment->start)
+      _emit_segment_progress (segment, position - segment->start);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+_concat_pad_added_cb (GstElement * splitmuxsrc, GstPad * pad,
+    GstElement * encodebin)
+{
+  GstPad *sinkpad = gst_element_get_compatible_pad (encodebin, pad, NULL);
+
+  if (!sinkpad || gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_ERROR_OBJECT (encodebin, "Could not concatenate %" GST_PTR_FORMAT,
+        pad);
+
+  if (sinkpad)
+    gst_object_unref (sinkpad);
+}
+
+static gboolean
+_concat_bus_cb (GstBus * bus, GstMessage * message, SegmentedRender * render)
+{
+  GTask *task = render->task;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      GST_INFO_OBJECT (g_task_get_source_object (task), "Rendered %s",
+          render->output_uri);
+      _segmented_render_stop (render);
+      g_task_return_boolean (task, TRUE);
+      g_object_unref (task);
+      break;
+    case GST_MESSAGE_ERROR:
+      _segmented_render_return_message_error (render, message);
+      break;
+    default:
+      break;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+/* Muxes the encoded streams of the segments, one after the other, into the
+ * final file, without reencoding them */
+static void
+_start_concat (SegmentedRender * render)
+{
+  GstBus *bus;
+  gchar *pattern;
+  GError *error = NULL;
+  GstEncodingProfile *profile;
+  GstElement *splitmuxsrc, *encodebin, *sink;
+
+  render->concat = gst_pipeline_new ("ges-segments-concat");
+  splitmuxsrc = gst_element_factory_make ("splitmuxsrc", NULL);
+  encodebin = gst_element_factory_make ("encodebin", NULL);
+  sink = gst_element_make_from_uri (GST_URI_SINK, render->output_uri, NULL,
+      &error);
+  if (!splitmuxsrc || !encodebin || !sink) {
+    if (splitmuxsrc)
+      gst_object_unref (gst_object_ref_sink (splitmuxsrc));
+    if (encodebin)
+      gst_object_unref (gst_object_ref_sink (encodebin));
+    if (sink)
+      gst_object_unref (gst_object_ref_sink (sink));
+
+    if (!error)
+      error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+          "Missing elements to concatenate the rendered segments");
+    _segmented_render_return_error (render, error);
+
+    return;
+  }
+
+  gst_bin_add_many (GST_BIN (render->concat), splitmuxsrc, encodebin, sink,
+      NULL);
+  pattern = g_build_filename (render->directory, "segment-*.mov", NULL);
+  g_object_set (splitmuxsrc, "location", pattern, NULL);
+  g_free (pattern);
+  profile = gst_encoding_profile_copy (render->profile);
+  g_object_set (encodebin, "profile", profile, NULL);
+  gst_encoding_profile_unref (profile);
+  gst_element_link (encodebin, sink);
+  g_signal_connect (splitmuxsrc, "pad-added",
+      G_CALLBACK (_concat_pad_added_cb), encodebin);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (render->concat));
+  render->concat_watch_id = gst_bus_add_watch (bus, (GstBusFunc)
+      _concat_bus_cb, render);
+  gst_object_unref (bus);
+
+  if (gst_element_set_state (render->concat, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE)
+    _segmented_render_return_error (render, g_error_new (GST_CORE_ERROR,
+            GST_CORE_ERROR_STATE_CHANGE,
+            "Could not concatenate the rendered segments"));
+}
+
+static gboolean _start_segments (SegmentedRender * render);
+
+static gboolean
+_segment_bus_cb (GstBus * bus, GstMessage * message, RenderSegment * segment)
+{
+  SegmentedRender *render = segment->render;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ASYNC_DONE:
+      if (GST_MESSAGE_SRC (message) != GST_OBJECT (segment->pipeline))
+        break;
+
+      if (segment->state == SEGMENT_PREROLLING) {
+        segment->state = SEGMENT_SEEKING;
+        if (!gst_element_seek (GST_ELEMENT (segment->pipeline), 1.0,
+                GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+                GST_SEEK_TYPE_SET, segment->start, GST_SEEK_TYPE_SET,
+                segment->stop)) {
+          _segmented_render_return_error (render, g_error_new (GST_CORE_ERROR,
+                  GST_CORE_ERROR_SEEK, "Could not seek to segment %u",
+                  segment->index));
+          break;
+        }
+      } else if (segment->state == SEGMENT_SEEKING) {
+        segment->state = SEGMENT_RENDERING;
+        gst_element_set_state (GST_ELEMENT (segment->pipeline),
+            GST_STATE_PLAYING);
+      }
+      break;
+    case GST_MESSAGE_EOS:
+      GST_DEBUG_OBJECT (segment->pipeline, "Segment %u rendered",
+          segment->index);
+      segment->state = SEGMENT_DONE;
+      _render_segment_stop (segment);
+      _emit_segment_progress (segment, segment->stop - segment->start);
+
+      render->running--;
+      render->done++;
+      if (render->done == render->segments->len)
+        _start_concat (render);
+      else
+        _start_segments (render);
+      break;
+    case GST_MESSAGE_ERROR:
+      _segmented_render_return_message_error (render, message);
+      break;
+    default:
+      break;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+_start_segment (SegmentedRender * render, RenderSegment * segment)
+{
+  GstBus *bus;
+  gchar *uri;
+  gboolean res;
+  GESPipeline *self = g_task_get_source_object (render->task);
+  GstEncodingProfile *profile = gst_encoding_profile_copy (render->profile);
+
+  GST_DEBUG_OBJECT (self, "Rendering segment %u [%" GST_TIME_FORMAT " - %"
+      GST_TIME_FORMAT "]", segment->index, GST_TIME_ARGS (segment->start),
+      GST_TIME_ARGS (segment->stop));
+
+  segment->pipeline = gst_object_ref_sink (ges_pipeline_new ());
+  uri = gst_filename_to_uri (segment->location, NULL);
+  res = ges_pipeline_set_timeline (segment->pipeline,
+      timeline_copy (self->priv->timeline)) &&
+      ges_pipeline_set_render_settings (segment->pipeline, uri, profile) &&
+      ges_pipeline_set_mode (segment->pipeline, render->mode);
+  gst_encoding_profile_unref (profile);
+  g_free (uri);
+
+  if (!res)
+    return FALSE;
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (segment->pipeline));
+  segment->bus_watch_id = gst_bus_add_watch (bus, (GstBusFunc)
+      _segment_bus_cb, segment);
+  gst_object_unref (bus);
+
+  segment->state = SEGMENT_PREROLLING;
+
+  return gst_element_set_state (GST_ELEMENT (segment->pipeline),
+      GST_STATE_PAUSED) != GST_STATE_CHANGE_FAILURE;
+}
+
+/* The segments are read back with splitmuxsrc, which only demuxes the
+ * QuickTime family of formats */
+static gboolean
+_profile_supports_segments (GstEncodingProfile * profile)
+{
+  gboolean ret;
+  GstCaps *format, *caps;
+
+  if (!GST_IS_ENCODING_CONTAINER_PROFILE (profile))
+    return FALSE;
+
+  format = gst_encoding_profile_get_format (profile);
+  if (!format)
+    return FALSE;
+
+  caps = gst_caps_new_empty_simple ("video/quicktime");
+  ret = gst_caps_can_intersect (format, caps);
+  gst_caps_unref (caps);
+  gst_caps_unref (format);
+
+  return ret;
+}
+
+static gboolean
+_start_segments (SegmentedRender * render)
+{
+  while (render->running < render->max_jobs &&
+      render->next < render->segments->len) {
+    RenderSegment *segment = g_ptr_array_index (render->segments,
+        render->next++);
+
+    render->running++;
+    if (!_start_segment (render, segment)) {
+      _segmented_render_return_error (render, g_error_new (GST_CORE_ERROR,
+              GST_CORE_ERROR_STATE_CHANGE, "Could not render segment %u",
+              segment->index));
+
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+ * ges_pipeline_render_segmented_async:
+ * @pipeline: a #GESPipeline
+ * @n_segments: the number of segments to split the timeline into, or 0 to
+ * use the number of processors
+ * @max_jobs: the maximum number of segments rendered at the same time, or 0
+ * to use the number of processors
+ * @cancellable: (allow-none): optional %GCancellable object, %NULL to ignore
+ * @callback: a #GAsyncReadyCallback to call when the rendering is done
+ * @user_data: the user data to pass to @callback
+ *
+ * Renders the timeline of @pipeline with the settings passed to
+ * ges_pipeline_set_render_settings(), splitting it into @n_segments
+ * segments rendered in parallel.
+ *
+ * Each segment is rendered by its own #GESPipeline over a copy of the
+ * timeline, so the segments start with a keyframe. Their boundaries are
+ * aligned on the frames of the video track. The encoded segments are then
+ * concatenated into the output URI without being reencoded, which requires
+ * the splitmuxsrc element. The container of the render profile must
+ * therefore be MP4 or QuickTime, other profiles are rejected. The progress
+ * of each segment is reported through the #GESPipeline::segment-progress
+ * signal.
+ *
+ * @pipeline itself is not used to render, and the timeline must not be
+ * modified until @callback is called. Audio encoders adding padding at the
+ * start or the end of streams might introduce tiny gaps at the segment
+ * boundaries.
+ *
+ * Since: 1.16
+ */
+void
+ges_pipeline_render_segmented_async (GESPipeline * pipeline, guint n_segments,
+    guint max_jobs, GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  guint i;
+  GList *tmp;
+  GTask *task;
+  SegmentedRender *render;
+  GstClockTime duration;
+  guint64 n_frames;
+  gint fps_n = GST_SECOND, fps_d = 1;
+
+  g_return_if_fail (GES_IS_PIPELINE (pipeline));
+  g_return_if_fail (pipeline->priv->timeline);
+
+  task = g_task_new (pipeline, cancellable, callback, user_data);
+  if (!pipeline->priv->urisink || !pipeline->priv->profile) {
+    g_task_return_new_error (task, GST_RESOURCE_ERROR,
+        GST_RESOURCE_ERROR_SETTINGS, "Render settings not set");
+    g_object_unref (task);
+
+    return;
+  }
+
+  if (!_profile_supports_segments (pipeline->priv->profile)) {
+    g_task_return_new_error (task, GST_RESOURCE_ERROR,
+        GST_RESOURCE_ERROR_SETTINGS, "Only MP4 and QuickTime profiles can "
+        "be rendered in segments");
+    g_object_unref (task);
+
+    return;
+  }
+
+  duration = ges_timeline_get_duration (pipeline->priv->timeline);
+  if (!duration) {
+    g_task_return_new_error (task, GST_RESOURCE_ERROR,
+        GST_RESOURCE_ERROR_SETTINGS, "Nothing to render");
+    g_object_unref (task);
+
+    return;
+  }
+
+  render = g_slice_new0 (SegmentedRender);
+  render->task = task;
+  render->mode = pipeline->priv->mode & (GES_PIPELINE_MODE_RENDER |
+      GES_PIPELINE_MODE_SMART_RENDER);
+  if (!render->mode)
+    render->mode = GES_PIPELINE_MODE_RENDER;
+  render->profile = gst_encoding_profile_ref (pipeline->priv->profile);
+  render->output_uri =
+      gst_uri_handler_get_uri (GST_URI_HANDLER (pipeline->priv->urisink));
+  render->max_jobs = max_jobs ? max_jobs : g_get_num_processors ();
+  render->segments =
+      g_ptr_array_new_with_free_func ((GDestroyNotify) _render_segment_free);
+  g_task_set_task_data (task, render, (GDestroyNotify) _segmented_render_free);
+
+  render->directory = g_dir_make_tmp ("ges-segments-XXXXXX", NULL);
+  if (!render->directory) {
+    g_task_return_new_error (task, GST_RESOURCE_ERROR,
+        GST_RESOURCE_ERROR_OPEN_WRITE, "Could not create a directory for "
+        "the segments");
+    g_object_unref (task);
+
+    return;
+  }
+
+  /* Cut between frames so that none is duplicated or dropped */
+  for (tmp = pipeline->priv->timeline->tracks; tmp; tmp = tmp->next) {
+    GstCaps *caps;
+    gint n, d;
+
+    if (!GES_IS_VIDEO_TRACK (tmp->data))
+      continue;
+
+    g_object_get (tmp->data, "restriction-caps", &caps, NULL);
+    if (caps && gst_caps_get_size (caps) &&
+        gst_structure_get_fraction (gst_caps_get_structure (caps, 0),
+            "framerate", &n, &d) && n > 0 && d > 0) {
+      fps_n = n;
+      fps_d = d;
+    }
+    if (caps)
+      gst_caps_unref (caps);
+  }
+
+  n_frames = gst_util_uint64_scale_ceil (duration, fps_n, GST_SECOND * fps_d);
+  if (!n_segments)
+    n_segments = g_get_num_processors ();
+  n_segments = MIN (n_segments, n_frames);
+
+  for (i = 0; i < n_segments; i++) {
+    gchar *filename;
+    RenderSegment *segment = g_slice_new0 (RenderSegment);
+
+    segment->render = render;
+    segment->index = i;
+    segment->start = gst_util_uint64_scale (n_frames * i / n_segments,
+        GST_SECOND * fps_d, fps_n);
+    segment->stop = i + 1 == n_segments ? duration :
+        gst_util_uint64_scale (n_frames * (i + 1) / n_segments,
+        GST_SECOND * fps_d, fps_n);
+
+    /* splitmuxsrc sorts the segments by name */
+    filename = g_strdup_printf ("segment-%05u.mov", i);
+    segment->location = g_build_filename (render->directory, filename, NULL);
+    g_free (filename);
+
+    g_ptr_array_add (render->segments, segment);
+  }
+
+  GST_INFO_OBJECT (pipeline, "Rendering %" GST_TIME_FORMAT " in %u segments,"
+      " %u at a time", GST_TIME_ARGS (duration), n_segments, render->max_jobs);
+
+  render->progress_source = g_timeout_source_new (500);
+  g_source_set_callback (render->progress_source,
+      (GSourceFunc) _report_progress_cb, render, NULL);
+  g_source_attach (render->progress_source, g_task_get_context (task));
+
+  _start_segments (render);
+}
+
+/**
+ * ges_pipeline_render_segmented_finish:
+ * @pipeline: a #GESPipeline
+ * @result: the #GAsyncResult passed to the callback
+ * @error: an error to be set in case something wrong happens or %NULL
+ *
+ * Finishes a rendering started with ges_pipeline_render_segmented_async().
+ *
+ * Returns: %TRUE if the timeline was rendered, %FALSE otherwise.
+ *
+ * Since: 1.16
+ */
+gboolean
+ges_pipeline_render_segmented_finish (GESPipeline * pipeline,
+    GAsyncResult * result, GError ** error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, pipeline), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /**
  * ges_pipeline_get_thumbnail:
  * @self: a #GESPipeline in %GST_STATE_PLAYING or %GST_STATE_PAUSED
@@ -22,6 +22,7 @@
 #define _GES_PIPELINE
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <ges/ges.h>
 #include <gst/pbutils/encoding-profile.h>
 
@@ -96,6 +97,15 @@ gboolean ges_pipeline_set_mode (GESPipeline *pipeline,
 GES_API
 GESPipelineFlags ges_pipeline_get_mode (GESPipeline *pipeline);
 
+GES_API void
+ges_pipeline_render_segmented_async (GESPipeline *pipeline,
+    guint n_segments, guint max_jobs, GCancellable *cancellable,
+    GAsyncReadyCallback callback, gpointer user_data);
+
+GES_API gboolean
+ges_pipeline_render_segmented_finish (GESPipeline *pipeline,
+    GAsyncResult *result, GError **error);
+
 GES_API GstSample *
 ges_pipeline_get_thumbnail(GESPipeline *self, GstCaps *caps);
 
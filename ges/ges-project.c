@@ -68,8 +68,24 @@ struct _GESProjectPrivate
   gchar *uri;
 
   GList *encoding_profiles;
+
+  gboolean lazy_loading;
+  /* Assets created from their serialized infos, to be checked once the
+   * project is loaded */
+  GList *lazy_assets;
 };
 
+/* State of a ges_project_create_assets_async() call */
+typedef struct
+{
+  GESProject *project;
+  GTask *task;
+
+  guint n_assets;
+  guint n_loaded;
+  guint n_errors;
+} CreateAssetsData;
+
 typedef struct EmitLoadedInIdle
 {
   GESProject *project;
@@ -84,6 +100,8 @@ enum
   ASSET_REMOVED_SIGNAL,
   MISSING_URI_SIGNAL,
   ASSET_LOADING_SIGNAL,
+  ASSETS_LOADING_PROGRESS_SIGNAL,
+  ASSET_MISMATCH_SIGNAL,
   LAST_SIGNAL
 };
 
@@ -95,6 +113,7 @@ enum
 {
   PROP_0,
   PROP_URI,
+  PROP_LAZY_LOADING,
   PROP_LAST,
 };
 
@@ -364,6 +383,8 @@ _dispose (GObject * object)
     g_hash_table_unref (priv->loaded_with_error);
   if (priv->formatter_asset)
     gst_object_unref (priv->formatter_asset);
+  g_list_free_full (priv->lazy_assets, gst_object_unref);
+  priv->lazy_assets = NULL;
 
   for (tmp = priv->formatters; tmp; tmp = tmp->next)
     ges_project_remove_formatter (GES_PROJECT (object), tmp->data);;
@@ -392,6 +413,9 @@ _get_property (GESProject * project, guint property_id,
     case PROP_URI:
       g_value_set_string (value, priv->uri);
       break;
+    case PROP_LAZY_LOADING:
+      g_value_set_boolean (value, priv->lazy_loading);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (project, property_id, pspec);
   }
@@ -405,6 +429,9 @@ _set_property (GESProject * project, guint property_id,
     case PROP_URI:
       project->priv->uri = g_value_dup_string (value);
       break;
+    case PROP_LAZY_LOADING:
+      project->priv->lazy_loading = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (project, property_id, pspec);
   }
@@ -432,6 +459,22 @@ ges_project_class_init (GESProjectClass * klass)
   _properties[PROP_URI] = g_param_spec_string ("uri", "URI",
       "uri of the project", NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
 
+  /**
+   * GESProject:lazy-loading:
+   *
+   * Whether to trust the stream information serialized in the project file
+   * when loading it. The clips are then created right away, without waiting
+   * for the media files to be discovered, and the files are checked in the
+   * background once the project is loaded. Files that do not match their
+   * serialized information are reported through the
+   * #GESProject::asset-mismatch signal.
+   *
+   * Since: 1.16
+   */
+  _properties[PROP_LAZY_LOADING] = g_param_spec_boolean ("lazy-loading",
+      "Lazy loading", "Trust the serialized stream information when loading",
+      FALSE, G_PARAM_READWRITE);
+
   g_object_class_install_properties (object_class, PROP_LAST, _properties);
 
   /**
@@ -528,6 +571,41 @@ ges_project_class_init (GESProjectClass * klass)
       NULL, NULL, g_cclosure_marshal_generic,
       G_TYPE_NONE, 3, G_TYPE_ERROR, G_TYPE_STRING, G_TYPE_GTYPE);
 
+  /**
+   * GESProject::assets-loading-progress:
+   * @project: the #GESProject
+   * @n_loaded: The number of assets done loading
+   * @n_assets: The number of assets to load
+   *
+   * Reports the progress of a ges_project_create_assets_async() call, each
+   * time one of its assets is done loading, with or without error.
+   *
+   * Since: 1.16
+   */
+  _signals[ASSETS_LOADING_PROGRESS_SIGNAL] =
+      g_signal_new ("assets-loading-progress", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_UINT);
+
+  /**
+   * GESProject::asset-mismatch:
+   * @project: the #GESProject
+   * @asset: The #GESAsset that does not match its media file
+   * @error: The #GError describing the mismatch
+   *
+   * Informs you that the media file of an asset created from the stream
+   * information serialized in the project file, when loading it with
+   * #GESProject:lazy-loading, could not be discovered or does not match
+   * that information. The clips that were created from @asset might not
+   * play properly.
+   *
+   * Since: 1.16
+   */
+  _signals[ASSET_MISMATCH_SIGNAL] =
+      g_signal_new ("asset-mismatch", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 2, GES_TYPE_ASSET, G_TYPE_ERROR);
+
   object_class->dispose = _dispose;
   object_class->finalize = _finalize;
 
@@ -640,6 +718,90 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, GESProject * project)
     gst_object_unref (asset);
 }
 
+static void
+_create_assets_data_asset_done (CreateAssetsData * data, gboolean error)
+{
+  data->n_loaded++;
+  if (error)
+    data->n_errors++;
+
+  g_signal_emit (data->project, _signals[ASSETS_LOADING_PROGRESS_SIGNAL], 0,
+      data->n_loaded, data->n_assets);
+
+  if (data->n_loaded < data->n_assets)
+    return;
+
+  if (data->n_errors)
+    g_task_return_new_error (data->task, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "%u of the %u assets could not be loaded", data->n_errors,
+        data->n_assets);
+  else
+    g_task_return_boolean (data->task, TRUE);
+
+  g_object_unref (data->task);
+  g_slice_free (CreateAssetsData, data);
+}
+
+static void
+new_asset_in_bulk_cb (GESAsset * source, GAsyncResult * res,
+    CreateAssetsData * data)
+{
+  GError *error = NULL;
+  gchar *possible_id = NULL;
+  GESProject *project = data->project;
+  GESAsset *asset = ges_asset_request_finish (res, &error);
+
+  if (error) {
+    possible_id = ges_project_try_updating_id (project, source, error);
+    g_error_free (error);
+
+    if (possible_id == NULL) {
+      _create_assets_data_asset_done (data, TRUE);
+      return;
+    }
+
+    /* Still part of the same bulk request */
+    ges_asset_request_async (ges_asset_get_extractable_type (source),
+        possible_id, g_task_get_cancellable (data->task),
+        (GAsyncReadyCallback) new_asset_in_bulk_cb, data);
+    ges_project_add_loading_asset (project,
+        ges_asset_get_extractable_type (source), possible_id);
+
+    g_free (possible_id);
+    return;
+  }
+
+  ges_asset_set_proxy (NULL, asset);
+  ges_project_add_asset (project, asset);
+  gst_object_unref (asset);
+
+  _create_assets_data_asset_done (data, FALSE);
+}
+
+static void
+_lazy_asset_checked_cb (GESUriClipAsset * asset, GAsyncResult * res,
+    GESProject * project)
+{
+  GError *error = NULL;
+
+  if (!ges_uri_clip_asset_check_info_finish (asset, res, &error)) {
+    GST_INFO_OBJECT (project, "Asset %s mismatch: %s",
+        ges_asset_get_id (GES_ASSET (asset)), error->message);
+    g_signal_emit (project, _signals[ASSET_MISMATCH_SIGNAL], 0, asset, error);
+    g_error_free (error);
+  }
+
+  gst_object_unref (project);
+}
+
+void
+ges_project_add_lazy_asset (GESProject * project, GESAsset * asset)
+{
+  ges_project_add_asset (project, asset);
+  project->priv->lazy_assets = g_list_prepend (project->priv->lazy_assets,
+      gst_object_ref (asset));
+}
+
 /**
  * ges_project_set_loaded:
  * @project: The #GESProject from which to emit the "project-loaded" signal
@@ -652,6 +814,8 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, GESProject * project)
 gboolean
 ges_project_set_loaded (GESProject * project, GESFormatter * formatter)
 {
+  GList *tmp;
+
   GST_INFO_OBJECT (project, "Emit project loaded");
   if (GST_STATE (formatter->timeline) < GST_STATE_PAUSED) {
     timeline_fill_gaps (formatter->timeline);
@@ -661,6 +825,14 @@ ges_project_set_loaded (GESProject * project, GESFormatter * formatter)
 
   g_signal_emit (project, _signals[LOADED_SIGNAL], 0, formatter->timeline);
 
+  /* Now that the project can be used, check the lazily created assets */
+  for (tmp = project->priv->lazy_assets; tmp; tmp = tmp->next)
+    ges_uri_clip_asset_check_info_async (tmp->data,
+        (GAsyncReadyCallback) _lazy_asset_checked_cb,
+        gst_object_ref (project));
+  g_list_free_full (project->priv->lazy_assets, gst_object_unref);
+  project->priv->lazy_assets = NULL;
+
   /* We are now done with that formatter */
   ges_project_remove_formatter (project, formatter);
   return TRUE;
@@ -722,6 +894,120 @@ ges_project_create_asset (GESProject * project, const gchar * id,
   return TRUE;
 }
 
+/**
+ * ges_project_create_assets_async:
+ * @project: A #GESProject
+ * @ids: (array length=n_assets) (element-type utf8) (nullable): The ids of
+ * the assets to create and add to @project, %NULL ids are replaced by the
+ * name of their extractable type
+ * @extractable_types: (array length=n_assets): The #GType of the assets to
+ * create
+ * @n_assets: The number of assets to create
+ * @cancellable: (allow-none): optional %GCancellable object, %NULL to ignore.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when all the
+ * assets are done loading
+ * @user_data: The user data to pass when @callback is called
+ *
+ * Creates and adds a set of #GESAsset to @project, all at once. Assets
+ * requested several times or that are already part of @project are only
+ * created once, the ones already loaded in the asset cache are added to
+ * @project right away, and the others are all loaded in parallel.
+ *
+ * The "asset-added" and "error-loading-asset" signals are emitted for each
+ * asset as with ges_project_create_asset(), and the overall progress is
+ * reported through the "assets-loading-progress" signal. @callback is
+ * called once, when all the assets are done loading, and should call
+ * ges_project_create_assets_finish().
+ *
+ * Since: 1.16
+ */
+void
+ges_project_create_assets_async (GESProject * project, const gchar ** ids,
+    const GType * extractable_types, guint n_assets,
+    GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  guint i;
+  GHashTable *requested;
+  CreateAssetsData *data;
+
+  g_return_if_fail (GES_IS_PROJECT (project));
+  g_return_if_fail (n_assets == 0 || extractable_types);
+
+  data = g_slice_new0 (CreateAssetsData);
+  data->project = project;
+  data->task = g_task_new (project, cancellable, callback, user_data);
+
+  requested = g_hash_table_new (g_str_hash, g_str_equal);
+  for (i = 0; i < n_assets; i++) {
+    GESAsset *asset;
+    GType extractable_type = extractable_types[i];
+    const gchar *id = ids ? ids[i] : NULL;
+
+    if (!g_type_is_a (extractable_type, GES_TYPE_EXTRACTABLE)) {
+      g_critical ("%s: %s is not a GESExtractable type", G_STRFUNC,
+          g_type_name (extractable_type));
+      continue;
+    }
+
+    if (id == NULL)
+      id = g_type_name (extractable_type);
+
+    if (g_hash_table_contains (requested, id) ||
+        g_hash_table_lookup (project->priv->assets, id) ||
+        g_hash_table_lookup (project->priv->loading_assets, id) ||
+        g_hash_table_lookup (project->priv->loaded_with_error, id))
+      continue;
+    g_hash_table_add (requested, (gpointer) id);
+
+    /* Already loaded assets do not need a round trip through the main
+     * context */
+    if (ges_asset_cache_lookup (extractable_type, id) &&
+        (asset = ges_asset_request (extractable_type, id, NULL))) {
+      ges_asset_set_proxy (NULL, asset);
+      ges_project_add_asset (project, asset);
+      gst_object_unref (asset);
+
+      continue;
+    }
+
+    data->n_assets++;
+    ges_asset_request_async (extractable_type, id, cancellable,
+        (GAsyncReadyCallback) new_asset_in_bulk_cb, data);
+    ges_project_add_loading_asset (project, extractable_type, id);
+  }
+  g_hash_table_unref (requested);
+
+  GST_DEBUG_OBJECT (project, "Loading %u assets", data->n_assets);
+  if (data->n_assets == 0) {
+    g_task_return_boolean (data->task, TRUE);
+    g_object_unref (data->task);
+    g_slice_free (CreateAssetsData, data);
+  }
+}
+
+/**
+ * ges_project_create_assets_finish:
+ * @project: A #GESProject
+ * @result: The #GAsyncResult passed to the callback of
+ * ges_project_create_assets_async()
+ * @error: (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes a ges_project_create_assets_async() call.
+ *
+ * Returns: %TRUE if all the assets could be loaded, %FALSE otherwise
+ *
+ * Since: 1.16
+ */
+gboolean
+ges_project_create_assets_finish (GESProject * project, GAsyncResult * result,
+    GError ** error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, project), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /**
  * ges_project_create_asset_sync:
  * @project: A #GESProject
@@ -1135,6 +1421,47 @@ ges_project_list_encoding_profiles (GESProject * project)
   return project->priv->encoding_profiles;
 }
 
+/**
+ * ges_project_set_lazy_loading:
+ * @project: A #GESProject
+ * @lazy_loading: Whether to trust the serialized stream information
+ *
+ * Sets #GESProject:lazy-loading.
+ *
+ * Since: 1.16
+ */
+void
+ges_project_set_lazy_loading (GESProject * project, gboolean lazy_loading)
+{
+  g_return_if_fail (GES_IS_PROJECT (project));
+
+  if (project->priv->lazy_loading == lazy_loading)
+    return;
+
+  project->priv->lazy_loading = lazy_loading;
+  g_object_notify_by_pspec (G_OBJECT (project),
+      _properties[PROP_LAZY_LOADING]);
+}
+
+/**
+ * ges_project_get_lazy_loading:
+ * @project: A #GESProject
+ *
+ * Gets #GESProject:lazy-loading.
+ *
+ * Returns: Whether @project trusts the serialized stream information when
+ * being loaded
+ *
+ * Since: 1.16
+ */
+gboolean
+ges_project_get_lazy_loading (GESProject * project)
+{
+  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+
+  return project->priv->lazy_loading;
+}
+
 /**
  * ges_project_get_loading_assets:
  * @project: A #GESProject
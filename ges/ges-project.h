@@ -108,6 +108,19 @@ gboolean ges_project_create_asset  (GESProject * project,
                                     const gchar *id,
                                     GType extractable_type);
 
+GES_API
+void ges_project_create_assets_async            (GESProject * project,
+                                                 const gchar ** ids,
+                                                 const GType * extractable_types,
+                                                 guint n_assets,
+                                                 GCancellable * cancellable,
+                                                 GAsyncReadyCallback callback,
+                                                 gpointer user_data);
+GES_API
+gboolean ges_project_create_assets_finish       (GESProject * project,
+                                                 GAsyncResult * result,
+                                                 GError ** error);
+
 GES_API
 GESAsset * ges_project_create_asset_sync        (GESProject * project,
                                                  const gchar * id,
@@ -116,6 +129,12 @@ GESAsset * ges_project_create_asset_sync        (GESProject * project,
 GES_API
 GList * ges_project_get_loading_assets          (GESProject * project);
 
+GES_API
+void ges_project_set_lazy_loading               (GESProject * project,
+                                                 gboolean lazy_loading);
+GES_API
+gboolean ges_project_get_lazy_loading           (GESProject * project);
+
 GES_API
 gboolean ges_project_add_encoding_profile       (GESProject *project,
                                                  GstEncodingProfile *profile);
@@ -0,0 +1,563 @@
+/* GStreamer Editing Services
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gesproxygenerator
+ * @title: GESProxyGenerator
+ * @short_description: Generates lightweight proxies of media files
+ *
+ * A #GESProxyGenerator transcodes the media files of #GESUriClipAsset-s to
+ * low resolution, intra-only versions that are much cheaper to decode and
+ * to seek in. Every frame of a proxy is a keyframe and keeps the timestamp
+ * of the original frame, so proxies can be used in place of the original
+ * files frame accurately.
+ *
+ * Once generated, a proxy is set as the default proxy of its asset with
+ * ges_asset_set_proxy(). A #GESPipeline in #GES_PIPELINE_MODE_PREVIEW then
+ * decodes the proxies, while the original files are used when rendering.
+ *
+ * The transcodings are run by a pool of #GESProxyGenerator:max-jobs
+ * threads. The proxies are written to #GESProxyGenerator:output-directory
+ * and are reused as long as they are more recent than their original file.
+ *
+ * Since: 1.16
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <glib/gstdio.h>
+
+#include "ges-internal.h"
+#include "ges-proxy-generator.h"
+
+#define DEFAULT_HEIGHT 360
+#define DEFAULT_MAX_JOBS 2
+
+struct _GESProxyGeneratorPrivate
+{
+  gchar *output_directory;
+  guint height;
+
+  GThreadPool *pool;
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (GESProxyGenerator, ges_proxy_generator,
+    G_TYPE_OBJECT);
+
+enum
+{
+  PROP_0,
+  PROP_OUTPUT_DIRECTORY,
+  PROP_HEIGHT,
+  PROP_MAX_JOBS,
+  PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
+typedef struct
+{
+  GESUriClipAsset *asset;
+  GstEncodingProfile *profile;
+  gchar *location;              /* Where the proxy is written */
+  gchar *uri;                   /* The URI of the proxy */
+  GError *error;
+} ProxyJob;
+
+static void
+_proxy_job_free (ProxyJob * job)
+{
+  gst_object_unref (job->asset);
+  if (job->profile)
+    gst_encoding_profile_unref (job->profile);
+  g_free (job->location);
+  g_free (job->uri);
+  g_clear_error (&job->error);
+  g_slice_free (ProxyJob, job);
+}
+
+static GstEncodingProfile *
+_create_profile (GESProxyGenerator * self, GESUriClipAsset * asset)
+{
+  GList *streams;
+  GstCaps *caps, *restriction = NULL;
+  GstEncodingContainerProfile *container;
+  GstDiscovererInfo *info = ges_uri_clip_asset_get_info (asset);
+
+  caps = gst_caps_new_empty_simple ("video/x-matroska");
+  container = gst_encoding_container_profile_new ("ges-proxy", NULL, caps,
+      NULL);
+  gst_caps_unref (caps);
+
+  streams = gst_discoverer_info_get_video_streams (info);
+  if (streams) {
+    GstEncodingVideoProfile *profile;
+    GstDiscovererVideoInfo *vinfo = streams->data;
+    guint width = gst_discoverer_video_info_get_width (vinfo);
+    guint height = gst_discoverer_video_info_get_height (vinfo);
+
+    /* Only scale down, keeping the aspect ratio */
+    if (width && height > self->priv->height) {
+      restriction = gst_caps_new_simple ("video/x-raw",
+          "width", G_TYPE_INT, GST_ROUND_UP_2 ((gint)
+              gst_util_uint64_scale_int (width, self->priv->height, height)),
+          "height", G_TYPE_INT, self->priv->height,
+          "pixel-aspect-ratio", GST_TYPE_FRACTION,
+          gst_discoverer_video_info_get_par_num (vinfo),
+          gst_discoverer_video_info_get_par_denom (vinfo), NULL);
+    }
+
+    /* JPEG only has intra frames */
+    caps = gst_caps_new_empty_simple ("image/jpeg");
+    profile = gst_encoding_video_profile_new (caps, NULL, restriction, 0);
+    /* Do not let encodebin add a videorate, the frames have to keep their
+     * original timestamps */
+    gst_encoding_video_profile_set_variableframerate (profile, TRUE);
+    gst_encoding_container_profile_add_profile (container,
+        (GstEncodingProfile *) profile);
+    gst_caps_unref (caps);
+    if (restriction)
+      gst_caps_unref (restriction);
+  }
+  gst_discoverer_stream_info_list_free (streams);
+
+  streams = gst_discoverer_info_get_audio_streams (info);
+  if (streams) {
+    caps = gst_caps_new_empty_simple ("audio/x-vorbis");
+    gst_encoding_container_profile_add_profile (container,
+        (GstEncodingProfile *) gst_encoding_audio_profile_new (caps, NULL,
+            NULL, 0));
+    gst_caps_unref (caps);
+  }
+  gst_discoverer_stream_info_list_free (streams);
+
+  return (GstEncodingProfile *) container;
+}
+
+static gboolean
+_proxy_is_up_to_date (const gchar * uri, const gchar * location)
+{
+  gchar *filename;
+  GStatBuf proxy_stat, stat;
+  gboolean ret = TRUE;
+
+  if (g_stat (location, &proxy_stat) != 0)
+    return FALSE;
+
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  if (filename && g_stat (filename, &stat) == 0)
+    ret = proxy_stat.st_mtime >= stat.st_mtime;
+  g_free (filename);
+
+  return ret;
+}
+
+static void
+_proxy_loaded_cb (GESAsset * source, GAsyncResult * res, GTask * task)
+{
+  GError *error = NULL;
+  ProxyJob *job = g_task_get_task_data (task);
+  GESAsset *proxy = ges_asset_request_finish (res, &error);
+
+  if (!proxy) {
+    g_task_return_error (task, error);
+  } else if (ges_asset_get_proxy_target (proxy) != GES_ASSET (job->asset) &&
+      !ges_asset_set_proxy (GES_ASSET (job->asset), proxy)) {
+    g_task_return_new_error (task, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not use %s as a proxy of %s", job->uri,
+        ges_asset_get_id (GES_ASSET (job->asset)));
+    gst_object_unref (proxy);
+  } else {
+    g_task_return_pointer (task, proxy, gst_object_unref);
+  }
+
+  g_object_unref (task);
+}
+
+static void
+_load_proxy (GTask * task)
+{
+  ProxyJob *job = g_task_get_task_data (task);
+
+  ges_asset_request_async (GES_TYPE_URI_CLIP, job->uri,
+      g_task_get_cancellable (task), (GAsyncReadyCallback) _proxy_loaded_cb,
+      task);
+}
+
+static gboolean
+_transcoded_cb (GTask * task)
+{
+  ProxyJob *job = g_task_get_task_data (task);
+
+  if (job->error) {
+    g_task_return_error (task, job->error);
+    job->error = NULL;
+    g_object_unref (task);
+  } else {
+    _load_proxy (task);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+_decoded_pad_added_cb (GstElement * decodebin, GstPad * pad,
+    GstElement * encodebin)
+{
+  GstPad *sinkpad = gst_element_get_compatible_pad (encodebin, pad, NULL);
+
+  if (!sinkpad || gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_ERROR_OBJECT (encodebin, "Could not encode %" GST_PTR_FORMAT, pad);
+
+  if (sinkpad)
+    gst_object_unref (sinkpad);
+}
+
+static GstElement *
+_add_element (GstElement * pipeline, const gchar * factory)
+{
+  GstElement *element = gst_element_factory_make (factory, NULL);
+
+  if (element)
+    gst_bin_add (GST_BIN (pipeline), element);
+
+  return element;
+}
+
+/* Runs in the worker threads */
+static void
+_transcode (GTask * task, GESProxyGenerator * self)
+{
+  GstBus *bus;
+  GstCaps *caps;
+  gchar *tmp_location;
+  gboolean done = FALSE;
+  GstElement *pipeline, *decodebin, *encodebin, *sink;
+  ProxyJob *job = g_task_get_task_data (task);
+  GCancellable *cancellable = g_task_get_cancellable (task);
+  const gchar *uri = ges_asset_get_id (GES_ASSET (job->asset));
+
+  GST_INFO_OBJECT (self, "Generating proxy of %s in %s", uri, job->location);
+
+  /* Do not leave half written proxies around if we fail */
+  tmp_location = g_strdup_printf ("%s.part", job->location);
+
+  pipeline = gst_pipeline_new ("ges-proxy-generator");
+  decodebin = _add_element (pipeline, "uridecodebin");
+  encodebin = _add_element (pipeline, "encodebin");
+  sink = _add_element (pipeline, "filesink");
+  if (!decodebin || !encodebin || !sink) {
+    job->error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Missing elements to generate the proxy of %s", uri);
+    goto done;
+  }
+
+  caps = gst_caps_from_string ("video/x-raw(ANY);audio/x-raw(ANY)");
+  g_object_set (decodebin, "uri", uri, "caps", caps, "expose-all-streams",
+      FALSE, NULL);
+  gst_caps_unref (caps);
+  g_object_set (encodebin, "profile", job->profile, NULL);
+  g_object_set (sink, "location", tmp_location, NULL);
+  gst_element_link (encodebin, sink);
+  g_signal_connect (decodebin, "pad-added",
+      G_CALLBACK (_decoded_pad_added_cb), encodebin);
+
+  if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    job->error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Could not start generating the proxy of %s", uri);
+    goto done;
+  }
+
+  bus = gst_element_get_bus (pipeline);
+  while (!done) {
+    GstMessage *message;
+
+    if (g_cancellable_set_error_if_cancelled (cancellable, &job->error))
+      break;
+
+    message = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    if (!message)
+      continue;
+
+    if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+      gst_message_parse_error (message, &job->error, NULL);
+    gst_message_unref (message);
+    done = TRUE;
+  }
+  gst_object_unref (bus);
+
+done:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  if (!job->error && g_rename (tmp_location, job->location) != 0) {
+    gint errsv = errno;
+
+    job->error = g_error_new (G_FILE_ERROR, g_file_error_from_errno (errsv),
+        "Could not write %s: %s", job->location, g_strerror (errsv));
+  }
+
+  if (job->error) {
+    GST_WARNING_OBJECT (self, "Could not generate the proxy of %s: %s", uri,
+        job->error->message);
+    g_unlink (tmp_location);
+  }
+  g_free (tmp_location);
+
+  g_main_context_invoke (g_task_get_context (task),
+      (GSourceFunc) _transcoded_cb, task);
+}
+
+static gchar *
+_ensure_output_directory (GESProxyGenerator * self, GError ** error)
+{
+  gchar *directory;
+
+  if (self->priv->output_directory)
+    directory = g_strdup (self->priv->output_directory);
+  else
+    directory = g_build_filename (g_get_user_cache_dir (), "gstreamer-1.0",
+        "ges", "proxies", NULL);
+
+  if (g_mkdir_with_parents (directory, 0755) != 0) {
+    gint errsv = errno;
+
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+        "Could not create %s: %s", directory, g_strerror (errsv));
+    g_free (directory);
+
+    return NULL;
+  }
+
+  return directory;
+}
+
+static void
+ges_proxy_generator_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESProxyGeneratorPrivate *priv = GES_PROXY_GENERATOR (object)->priv;
+
+  switch (property_id) {
+    case PROP_OUTPUT_DIRECTORY:
+      g_value_set_string (value, priv->output_directory);
+      break;
+    case PROP_HEIGHT:
+      g_value_set_uint (value, priv->height);
+      break;
+    case PROP_MAX_JOBS:
+      g_value_set_uint (value, g_thread_pool_get_max_threads (priv->pool));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_proxy_generator_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESProxyGeneratorPrivate *priv = GES_PROXY_GENERATOR (object)->priv;
+
+  switch (property_id) {
+    case PROP_OUTPUT_DIRECTORY:
+      g_free (priv->output_directory);
+      priv->output_directory = g_value_dup_string (value);
+      break;
+    case PROP_HEIGHT:
+      priv->height = g_value_get_uint (value);
+      break;
+    case PROP_MAX_JOBS:
+      g_thread_pool_set_max_threads (priv->pool, g_value_get_uint (value),
+          NULL);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_proxy_generator_finalize (GObject * object)
+{
+  GESProxyGeneratorPrivate *priv = GES_PROXY_GENERATOR (object)->priv;
+
+  /* The running jobs keep a reference on us, so there are none left */
+  g_thread_pool_free (priv->pool, FALSE, TRUE);
+  g_free (priv->output_directory);
+
+  G_OBJECT_CLASS (ges_proxy_generator_parent_class)->finalize (object);
+}
+
+static void
+ges_proxy_generator_class_init (GESProxyGeneratorClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->get_property = ges_proxy_generator_get_property;
+  object_class->set_property = ges_proxy_generator_set_property;
+  object_class->finalize = ges_proxy_generator_finalize;
+
+  /**
+   * GESProxyGenerator:output-directory:
+   *
+   * The directory where the proxies are written. If %NULL, they are written
+   * to a "gstreamer-1.0/ges/proxies" directory in the user cache directory.
+   */
+  properties[PROP_OUTPUT_DIRECTORY] =
+      g_param_spec_string ("output-directory", "Output directory",
+      "The directory where the proxies are written", NULL,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GESProxyGenerator:height:
+   *
+   * The height of the video streams of the proxies. Videos that are not
+   * higher are not scaled.
+   */
+  properties[PROP_HEIGHT] = g_param_spec_uint ("height", "Height",
+      "The height of the video streams of the proxies", 16, G_MAXINT,
+      DEFAULT_HEIGHT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GESProxyGenerator:max-jobs:
+   *
+   * The maximum number of proxies being generated at the same time.
+   */
+  properties[PROP_MAX_JOBS] = g_param_spec_uint ("max-jobs", "Maximum jobs",
+      "The maximum number of proxies being generated at the same time", 1,
+      G_MAXINT, DEFAULT_MAX_JOBS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (object_class, PROP_LAST, properties);
+}
+
+static void
+ges_proxy_generator_init (GESProxyGenerator * self)
+{
+  self->priv = ges_proxy_generator_get_instance_private (self);
+
+  self->priv->height = DEFAULT_HEIGHT;
+  self->priv->pool = g_thread_pool_new ((GFunc) _transcode, self,
+      DEFAULT_MAX_JOBS, FALSE, NULL);
+}
+
+/**
+ * ges_proxy_generator_new:
+ *
+ * Creates a new #GESProxyGenerator.
+ *
+ * Returns: (transfer full): The new #GESProxyGenerator
+ *
+ * Since: 1.16
+ */
+GESProxyGenerator *
+ges_proxy_generator_new (void)
+{
+  return g_object_new (GES_TYPE_PROXY_GENERATOR, NULL);
+}
+
+/**
+ * ges_proxy_generator_generate_async:
+ * @self: A #GESProxyGenerator
+ * @asset: The loaded #GESUriClipAsset to generate a proxy for
+ * @cancellable: (allow-none): optional %GCancellable object, %NULL to ignore
+ * @callback: A #GAsyncReadyCallback to call when the proxy is ready
+ * @user_data: The user data to pass to @callback
+ *
+ * Generates a proxy of @asset in a background thread, unless an up to date
+ * one was already generated, and sets it as the default proxy of @asset
+ * with ges_asset_set_proxy().
+ *
+ * Since: 1.16
+ */
+void
+ges_proxy_generator_generate_async (GESProxyGenerator * self,
+    GESUriClipAsset * asset, GCancellable * cancellable,
+    GAsyncReadyCallback callback, gpointer user_data)
+{
+  GTask *task;
+  ProxyJob *job;
+  GError *error = NULL;
+  gchar *directory, *checksum, *filename;
+  const gchar *uri;
+
+  g_return_if_fail (GES_IS_PROXY_GENERATOR (self));
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (asset));
+  g_return_if_fail (ges_uri_clip_asset_get_info (asset));
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  uri = ges_asset_get_id (GES_ASSET (asset));
+
+  job = g_slice_new0 (ProxyJob);
+  job->asset = gst_object_ref (asset);
+  g_task_set_task_data (task, job, (GDestroyNotify) _proxy_job_free);
+
+  directory = _ensure_output_directory (self, &error);
+  if (!directory) {
+    g_task_return_error (task, error);
+    g_object_unref (task);
+
+    return;
+  }
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  filename = g_strdup_printf ("%s.mkv", checksum);
+  job->location = g_build_filename (directory, filename, NULL);
+  job->uri = gst_filename_to_uri (job->location, NULL);
+  g_free (filename);
+  g_free (checksum);
+  g_free (directory);
+
+  if (_proxy_is_up_to_date (uri, job->location)) {
+    GST_INFO_OBJECT (self, "Reusing proxy %s for %s", job->location, uri);
+    _load_proxy (task);
+
+    return;
+  }
+
+  job->profile = _create_profile (self, asset);
+  g_thread_pool_push (self->priv->pool, task, NULL);
+}
+
+/**
+ * ges_proxy_generator_generate_finish:
+ * @self: A #GESProxyGenerator
+ * @result: The #GAsyncResult passed to the callback
+ * @error: An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes the generation of a proxy started with
+ * ges_proxy_generator_generate_async().
+ *
+ * Returns: (transfer full): The proxy #GESAsset, or %NULL if an error
+ * happened.
+ *
+ * Since: 1.16
+ */
+GESAsset *
+ges_proxy_generator_generate_finish (GESProxyGenerator * self,
+    GAsyncResult * result, GError ** error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
@@ -0,0 +1,69 @@
+/* GStreamer Editing Services
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef GES_PROXY_GENERATOR_H
+#define GES_PROXY_GENERATOR_H
+
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <ges/ges-types.h>
+#include <ges/ges-uri-asset.h>
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_PROXY_GENERATOR (ges_proxy_generator_get_type ())
+#define GES_PROXY_GENERATOR(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_PROXY_GENERATOR, GESProxyGenerator))
+#define GES_PROXY_GENERATOR_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_PROXY_GENERATOR, GESProxyGeneratorClass))
+#define GES_IS_PROXY_GENERATOR(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_PROXY_GENERATOR))
+#define GES_IS_PROXY_GENERATOR_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_PROXY_GENERATOR))
+#define GES_PROXY_GENERATOR_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GES_TYPE_PROXY_GENERATOR, GESProxyGeneratorClass))
+
+typedef struct _GESProxyGeneratorPrivate GESProxyGeneratorPrivate;
+
+struct _GESProxyGenerator {
+  GObject parent;
+
+  /*< private >*/
+  GESProxyGeneratorPrivate *priv;
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+struct _GESProxyGeneratorClass {
+  GObjectClass parent_class;
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+GES_API
+GType ges_proxy_generator_get_type                  (void);
+GES_API
+GESProxyGenerator * ges_proxy_generator_new         (void);
+GES_API
+void ges_proxy_generator_generate_async             (GESProxyGenerator * self,
+                                                     GESUriClipAsset * asset,
+                                                     GCancellable * cancellable,
+                                                     GAsyncReadyCallback callback,
+                                                     gpointer user_data);
+GES_API
+GESAsset * ges_proxy_generator_generate_finish      (GESProxyGenerator * self,
+                                                     GAsyncResult * result,
+                                                     GError ** error);
+
+G_END_DECLS
+#endif /* GES_PROXY_GENERATOR_H */
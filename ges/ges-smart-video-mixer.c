@@ -17,6 +17,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.";
  */
 
+#include <gst/video/gstvideoaggregator.h>
+
 #include "gstframepositioner.h"
 #include "ges-types.h"
 #include "ges-internal.h"
@@ -40,12 +42,37 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink_%u",
     GST_STATIC_CAPS ("video/x-raw")
     );
 
+/* The mixer pad properties set from the GstFramePositionerMeta */
+typedef enum
+{
+  PAD_PROP_ALPHA,
+  PAD_PROP_ZORDER,
+  PAD_PROP_XPOS,
+  PAD_PROP_YPOS,
+  PAD_PROP_WIDTH,
+  PAD_PROP_HEIGHT,
+  N_PAD_PROPS
+} PadProperty;
+
+static const gchar *pad_properties[N_PAD_PROPS] = {
+  "alpha", "zorder", "xpos", "ypos", "width", "height"
+};
+
 typedef struct _PadInfos
 {
   GESSmartMixer *self;
   GstPad *mixer_pad;
   GstElement *bin;
   gulong probe_id;
+
+  /* The positioning last set on @mixer_pad, only the values that change
+   * from one frame to the other have to be set again */
+  gboolean positioned;
+  GstFramePositionerMeta last;
+
+  /* Looked up once so setting them per buffer does not go through
+   * the property name lookup */
+  GParamSpec *pspecs[N_PAD_PROPS];
 } PadInfos;
 
 static void
@@ -84,13 +111,61 @@ ges_smart_mixer_get_mixer_pad (GESSmartMixer * self, GstPad ** mixerpad)
   return sinkpad;
 }
 
+/* What g_object_set_property() does once it found @pspec */
+static void
+_set_property (PadInfos * infos, PadProperty prop, GValue * value)
+{
+  GParamSpec *pspec = infos->pspecs[prop];
+  GObjectClass *klass;
+
+  if (G_UNLIKELY (!pspec))
+    return;
+
+  g_param_value_validate (pspec, value);
+  klass = g_type_class_peek (pspec->owner_type);
+  klass->set_property (G_OBJECT (infos->mixer_pad), pspec->param_id, value,
+      pspec);
+  g_object_notify_by_pspec (G_OBJECT (infos->mixer_pad), pspec);
+}
+
+static inline void
+_set_double (PadInfos * infos, PadProperty prop, gdouble value)
+{
+  GValue v = G_VALUE_INIT;
+
+  g_value_init (&v, G_TYPE_DOUBLE);
+  g_value_set_double (&v, value);
+  _set_property (infos, prop, &v);
+}
+
+static inline void
+_set_int (PadInfos * infos, PadProperty prop, gint value)
+{
+  GValue v = G_VALUE_INIT;
+
+  g_value_init (&v, G_TYPE_INT);
+  g_value_set_int (&v, value);
+  _set_property (infos, prop, &v);
+}
+
+static inline void
+_set_uint (PadInfos * infos, PadProperty prop, guint value)
+{
+  GValue v = G_VALUE_INIT;
+
+  g_value_init (&v, G_TYPE_UINT);
+  g_value_set_uint (&v, value);
+  _set_property (infos, prop, &v);
+}
+
 /* These metadata will get set by the upstream framepositioner element,
    added in the video sources' bin */
 static GstPadProbeReturn
-parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info,
-    GESSmartMixer * self)
+parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, PadInfos * infos)
 {
   GstFramePositionerMeta *meta;
+  GstFramePositionerMeta *last = &infos->last;
+  gboolean force = !infos->positioned;
 
   meta =
       (GstFramePositionerMeta *) gst_buffer_get_meta ((GstBuffer *) info->data,
@@ -101,15 +176,25 @@ parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info,
     return GST_PAD_PROBE_OK;
   }
 
-  if (!self->disable_zorder_alpha) {
-    g_object_set (mixer_pad, "alpha", meta->alpha,
-        "zorder", meta->zorder, NULL);
-  } else {
-    g_object_set (mixer_pad, "alpha", meta->alpha, NULL);
-  }
-
-  g_object_set (mixer_pad, "xpos", meta->posx, "ypos",
-      meta->posy, "width", meta->width, "height", meta->height, NULL);
+  /* This runs for every frame of every layer, positions mostly do not change
+   * so only touch the properties that did, without any varargs parsing nor
+   * property lookup */
+  if (force || meta->alpha != last->alpha)
+    _set_double (infos, PAD_PROP_ALPHA, meta->alpha);
+  if (!infos->self->disable_zorder_alpha &&
+      (force || meta->zorder != last->zorder))
+    _set_uint (infos, PAD_PROP_ZORDER, meta->zorder);
+  if (force || meta->posx != last->posx)
+    _set_int (infos, PAD_PROP_XPOS, meta->posx);
+  if (force || meta->posy != last->posy)
+    _set_int (infos, PAD_PROP_YPOS, meta->posy);
+  if (force || meta->width != last->width)
+    _set_int (infos, PAD_PROP_WIDTH, meta->width);
+  if (force || meta->height != last->height)
+    _set_int (infos, PAD_PROP_HEIGHT, meta->height);
+
+  infos->last = *meta;
+  infos->positioned = TRUE;
 
   return GST_PAD_PROBE_OK;
 }
@@ -126,6 +211,7 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
   GESSmartMixer *self = GES_SMART_MIXER (element);
   GstPad *ghost;
   GstElement *videoconvert;
+  gint i;
 
   infos->mixer_pad = gst_element_request_pad (self->mixer,
       gst_element_class_get_pad_template (GST_ELEMENT_GET_CLASS (self->mixer),
@@ -139,34 +225,57 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
   }
 
   infos->self = self;
+  for (i = 0; i < N_PAD_PROPS; i++) {
+    infos->pspecs[i] =
+        g_object_class_find_property (G_OBJECT_GET_CLASS (infos->mixer_pad),
+        pad_properties[i]);
+    if (!infos->pspecs[i])
+      GST_WARNING_OBJECT (self, "%" GST_PTR_FORMAT " has no '%s' property",
+          infos->mixer_pad, pad_properties[i]);
+  }
 
-  infos->bin = gst_bin_new (NULL);
-  videoconvert = gst_element_factory_make ("videoconvert", NULL);
-
-  gst_bin_add (GST_BIN (infos->bin), videoconvert);
-
-  videoconvert_sinkpad = gst_element_get_static_pad (videoconvert, "sink");
-  tmpghost = GST_PAD (gst_ghost_pad_new (NULL, videoconvert_sinkpad));
-  gst_object_unref (videoconvert_sinkpad);
-  gst_pad_set_active (tmpghost, TRUE);
-  gst_element_add_pad (GST_ELEMENT (infos->bin), tmpghost);
-
-  gst_bin_add (GST_BIN (self), infos->bin);
-  ghost = gst_ghost_pad_new (NULL, tmpghost);
-  gst_pad_set_active (ghost, TRUE);
-  if (!gst_element_add_pad (GST_ELEMENT (self), ghost))
-    goto could_not_add;
-
-  videoconvert_srcpad = gst_element_get_static_pad (videoconvert, "src");
-  tmpghost = GST_PAD (gst_ghost_pad_new (NULL, videoconvert_srcpad));
-  gst_object_unref (videoconvert_srcpad);
-  gst_pad_set_active (tmpghost, TRUE);
-  gst_element_add_pad (GST_ELEMENT (infos->bin), tmpghost);
-  gst_pad_link (tmpghost, infos->mixer_pad);
+  /* The compositor converts each input to the format it negotiated for its
+   * output: the format forced by the track, or else the one most of its
+   * inputs have, with alpha only if one of them needs it. Sources
+   * already converted what they had to, so plugging a converter in front of
+   * it would only add a second colorspace conversion. Setting
+   * GES_SMART_MIXER_CONVERT_PADS brings the converters back, to compare
+   * with how it used to be done. */
+  if (GST_IS_VIDEO_AGGREGATOR_CONVERT_PAD (infos->mixer_pad) &&
+      !g_getenv ("GES_SMART_MIXER_CONVERT_PADS")) {
+    ghost = gst_ghost_pad_new (NULL, infos->mixer_pad);
+    gst_pad_set_active (ghost, TRUE);
+    if (!gst_element_add_pad (GST_ELEMENT (self), ghost))
+      goto could_not_add;
+  } else {
+    infos->bin = gst_bin_new (NULL);
+    videoconvert = gst_element_factory_make ("videoconvert", NULL);
+
+    gst_bin_add (GST_BIN (infos->bin), videoconvert);
+
+    videoconvert_sinkpad = gst_element_get_static_pad (videoconvert, "sink");
+    tmpghost = GST_PAD (gst_ghost_pad_new (NULL, videoconvert_sinkpad));
+    gst_object_unref (videoconvert_sinkpad);
+    gst_pad_set_active (tmpghost, TRUE);
+    gst_element_add_pad (GST_ELEMENT (infos->bin), tmpghost);
+
+    gst_bin_add (GST_BIN (self), infos->bin);
+    ghost = gst_ghost_pad_new (NULL, tmpghost);
+    gst_pad_set_active (ghost, TRUE);
+    if (!gst_element_add_pad (GST_ELEMENT (self), ghost))
+      goto could_not_add;
+
+    videoconvert_srcpad = gst_element_get_static_pad (videoconvert, "src");
+    tmpghost = GST_PAD (gst_ghost_pad_new (NULL, videoconvert_srcpad));
+    gst_object_unref (videoconvert_srcpad);
+    gst_pad_set_active (tmpghost, TRUE);
+    gst_element_add_pad (GST_ELEMENT (infos->bin), tmpghost);
+    gst_pad_link (tmpghost, infos->mixer_pad);
+  }
 
   infos->probe_id =
       gst_pad_add_probe (infos->mixer_pad, GST_PAD_PROBE_TYPE_BUFFER,
-      (GstPadProbeCallback) parse_metadata, self, NULL);
+      (GstPadProbeCallback) parse_metadata, infos, NULL);
 
   LOCK (self);
   g_hash_table_insert (self->pads_infos, ghost, infos);
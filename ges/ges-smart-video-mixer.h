@@ -59,13 +59,13 @@ struct _GESSmartMixer
   gpointer _ges_reserved[GES_PADDING];
 };
 
-G_GNUC_INTERNAL
+GES_API
 GType ges_smart_mixer_get_type (void) G_GNUC_CONST;
 
 G_GNUC_INTERNAL GstPad *
 ges_smart_mixer_get_mixer_pad (GESSmartMixer *self, GstPad **mixerpad);
 
-G_GNUC_INTERNAL
+GES_API
 GstElement*   ges_smart_mixer_new      (GESTrack *track);
 
 G_END_DECLS
@@ -28,6 +28,8 @@
 #include "ges/ges-meta-container.h"
 #include "ges-track-element.h"
 #include "ges-source.h"
+#include "ges-uri-asset.h"
+#include "ges-extractable.h"
 #include "ges-layer.h"
 #include "gstframepositioner.h"
 
@@ -37,6 +39,14 @@ struct _GESSourcePrivate
 {
   /*  Dummy variable */
   GstFramePositioner *positioner;
+
+  /* Created by ges_source_create_uri_decoder(), owned by our element */
+  GstElement *decoder;
+
+  /* The processing elements bypassed while passing compressed data through */
+  gboolean passthrough;
+  GstPad *processing_sinkpad;
+  GstPad *processing_srcpad;
 };
 
 /******************************
@@ -140,13 +150,166 @@ ges_source_create_topbin (const gchar * bin_name, GstElement * sub_element, ...)
   return bin;
 }
 
+/* Smart rendering sets the compressed formats in the track caps, only pass
+ * them to the decoders of the sources that are passed through */
+static GstCaps *
+_get_raw_caps (const GstCaps * caps)
+{
+  guint i;
+  GstCaps *raw_caps = gst_caps_new_empty ();
+
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    const gchar *name = gst_structure_get_name (gst_caps_get_structure (caps,
+            i));
+
+    if (g_str_has_suffix (name, "/x-raw")) {
+      GstCapsFeatures *features = gst_caps_get_features (caps, i);
+
+      gst_caps_append_structure_full (raw_caps,
+          gst_structure_copy (gst_caps_get_structure (caps, i)),
+          features ? gst_caps_features_copy (features) : NULL);
+    }
+  }
+
+  if (gst_caps_is_empty (raw_caps)) {
+    gst_caps_unref (raw_caps);
+
+    return gst_caps_copy (caps);
+  }
+
+  return raw_caps;
+}
+
+/* Creates the element decoding the stream of @source read from @uri, its
+ * decoders are shared with the other sources of the track reading the same
+ * stream, and it reads the proxy of @uri when the track uses proxies */
+GstElement *
+ges_source_create_uri_decoder (GESSource * source, const gchar * uri)
+{
+  GstElement *decoder;
+  GESAsset *clip_asset = NULL;
+  const gchar *stream_id = NULL;
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (source));
+  GESAsset *asset = ges_extractable_get_asset (GES_EXTRACTABLE (source));
+
+  if (GES_IS_URI_SOURCE_ASSET (asset)) {
+    GstDiscovererStreamInfo *sinfo =
+        ges_uri_source_asset_get_stream_info (GES_URI_SOURCE_ASSET (asset));
+
+    if (sinfo)
+      stream_id = gst_discoverer_stream_info_get_stream_id (sinfo);
+    clip_asset = (GESAsset *) ges_uri_source_asset_get_filesource_asset
+        (GES_URI_SOURCE_ASSET (asset));
+  }
+
+  decoder = ges_pooled_decoder_new (track ?
+      ges_track_get_decoder_pool (track) : NULL, clip_asset, uri, stream_id);
+  if (track) {
+    GstCaps *caps = _get_raw_caps (ges_track_get_caps (track));
+
+    g_object_set (decoder, "caps", caps, NULL);
+    gst_caps_unref (caps);
+  }
+  ges_pooled_decoder_set_prepare_func (GES_POOLED_DECODER (decoder),
+      (GESPooledDecoderPrepareFunc) _decoder_prepare_cb, source);
+  source->priv->decoder = decoder;
+
+  return decoder;
+}
+
+/* Bypasses the processing elements of @source if @caps is set, or puts
+ * them back otherwise. The decoder must not be running. */
+static void
+_apply_passthrough (GESSource * source, GstCaps * caps)
+{
+  GstElement *topbin;
+  GstPad *ghost, *decoder_srcpad;
+  GESSourcePrivate *priv = source->priv;
+
+  topbin = ges_track_element_get_element (GES_TRACK_ELEMENT (source));
+  if (!topbin || priv->passthrough == (caps != NULL))
+    return;
+
+  GST_INFO_OBJECT (source, "%s passthrough", caps ? "Enabling" : "Disabling");
+
+  ghost = gst_element_get_static_pad (topbin, "src");
+  decoder_srcpad = gst_element_get_static_pad (priv->decoder, "src");
+  if (caps) {
+    priv->processing_sinkpad = gst_pad_get_peer (decoder_srcpad);
+    priv->processing_srcpad =
+        gst_ghost_pad_get_target (GST_GHOST_PAD (ghost));
+    gst_pad_unlink (decoder_srcpad, priv->processing_sinkpad);
+    gst_ghost_pad_set_target (GST_GHOST_PAD (ghost), decoder_srcpad);
+  } else {
+    gst_ghost_pad_set_target (GST_GHOST_PAD (ghost),
+        priv->processing_srcpad);
+    gst_pad_link (decoder_srcpad, priv->processing_sinkpad);
+    gst_object_unref (priv->processing_sinkpad);
+    gst_object_unref (priv->processing_srcpad);
+    priv->processing_sinkpad = NULL;
+    priv->processing_srcpad = NULL;
+  }
+  priv->passthrough = caps != NULL;
+
+  gst_object_unref (decoder_srcpad);
+  gst_object_unref (ghost);
+}
+
+static void
+_decoder_prepare_cb (GESPooledDecoder * decoder, GstCaps * passthrough_caps,
+    GESSource * source)
+{
+  _apply_passthrough (source, passthrough_caps);
+}
+
+/* Makes @source output the compressed stream of its file matching @caps,
+ * bypassing its processing elements, or the processed decoded stream again
+ * if @caps is %NULL. Only works for the sources decoding their stream with
+ * ges_source_create_uri_decoder(). Running sources keep their current
+ * output until they get started again, when their decoder is reconfigured
+ * at the same time. */
+void
+ges_source_set_passthrough_caps (GESSource * source, GstCaps * caps)
+{
+  GESSourcePrivate *priv = source->priv;
+
+  if (!priv->decoder)
+    return;
+
+  /* Holding the state lock, the decoder can not start meanwhile */
+  GST_STATE_LOCK (priv->decoder);
+  ges_pooled_decoder_set_passthrough_caps (GES_POOLED_DECODER (priv->decoder),
+      caps);
+
+  if (GST_STATE (priv->decoder) <= GST_STATE_READY)
+    _apply_passthrough (source, caps);
+  else
+    GST_DEBUG_OBJECT (source, "Running, passthrough changes once restarted");
+  GST_STATE_UNLOCK (priv->decoder);
+}
+
+static void
+ges_source_finalize (GObject * object)
+{
+  GESSourcePrivate *priv = GES_SOURCE (object)->priv;
+
+  if (priv->processing_sinkpad)
+    gst_object_unref (priv->processing_sinkpad);
+  if (priv->processing_srcpad)
+    gst_object_unref (priv->processing_srcpad);
+
+  G_OBJECT_CLASS (ges_source_parent_class)->finalize (object);
+}
+
 static void
 ges_source_class_init (GESSourceClass * klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GESTrackElementClass *track_class = GES_TRACK_ELEMENT_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESSourcePrivate));
 
+  object_class->finalize = ges_source_finalize;
   track_class->nleobject_factorytype = "nlesource";
   track_class->create_element = NULL;
 }
@@ -87,15 +87,72 @@ GST_DEBUG_CATEGORY_STATIC (ges_timeline_debug);
         g_thread_self());         \
   } G_STMT_END
 
+/* An edge of a source, as stored in the edges indexes */
+typedef struct
+{
+  GstClockTime timecode;
+  GESTrackElement *element;
+  GESEdge edge;
+} TimelineEdge;
+
+/* Array of TimelineEdge sorted by timecode. New edges are appended and the
+ * array is only sorted again when needed, in which case @unsorted is %TRUE
+ * and @max_timecode is the biggest timecode in it */
+typedef struct
+{
+  GArray *edges;
+  gboolean unsorted;
+  GstClockTime max_timecode;
+} EdgeIndex;
+
+/* Edges of the sources of a layer in one track, used to create the auto
+ * transitions. [@dirty_start, @dirty_end] is the range where sources
+ * changed since transitions were last created there, it is empty when
+ * @dirty_start > @dirty_end */
+typedef struct
+{
+  GESTrack *track;
+  EdgeIndex index;
+  /* Biggest duration of the sources, never shrinks unless the index is
+   * emptied */
+  GstClockTime max_duration;
+  GstClockTime dirty_start;
+  GstClockTime dirty_end;
+
+  /* Sources of the index being updated by timeline_flush_edits */
+  guint n_moved;
+  gboolean retime;
+} LayerEdges;
+
 typedef struct TrackObjIters
 {
-  GSequenceIter *iter_start;
-  GSequenceIter *iter_end;
+  /* Start and end of the source as currently stored in the edges indexes */
+  GstClockTime start;
+  GstClockTime end;
   GSequenceIter *iter_obj;
   GSequenceIter *iter_by_layer;
+  LayerEdges *layer_edges;
 
   GESLayer *layer;
   GESTrackElement *trackelement;
+
+  /* %TRUE when the element changed and is waiting for its indexes to be
+   * updated by timeline_flush_edits */
+  gboolean pending;
+  /* %TRUE when the element is in the move context moving_trackelements */
+  gboolean moving;
+
+  /* Timings of the source as of its last notifications */
+  GstClockTime known_start;
+  GstClockTime known_inpoint;
+  GstClockTime known_duration;
+
+  /* Timings of the source before the current edit transaction changed
+   * them, only set when @edited is %TRUE */
+  gboolean edited;
+  GstClockTime saved_start;
+  GstClockTime saved_inpoint;
+  GstClockTime saved_duration;
 } TrackObjIters;
 
 static void
@@ -119,8 +176,12 @@ struct _MoveContext
   /* The  start of the moving context */
   GstClockTime start;
 
-  /* Ripple and Roll Objects */
-  GList *moving_trackelements;
+  /* TrackObjIters of the Ripple and Roll Objects, sorted by start */
+  GPtrArray *moving_trackelements;
+  /* TrackObjIters of the first of the moving_trackelements of each
+   * toplevel container, sorted by start. Moving them moves all the
+   * moving_trackelements */
+  GPtrArray *moving_toplevels;
 
   /* We use it as a set of Clip to move between layers */
   GHashTable *toplevel_containers;
@@ -144,7 +205,7 @@ struct _MoveContext
   /* Last snapping  properties */
   GESTrackElement *last_snaped1;
   GESTrackElement *last_snaped2;
-  GstClockTime *last_snap_ts;
+  GstClockTime last_snap_ts;
 
   /* Priority of the layer where we are moving current clip
    * -1 if not moving any clip to a new layer. */
@@ -158,11 +219,21 @@ struct _GESTimelinePrivate
 
   /* The auto-transition of the timeline */
   gboolean auto_transition;
-  /* Use to determine that a edit action should be rolled
-   * back because it leads to a wrong state of the element
-   * position (currently only happens if 3 clips overlap) */
-  gboolean needs_rollback;
-  gboolean rolling_back;
+
+  /* Edit transactions, see ges_timeline_begin_edit() */
+  guint edit_depth;
+  /* Set when the current transaction leads to a wrong state of the
+   * elements position (currently only happens if 3 clips overlap) and
+   * needs to be rolled back */
+  gboolean edit_failed;
+  /* TrackObjIters of the elements to reindex */
+  GPtrArray *pending_iters;
+  /* TrackObjIters of the sources changed by the transaction */
+  GPtrArray *edited_iters;
+  /* {Clip: Layer} the clips were in before the transaction moved them */
+  GHashTable *edited_layers;
+  /* Holds the elements taken out of their sequences while reindexing */
+  GSequence *detached;
 
   /* Timeline edition modes and snapping management */
   guint64 snapping_distance;
@@ -172,11 +243,8 @@ struct _GESTimelinePrivate
    * be tracked? */
 
   /* Snapping fields */
-  GHashTable *by_start;         /* {Source: start} */
-  GHashTable *by_end;           /* {Source: end} */
-  GHashTable *by_object;        /* {timecode: Source} */
   GHashTable *obj_iters;        /* {Source: TrackObjIters} */
-  GSequence *starts_ends;       /* Sorted list of starts/ends */
+  EdgeIndex edges;              /* Starts and ends of all the sources */
   /* We keep 1 reference to our trackelement here */
   GSequence *tracksources;      /* Source-s sorted by start/priorities */
 
@@ -185,6 +253,7 @@ struct _GESTimelinePrivate
   /* FIXME: We should definitly offer an API over this,
    * probably through a ges_layer_get_track_elements () method */
   GHashTable *by_layer;         /* {layer: GSequence of TrackElement by start/priorities} */
+  GHashTable *layer_edges;      /* {layer: {track: LayerEdges}} */
 
   /* Avoid sorting layers when we are actually resyncing them ourself */
   gboolean resyncing_layers;
@@ -371,14 +440,17 @@ ges_timeline_dispose (GObject * object)
   g_list_free (priv->groups);
   g_list_free (groups);
 
-  g_hash_table_unref (priv->by_start);
-  g_hash_table_unref (priv->by_end);
-  g_hash_table_unref (priv->by_object);
   g_hash_table_unref (priv->by_layer);
+  g_hash_table_unref (priv->layer_edges);
   g_hash_table_unref (priv->obj_iters);
-  g_sequence_free (priv->starts_ends);
+  edge_index_clear (&priv->edges);
   g_sequence_free (priv->tracksources);
-  g_list_free (priv->movecontext.moving_trackelements);
+  g_ptr_array_unref (priv->pending_iters);
+  g_ptr_array_unref (priv->edited_iters);
+  g_hash_table_unref (priv->edited_layers);
+  g_sequence_free (priv->detached);
+  g_ptr_array_unref (priv->movecontext.moving_trackelements);
+  g_ptr_array_unref (priv->movecontext.moving_toplevels);
   g_hash_table_unref (priv->movecontext.toplevel_containers);
 
   g_list_free_full (priv->auto_transitions, gst_object_unref);
@@ -677,15 +749,19 @@ ges_timeline_init (GESTimeline * self)
   priv->movecontext.ignore_needs_ctx = FALSE;
 
   priv->priv_tracks = NULL;
-  priv->by_start = g_hash_table_new (g_direct_hash, g_direct_equal);
-  priv->by_end = g_hash_table_new (g_direct_hash, g_direct_equal);
-  priv->by_object = g_hash_table_new (g_direct_hash, g_direct_equal);
   priv->by_layer = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       (GDestroyNotify) g_sequence_free);
   priv->obj_iters = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       (GDestroyNotify) _destroy_obj_iters);
-  priv->starts_ends = g_sequence_new (g_free);
+  priv->layer_edges = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify) g_hash_table_unref);
+  edge_index_init (&priv->edges);
   priv->tracksources = g_sequence_new (gst_object_unref);
+  priv->pending_iters = g_ptr_array_new ();
+  priv->edited_iters = g_ptr_array_new ();
+  priv->edited_layers = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      gst_object_unref, gst_object_unref);
+  priv->detached = g_sequence_new (NULL);
 
   priv->needs_transitions_update = TRUE;
 
@@ -750,28 +826,280 @@ _resync_layers (GESTimeline * timeline)
   timeline->priv->resyncing_layers = FALSE;
 }
 
+/* Edges are sorted by timecode, then starts before ends so that an element
+ * is always entered before being left */
+static gint
+compare_edges (const TimelineEdge * a, const TimelineEdge * b)
+{
+  if (a->timecode != b->timecode)
+    return a->timecode < b->timecode ? -1 : 1;
+
+  if (a->edge != b->edge)
+    return a->edge == GES_EDGE_START ? -1 : 1;
+
+  if (a->element != b->element)
+    return a->element < b->element ? -1 : 1;
+
+  return 0;
+}
+
+static void
+edge_index_init (EdgeIndex * index)
+{
+  index->edges = g_array_new (FALSE, FALSE, sizeof (TimelineEdge));
+  index->unsorted = FALSE;
+  index->max_timecode = 0;
+}
+
+static void
+edge_index_clear (EdgeIndex * index)
+{
+  g_array_unref (index->edges);
+  index->edges = NULL;
+}
+
+static void
+edge_index_ensure_sorted (EdgeIndex * index)
+{
+  if (!index->unsorted)
+    return;
+
+  GST_DEBUG ("Sorting %u edges", index->edges->len);
+  g_array_sort (index->edges, (GCompareFunc) compare_edges);
+  index->unsorted = FALSE;
+}
+
+/* Index of the first edge not sorting before @edge, which does not need to
+ * be in the array */
+static guint
+edge_index_lower_bound (EdgeIndex * index, const TimelineEdge * edge)
+{
+  guint low = 0, high = index->edges->len;
+  TimelineEdge *edges = (TimelineEdge *) index->edges->data;
+
+  while (low < high) {
+    guint mid = low + (high - low) / 2;
+
+    if (compare_edges (&edges[mid], edge) < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low;
+}
+
+/* Index of the first edge strictly after @timecode */
+static guint
+edge_index_upper_bound (EdgeIndex * index, GstClockTime timecode)
+{
+  guint low = 0, high = index->edges->len;
+  TimelineEdge *edges = (TimelineEdge *) index->edges->data;
+
+  while (low < high) {
+    guint mid = low + (high - low) / 2;
+
+    if (edges[mid].timecode <= timecode)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low;
+}
+
+static void
+edge_index_add (EdgeIndex * index, GESTrackElement * element,
+    GESEdge edge, GstClockTime timecode)
+{
+  TimelineEdge new_edge = { timecode, element, edge };
+
+  if (!index->unsorted && index->edges->len) {
+    TimelineEdge *last = &g_array_index (index->edges, TimelineEdge,
+        index->edges->len - 1);
+
+    if (compare_edges (last, &new_edge) > 0) {
+      index->unsorted = TRUE;
+      index->max_timecode = last->timecode;
+    }
+  }
+
+  g_array_append_val (index->edges, new_edge);
+  index->max_timecode = MAX (index->max_timecode, timecode);
+}
+
+static void
+edge_index_remove (EdgeIndex * index, GESTrackElement * element,
+    GESEdge edge, GstClockTime timecode)
+{
+  guint i;
+  TimelineEdge old_edge = { timecode, element, edge };
+
+  edge_index_ensure_sorted (index);
+
+  i = edge_index_lower_bound (index, &old_edge);
+  g_assert (i < index->edges->len);
+  g_array_remove_index (index->edges, i);
+}
+
+/* Moves the edge to its new place, only shifting the edges in between */
+static void
+edge_index_move (EdgeIndex * index, GESTrackElement * element,
+    GESEdge edge, GstClockTime old_timecode, GstClockTime new_timecode)
+{
+  guint from, to;
+  TimelineEdge *edges;
+  TimelineEdge old_edge = { old_timecode, element, edge };
+  TimelineEdge new_edge = { new_timecode, element, edge };
+
+  if (old_timecode == new_timecode)
+    return;
+
+  edge_index_ensure_sorted (index);
+
+  edges = (TimelineEdge *) index->edges->data;
+  from = edge_index_lower_bound (index, &old_edge);
+  to = edge_index_lower_bound (index, &new_edge);
+  g_assert (from < index->edges->len);
+
+  if (to > from) {
+    to--;
+    memmove (&edges[from], &edges[from + 1], (to - from) * sizeof (*edges));
+  } else {
+    memmove (&edges[to + 1], &edges[to], (from - to) * sizeof (*edges));
+  }
+  edges[to] = new_edge;
+}
+
+/* Gives their new timecode to the edges of the sources pending in
+ * @obj_iters in a single pass, the index is sorted again when next needed */
+static void
+edge_index_retime (EdgeIndex * index, GHashTable * obj_iters)
+{
+  guint i;
+  GstClockTime max_timecode = 0;
+  TimelineEdge *edges = (TimelineEdge *) index->edges->data;
+
+  for (i = 0; i < index->edges->len; i++) {
+    TrackObjIters *iters = g_hash_table_lookup (obj_iters, edges[i].element);
+
+    if (iters->pending)
+      edges[i].timecode = edges[i].edge == GES_EDGE_START ?
+          iters->start : iters->end;
+    max_timecode = MAX (max_timecode, edges[i].timecode);
+  }
+
+  index->unsorted = TRUE;
+  index->max_timecode = max_timecode;
+}
+
+static LayerEdges *
+layer_edges_new (GESTrack * track)
+{
+  LayerEdges *layer_edges = g_slice_new0 (LayerEdges);
+
+  layer_edges->track = track;
+  edge_index_init (&layer_edges->index);
+  layer_edges->dirty_start = GST_CLOCK_TIME_NONE;
+  layer_edges->dirty_end = 0;
+
+  return layer_edges;
+}
+
+static void
+layer_edges_free (LayerEdges * layer_edges)
+{
+  edge_index_clear (&layer_edges->index);
+  g_slice_free (LayerEdges, layer_edges);
+}
+
+static inline void
+layer_edges_mark_dirty (LayerEdges * layer_edges, GstClockTime start,
+    GstClockTime end)
+{
+  layer_edges->dirty_start = MIN (layer_edges->dirty_start, start);
+  layer_edges->dirty_end = MAX (layer_edges->dirty_end, end);
+}
+
+/* Returns the edges of the sources of @layer in @track, %NULL if @layer is
+ * not in the timeline */
+static LayerEdges *
+timeline_get_layer_edges (GESTimeline * timeline, GESLayer * layer,
+    GESTrack * track)
+{
+  LayerEdges *layer_edges;
+  GHashTable *by_track;
+
+  if (!layer || !track)
+    return NULL;
+
+  by_track = g_hash_table_lookup (timeline->priv->layer_edges, layer);
+  if (!by_track)
+    return NULL;
+
+  layer_edges = g_hash_table_lookup (by_track, track);
+  if (!layer_edges) {
+    layer_edges = layer_edges_new (track);
+    g_hash_table_insert (by_track, track, layer_edges);
+  }
+
+  return layer_edges;
+}
+
+static void
+layer_edges_add_source (LayerEdges * layer_edges, TrackObjIters * iters)
+{
+  edge_index_add (&layer_edges->index, iters->trackelement, GES_EDGE_START,
+      iters->start);
+  edge_index_add (&layer_edges->index, iters->trackelement, GES_EDGE_END,
+      iters->end);
+  layer_edges->max_duration = MAX (layer_edges->max_duration,
+      iters->end - iters->start);
+  layer_edges_mark_dirty (layer_edges, iters->start, iters->end);
+  iters->layer_edges = layer_edges;
+}
+
+static void
+layer_edges_remove_source (LayerEdges * layer_edges, TrackObjIters * iters)
+{
+  edge_index_remove (&layer_edges->index, iters->trackelement,
+      GES_EDGE_START, iters->start);
+  edge_index_remove (&layer_edges->index, iters->trackelement, GES_EDGE_END,
+      iters->end);
+  if (layer_edges->index.edges->len == 0)
+    layer_edges->max_duration = 0;
+  layer_edges_mark_dirty (layer_edges, iters->start, iters->end);
+  iters->layer_edges = NULL;
+}
+
 static void
 timeline_update_duration (GESTimeline * timeline)
 {
-  GstClockTime *cduration;
-  GSequenceIter *it = g_sequence_get_end_iter (timeline->priv->starts_ends);
+  GstClockTime duration;
+  GESTimelinePrivate *priv = timeline->priv;
 
-  it = g_sequence_iter_prev (it);
+  /* Notified once the transaction is over */
+  if (priv->edit_depth)
+    return;
 
-  if (g_sequence_iter_is_end (it)) {
-    timeline->priv->duration = 0;
+  if (priv->edges.edges->len == 0) {
+    priv->duration = 0;
     g_object_notify_by_pspec (G_OBJECT (timeline), properties[PROP_DURATION]);
     return;
   }
 
-  cduration = g_sequence_get (it);
+  if (priv->edges.unsorted)
+    duration = priv->edges.max_timecode;
+  else
+    duration = g_array_index (priv->edges.edges, TimelineEdge,
+        priv->edges.edges->len - 1).timecode;
 
-  if (cduration && timeline->priv->duration != *cduration) {
+  if (priv->duration != duration) {
     GST_DEBUG ("track duration : %" GST_TIME_FORMAT " current : %"
-        GST_TIME_FORMAT, GST_TIME_ARGS (*cduration),
-        GST_TIME_ARGS (timeline->priv->duration));
+        GST_TIME_FORMAT, GST_TIME_ARGS (duration),
+        GST_TIME_ARGS (priv->duration));
 
-    timeline->priv->duration = *cduration;
+    priv->duration = duration;
 
     g_object_notify_by_pspec (G_OBJECT (timeline), properties[PROP_DURATION]);
   }
@@ -789,24 +1117,6 @@ find_layer_by_prio (GESLayer * a, gpointer pprio)
   return 0;
 }
 
-static void
-sort_track_elements (GESTimeline * timeline, TrackObjIters * iters)
-{
-  g_sequence_sort_changed (iters->iter_obj,
-      (GCompareDataFunc) element_start_compare, NULL);
-}
-
-static gint
-compare_uint64 (guint64 * a, guint64 * b, gpointer user_data)
-{
-  if (*a > *b)
-    return 1;
-  else if (*a == *b)
-    return 0;
-  else
-    return -1;
-}
-
 static gint
 custom_find_track (TrackPrivate * tr_priv, GESTrack * track)
 {
@@ -815,32 +1125,185 @@ custom_find_track (TrackPrivate * tr_priv, GESTrack * track)
   return -1;
 }
 
-static inline void
-sort_starts_ends_end (GESTimeline * timeline, TrackObjIters * iters)
+/* Layer where @element lands, %NULL if the timeline does not control it */
+static GESLayer *
+timeline_get_element_layer (GESTimeline * timeline, TrackObjIters * iters)
 {
-  GESTimelineElement *obj = GES_TIMELINE_ELEMENT (iters->trackelement);
-  GESTimelinePrivate *priv = timeline->priv;
-  guint64 *end = g_hash_table_lookup (priv->by_end, obj);
+  GList *layer_node;
+  guint32 prio = _ges_track_element_get_layer_priority (iters->trackelement);
 
-  *end = _START (obj) + _DURATION (obj);
+  if (iters->layer && ges_layer_get_priority (iters->layer) == prio)
+    return iters->layer;
 
-  g_sequence_sort_changed (iters->iter_end, (GCompareDataFunc) compare_uint64,
-      NULL);
-  timeline_update_duration (timeline);
+  layer_node = g_list_find_custom (timeline->layers, GINT_TO_POINTER (prio),
+      (GCompareFunc) find_layer_by_prio);
+
+  return layer_node ? layer_node->data : NULL;
 }
 
 static inline void
-sort_starts_ends_start (GESTimeline * timeline, TrackObjIters * iters)
+sequence_detach (GSequence * detached, GSequenceIter * iter)
+{
+  g_sequence_move_range (g_sequence_get_end_iter (detached), iter,
+      g_sequence_iter_next (iter));
+}
+
+/* Moves @iter to its place in @sequence, which must not contain it */
+static inline void
+sequence_attach_sorted (GSequence * sequence, GSequenceIter * iter)
+{
+  g_sequence_move_range (g_sequence_search (sequence, g_sequence_get (iter),
+          (GCompareDataFunc) element_start_compare, NULL), iter,
+      g_sequence_iter_next (iter));
+}
+
+/* An edges index is fixed up in one pass and sorted again when more than
+ * 1 in EDGE_INDEX_RETIME_RATIO of its edges moved, instead of moving the
+ * edges one by one */
+#define EDGE_INDEX_RETIME_RATIO 16
+
+/* Updates the indexes for all the elements that changed since the last
+ * call, so that they can be queried again */
+static void
+timeline_flush_edits (GESTimeline * timeline)
 {
-  GESTimelineElement *obj = GES_TIMELINE_ELEMENT (iters->trackelement);
+  guint i, n_sources = 0;
+  gboolean retime_edges;
+  GPtrArray *retimed;
   GESTimelinePrivate *priv = timeline->priv;
-  guint64 *start = g_hash_table_lookup (priv->by_start, obj);
+  GPtrArray *pending = priv->pending_iters;
 
-  *start = _START (obj);
+  if (pending->len == 0)
+    return;
 
-  g_sequence_sort_changed (iters->iter_start,
-      (GCompareDataFunc) compare_uint64, NULL);
-  timeline_update_duration (timeline);
+  GST_DEBUG_OBJECT (timeline, "Reindexing %u track elements", pending->len);
+
+  /* 1- Take the elements out of the sequences, so that the other ones stay
+   * sorted while we put them back, and handle layer changes */
+  for (i = 0; i < pending->len; i++) {
+    TrackObjIters *iters = g_ptr_array_index (pending, i);
+    GESLayer *layer = timeline_get_element_layer (timeline, iters);
+
+    if (iters->iter_by_layer)
+      sequence_detach (priv->detached, iters->iter_by_layer);
+    if (iters->iter_obj)
+      sequence_detach (priv->detached, iters->iter_obj);
+
+    if (layer != iters->layer) {
+      GST_DEBUG_OBJECT (iters->trackelement, "Moved from layer %"
+          GST_PTR_FORMAT " to %" GST_PTR_FORMAT, iters->layer, layer);
+
+      /* Added back to the edges of its new layer once they are updated */
+      if (iters->layer_edges)
+        layer_edges_remove_source (iters->layer_edges, iters);
+      iters->layer = layer;
+
+      if (G_UNLIKELY (layer == NULL)) {
+        GST_ERROR_OBJECT (timeline, "Changing a TrackElement prio, which"
+            " would not land in no layer we are controlling");
+        if (iters->iter_by_layer)
+          g_sequence_remove (iters->iter_by_layer);
+        iters->iter_by_layer = NULL;
+      }
+    }
+
+    if (iters->iter_obj) {
+      n_sources++;
+      if (iters->layer_edges)
+        iters->layer_edges->n_moved++;
+    }
+  }
+
+  /* 2- Move the edges of the sources */
+  retimed = g_ptr_array_new ();
+  retime_edges =
+      n_sources * EDGE_INDEX_RETIME_RATIO > priv->edges.edges->len;
+  for (i = 0; i < pending->len; i++) {
+    TrackObjIters *iters = g_ptr_array_index (pending, i);
+    GESTrackElement *element = iters->trackelement;
+    LayerEdges *layer_edges = iters->layer_edges;
+    GstClockTime start = _START (element);
+    GstClockTime end = start + _DURATION (element);
+
+    if (!iters->iter_obj)
+      continue;
+
+    if (!retime_edges) {
+      edge_index_move (&priv->edges, element, GES_EDGE_START, iters->start,
+          start);
+      edge_index_move (&priv->edges, element, GES_EDGE_END, iters->end, end);
+    }
+
+    if (layer_edges) {
+      if (layer_edges->n_moved * EDGE_INDEX_RETIME_RATIO <=
+          layer_edges->index.edges->len) {
+        edge_index_move (&layer_edges->index, element, GES_EDGE_START,
+            iters->start, start);
+        edge_index_move (&layer_edges->index, element, GES_EDGE_END,
+            iters->end, end);
+      } else if (!layer_edges->retime) {
+        layer_edges->retime = TRUE;
+        g_ptr_array_add (retimed, layer_edges);
+      }
+
+      if (end > start)
+        layer_edges->max_duration = MAX (layer_edges->max_duration,
+            end - start);
+      layer_edges_mark_dirty (layer_edges, MIN (iters->start, start),
+          MAX (iters->end, end));
+    }
+
+    iters->start = start;
+    iters->end = end;
+  }
+
+  if (retime_edges)
+    edge_index_retime (&priv->edges, priv->obj_iters);
+  for (i = 0; i < retimed->len; i++) {
+    LayerEdges *layer_edges = g_ptr_array_index (retimed, i);
+
+    edge_index_retime (&layer_edges->index, priv->obj_iters);
+    layer_edges->retime = FALSE;
+  }
+  g_ptr_array_free (retimed, TRUE);
+
+  /* 3- Put the elements back in place */
+  for (i = 0; i < pending->len; i++) {
+    TrackObjIters *iters = g_ptr_array_index (pending, i);
+
+    if (iters->layer) {
+      GSequence *by_layer_sequence =
+          g_hash_table_lookup (priv->by_layer, iters->layer);
+
+      if (iters->iter_by_layer)
+        sequence_attach_sorted (by_layer_sequence, iters->iter_by_layer);
+      else
+        iters->iter_by_layer = g_sequence_insert_sorted (by_layer_sequence,
+            iters->trackelement, (GCompareDataFunc) element_start_compare,
+            NULL);
+    }
+
+    if (iters->iter_obj) {
+      sequence_attach_sorted (priv->tracksources, iters->iter_obj);
+
+      if (!iters->layer_edges) {
+        LayerEdges *layer_edges = timeline_get_layer_edges (timeline,
+            iters->layer, ges_track_element_get_track (iters->trackelement));
+
+        if (layer_edges)
+          layer_edges_add_source (layer_edges, iters);
+      }
+
+      if (iters->layer_edges)
+        iters->layer_edges->n_moved = 0;
+    }
+
+    iters->pending = FALSE;
+  }
+  g_ptr_array_set_size (pending, 0);
+
+  if (n_sources)
+    timeline_update_duration (timeline);
 }
 
 static void
@@ -929,7 +1392,7 @@ _find_transition_from_auto_transitions (GESTimeline * timeline,
     if (auto_trans->previous_source == prev || auto_trans->next_source == next) {
       if (auto_trans->previous_source != prev
           || auto_trans->next_source != next) {
-        timeline->priv->needs_rollback = TRUE;
+        timeline->priv->edit_failed = TRUE;
         GST_INFO_OBJECT (timeline, "Failed creating auto transition, "
             " trying to have 3 clips overlapping, rolling back");
       }
@@ -989,84 +1452,81 @@ _create_auto_transition_from_transitions (GESTimeline * timeline,
   return NULL;
 }
 
-/* Create all transition that do not exist on @layer.
+/* Create all transitions that do not exist between the sources of
+ * @layer_edges whose overlap starts in [@start, @end].
  * @get_auto_transition is called to check if a particular transition exists.
- * If @track is specified, we will create the transitions only for that particular
- * track. */
+ * Once transitions have been checked all over its dirty range, @layer_edges
+ * is marked as clean. */
 static void
-_create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
-    GESTrack * track, GESTrackElement * initiating_obj,
+_create_transitions_in_range (GESTimeline * timeline, GESLayer * layer,
+    LayerEdges * layer_edges, GstClockTime start, GstClockTime end,
     GetAutoTransitionFunc get_auto_transition)
 {
-  guint32 layer_prio;
-  GSequenceIter *iter;
+  guint i;
+  TimelineEdge first;
   GESAutoTransition *transition;
   GESContainer *toplevel_next;
   MoveContext *mv_ctx = &timeline->priv->movecontext;
-  GESTrack *ctrack = track;
-  GList *entered = NULL;        /* List of TrackElement for wich we walk through the
-                                 * "start" but not the "end" in the starts_ends list */
-  GESTimelinePrivate *priv = timeline->priv;
-
-  if (!layer || !ges_layer_get_auto_transition (layer))
-    return;
-
-  layer_prio = ges_layer_get_priority (layer);
-  for (iter = g_sequence_get_begin_iter (priv->starts_ends);
-      iter && !g_sequence_iter_is_end (iter);
-      iter = g_sequence_iter_next (iter)) {
-    GList *tmp;
-    guint *start_or_end = g_sequence_get (iter);
-    GESTrackElement *next = g_hash_table_lookup (timeline->priv->by_object,
-        start_or_end);
+  GESTrack *track = layer_edges->track;
+  GstClockTime dirty_start, dirty_end;
+  gboolean complete = TRUE;
+  GPtrArray *entered;           /* TrackElement-s for wich we walked through the
+                                 * "start" but not the "end" */
+
+  timeline_flush_edits (timeline);
+  dirty_start = layer_edges->dirty_start;
+  dirty_end = layer_edges->dirty_end;
+
+  /* Sources overlapping @start can not start before that */
+  first.timecode = start > layer_edges->max_duration ?
+      start - layer_edges->max_duration : 0;
+  first.element = NULL;
+  first.edge = GES_EDGE_START;
+
+  entered = g_ptr_array_new ();
+  edge_index_ensure_sorted (&layer_edges->index);
+  for (i = edge_index_lower_bound (&layer_edges->index, &first);
+      i < layer_edges->index.edges->len; i++) {
+    guint j;
+    /* Copy as creating transitions could modify the array */
+    TimelineEdge edge = g_array_index (layer_edges->index.edges,
+        TimelineEdge, i);
+    GESTrackElement *next = edge.element;
     GESContainer *toplevel =
         get_toplevel_container (GES_TIMELINE_ELEMENT (next));
 
-    /* Only object that are in that layer and track */
-    if (_ges_track_element_get_layer_priority (next) != layer_prio ||
-        (track && track != ges_track_element_get_track (next)))
-      continue;
-
-    if (track == NULL)
-      ctrack = ges_track_element_get_track (next);
+    if (edge.timecode > end)
+      break;
 
-    if (start_or_end == g_hash_table_lookup (priv->by_end, next)) {
-      if (initiating_obj == next) {
-        /* We passed the objects that initiated the research
-         * we are now done */
-        g_list_free (entered);
-        return;
-      }
-      entered = g_list_remove (entered, next);
+    if (edge.edge == GES_EDGE_END) {
+      g_ptr_array_remove (entered, next);
 
       continue;
     }
 
     toplevel_next = get_toplevel_container (next);
-    for (tmp = entered; tmp; tmp = tmp->next) {
+    for (j = 0; edge.timecode >= start && j < entered->len; j++) {
       gint64 transition_duration;
-      GESTrackElement *prev = tmp->data;
+      GESTrackElement *prev = g_ptr_array_index (entered, j);
       GESContainer *toplevel_prev = get_toplevel_container (prev);
 
-      /* If we are not in the same track, we do not create a transition */
-      if (ctrack != ges_track_element_get_track (prev))
-        continue;
-
       /* If elements are in the same toplevel element, we do not create a transition */
       if (get_toplevel_container (GES_TIMELINE_ELEMENT (prev)) == toplevel)
         continue;
 
       /* If the element is inside a container we are moving, we do not
-       * create a transition */
+       * create a transition, and will need to check again later */
       if (g_hash_table_lookup (mv_ctx->toplevel_containers, toplevel_prev) &&
-          g_hash_table_lookup (mv_ctx->toplevel_containers, toplevel_next))
+          g_hash_table_lookup (mv_ctx->toplevel_containers, toplevel_next)) {
+        complete = FALSE;
         continue;
+      }
 
       transition_duration = (_START (prev) + _DURATION (prev)) - _START (next);
       if (transition_duration > 0 && transition_duration < _DURATION (prev) &&
           transition_duration < _DURATION (next)) {
         transition =
-            get_auto_transition (timeline, layer, ctrack, prev, next,
+            get_auto_transition (timeline, layer, track, prev, next,
             transition_duration);
         if (!transition)
           create_transition (timeline, prev, next, NULL, layer,
@@ -1076,25 +1536,74 @@ _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
 
     /* And add that object to the entered list so that it we can possibly set
      * a transition on its end edge */
-    entered = g_list_append (entered, next);
+    g_ptr_array_add (entered, next);
+  }
+  g_ptr_array_free (entered, TRUE);
+
+  /* Shrink the dirty range if we went through its beginning and nothing
+   * changed meanwhile */
+  if (complete && start <= dirty_start &&
+      layer_edges->dirty_start == dirty_start &&
+      layer_edges->dirty_end == dirty_end) {
+    if (end >= dirty_end) {
+      layer_edges->dirty_start = GST_CLOCK_TIME_NONE;
+      layer_edges->dirty_end = 0;
+    } else if (end >= dirty_start) {
+      layer_edges->dirty_start = end + 1;
+    }
   }
 }
 
+/* Create all transition that do not exist on @layer.
+ * @get_auto_transition is called to check if a particular transition exists.
+ * If @full is %FALSE, only the ranges where sources changed since the last
+ * time are checked. */
+static void
+_create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
+    gboolean full, GetAutoTransitionFunc get_auto_transition)
+{
+  GList *tmp, *layer_edges;
+  GHashTable *by_track;
+
+  if (!layer || !ges_layer_get_auto_transition (layer))
+    return;
+
+  timeline_flush_edits (timeline);
+  by_track = g_hash_table_lookup (timeline->priv->layer_edges, layer);
+  if (!by_track)
+    return;
+
+  layer_edges = g_hash_table_get_values (by_track);
+  for (tmp = layer_edges; tmp; tmp = tmp->next) {
+    LayerEdges *edges = tmp->data;
+
+    if (full)
+      _create_transitions_in_range (timeline, layer, edges, 0,
+          G_MAXUINT64, get_auto_transition);
+    else if (edges->dirty_start <= edges->dirty_end)
+      _create_transitions_in_range (timeline, layer, edges,
+          edges->dirty_start, edges->dirty_end, get_auto_transition);
+  }
+  g_list_free (layer_edges);
+}
+
 /* @track_element must be a GESSource */
 void
 timeline_create_transitions (GESTimeline * timeline,
     GESTrackElement * track_element)
 {
-  GESTrack *track;
-  GList *layer_node;
+  TrackObjIters *iters;
+  LayerEdges *layer_edges;
 
   GESTimelinePrivate *priv = timeline->priv;
   MoveContext *mv_ctx = &timeline->priv->movecontext;
 
-  if (!priv->needs_transitions_update)
+  /* Transitions are created for all the changes once the transaction is
+   * over */
+  if (!priv->needs_transitions_update || priv->edit_depth)
     return;
 
-  if (mv_ctx->moving_trackelements &&
+  if (mv_ctx->moving_trackelements->len &&
       GES_TIMELINE_ELEMENT_START (track_element) > mv_ctx->start) {
     GST_DEBUG_OBJECT (timeline, "Not creating transition around %"
         GES_TIMELINE_ELEMENT_FORMAT " as it is not the first rippled"
@@ -1102,13 +1611,16 @@ timeline_create_transitions (GESTimeline * timeline,
     return;
   }
 
-  track = ges_track_element_get_track (track_element);
-  layer_node = g_list_find_custom (timeline->layers,
-      GINT_TO_POINTER (_ges_track_element_get_layer_priority (track_element)),
-      (GCompareFunc) find_layer_by_prio);
+  iters = g_hash_table_lookup (priv->obj_iters, track_element);
+  layer_edges = iters ? iters->layer_edges : NULL;
+  if (!layer_edges || !ges_layer_get_auto_transition (iters->layer))
+    return;
 
-  _create_transitions_on_layer (timeline,
-      layer_node ? layer_node->data : NULL, track, track_element,
+  /* Also go through what changed before @track_element and did not get
+   * its transitions yet */
+  _create_transitions_in_range (timeline, iters->layer, layer_edges,
+      MIN (layer_edges->dirty_start, _START (track_element)),
+      _START (track_element) + _DURATION (track_element),
       _find_transition_from_auto_transitions);
 
   GST_DEBUG_OBJECT (timeline, "Done updating transitions");
@@ -1118,25 +1630,33 @@ timeline_create_transitions (GESTimeline * timeline,
 static inline void
 init_movecontext (MoveContext * mv_ctx, gboolean first_init)
 {
-  if (G_UNLIKELY (first_init))
+  if (G_UNLIKELY (first_init)) {
     mv_ctx->toplevel_containers =
         g_hash_table_new (g_direct_hash, g_direct_equal);
+    mv_ctx->moving_trackelements = g_ptr_array_new ();
+    mv_ctx->moving_toplevels = g_ptr_array_new ();
+  }
 
-  mv_ctx->moving_trackelements = NULL;
   mv_ctx->start = G_MAXUINT64;
   mv_ctx->max_trim_pos = G_MAXUINT64;
   mv_ctx->min_move_layer = G_MAXUINT;
   mv_ctx->max_layer_prio = 0;
   mv_ctx->last_snaped1 = NULL;
   mv_ctx->last_snaped2 = NULL;
-  mv_ctx->last_snap_ts = NULL;
+  mv_ctx->last_snap_ts = GST_CLOCK_TIME_NONE;
   mv_ctx->moving_to_layer = NULL;
 }
 
 static inline void
 clean_movecontext (MoveContext * mv_ctx)
 {
-  g_list_free (mv_ctx->moving_trackelements);
+  guint i;
+
+  for (i = 0; i < mv_ctx->moving_trackelements->len; i++)
+    ((TrackObjIters *) g_ptr_array_index (mv_ctx->moving_trackelements,
+            i))->moving = FALSE;
+  g_ptr_array_set_size (mv_ctx->moving_trackelements, 0);
+  g_ptr_array_set_size (mv_ctx->moving_toplevels, 0);
   g_hash_table_remove_all (mv_ctx->toplevel_containers);
   init_movecontext (mv_ctx, FALSE);
 }
@@ -1145,11 +1665,20 @@ static void
 stop_tracking_track_element (GESTimeline * timeline,
     GESTrackElement * trackelement)
 {
-  guint64 *start, *end;
   TrackObjIters *iters;
   GESTimelinePrivate *priv = timeline->priv;
 
   iters = g_hash_table_lookup (priv->obj_iters, trackelement);
+  if (iters->pending)
+    g_ptr_array_remove_fast (priv->pending_iters, iters);
+  if (iters->edited)
+    g_ptr_array_remove_fast (priv->edited_iters, iters);
+  if (iters->moving) {
+    g_ptr_array_remove (priv->movecontext.moving_trackelements, iters);
+    g_ptr_array_remove (priv->movecontext.moving_toplevels, iters);
+    priv->movecontext.needs_move_ctx = TRUE;
+  }
+
   if (G_LIKELY (iters->iter_by_layer)) {
     g_sequence_remove (iters->iter_by_layer);
   } else {
@@ -1158,15 +1687,11 @@ stop_tracking_track_element (GESTimeline * timeline,
   }
 
   if (GES_IS_SOURCE (trackelement)) {
-    start = g_hash_table_lookup (priv->by_start, trackelement);
-    end = g_hash_table_lookup (priv->by_end, trackelement);
-
-    g_hash_table_remove (priv->by_start, trackelement);
-    g_hash_table_remove (priv->by_end, trackelement);
-    g_hash_table_remove (priv->by_object, end);
-    g_hash_table_remove (priv->by_object, start);
-    g_sequence_remove (iters->iter_start);
-    g_sequence_remove (iters->iter_end);
+    edge_index_remove (&priv->edges, trackelement, GES_EDGE_START,
+        iters->start);
+    edge_index_remove (&priv->edges, trackelement, GES_EDGE_END, iters->end);
+    if (iters->layer_edges)
+      layer_edges_remove_source (iters->layer_edges, iters);
     g_sequence_remove (iters->iter_obj);
     timeline_update_duration (timeline);
   }
@@ -1177,17 +1702,19 @@ static void
 start_tracking_track_element (GESTimeline * timeline,
     GESTrackElement * trackelement)
 {
-  guint64 *pstart, *pend;
   GSequence *by_layer_sequence;
+  LayerEdges *layer_edges;
   TrackObjIters *iters;
   GESTimelinePrivate *priv = timeline->priv;
 
-  guint layer_prio = _ges_track_element_get_layer_priority (trackelement);
-  GList *layer_node = g_list_find_custom (timeline->layers,
-      GINT_TO_POINTER (layer_prio), (GCompareFunc) find_layer_by_prio);
-  GESLayer *layer = layer_node ? layer_node->data : NULL;
+  GESLayer *layer;
 
   iters = g_slice_new0 (TrackObjIters);
+  iters->trackelement = trackelement;
+  iters->known_start = _START (trackelement);
+  iters->known_inpoint = _INPOINT (trackelement);
+  iters->known_duration = _DURATION (trackelement);
+  layer = timeline_get_element_layer (timeline, iters);
 
   /* We add all TrackElement to obj_iters as we always follow them
    * in the by_layer Sequences */
@@ -1214,48 +1741,141 @@ start_tracking_track_element (GESTimeline * timeline,
 
   if (GES_IS_SOURCE (trackelement)) {
     /* Track only sources for timeline edition and snapping */
-    pstart = g_malloc (sizeof (guint64));
-    pend = g_malloc (sizeof (guint64));
-    *pstart = _START (trackelement);
-    *pend = *pstart + _DURATION (trackelement);
-
-    iters->iter_start = g_sequence_insert_sorted (priv->starts_ends, pstart,
-        (GCompareDataFunc) compare_uint64, NULL);
-    iters->iter_end = g_sequence_insert_sorted (priv->starts_ends, pend,
-        (GCompareDataFunc) compare_uint64, NULL);
+    iters->start = _START (trackelement);
+    iters->end = iters->start + _DURATION (trackelement);
+
+    edge_index_add (&priv->edges, trackelement, GES_EDGE_START, iters->start);
+    edge_index_add (&priv->edges, trackelement, GES_EDGE_END, iters->end);
     iters->iter_obj =
         g_sequence_insert_sorted (priv->tracksources,
         gst_object_ref (trackelement), (GCompareDataFunc) element_start_compare,
         NULL);
-    iters->trackelement = trackelement;
 
-    g_hash_table_insert (priv->by_start, trackelement, pstart);
-    g_hash_table_insert (priv->by_object, pstart, trackelement);
-    g_hash_table_insert (priv->by_end, trackelement, pend);
-    g_hash_table_insert (priv->by_object, pend, trackelement);
+    layer_edges = timeline_get_layer_edges (timeline, layer,
+        ges_track_element_get_track (trackelement));
+    if (layer_edges)
+      layer_edges_add_source (layer_edges, iters);
 
     timeline->priv->movecontext.needs_move_ctx = TRUE;
 
     timeline_update_duration (timeline);
     timeline_create_transitions (timeline, trackelement);
   }
+
+  /* The sequences might not be sorted around the elements that already
+   * changed, put it back in place with them */
+  if (priv->edit_depth) {
+    iters->pending = TRUE;
+    g_ptr_array_add (priv->pending_iters, iters);
+  }
+}
+
+/* Keeps the timings of the source known before each change so that the
+ * edit transaction can be rolled back */
+static void
+track_element_record_timings (GESTimeline * timeline, TrackObjIters * iters)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+  GESTimelineElement *element = GES_TIMELINE_ELEMENT (iters->trackelement);
+
+  if (priv->edit_depth && !iters->edited) {
+    iters->edited = TRUE;
+    iters->saved_start = iters->known_start;
+    iters->saved_inpoint = iters->known_inpoint;
+    iters->saved_duration = iters->known_duration;
+    g_ptr_array_add (priv->edited_iters, iters);
+  }
+
+  iters->known_start = _START (element);
+  iters->known_inpoint = _INPOINT (element);
+  iters->known_duration = _DURATION (element);
+}
+
+/* Reindexes the element right away, or once needed during transactions */
+static void
+track_element_changed (GESTimeline * timeline, TrackObjIters * iters)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+
+  if (!iters->pending) {
+    iters->pending = TRUE;
+    g_ptr_array_add (priv->pending_iters, iters);
+  }
+
+  if (!priv->edit_depth)
+    timeline_flush_edits (timeline);
+}
+
+/* Puts back the clips moved by the transaction in their layers and the
+ * sources at their positions */
+static void
+timeline_restore_edits (GESTimeline * timeline)
+{
+  guint i;
+  GHashTableIter iter;
+  GESClip *clip;
+  GESLayer *layer;
+  GESTimelinePrivate *priv = timeline->priv;
+  GHashTable *edited_layers = priv->edited_layers;
+
+  priv->edited_layers = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      gst_object_unref, gst_object_unref);
+
+  g_hash_table_iter_init (&iter, edited_layers);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & clip,
+          (gpointer *) & layer)) {
+    GESLayer *current_layer = ges_clip_get_layer (clip);
+
+    if (current_layer && current_layer != layer &&
+        ges_layer_get_timeline (layer) == timeline) {
+      priv->movecontext.moving_to_layer = layer;
+      ges_clip_move_to_layer (clip, layer);
+    }
+    if (current_layer)
+      gst_object_unref (current_layer);
+  }
+  priv->movecontext.moving_to_layer = NULL;
+  g_hash_table_unref (edited_layers);
+
+  /* Restoring can record more sources, which do not need to move */
+  for (i = 0; i < priv->edited_iters->len; i++) {
+    TrackObjIters *iters = g_ptr_array_index (priv->edited_iters, i);
+    GESTimelineElement *element = GES_TIMELINE_ELEMENT (iters->trackelement);
+
+    _set_start0 (element, iters->saved_start);
+    _set_inpoint0 (element, iters->saved_inpoint);
+    _set_duration0 (element, iters->saved_duration);
+  }
+}
+
+static void
+timeline_clear_edits (GESTimeline * timeline)
+{
+  guint i;
+  GESTimelinePrivate *priv = timeline->priv;
+
+  for (i = 0; i < priv->edited_iters->len; i++) {
+    TrackObjIters *iters = g_ptr_array_index (priv->edited_iters, i);
+
+    iters->edited = FALSE;
+  }
+  g_ptr_array_set_size (priv->edited_iters, 0);
+  g_hash_table_remove_all (priv->edited_layers);
 }
 
 static inline void
 ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
-    guint64 * timecode)
+    const TimelineEdge * snapped)
 {
-  GESTrackElement *obj2;
   MoveContext *mv_ctx = &timeline->priv->movecontext;
-  GstClockTime snap_time = timecode ? *timecode : 0;
-  GstClockTime last_snap_ts = mv_ctx->last_snap_ts ?
-      *mv_ctx->last_snap_ts : GST_CLOCK_TIME_NONE;
+  GstClockTime snap_time = snapped ? snapped->timecode : 0;
+  GstClockTime last_snap_ts = mv_ctx->last_snap_ts;
 
   GST_DEBUG_OBJECT (timeline, "Distance: %" GST_TIME_FORMAT " snapping at %"
       GST_TIME_FORMAT, GST_TIME_ARGS (timeline->priv->snapping_distance),
       GST_TIME_ARGS (snap_time));
 
-  if (timecode == NULL) {
+  if (snapped == NULL) {
     if (mv_ctx->last_snaped1 != NULL && mv_ctx->last_snaped2 != NULL) {
       g_signal_emit (timeline, ges_timeline_signals[SNAPING_ENDED], 0,
           mv_ctx->last_snaped1, mv_ctx->last_snaped2, last_snap_ts);
@@ -1267,57 +1887,60 @@ ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
     return;
   }
 
-  obj2 = g_hash_table_lookup (timeline->priv->by_object, timecode);
-
-  if (last_snap_ts != *timecode) {
+  if (last_snap_ts != snapped->timecode) {
     g_signal_emit (timeline, ges_timeline_signals[SNAPING_ENDED], 0,
         mv_ctx->last_snaped1, mv_ctx->last_snaped2, (last_snap_ts));
 
     /* We want the snap start signal to be emited anyway */
-    mv_ctx->last_snap_ts = NULL;
+    mv_ctx->last_snap_ts = GST_CLOCK_TIME_NONE;
   }
 
-  if (mv_ctx->last_snap_ts == NULL) {
+  if (!GST_CLOCK_TIME_IS_VALID (mv_ctx->last_snap_ts)) {
 
     mv_ctx->last_snaped1 = obj1;
-    mv_ctx->last_snaped2 = obj2;
-    mv_ctx->last_snap_ts = timecode;
+    mv_ctx->last_snaped2 = snapped->element;
+    mv_ctx->last_snap_ts = snapped->timecode;
 
     g_signal_emit (timeline, ges_timeline_signals[SNAPING_STARTED], 0,
-        obj1, obj2, *timecode);
+        obj1, snapped->element, snapped->timecode);
 
   }
 }
 
-static GstClockTime *
+/* Returns %TRUE if @timecode snaps with an edge of another source, in which
+ * case @snapped is set to a copy of that edge */
+static gboolean
 ges_timeline_snap_position (GESTimeline * timeline,
-    GESTrackElement * trackelement, GstClockTime * current,
-    GstClockTime timecode, gboolean emit)
+    GESTrackElement * trackelement, GstClockTime timecode,
+    TimelineEdge * snapped, gboolean emit)
 {
+  guint i, end;
   GESTimelinePrivate *priv = timeline->priv;
-  GSequenceIter *iter, *end_iter;
   GESContainer *container = get_toplevel_container (trackelement);
-  GstClockTime *ret = NULL;
+  TimelineEdge *edges, *ret = NULL;
   GstClockTime smallest_offset = G_MAXUINT64;
   GstClockTime tmp_pos;
 
+  /* Nothing can snap, avoid updating the indexes in the middle of a
+   * transaction */
+  if (priv->snapping_distance == 0)
+    goto done;
+
+  timeline_flush_edits (timeline);
+  edge_index_ensure_sorted (&priv->edges);
+  edges = (TimelineEdge *) priv->edges.edges->data;
+
   tmp_pos = timecode - priv->snapping_distance;
   /* Rippling, not snapping with previous elements */
-  if (priv->movecontext.moving_trackelements)
+  if (priv->movecontext.moving_trackelements->len)
     tmp_pos = timecode;
-  iter = g_sequence_search (priv->starts_ends, &tmp_pos,
-      (GCompareDataFunc) compare_uint64, NULL);
+  i = edge_index_upper_bound (&priv->edges, tmp_pos);
 
   tmp_pos = timecode + priv->snapping_distance;
-  end_iter = g_sequence_search (priv->starts_ends, &tmp_pos,
-      (GCompareDataFunc) compare_uint64, NULL);
-
-  for (; iter != end_iter && !g_sequence_iter_is_end (iter);
-      iter = g_sequence_iter_next (iter)) {
-    GstClockTime *iter_tc = g_sequence_get (iter);
-    GESTrackElement *tmp_trackelement =
-        g_hash_table_lookup (priv->by_object, iter_tc);
-    GESContainer *tmp_container = get_toplevel_container (tmp_trackelement);
+  end = edge_index_upper_bound (&priv->edges, tmp_pos);
+
+  for (; i < end; i++) {
+    GESContainer *tmp_container = get_toplevel_container (edges[i].element);
     GstClockTimeDiff diff;
 
     if (tmp_container == container)
@@ -1327,33 +1950,35 @@ ges_timeline_snap_position (GESTimeline * timeline,
             tmp_container))
       continue;
 
-    if (timecode > *iter_tc)
-      diff = timecode - *iter_tc;
+    if (timecode > edges[i].timecode)
+      diff = timecode - edges[i].timecode;
     else
-      diff = *iter_tc - timecode;
+      diff = edges[i].timecode - timecode;
 
     if (diff > smallest_offset)
       break;
 
     smallest_offset = diff;
-    ret = iter_tc;
+    ret = &edges[i];
   }
 
+  /* Copy before emitting as signal handlers could modify the edges */
+  if (ret)
+    *snapped = *ret;
+
+done:
   /* We emit the snapping signal only if we snapped with a different value
    * than the current one */
   if (emit) {
-    GstClockTime snap_time = ret ? *ret : GST_CLOCK_TIME_NONE;
+    GstClockTime snap_time = ret ? snapped->timecode : GST_CLOCK_TIME_NONE;
 
-    if (!timeline->priv->needs_rollback)
-      ges_timeline_emit_snappig (timeline, trackelement, ret);
-    else
-      ges_timeline_emit_snappig (timeline, trackelement, NULL);
+    ges_timeline_emit_snappig (timeline, trackelement, ret ? snapped : NULL);
 
     GST_DEBUG_OBJECT (timeline, "Snaping at %" GST_TIME_FORMAT,
         GST_TIME_ARGS (snap_time));
   }
 
-  return ret;
+  return ret != NULL;
 }
 
 static inline GESContainer *
@@ -1392,6 +2017,25 @@ add_toplevel_container (MoveContext * mv_ctx, GESTrackElement * trackelement)
   return toplevel;
 }
 
+/* Adds @iters to the moving elements, they need to be added by increasing
+ * start. When rippling, their toplevel containers are all moved together */
+static void
+move_context_add_moving (MoveContext * mv_ctx, TrackObjIters * iters)
+{
+  guint n_toplevels;
+
+  iters->moving = TRUE;
+  g_ptr_array_add (mv_ctx->moving_trackelements, iters);
+
+  if (mv_ctx->mode != GES_EDIT_MODE_RIPPLE)
+    return;
+
+  n_toplevels = g_hash_table_size (mv_ctx->toplevel_containers);
+  add_toplevel_container (mv_ctx, iters->trackelement);
+  if (g_hash_table_size (mv_ctx->toplevel_containers) > n_toplevels)
+    g_ptr_array_add (mv_ctx->moving_toplevels, iters);
+}
+
 static gboolean
 ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
     GESEdge edge)
@@ -1401,8 +2045,11 @@ ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
   guint64 start, tmpend, moving_point = _START (obj);
   GSequenceIter *iter, *trackelement_iter, *tmpiter;
 
-  MoveContext *mv_ctx = &timeline->priv->movecontext;
-  iters = g_hash_table_lookup (timeline->priv->obj_iters, obj);
+  GESTimelinePrivate *priv = timeline->priv;
+  MoveContext *mv_ctx = &priv->movecontext;
+
+  timeline_flush_edits (timeline);
+  iters = g_hash_table_lookup (priv->obj_iters, obj);
   trackelement_iter = iters->iter_obj;
   switch (edge) {
     case GES_EDGE_START:
@@ -1411,13 +2058,9 @@ ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
       mv_ctx->min_trim_pos = 0;
       start = _START (obj);
 
-      if (g_sequence_iter_is_begin (trackelement_iter))
-        break;
-
       /* Look for the objects */
-      for (iter = g_sequence_iter_prev (trackelement_iter);
-          iter && !g_sequence_iter_is_end (iter);
-          iter = g_sequence_iter_prev (iter)) {
+      for (iter = g_sequence_get_begin_iter (priv->tracksources);
+          iter != trackelement_iter; iter = g_sequence_iter_next (iter)) {
 
         tmptrackelement = GES_TRACK_ELEMENT (g_sequence_get (iter));
         tmpend = _START (tmptrackelement) + _DURATION (tmptrackelement);
@@ -1428,13 +2071,9 @@ ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
               MAX (mv_ctx->max_trim_pos, _START (tmptrackelement));
           mv_ctx->min_trim_pos = MAX (mv_ctx->min_trim_pos,
               _START (tmptrackelement) - _INPOINT (tmptrackelement));
-          mv_ctx->moving_trackelements =
-              g_list_prepend (mv_ctx->moving_trackelements, tmptrackelement);
+          move_context_add_moving (mv_ctx,
+              g_hash_table_lookup (priv->obj_iters, tmptrackelement));
         }
-
-
-        if (g_sequence_iter_is_begin (iter))
-          break;
       }
       break;
 
@@ -1472,8 +2111,8 @@ ges_move_context_set_objects (GESTimeline * timeline, GESTrackElement * obj,
             GES_TIMELINE_ELEMENT_PARENT (obj)) {
           tmpend = _START (tmptrackelement) + _DURATION (tmptrackelement);
           mv_ctx->max_trim_pos = MIN (mv_ctx->max_trim_pos, tmpend);
-          mv_ctx->moving_trackelements =
-              g_list_prepend (mv_ctx->moving_trackelements, tmptrackelement);
+          move_context_add_moving (mv_ctx,
+              g_hash_table_lookup (priv->obj_iters, tmptrackelement));
         }
       }
       break;
@@ -1595,7 +2234,8 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
     GESTimelineElement * element, GList * layers, GESEdge edge,
     guint64 position, gboolean snapping)
 {
-  guint64 start, inpoint, duration, max_duration, *snapped, *cur;
+  guint64 start, inpoint, duration, max_duration;
+  TimelineEdge snapped;
   gboolean ret = TRUE;
   gint64 real_dur;
   GESTrackElement *track_element;
@@ -1646,12 +2286,9 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
       duration = _DURATION (track_element);
 
       if (snapping) {
-        cur = g_hash_table_lookup (timeline->priv->by_start, track_element);
-
-        snapped = ges_timeline_snap_position (timeline, track_element, cur,
-            position, TRUE);
-        if (snapped)
-          position = *snapped;
+        if (ges_timeline_snap_position (timeline, track_element, position,
+                &snapped, TRUE))
+          position = snapped.timecode;
       }
 
       /* Calculate new values */
@@ -1703,11 +2340,9 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
     }
     case GES_EDGE_END:
     {
-      cur = g_hash_table_lookup (timeline->priv->by_end, track_element);
-      snapped = ges_timeline_snap_position (timeline, track_element, cur,
-          position, TRUE);
-      if (snapped)
-        position = *snapped;
+      if (ges_timeline_snap_position (timeline, track_element, position,
+              &snapped, TRUE))
+        position = snapped.timecode;
 
       /* Calculate new values */
       real_dur = position - start;
@@ -1731,20 +2366,35 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
   return ret;
 }
 
+/* Returns the @i-th toplevel to move by @offset, going from the last one
+ * when moving forward so that the moved elements keep their order */
+static inline GESTrackElement *
+ripple_get_moving_toplevel (MoveContext * mv_ctx, guint i, gint64 offset)
+{
+  GPtrArray *moving = mv_ctx->moving_toplevels;
+
+  if (offset > 0)
+    i = moving->len - 1 - i;
+
+  return ((TrackObjIters *) g_ptr_array_index (moving, i))->trackelement;
+}
+
 gboolean
 timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
     GList * layers, GESEdge edge, guint64 position)
 {
-  GList *tmp, *moved_clips = NULL;
+  guint i;
   GESTrackElement *trackelement;
   GESContainer *container;
-  guint64 duration, new_start, *snapped, *cur;
+  guint64 duration;
+  TimelineEdge snapped;
   gint64 offset;
+  gboolean ret, needs_move_ctx;
 
   MoveContext *mv_ctx = &timeline->priv->movecontext;
 
   mv_ctx->ignore_needs_ctx = TRUE;
-  timeline->priv->needs_rollback = FALSE;
+  ges_timeline_begin_edit (timeline);
   if (!ges_timeline_set_moving_context (timeline, obj, GES_EDIT_MODE_RIPPLE,
           edge, layers))
     goto error;
@@ -1754,90 +2404,60 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       GST_DEBUG ("Simply rippling");
 
       /* We should be smart here to avoid recalculate transitions when possible */
-      cur = g_hash_table_lookup (timeline->priv->by_end, obj);
-      snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
-      if (snapped)
-        position = *snapped;
+      if (ges_timeline_snap_position (timeline, obj, position,
+              &snapped, TRUE))
+        position = snapped.timecode;
 
       offset = position - _START (obj);
+      needs_move_ctx = mv_ctx->needs_move_ctx;
 
-      for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-        trackelement = GES_TRACK_ELEMENT (tmp->data);
-        new_start = _START (trackelement) + offset;
-
-        container = add_toplevel_container (mv_ctx, trackelement);
-        /* Make sure not to move 2 times the same Clip */
-        if (g_list_find (moved_clips, container) == NULL) {
-          _set_start0 (GES_TIMELINE_ELEMENT (trackelement), new_start);
-          moved_clips = g_list_prepend (moved_clips, container);
-        }
+      for (i = 0; i < mv_ctx->moving_toplevels->len; i++) {
+        trackelement = ripple_get_moving_toplevel (mv_ctx, i, offset);
 
+        _set_start0 (GES_TIMELINE_ELEMENT (trackelement),
+            _START (trackelement) + offset);
       }
-      g_list_free (moved_clips);
       _set_start0 (GES_TIMELINE_ELEMENT (obj), position);
 
-      moved_clips = NULL;
-      if (timeline->priv->needs_rollback && !timeline->priv->rolling_back) {
-        timeline->priv->rolling_back = TRUE;
-        for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-          trackelement = GES_TRACK_ELEMENT (tmp->data);
-          new_start = _START (trackelement) - offset;
-
-          container = add_toplevel_container (mv_ctx, trackelement);
-          /* Make sure not to move 2 times the same Clip */
-          if (g_list_find (moved_clips, container) == NULL) {
-            _set_start0 (GES_TIMELINE_ELEMENT (trackelement), new_start);
-            moved_clips = g_list_prepend (moved_clips, container);
-          }
-
-        }
-        g_list_free (moved_clips);
-        moved_clips = NULL;
-        _set_start0 (GES_TIMELINE_ELEMENT (obj), position - offset);
-
-        ges_timeline_emit_snappig (timeline, obj, NULL);
-        mv_ctx->needs_move_ctx = TRUE;
-        timeline->priv->rolling_back = FALSE;
-
-        goto error;
-      }
+      /* Moving forward, the same elements follow @obj */
+      if (offset >= 0)
+        mv_ctx->needs_move_ctx = needs_move_ctx;
 
       break;
     case GES_EDGE_END:
       timeline->priv->needs_transitions_update = FALSE;
       GST_DEBUG ("Rippling end");
 
-      cur = g_hash_table_lookup (timeline->priv->by_end, obj);
-      snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
-      if (snapped)
-        position = *snapped;
+      if (ges_timeline_snap_position (timeline, obj, position,
+              &snapped, TRUE))
+        position = snapped.timecode;
 
       duration = _DURATION (obj);
+      needs_move_ctx = mv_ctx->needs_move_ctx;
 
       if (!ges_timeline_trim_object_simple (timeline,
               GES_TIMELINE_ELEMENT (obj), NULL, GES_EDGE_END, position,
-              FALSE)) {
-        return FALSE;
-      }
+              FALSE))
+        goto error;
 
       offset = _DURATION (obj) - duration;
-      for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-        trackelement = GES_TRACK_ELEMENT (tmp->data);
-        new_start = _START (trackelement) + offset;
 
-        container = add_toplevel_container (mv_ctx, trackelement);
+      for (i = 0; i < mv_ctx->moving_toplevels->len; i++) {
+        trackelement = ripple_get_moving_toplevel (mv_ctx, i, offset);
+        container = get_toplevel_container (trackelement);
+
         if (GES_IS_GROUP (container))
           container->children_control_mode = GES_CHILDREN_UPDATE_OFFSETS;
-        /* Make sure not to move 2 times the same Clip */
-        if (g_list_find (moved_clips, container) == NULL) {
-          _set_start0 (GES_TIMELINE_ELEMENT (trackelement), new_start);
-          moved_clips = g_list_prepend (moved_clips, container);
-        }
+        _set_start0 (GES_TIMELINE_ELEMENT (trackelement),
+            _START (trackelement) + offset);
         if (GES_IS_GROUP (container))
           container->children_control_mode = GES_CHILDREN_UPDATE;
       }
 
-      g_list_free (moved_clips);
+      /* Moving forward, the same elements follow the end of @obj */
+      if (offset >= 0)
+        mv_ctx->needs_move_ctx = needs_move_ctx;
+
       timeline->priv->needs_transitions_update = TRUE;
       GST_DEBUG ("Done Rippling end");
       break;
@@ -1852,11 +2472,14 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       break;
   }
 
+  ret = ges_timeline_end_edit (timeline);
   mv_ctx->ignore_needs_ctx = FALSE;
 
-  return TRUE;
+  return ret;
 
 error:
+  timeline->priv->needs_transitions_update = TRUE;
+  ges_timeline_end_edit (timeline);
   mv_ctx->ignore_needs_ctx = FALSE;
 
   return FALSE;
@@ -1878,38 +2501,24 @@ timeline_trim_object (GESTimeline * timeline, GESTrackElement * object,
     GList * layers, GESEdge edge, guint64 position)
 {
   gboolean ret = FALSE;
-  GstClockTime cpos;
   MoveContext *mv_ctx = &timeline->priv->movecontext;
 
   mv_ctx->ignore_needs_ctx = TRUE;
 
-  timeline->priv->needs_rollback = FALSE;
+  ges_timeline_begin_edit (timeline);
   if (!ges_timeline_set_moving_context (timeline, object, GES_EDIT_MODE_TRIM,
           edge, layers))
     goto end;
 
-  switch (edge) {
-    case GES_EDGE_START:
-      cpos = GES_TIMELINE_ELEMENT_START (object);
-      break;
-    case GES_EDGE_END:
-      cpos = GES_TIMELINE_ELEMENT_END (object);
-      break;
-    default:
-      goto end;
-  }
+  if (edge != GES_EDGE_START && edge != GES_EDGE_END)
+    goto end;
+
   ret = ges_timeline_trim_object_simple (timeline,
       GES_TIMELINE_ELEMENT (object), layers, edge, position, TRUE);
 
-  if (timeline->priv->needs_rollback && !timeline->priv->rolling_back) {
-    timeline->priv->rolling_back = TRUE;
-    ret = FALSE;
-    timeline_trim_object (timeline, object, layers, edge, cpos);
-    ges_timeline_emit_snappig (timeline, object, NULL);
-    timeline->priv->rolling_back = FALSE;
-  }
-
 end:
+  if (!ges_timeline_end_edit (timeline))
+    ret = FALSE;
   mv_ctx->ignore_needs_ctx = FALSE;
 
   return ret;
@@ -1920,15 +2529,17 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
     GList * layers, GESEdge edge, guint64 position)
 {
   MoveContext *mv_ctx = &timeline->priv->movecontext;
-  guint64 start, duration, end, tmpstart, tmpduration, tmpend, *snapped, *cur;
+  guint64 start, duration, end, tmpstart, tmpduration, tmpend;
+  TimelineEdge snapped;
   gboolean ret = TRUE;
-  GList *tmp;
+  guint i;
 
   mv_ctx->ignore_needs_ctx = TRUE;
 
   GST_DEBUG_OBJECT (obj, "Rolling object to %" GST_TIME_FORMAT,
       GST_TIME_ARGS (position));
 
+  ges_timeline_begin_edit (timeline);
   if (!ges_timeline_set_moving_context (timeline, obj, GES_EDIT_MODE_ROLL,
           edge, layers))
     goto error;
@@ -1946,10 +2557,9 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
           position < mv_ctx->min_trim_pos)
         goto error;
 
-      cur = g_hash_table_lookup (timeline->priv->by_start, obj);
-      snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
-      if (snapped)
-        position = *snapped;
+      if (ges_timeline_snap_position (timeline, obj, position,
+              &snapped, TRUE))
+        position = snapped.timecode;
 
       ret &= ges_timeline_trim_object_simple (timeline,
           GES_TIMELINE_ELEMENT (obj), layers, GES_EDGE_START, position, FALSE);
@@ -1958,7 +2568,7 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
         GST_INFO_OBJECT (timeline, "Could not trim %s",
             GES_TIMELINE_ELEMENT_NAME (obj));
 
-        return FALSE;
+        goto done;
       }
 
 
@@ -1967,8 +2577,11 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
       position = _START (obj);
 
       /* Send back changes to the neighbourhood */
-      for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-        GESTimelineElement *tmpelement = GES_TIMELINE_ELEMENT (tmp->data);
+      for (i = 0; i < mv_ctx->moving_trackelements->len; i++) {
+        TrackObjIters *tmpiters =
+            g_ptr_array_index (mv_ctx->moving_trackelements, i);
+        GESTimelineElement *tmpelement =
+            GES_TIMELINE_ELEMENT (tmpiters->trackelement);
 
         tmpstart = _START (tmpelement);
         tmpduration = _DURATION (tmpelement);
@@ -1991,10 +2604,9 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
 
       end = _START (obj) + _DURATION (obj);
 
-      cur = g_hash_table_lookup (timeline->priv->by_end, obj);
-      snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
-      if (snapped)
-        position = *snapped;
+      if (ges_timeline_snap_position (timeline, obj, position,
+              &snapped, TRUE))
+        position = snapped.timecode;
 
       ret &= ges_timeline_trim_object_simple (timeline,
           GES_TIMELINE_ELEMENT (obj), NULL, GES_EDGE_END, position, FALSE);
@@ -2009,8 +2621,11 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
       position = _START (obj) + _DURATION (obj);
 
       /* Send back changes to the neighbourhood */
-      for (tmp = mv_ctx->moving_trackelements; tmp; tmp = tmp->next) {
-        GESTimelineElement *tmpelement = GES_TIMELINE_ELEMENT (tmp->data);
+      for (i = 0; i < mv_ctx->moving_trackelements->len; i++) {
+        TrackObjIters *tmpiters =
+            g_ptr_array_index (mv_ctx->moving_trackelements, i);
+        GESTimelineElement *tmpelement =
+            GES_TIMELINE_ELEMENT (tmpiters->trackelement);
 
         tmpstart = _START (tmpelement);
         tmpduration = _DURATION (tmpelement);
@@ -2031,6 +2646,8 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
 
 done:
   timeline->priv->needs_transitions_update = TRUE;
+  if (!ges_timeline_end_edit (timeline))
+    ret = FALSE;
   mv_ctx->ignore_needs_ctx = FALSE;
 
   return ret;
@@ -2064,69 +2681,62 @@ ges_timeline_move_object_simple (GESTimeline * timeline,
     GESTimelineElement * element, GList * layers, GESEdge edge,
     guint64 position)
 {
-  GstClockTime cpos = GES_TIMELINE_ELEMENT_START (element);
-  guint64 *snap_end, *snap_st, *cur, position_offset, off1, off2, top_end;
+  guint64 position_offset, off1, off2, top_end;
+  gboolean has_snap_end, has_snap_st;
+  TimelineEdge snap_end, snap_st;
   GESTrackElement *track_element;
   GESContainer *toplevel;
+  TrackObjIters *iters;
 
   /* We only work with GESSource-s and we check that we are not already moving
    * the specified element ourself */
-  if (GES_IS_SOURCE (element) == FALSE ||
-      g_list_find (timeline->priv->movecontext.moving_trackelements, element))
+  if (GES_IS_SOURCE (element) == FALSE)
+    return FALSE;
+
+  iters = g_hash_table_lookup (timeline->priv->obj_iters, element);
+  if (iters && iters->moving)
     return FALSE;
 
-  timeline->priv->needs_rollback = FALSE;
+  ges_timeline_begin_edit (timeline);
   track_element = GES_TRACK_ELEMENT (element);
   toplevel = get_toplevel_container (track_element);
   position_offset = position - _START (track_element);
 
   top_end = _START (toplevel) + _DURATION (toplevel) + position_offset;
-  cur = g_hash_table_lookup (timeline->priv->by_end, track_element);
 
   GST_DEBUG_OBJECT (timeline, "Moving %" GST_PTR_FORMAT " to %"
       GST_TIME_FORMAT " (end %" GST_TIME_FORMAT ")", element,
       GST_TIME_ARGS (position), GST_TIME_ARGS (top_end));
 
-  snap_end = ges_timeline_snap_position (timeline, track_element, cur, top_end,
-      FALSE);
-  if (snap_end)
-    off1 = top_end > *snap_end ? top_end - *snap_end : *snap_end - top_end;
+  has_snap_end = ges_timeline_snap_position (timeline, track_element, top_end,
+      &snap_end, FALSE);
+  if (has_snap_end)
+    off1 = top_end > snap_end.timecode ? top_end - snap_end.timecode :
+        snap_end.timecode - top_end;
   else
     off1 = G_MAXUINT64;
 
-  cur = g_hash_table_lookup (timeline->priv->by_start, track_element);
-  snap_st =
-      ges_timeline_snap_position (timeline, track_element, cur, position,
-      FALSE);
-  if (snap_st)
-    off2 = position > *snap_st ? position - *snap_st : *snap_st - position;
+  has_snap_st = ges_timeline_snap_position (timeline, track_element, position,
+      &snap_st, FALSE);
+  if (has_snap_st)
+    off2 = position > snap_st.timecode ? position - snap_st.timecode :
+        snap_st.timecode - position;
   else
     off2 = G_MAXUINT64;
 
   /* In the case we could snap on both sides, we snap on the end */
-  if (snap_end && off1 <= off2) {
-    position = position + *snap_end - top_end;
-    ges_timeline_emit_snappig (timeline, track_element, snap_end);
-  } else if (snap_st) {
-    position = position + *snap_st - position;
-    ges_timeline_emit_snappig (timeline, track_element, snap_st);
+  if (has_snap_end && off1 <= off2) {
+    position = position + snap_end.timecode - top_end;
+    ges_timeline_emit_snappig (timeline, track_element, &snap_end);
+  } else if (has_snap_st) {
+    position = position + snap_st.timecode - position;
+    ges_timeline_emit_snappig (timeline, track_element, &snap_st);
   } else
     ges_timeline_emit_snappig (timeline, track_element, NULL);
-  timeline->priv->needs_rollback = FALSE;
 
   _set_start0 (GES_TIMELINE_ELEMENT (track_element), position);
 
-  if (timeline->priv->needs_rollback && !timeline->priv->rolling_back) {
-    timeline->priv->needs_rollback = FALSE;
-    timeline->priv->rolling_back = TRUE;
-    ges_timeline_move_object_simple (timeline, element, layers, edge, cpos);
-    ges_timeline_emit_snappig (timeline, track_element, NULL);
-    timeline->priv->rolling_back = FALSE;
-
-    return FALSE;
-  }
-
-  return TRUE;
+  return ges_timeline_end_edit (timeline);
 }
 
 gboolean
@@ -2150,7 +2760,7 @@ timeline_context_to_layer (GESTimeline * timeline, gint offset)
       g_hash_table_size (mv_ctx->toplevel_containers), offset);
 
   mv_ctx->ignore_needs_ctx = TRUE;
-  timeline->priv->needs_rollback = FALSE;
+  ges_timeline_begin_edit (timeline);
   g_hash_table_iter_init (&iter, mv_ctx->toplevel_containers);
   while (g_hash_table_iter_next (&iter, (gpointer *) & key,
           (gpointer *) & value)) {
@@ -2188,14 +2798,12 @@ timeline_context_to_layer (GESTimeline * timeline, gint offset)
 
   /* Readjust min_move_layer */
   mv_ctx->min_move_layer = mv_ctx->min_move_layer + offset;
-  mv_ctx->ignore_needs_ctx = FALSE;
 
-  if (timeline->priv->needs_rollback && !timeline->priv->rolling_back) {
+  /* Rolling back puts the clips back in their layers and needs a new
+   * moving context */
+  if (!ges_timeline_end_edit (timeline))
     ret = FALSE;
-    timeline->priv->rolling_back = TRUE;
-    timeline_context_to_layer (timeline, -offset);
-    timeline->priv->rolling_back = FALSE;
-  }
+  mv_ctx->ignore_needs_ctx = FALSE;
   mv_ctx->moving_to_layer = NULL;
 
   return ret;
@@ -2308,9 +2916,10 @@ layer_auto_transition_changed_cb (GESLayer * layer,
     GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
 {
   GList *tmp, *clips;
+  gboolean edit_failed = timeline->priv->edit_failed;
 
-  timeline->priv->needs_rollback = FALSE;
-  _create_transitions_on_layer (timeline, layer, NULL, NULL,
+  timeline->priv->edit_failed = FALSE;
+  _create_transitions_on_layer (timeline, layer, TRUE,
       _create_auto_transition_from_transitions);
 
   clips = ges_layer_get_clips (layer);
@@ -2339,7 +2948,7 @@ layer_auto_transition_changed_cb (GESLayer * layer,
   }
   g_list_free_full (clips, gst_object_unref);
 
-  if (timeline->priv->needs_rollback) {
+  if (timeline->priv->edit_failed) {
     GList *tmp, *trans;
 
     ges_layer_set_auto_transition (layer, FALSE);
@@ -2360,6 +2969,8 @@ layer_auto_transition_changed_cb (GESLayer * layer,
     }
     g_list_free_full (trans, gst_object_unref);
   }
+
+  timeline->priv->edit_failed = edit_failed;
 }
 
 static void
@@ -2517,8 +3128,9 @@ layer_object_added_cb (GESLayer * layer, GESClip * clip, GESTimeline * timeline)
     GST_DEBUG ("Clip %p moving from one layer to another, not creating "
         "TrackElement", clip);
     timeline->priv->movecontext.needs_move_ctx = TRUE;
-    _create_transitions_on_layer (timeline, layer, NULL, NULL,
-        _find_transition_from_auto_transitions);
+    if (!timeline->priv->edit_depth)
+      _create_transitions_on_layer (timeline, layer, FALSE,
+          _find_transition_from_auto_transitions);
     return;
   }
 
@@ -2554,6 +3166,12 @@ layer_object_removed_cb (GESLayer * layer, GESClip * clip,
   if (ges_clip_is_moving_from_layer (clip)) {
     GST_DEBUG ("Clip %p is moving from a layer to another, not doing"
         " anything on it", clip);
+
+    /* Remember where to put it back if the transaction is rolled back */
+    if (timeline->priv->edit_depth &&
+        !g_hash_table_contains (timeline->priv->edited_layers, clip))
+      g_hash_table_insert (timeline->priv->edited_layers,
+          gst_object_ref (clip), gst_object_ref (layer));
     return;
   }
 
@@ -2601,15 +3219,12 @@ trackelement_start_changed_cb (GESTrackElement * child,
   GESTimelinePrivate *priv = timeline->priv;
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
-  if (G_LIKELY (iters->iter_by_layer))
-    g_sequence_sort_changed (iters->iter_by_layer,
-        (GCompareDataFunc) element_start_compare, NULL);
+  if (GES_IS_SOURCE (child))
+    track_element_record_timings (timeline, iters);
 
-  if (GES_IS_SOURCE (child)) {
-    sort_track_elements (timeline, iters);
-    sort_starts_ends_start (timeline, iters);
-    sort_starts_ends_end (timeline, iters);
+  track_element_changed (timeline, iters);
 
+  if (GES_IS_SOURCE (child)) {
     /* If the timeline is set to snap objects together, we
      * are sure that all movement of TrackElement-s are done within
      * the moving context, so we do not need to recalculate the
@@ -2627,46 +3242,21 @@ trackelement_priority_changed_cb (GESTrackElement * child,
     GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
 {
   GESTimelinePrivate *priv = timeline->priv;
+  TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
-  GList *layer_node = g_list_find_custom (timeline->layers,
-      GINT_TO_POINTER (_ges_track_element_get_layer_priority (child)),
-      (GCompareFunc) find_layer_by_prio);
-  GESLayer *layer = layer_node ? layer_node->data : NULL;
-  TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters,
-      child);
-
-  if (G_UNLIKELY (layer == NULL)) {
-    GST_ERROR_OBJECT (timeline,
-        "Changing a TrackElement prio, which would not "
-        "land in no layer we are controlling");
-    if (iters->iter_by_layer)
-      g_sequence_remove (iters->iter_by_layer);
-    iters->iter_by_layer = NULL;
-    iters->layer = NULL;
-  } else {
-    /* If it moves from layer, properly change it */
-    if (layer != iters->layer) {
-      GSequence *by_layer_sequence =
-          g_hash_table_lookup (priv->by_layer, layer);
-
-      GST_DEBUG_OBJECT (child, "Moved from layer %" GST_PTR_FORMAT
-          "(prio %d) to" " %" GST_PTR_FORMAT " (prio %d)", layer,
-          ges_layer_get_priority (layer), iters->layer,
-          ges_layer_get_priority (iters->layer));
+  /* Changing layer is handled when reindexing */
+  track_element_changed (timeline, iters);
+}
 
-      g_sequence_remove (iters->iter_by_layer);
-      iters->iter_by_layer =
-          g_sequence_insert_sorted (by_layer_sequence, child,
-          (GCompareDataFunc) element_start_compare, NULL);
-      iters->layer = layer;
-    } else {
-      g_sequence_sort_changed (iters->iter_by_layer,
-          (GCompareDataFunc) element_start_compare, NULL);
-    }
-  }
+static void
+trackelement_inpoint_changed_cb (GESTrackElement * child,
+    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+{
+  GESTimelinePrivate *priv = timeline->priv;
 
   if (GES_IS_SOURCE (child))
-    sort_track_elements (timeline, iters);
+    track_element_record_timings (timeline,
+        g_hash_table_lookup (priv->obj_iters, child));
 }
 
 static void
@@ -2677,7 +3267,8 @@ trackelement_duration_changed_cb (GESTrackElement * child,
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
   if (GES_IS_SOURCE (child)) {
-    sort_starts_ends_end (timeline, iters);
+    track_element_record_timings (timeline, iters);
+    track_element_changed (timeline, iters);
 
     /* If the timeline is set to snap objects together, we
      * are sure that all movement of TrackElement-s are done within
@@ -2705,6 +3296,9 @@ track_element_added_cb (GESTrack * track, GESTrackElement * track_element,
   g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
       "notify::priority", G_CALLBACK (trackelement_priority_changed_cb),
       timeline);
+  g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
+      "notify::in-point", G_CALLBACK (trackelement_inpoint_changed_cb),
+      timeline);
 
   start_tracking_track_element (timeline, track_element);
 }
@@ -2726,6 +3320,8 @@ track_element_removed_cb (GESTrack * track,
       trackelement_duration_changed_cb, timeline);
   g_signal_handlers_disconnect_by_func (track_element,
       trackelement_priority_changed_cb, timeline);
+  g_signal_handlers_disconnect_by_func (track_element,
+      trackelement_inpoint_changed_cb, timeline);
 
   stop_tracking_track_element (timeline, track_element);
 }
@@ -2838,6 +3434,64 @@ timeline_fill_gaps (GESTimeline * timeline)
   }
 }
 
+/* Creates a new timeline with copies of the tracks, layers and clips of
+ * @timeline. Transitions are copied as any other clip, and then adopted by
+ * the layers using auto transitions. Groups are not copied. */
+GESTimeline *
+timeline_copy (GESTimeline * timeline)
+{
+  GList *tmp, *clips, *clip, *nlayers = NULL, *nlayer;
+  GESTimeline *copy = ges_timeline_new ();
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    GESTrack *track = tmp->data, *ntrack;
+    GstCaps *restriction_caps;
+
+    if (GES_IS_VIDEO_TRACK (track))
+      ntrack = GES_TRACK (ges_video_track_new ());
+    else if (GES_IS_AUDIO_TRACK (track))
+      ntrack = GES_TRACK (ges_audio_track_new ());
+    else
+      ntrack = ges_track_new (track->type,
+          gst_caps_copy (ges_track_get_caps (track)));
+
+    ges_track_set_caps (ntrack, ges_track_get_caps (track));
+    g_object_get (track, "restriction-caps", &restriction_caps, NULL);
+    if (restriction_caps) {
+      ges_track_set_restriction_caps (ntrack, restriction_caps);
+      gst_caps_unref (restriction_caps);
+    }
+    ges_track_set_mixing (ntrack, ges_track_get_mixing (track));
+
+    ges_timeline_add_track (copy, ntrack);
+  }
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    GESLayer *layer = ges_layer_new ();
+
+    ges_layer_set_priority (layer, ges_layer_get_priority (tmp->data));
+    ges_timeline_add_layer (copy, layer);
+
+    clips = ges_layer_get_clips (tmp->data);
+    for (clip = clips; clip; clip = clip->next)
+      ges_clip_copy_to_layer (clip->data, layer);
+    g_list_free_full (clips, gst_object_unref);
+
+    nlayers = g_list_append (nlayers, layer);
+  }
+
+  /* Only now that the copied transitions are in place, so that they are
+   * reused instead of new ones being created with the default settings */
+  copy->priv->auto_transition = timeline->priv->auto_transition;
+  for (tmp = timeline->layers, nlayer = nlayers; tmp;
+      tmp = tmp->next, nlayer = nlayer->next)
+    ges_layer_set_auto_transition (nlayer->data,
+        ges_layer_get_auto_transition (tmp->data));
+  g_list_free (nlayers);
+
+  return copy;
+}
+
 /**** API *****/
 /**
  * ges_timeline_new:
@@ -3042,6 +3696,9 @@ ges_timeline_add_layer (GESTimeline * timeline, GESLayer * layer)
   ges_layer_set_timeline (layer, timeline);
 
   g_hash_table_insert (timeline->priv->by_layer, layer, g_sequence_new (NULL));
+  g_hash_table_insert (timeline->priv->layer_edges, layer,
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+          (GDestroyNotify) layer_edges_free));
 
   /* Connect to 'clip-added'/'clip-removed' signal from the new layer */
   g_signal_connect_after (layer, "clip-added",
@@ -3115,6 +3772,7 @@ ges_timeline_remove_layer (GESTimeline * timeline, GESLayer * layer)
       layer_auto_transition_changed_cb, timeline);
 
   g_hash_table_remove (timeline->priv->by_layer, layer);
+  g_hash_table_remove (timeline->priv->layer_edges, layer);
   timeline->layers = g_list_remove (timeline->layers, layer);
   ges_layer_set_timeline (layer, NULL);
 
@@ -3175,6 +3833,8 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
 
   /* Inform the track that it's currently being used by ourself */
   ges_track_set_timeline (track, timeline);
+  if (timeline->priv->edit_depth)
+    track_defer_resort (track, TRUE);
 
   GST_DEBUG ("Done adding track, emitting 'track-added' signal");
 
@@ -3232,7 +3892,10 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
 gboolean
 ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
 {
-  GList *tmp;
+  GList *tmp, *untracked = NULL;
+  GHashTableIter iter;
+  GHashTable *by_track;
+  TrackObjIters *iters;
   TrackPrivate *tr_priv;
   GESTimelinePrivate *priv;
 
@@ -3256,6 +3919,8 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   UNLOCK_DYN (timeline);
   timeline->tracks = g_list_remove (timeline->tracks, track);
 
+  if (priv->edit_depth)
+    track_defer_resort (track, FALSE);
   ges_track_set_timeline (track, NULL);
 
   /* Remove ghost pad */
@@ -3275,6 +3940,23 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   /* Signal track removal to all layers/objects */
   g_signal_emit (timeline, ges_timeline_signals[TRACK_REMOVED], 0, track);
 
+  /* The elements of @track, including the ones removed from it by the
+   * handlers above, are not part of the timeline anymore. Stop tracking
+   * them before dropping the edges of @track in all layers */
+  g_hash_table_iter_init (&iter, priv->obj_iters);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & iters)) {
+    if ((iters->layer_edges && iters->layer_edges->track == track) ||
+        ges_track_element_get_track (iters->trackelement) == track)
+      untracked = g_list_prepend (untracked, iters->trackelement);
+  }
+  for (tmp = untracked; tmp; tmp = tmp->next)
+    track_element_removed_cb (track, tmp->data, timeline);
+  g_list_free (untracked);
+
+  g_hash_table_iter_init (&iter, priv->layer_edges);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & by_track))
+    g_hash_table_remove (by_track, track);
+
   /* remove track from our bin */
   gst_object_ref (track);
   if (G_UNLIKELY (!gst_bin_remove (GST_BIN (timeline), GST_ELEMENT (track)))) {
@@ -3420,10 +4102,11 @@ ges_timeline_commit_unlocked (GESTimeline * timeline)
 
   GST_DEBUG_OBJECT (timeline, "commiting changes");
 
+  timeline_flush_edits (timeline);
   for (tmp = timeline->layers; tmp; tmp = tmp->next) {
     GESLayer *layer = tmp->data;
 
-    _create_transitions_on_layer (timeline, layer, NULL, NULL,
+    _create_transitions_on_layer (timeline, layer, FALSE,
         _find_transition_from_auto_transitions);
 
     /* Ensure clip priorities are correct after an edit */
@@ -3556,6 +4239,109 @@ ges_timeline_commit_sync (GESTimeline * timeline)
   return ret;
 }
 
+/**
+ * ges_timeline_begin_edit:
+ * @timeline: a #GESTimeline
+ *
+ * Starts an edit transaction on @timeline. Until the matching
+ * #ges_timeline_end_edit call, changes to the timing of the elements of
+ * @timeline are only recorded: sorting them, updating the
+ * #GESTimeline:duration, filling the gaps of the tracks and creating the
+ * auto transitions is done once for all of them when the transaction
+ * ends.
+ *
+ * Use it around sets of changes touching many clips, like moving all the
+ * clips of a layer, which would otherwise update the timeline after each
+ * of them.
+ *
+ * Transactions can be nested, only the outermost one is applied.
+ *
+ * Since: 1.16
+ */
+void
+ges_timeline_begin_edit (GESTimeline * timeline)
+{
+  GList *tmp;
+
+  g_return_if_fail (GES_IS_TIMELINE (timeline));
+
+  if (timeline->priv->edit_depth++)
+    return;
+
+  GST_DEBUG_OBJECT (timeline, "Starting edit transaction");
+  timeline->priv->edit_failed = FALSE;
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next)
+    track_defer_resort (tmp->data, TRUE);
+}
+
+/**
+ * ges_timeline_end_edit:
+ * @timeline: a #GESTimeline
+ *
+ * Ends an edit transaction started with #ges_timeline_begin_edit. If it
+ * is the outermost one, all the changes done since it began are applied.
+ *
+ * If the changes lead to a state the timeline can not handle, like three
+ * clips overlapping at the same position in a layer with auto transitions,
+ * the whole transaction is rolled back: the clips that were moved to
+ * other layers are put back in their original layer, and the timings of
+ * their elements are restored. Elements added or removed during the
+ * transaction are not.
+ *
+ * Returns: %FALSE if the transaction was rolled back, %TRUE otherwise
+ *
+ * Since: 1.16
+ */
+gboolean
+ges_timeline_end_edit (GESTimeline * timeline)
+{
+  GList *tmp;
+  gboolean ret = TRUE;
+  GESTimelinePrivate *priv;
+
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), FALSE);
+
+  priv = timeline->priv;
+  g_return_val_if_fail (priv->edit_depth > 0, FALSE);
+
+  if (priv->edit_depth > 1) {
+    priv->edit_depth--;
+
+    return TRUE;
+  }
+
+  GST_DEBUG_OBJECT (timeline, "Applying edit transaction on %u elements",
+      priv->edited_iters->len);
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next)
+    _create_transitions_on_layer (timeline, tmp->data, FALSE,
+        _find_transition_from_auto_transitions);
+
+  if (priv->edit_failed) {
+    GST_INFO_OBJECT (timeline, "Rolling back edit transaction");
+
+    timeline_restore_edits (timeline);
+    /* Transitions removed while editing need to be recreated */
+    for (tmp = timeline->layers; tmp; tmp = tmp->next)
+      _create_transitions_on_layer (timeline, tmp->data, FALSE,
+          _find_transition_from_auto_transitions);
+    ges_timeline_emit_snappig (timeline, NULL, NULL);
+    priv->movecontext.needs_move_ctx = TRUE;
+    ret = FALSE;
+  }
+
+  timeline_flush_edits (timeline);
+  timeline_clear_edits (timeline);
+  priv->edit_failed = FALSE;
+  priv->edit_depth = 0;
+
+  timeline_update_duration (timeline);
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next)
+    track_defer_resort (tmp->data, FALSE);
+
+  return ret;
+}
+
 /**
  * ges_timeline_get_duration:
  * @timeline: a #GESTimeline
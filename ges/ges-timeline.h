@@ -143,6 +143,11 @@ gboolean ges_timeline_commit (GESTimeline * timeline);
 GES_API
 gboolean ges_timeline_commit_sync (GESTimeline * timeline);
 
+GES_API
+void ges_timeline_begin_edit (GESTimeline * timeline);
+GES_API
+gboolean ges_timeline_end_edit (GESTimeline * timeline);
+
 GES_API
 GstClockTime ges_timeline_get_duration (GESTimeline *timeline);
 
@@ -34,6 +34,9 @@
 #include "ges-meta-container.h"
 #include "ges-video-track.h"
 #include "ges-audio-track.h"
+#include "ges-video-source.h"
+#include "ges-audio-source.h"
+#include "ges-uri-asset.h"
 
 G_DEFINE_TYPE_WITH_CODE (GESTrack, ges_track, GST_TYPE_BIN,
     G_IMPLEMENT_INTERFACE (GES_TYPE_META_CONTAINER, NULL));
@@ -44,6 +47,9 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+/* Maximum number of unused gaps a track keeps around */
+#define GAP_POOL_MAX_SIZE 16
+
 /* Structure that represents gaps and keep knowledge
  * of the gaps filled in the track */
 typedef struct
@@ -61,9 +67,19 @@ struct _GESTrackPrivate
   GESTimeline *timeline;
   GSequence *trackelements_by_start;
   GHashTable *trackelements_iter;
-  GList *gaps;
+  GList *gaps;                  /* Gap-s sorted by decreasing start */
   gboolean last_gap_disabled;
 
+  /* Gap-s not used anymore, kept deactivated in the composition so they
+   * can be retargeted instead of building new gap fillers */
+  GQueue gap_pool;
+  guint gap_pool_hits;
+  guint gap_pool_misses;
+
+  /* Decoders of the uri sources, shared between the sources that are not
+   * active at the same time */
+  GESDecoderPool *decoder_pool;
+
   guint64 duration;
 
   GstCaps *caps;
@@ -74,8 +90,20 @@ struct _GESTrackPrivate
 
   gboolean updating;
 
+  /* Set while the timeline applies an edit transaction, sorting the
+   * elements and filling the gaps is then only done once it is over */
+  gboolean resort_deferred;
+  gboolean needs_sort;
+  gboolean needs_gaps;
+
   gboolean mixing;
   GstElement *mixing_operation;
+  /* Compressed streams can not be mixed, so the mixer is removed while
+   * some sources are passed through */
+  gboolean mixer_bypassed;
+  /* The format the track is rendered to, when sources may pass their
+   * streams through, re-evaluated on each commit */
+  GstCaps *passthrough_caps;
   GstElement *capsfilter;
 
   /* Virtual method to create GstElement that fill gaps */
@@ -90,6 +118,8 @@ enum
   ARG_TYPE,
   ARG_DURATION,
   ARG_MIXING,
+  ARG_GAP_POOL_STATS,
+  ARG_DECODER_POOL_STATS,
   ARG_LAST,
   TRACK_ELEMENT_ADDED,
   TRACK_ELEMENT_REMOVED,
@@ -177,10 +207,90 @@ free_gap (Gap * gap)
   g_slice_free (Gap, gap);
 }
 
+/* Deactivates @gap and keeps it for later reuse if the pool is not full */
+static void
+release_gap (Gap * gap)
+{
+  GESTrackPrivate *priv = gap->track->priv;
+
+  if (priv->gap_pool.length >= GAP_POOL_MAX_SIZE) {
+    free_gap (gap);
+
+    return;
+  }
+
+  GST_DEBUG_OBJECT (gap->track, "Pooling gap with start %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT, GST_TIME_ARGS (gap->start),
+      GST_TIME_ARGS (gap->duration));
+  g_object_set (gap->nleobj, "active", FALSE, NULL);
+  g_queue_push_head (&priv->gap_pool, gap);
+}
+
+static void
+gap_set_timings (Gap * gap, GstClockTime start, GstClockTime duration)
+{
+  if (gap->start == start && gap->duration == duration)
+    return;
+
+  GST_DEBUG_OBJECT (gap->track, "Moving gap from %" GST_TIME_FORMAT
+      " duration %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT " duration %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (gap->start),
+      GST_TIME_ARGS (gap->duration), GST_TIME_ARGS (start),
+      GST_TIME_ARGS (duration));
+
+  gap->start = start;
+  gap->duration = duration;
+  g_object_set (gap->nleobj, "start", start, "duration", duration, NULL);
+}
+
+/* Fills [@start, @start + @duration] with the first of @old_gaps that
+ * overlaps it if any, else with a pooled gap. @old_gaps is sorted by
+ * increasing start and so are the calls, the old gaps ending before @start
+ * are thus not needed anymore */
+static void
+fill_gap (GESTrack * track, GList ** old_gaps, GstClockTime start,
+    GstClockTime duration)
+{
+  Gap *gap = NULL;
+  GESTrackPrivate *priv = track->priv;
+
+  while (*old_gaps) {
+    Gap *old_gap = (*old_gaps)->data;
+
+    if (old_gap->start >= start + duration)
+      break;
+
+    *old_gaps = g_list_delete_link (*old_gaps, *old_gaps);
+    if (old_gap->start + old_gap->duration > start) {
+      gap = old_gap;
+      break;
+    }
+
+    release_gap (old_gap);
+  }
+
+  if (!gap) {
+    gap = g_queue_pop_head (&priv->gap_pool);
+
+    if (gap) {
+      priv->gap_pool_hits++;
+      g_object_set (gap->nleobj, "active", TRUE, NULL);
+    } else {
+      priv->gap_pool_misses++;
+      gap = gap_new (track, start, duration);
+    }
+  }
+
+  if (G_LIKELY (gap != NULL))
+    gap_set_timings (gap, start, duration);
+
+  if (G_LIKELY (gap != NULL))
+    priv->gaps = g_list_prepend (priv->gaps, gap);
+}
+
 static inline void
 update_gaps (GESTrack * track)
 {
-  Gap *gap;
   GList *gaps;
   GSequenceIter *it;
 
@@ -195,7 +305,9 @@ update_gaps (GESTrack * track)
     return;
   }
 
-  gaps = priv->gaps;
+  /* Only create and remove the gaps that appeared or vanished, the others
+   * are moved so that the composition keeps the same objects */
+  gaps = g_list_reverse (priv->gaps);
   priv->gaps = NULL;
 
   /* 1- And recalculate gaps */
@@ -209,13 +321,9 @@ update_gaps (GESTrack * track)
     start = _START (trackelement);
     end = start + _DURATION (trackelement);
 
-    if (start > duration) {
-      /* 2- Fill gap */
-      gap = gap_new (track, duration, start - duration);
-
-      if (G_LIKELY (gap != NULL))
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-    }
+    /* 2- Fill gap */
+    if (start > duration)
+      fill_gap (track, &gaps, duration, start - duration);
 
     duration = MAX (duration, end);
   }
@@ -225,11 +333,7 @@ update_gaps (GESTrack * track)
     g_object_get (priv->timeline, "duration", &timeline_duration, NULL);
 
     if (duration < timeline_duration) {
-      gap = gap_new (track, duration, timeline_duration - duration);
-
-      if (G_LIKELY (gap != NULL)) {
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-      }
+      fill_gap (track, &gaps, duration, timeline_duration - duration);
 
       priv->duration = timeline_duration;
     }
@@ -237,12 +341,11 @@ update_gaps (GESTrack * track)
 
   if (!track->priv->last_gap_disabled) {
     GST_DEBUG_OBJECT (track, "Adding a one second gap at the end");
-    gap = gap_new (track, timeline_duration, 1);
-    priv->gaps = g_list_prepend (priv->gaps, gap);
+    fill_gap (track, &gaps, timeline_duration, 1);
   }
 
-  /* 4- Remove old gaps */
-  g_list_free_full (gaps, (GDestroyNotify) free_gap);
+  /* 4- Release the gaps that vanished */
+  g_list_free_full (gaps, (GDestroyNotify) release_gap);
 }
 
 void
@@ -252,9 +355,219 @@ track_disable_last_gap (GESTrack * track, gboolean disabled)
   update_gaps (track);
 }
 
+/* Let the composition preroll the next stack while the current one is
+ * playing, used when rendering so that stack switches do not stall */
+void
+track_set_lookahead (GESTrack * track, gboolean lookahead)
+{
+  g_object_set (track->priv->composition, "lookahead", lookahead, NULL);
+}
+
+/* Decode the proxies of the assets when previewing, and the original files
+ * when rendering */
+void
+track_set_use_proxies (GESTrack * track, gboolean use_proxies)
+{
+  ges_decoder_pool_set_use_proxies (track->priv->decoder_pool, use_proxies);
+  /* The idle decoders read the files that are not used anymore */
+  ges_decoder_pool_clear (track->priv->decoder_pool);
+}
+
+/* Whether the track restriction caps, and the encoding @format, accept the
+ * stream of @source as it is in its file */
+static gboolean
+_stream_matches (GESTrack * track, GstDiscovererStreamInfo * sinfo,
+    GstCaps * format)
+{
+  guint i;
+  gboolean ret;
+  GstCaps *restriction, *caps = gst_discoverer_stream_info_get_caps (sinfo);
+
+  if (!caps)
+    return FALSE;
+
+  if (!gst_caps_can_intersect (caps, format)) {
+    gst_caps_unref (caps);
+
+    return FALSE;
+  }
+
+  if (!track->priv->restriction_caps) {
+    gst_caps_unref (caps);
+
+    return TRUE;
+  }
+
+  /* The fields of the raw restriction caps also apply to the compressed
+   * stream, ie. its size, framerate, or rate and channels */
+  restriction = gst_caps_copy (track->priv->restriction_caps);
+  for (i = 0; i < gst_caps_get_size (restriction); i++)
+    gst_structure_set_name (gst_caps_get_structure (restriction, i),
+        gst_structure_get_name (gst_caps_get_structure (caps, 0)));
+  ret = gst_caps_can_intersect (caps, restriction);
+
+  gst_caps_unref (restriction);
+  gst_caps_unref (caps);
+
+  return ret;
+}
+
+/* Whether @source plays its stream unmodified, alone in the track */
+static gboolean
+_source_can_passthrough (GESTrack * track, GESTrackElement * source,
+    GList * elements, GstCaps * format)
+{
+  GList *tmp;
+  GstDiscovererStreamInfo *sinfo;
+  GESAsset *asset = ges_extractable_get_asset (GES_EXTRACTABLE (source));
+
+  if (!GES_IS_URI_SOURCE_ASSET (asset) || !ges_track_element_is_active (source))
+    return FALSE;
+
+  sinfo = ges_uri_source_asset_get_stream_info (GES_URI_SOURCE_ASSET (asset));
+  if (!sinfo || !_stream_matches (track, sinfo, format))
+    return FALSE;
+
+  if (g_hash_table_size (ges_track_element_get_all_control_bindings (source)))
+    return FALSE;
+
+  if (GES_IS_VIDEO_SOURCE (source)) {
+    gdouble alpha;
+    gint posx, posy, width, height, crop_left, crop_right, crop_top,
+        crop_bottom;
+    GstDiscovererVideoInfo *vinfo = GST_DISCOVERER_VIDEO_INFO (sinfo);
+
+    if (gst_discoverer_video_info_is_image (vinfo))
+      return FALSE;
+
+    ges_timeline_element_get_child_properties (GES_TIMELINE_ELEMENT (source),
+        "alpha", &alpha, "posx", &posx, "posy", &posy, "width", &width,
+        "height", &height, "crop-left", &crop_left, "crop-right",
+        &crop_right, "crop-top", &crop_top, "crop-bottom", &crop_bottom, NULL);
+    if (alpha != 1.0 || posx || posy ||
+        crop_left || crop_right || crop_top || crop_bottom ||
+        (width && width != gst_discoverer_video_info_get_width (vinfo)) ||
+        (height && height != gst_discoverer_video_info_get_height (vinfo)))
+      return FALSE;
+  } else if (GES_IS_AUDIO_SOURCE (source)) {
+    gdouble volume;
+    gboolean mute;
+
+    ges_timeline_element_get_child_properties (GES_TIMELINE_ELEMENT (source),
+        "volume", &volume, "mute", &mute, NULL);
+    if (volume != 1.0 || mute)
+      return FALSE;
+  }
+
+  /* Effects, transitions and the sources of other layers all overlap with
+   * the source they modify */
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    GESTimelineElement *other = tmp->data;
+
+    if (other == GES_TIMELINE_ELEMENT (source) ||
+        !ges_track_element_is_active (tmp->data))
+      continue;
+
+    if (_START (other) < _END (source) && _END (other) > _START (source))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Whether sources of different layers overlap, their compressed streams
+ * could then not be mixed */
+static gboolean
+_needs_mixer (GList * elements)
+{
+  GList *tmp, *tmp1;
+
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    GESTimelineElement *source = tmp->data;
+
+    if (!GES_IS_SOURCE (source) || !ges_track_element_is_active (tmp->data))
+      continue;
+
+    for (tmp1 = tmp->next; tmp1; tmp1 = tmp1->next) {
+      GESTimelineElement *other = tmp1->data;
+
+      if (!GES_IS_SOURCE (other) || !ges_track_element_is_active (tmp1->data))
+        continue;
+
+      if (_START (other) < _END (source) && _END (other) > _START (source) &&
+          (!GES_IS_CLIP (source->parent) || !GES_IS_CLIP (other->parent) ||
+              ges_clip_get_layer_priority (GES_CLIP (source->parent)) !=
+              ges_clip_get_layer_priority (GES_CLIP (other->parent))))
+        return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* Decides which sources pass their streams through, from the current
+ * content of the track */
+static void
+_update_passthrough (GESTrack * track)
+{
+  GList *tmp, *elements;
+  gboolean passthrough = FALSE;
+  GESTrackPrivate *priv = track->priv;
+  GstCaps *caps = priv->passthrough_caps;
+
+  elements = ges_track_get_elements (track);
+  if (caps && priv->mixing && _needs_mixer (elements)) {
+    GST_INFO_OBJECT (track, "Layers are mixed, can not pass streams through");
+    caps = NULL;
+  }
+
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    gboolean can_passthrough;
+
+    if (!GES_IS_SOURCE (tmp->data))
+      continue;
+
+    can_passthrough = caps &&
+        _source_can_passthrough (track, tmp->data, elements, caps);
+    ges_source_set_passthrough_caps (tmp->data, can_passthrough ? caps : NULL);
+    passthrough |= can_passthrough;
+  }
+  g_list_free_full (elements, gst_object_unref);
+
+  GST_INFO_OBJECT (track, "Passthrough %s", passthrough ? "enabled" :
+      "disabled");
+
+  if (!priv->mixing_operation || !priv->mixing ||
+      passthrough == priv->mixer_bypassed)
+    return;
+
+  /* No sources of different layers overlap, so nothing needs mixing */
+  if (passthrough)
+    ges_nle_composition_remove_object (priv->composition,
+        priv->mixing_operation);
+  else
+    ges_nle_composition_add_object (priv->composition, priv->mixing_operation);
+  priv->mixer_bypassed = passthrough;
+}
+
+/* Lets the sources that play their stream unmodified, and alone, output
+ * their compressed stream when it matches @caps, the format to render the
+ * track to. The other sources are decoded, processed and encoded again.
+ * Disabled if @caps is %NULL. The sources are checked again each time the
+ * track is commited, as edits can change what they play, the running ones
+ * only switching once the composition restarts them. */
+void
+track_set_passthrough_caps (GESTrack * track, GstCaps * caps)
+{
+  gst_caps_replace (&track->priv->passthrough_caps, caps);
+  _update_passthrough (track);
+}
+
 void
 track_resort_and_fill_gaps (GESTrack * track)
 {
+  track->priv->needs_sort = FALSE;
+  track->priv->needs_gaps = FALSE;
   g_sequence_sort (track->priv->trackelements_by_start,
       (GCompareDataFunc) element_start_compare, NULL);
 
@@ -270,11 +583,36 @@ update_field (GQuark field_id, const GValue * value, GstStructure * original)
   return TRUE;
 }
 
+/* Used by the timeline around edit transactions, so that the elements are
+ * sorted and the gaps filled only once they are over */
+void
+track_defer_resort (GESTrack * track, gboolean defer)
+{
+  GESTrackPrivate *priv = track->priv;
+
+  priv->resort_deferred = defer;
+  if (defer)
+    return;
+
+  if (priv->needs_gaps) {
+    track_resort_and_fill_gaps (track);
+  } else if (priv->needs_sort) {
+    priv->needs_sort = FALSE;
+    g_sequence_sort (priv->trackelements_by_start,
+        (GCompareDataFunc) element_start_compare, NULL);
+  }
+}
+
 /* callbacks */
 static void
 sort_track_elements_cb (GESTrackElement * child,
     GParamSpec * arg G_GNUC_UNUSED, GESTrack * track)
 {
+  if (track->priv->resort_deferred) {
+    track->priv->needs_sort = TRUE;
+    return;
+  }
+
   g_sequence_sort (track->priv->trackelements_by_start,
       (GCompareDataFunc) element_start_compare, NULL);
 }
@@ -339,6 +677,13 @@ ges_track_get_composition (GESTrack * track)
   return track->priv->composition;
 }
 
+/* Internal */
+GESDecoderPool *
+ges_track_get_decoder_pool (GESTrack * track)
+{
+  return track->priv->decoder_pool;
+}
+
 /* FIXME: Find out how to avoid doing this "hack" using the GDestroyNotify
  * function pointer in the trackelements_by_start GSequence
  *
@@ -425,6 +770,16 @@ ges_track_get_property (GObject * object, guint property_id,
     case ARG_MIXING:
       g_value_set_boolean (value, track->priv->mixing);
       break;
+    case ARG_GAP_POOL_STATS:
+      g_value_take_boxed (value, gst_structure_new ("gap-pool-stats",
+              "hits", G_TYPE_UINT, track->priv->gap_pool_hits,
+              "misses", G_TYPE_UINT, track->priv->gap_pool_misses,
+              "size", G_TYPE_UINT, track->priv->gap_pool.length, NULL));
+      break;
+    case ARG_DECODER_POOL_STATS:
+      g_value_take_boxed (value,
+          ges_decoder_pool_get_stats (track->priv->decoder_pool));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -466,6 +821,10 @@ ges_track_dispose (GObject * object)
       (GFunc) dispose_trackelements_foreach, track);
   g_sequence_free (priv->trackelements_by_start);
   g_list_free_full (priv->gaps, (GDestroyNotify) free_gap);
+  priv->gaps = NULL;
+  g_queue_foreach (&priv->gap_pool, (GFunc) free_gap, NULL);
+  g_queue_clear (&priv->gap_pool);
+  ges_decoder_pool_clear (priv->decoder_pool);
   ges_nle_object_commit (track->priv->composition, TRUE);
 
   if (priv->composition) {
@@ -490,6 +849,9 @@ ges_track_dispose (GObject * object)
 static void
 ges_track_finalize (GObject * object)
 {
+  ges_decoder_pool_unref (GES_TRACK (object)->priv->decoder_pool);
+  gst_caps_replace (&GES_TRACK (object)->priv->passthrough_caps, NULL);
+
   G_OBJECT_CLASS (ges_track_parent_class)->finalize (object);
 }
 
@@ -641,6 +1003,42 @@ ges_track_class_init (GESTrackClass * klass)
   g_object_class_install_property (object_class, ARG_MIXING,
       properties[ARG_MIXING]);
 
+  /**
+   * GESTrack:gap-pool-stats:
+   *
+   * Debugging statistics about the elements filling the gaps of the track,
+   * as a #GstStructure. "hits" is the number of times an unused gap filler
+   * could be reused, "misses" the number of times a new one had to be
+   * created and "size" the number of unused gap fillers currently kept.
+   *
+   * Since: 1.16
+   */
+  properties[ARG_GAP_POOL_STATS] =
+      g_param_spec_boxed ("gap-pool-stats", "Gap pool statistics",
+      "Statistics about the reuse of the gap fillers", GST_TYPE_STRUCTURE,
+      G_PARAM_READABLE);
+  g_object_class_install_property (object_class, ARG_GAP_POOL_STATS,
+      properties[ARG_GAP_POOL_STATS]);
+
+  /**
+   * GESTrack:decoder-pool-stats:
+   *
+   * Debugging statistics about the decoders of the file sources of the
+   * track, as a #GstStructure. "created" is the number of decoders that
+   * were created, "reused" the number of times a source could borrow the
+   * already opened decoder of an inactive source reading the same stream,
+   * "live" the number of decoders currently existing and "idle" the number
+   * of them kept opened without being used.
+   *
+   * Since: 1.16
+   */
+  properties[ARG_DECODER_POOL_STATS] =
+      g_param_spec_boxed ("decoder-pool-stats", "Decoder pool statistics",
+      "Statistics about the reuse of the decoders", GST_TYPE_STRUCTURE,
+      G_PARAM_READABLE);
+  g_object_class_install_property (object_class, ARG_DECODER_POOL_STATS,
+      properties[ARG_DECODER_POOL_STATS]);
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &ges_track_src_pad_template);
 
@@ -695,6 +1093,7 @@ ges_track_init (GESTrack * self)
   self->priv->gaps = NULL;
   self->priv->mixing = TRUE;
   self->priv->restriction_caps = NULL;
+  self->priv->decoder_pool = ges_decoder_pool_new ();
 
   g_signal_connect (G_OBJECT (self->priv->composition), "notify::duration",
       G_CALLBACK (composition_duration_cb), self);
@@ -879,7 +1278,7 @@ ges_track_set_mixing (GESTrack * track, gboolean mixing)
 {
   g_return_if_fail (GES_IS_TRACK (track));
 
-  if (!track->priv->mixing_operation) {
+  if (!track->priv->mixing_operation || track->priv->mixer_bypassed) {
     GST_DEBUG_OBJECT (track, "Track will be set to mixing = %d", mixing);
     track->priv->mixing = mixing;
     return;
@@ -994,6 +1393,12 @@ ges_track_get_elements (GESTrack * track)
 
   g_return_val_if_fail (GES_IS_TRACK (track), NULL);
 
+  if (track->priv->needs_sort) {
+    track->priv->needs_sort = FALSE;
+    g_sequence_sort (track->priv->trackelements_by_start,
+        (GCompareDataFunc) element_start_compare, NULL);
+  }
+
   g_sequence_foreach (track->priv->trackelements_by_start,
       (GFunc) add_trackelement_to_list_foreach, &ret);
 
@@ -1029,7 +1434,10 @@ ges_track_remove_element (GESTrack * track, GESTrackElement * object)
 
   it = g_hash_table_lookup (priv->trackelements_iter, object);
   g_sequence_remove (it);
-  track_resort_and_fill_gaps (track);
+  if (priv->resort_deferred)
+    priv->needs_gaps = TRUE;
+  else
+    track_resort_and_fill_gaps (track);
 
   if (remove_object_internal (track, object) == TRUE) {
     ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (object), NULL);
@@ -1113,6 +1521,8 @@ ges_track_commit (GESTrack * track)
   g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
 
   track_resort_and_fill_gaps (track);
+  if (track->priv->passthrough_caps)
+    _update_passthrough (track);
 
   return ges_nle_object_commit (track->priv->composition, TRUE);
 }
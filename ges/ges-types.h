@@ -172,6 +172,9 @@ typedef struct _GESTrackElementAssetClass GESTrackElementAssetClass;
 typedef struct _GESUriSourceAsset GESUriSourceAsset;
 typedef struct _GESUriSourceAssetClass GESUriSourceAssetClass;
 
+typedef struct _GESProxyGenerator GESProxyGenerator;
+typedef struct _GESProxyGeneratorClass GESProxyGeneratorClass;
+
 typedef struct _GESProject GESProject;
 typedef struct _GESProjectClass GESProjectClass;
 
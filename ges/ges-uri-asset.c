@@ -27,8 +27,20 @@
  * the media file to use inside the GStreamer Editing Services. It has APIs that
  * let you get information about the medias. Also, the tags found in the media file are
  * set as Metadatas of the Asser.
+ *
+ * Media files are discovered asynchronously by a pool of #GstDiscoverer, one
+ * per processor by default. The GES_DISCOVERERS environment variable can be
+ * used to set their number.
+ *
+ * The #GstDiscovererInfo of local files are cached on disk, in the user cache
+ * directory, and reused as long as the size and modification time of the
+ * files do not change. The GES_DISCOVERY_CACHE_DIR environment variable can
+ * be used to set the directory of the cache, and setting GES_DISCOVERY_CACHE
+ * to 0 disables it. See ges_uri_clip_asset_prewarm_cache() and
+ * ges_uri_clip_asset_invalidate_cache().
  */
 #include <errno.h>
+#include <glib/gstdio.h>
 #include <gst/pbutils/pbutils.h>
 #include "ges.h"
 #include "ges-internal.h"
@@ -38,9 +50,35 @@
 
 static GHashTable *parent_newparent_table = NULL;
 
+/* Discoverers used to load the assets asynchronously, the URIs are
+ * dispatched to the least loaded one */
+typedef struct
+{
+  GstDiscoverer *discoverer;
+  /* Number of URIs being discovered, atomic */
+  gint pending;
+} DiscovererSlot;
+
+static DiscovererSlot *discoverers = NULL;
+static guint n_discoverers = 0;
+
 static GstDiscoverer *discoverer = NULL;
 static GstDiscoverer *sync_discoverer = NULL;
 
+/* On-disk cache of the serialized GstDiscovererInfo of the local files, one
+ * file per URI, validated against the size and modification time of the
+ * media file */
+#define DISCOVERY_CACHE_VERSION 1
+#define DISCOVERY_CACHE_FORMAT "(usttv)"
+
+/* Size and modification time of the file, and the GstDiscovererInfo, as
+ * serialized in the projects */
+#define SERIALIZED_INFO_FORMAT "(ttv)"
+
+static gchar *discovery_cache_dir = NULL;
+static gint discovery_cache_hits = 0;
+static gint discovery_cache_misses = 0;
+
 static void
 initable_iface_init (GInitableIface * initable_iface)
 {
@@ -64,7 +102,8 @@ enum
 static GParamSpec *properties[PROP_LAST];
 
 static void discoverer_discovered_cb (GstDiscoverer * discoverer,
-    GstDiscovererInfo * info, GError * err, gpointer user_data);
+    GstDiscovererInfo * info, GError * err, DiscovererSlot * slot);
+static void asset_discovered (GstDiscovererInfo * info, GError * err);
 
 struct _GESUriClipAssetPrivate
 {
@@ -72,6 +111,9 @@ struct _GESUriClipAssetPrivate
   GstClockTime duration;
   gboolean is_image;
 
+  /* Set while checking the serialized info the asset was created from */
+  GTask *check_task;
+
   GList *asset_trackfilesources;
 };
 
@@ -83,6 +125,344 @@ struct _GESUriSourceAssetPrivate
   const gchar *uri;
 };
 
+/* Gets the size and modification time (in microseconds) of the local file
+ * @uri points to */
+static gboolean
+_discovery_cache_get_file_stamp (const gchar * uri, guint64 * size,
+    guint64 * mtime)
+{
+  GFile *file;
+  GFileInfo *file_info;
+  gboolean ret = FALSE;
+
+  if (!gst_uri_has_protocol (uri, "file"))
+    return FALSE;
+
+  file = g_file_new_for_uri (uri);
+  file_info = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  if (file_info && g_file_info_has_attribute (file_info,
+          G_FILE_ATTRIBUTE_TIME_MODIFIED)) {
+    *size = g_file_info_get_attribute_uint64 (file_info,
+        G_FILE_ATTRIBUTE_STANDARD_SIZE);
+    *mtime = g_file_info_get_attribute_uint64 (file_info,
+        G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+        g_file_info_get_attribute_uint32 (file_info,
+        G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+    ret = TRUE;
+  }
+
+  g_object_unref (file);
+  if (file_info)
+    g_object_unref (file_info);
+
+  return ret;
+}
+
+/* Layouts gst_discoverer_info_to_variant() uses, the streams are
+ * (type, common, specific) tuples, see _stream_variant_is_valid() */
+#define DISCOVERER_INFO_FORMAT "(mstbmsb)"
+#define DISCOVERER_COMMON_FORMAT "(msmsmsms)"
+#define DISCOVERER_VIDEO_FORMAT "(uuuuuuubuub)"
+#define DISCOVERER_SUBTITLE_FORMAT "(ms)"
+/* Streams can not be nested deeper than that in any sane media */
+#define DISCOVERER_MAX_DEPTH 32
+
+static gboolean _stream_variant_is_valid (GVariant * variant, guint depth);
+
+/* Whether @variant is a "v" holding a value of @type */
+static gboolean
+_boxed_variant_is_of_type (GVariant * variant, const gchar * type)
+{
+  gboolean ret;
+  GVariant *boxed;
+
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE_VARIANT))
+    return FALSE;
+
+  boxed = g_variant_get_variant (variant);
+  ret = g_variant_is_of_type (boxed, G_VARIANT_TYPE (type));
+  g_variant_unref (boxed);
+
+  return ret;
+}
+
+/* Whether @variant is a "v" holding a valid stream */
+static gboolean
+_boxed_stream_is_valid (GVariant * variant, guint depth)
+{
+  gboolean ret;
+  GVariant *boxed;
+
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE_VARIANT))
+    return FALSE;
+
+  boxed = g_variant_get_variant (variant);
+  ret = _stream_variant_is_valid (boxed, depth);
+  g_variant_unref (boxed);
+
+  return ret;
+}
+
+/* Whether @variant is an "av" of valid streams */
+static gboolean
+_stream_array_is_valid (GVariant * variant, guint depth)
+{
+  gsize i;
+  gboolean ret = TRUE;
+
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE ("av")))
+    return FALSE;
+
+  for (i = 0; ret && i < g_variant_n_children (variant); i++) {
+    GVariant *child = g_variant_get_child_value (variant, i);
+
+    ret = _boxed_stream_is_valid (child, depth);
+    g_variant_unref (child);
+  }
+
+  return ret;
+}
+
+static gboolean
+_stream_variant_is_valid (GVariant * variant, guint depth)
+{
+  guchar type;
+  gboolean ret = FALSE;
+  GVariant *common, *specific = NULL, *boxed = NULL;
+
+  if (depth > DISCOVERER_MAX_DEPTH)
+    return FALSE;
+
+  if (g_variant_is_of_type (variant, G_VARIANT_TYPE ("(yvav)")) ||
+      g_variant_is_of_type (variant, G_VARIANT_TYPE ("(yvv)"))) {
+    g_variant_get (variant, "(y@v@*)", &type, &common, &specific);
+  } else if (g_variant_is_of_type (variant, G_VARIANT_TYPE ("(yv)"))) {
+    g_variant_get (variant, "(y@v)", &type, &common);
+  } else {
+    return FALSE;
+  }
+
+  if (!_boxed_variant_is_of_type (common, DISCOVERER_COMMON_FORMAT))
+    goto done;
+
+  /* Streams without any specific part are the last ones of a chain */
+  if (!specific) {
+    ret = type == 'n';
+    goto done;
+  }
+
+  if (g_variant_is_of_type (specific, G_VARIANT_TYPE_VARIANT))
+    boxed = g_variant_get_variant (specific);
+
+  switch (type) {
+    case 'c':
+      /* The streams of containers without children are boxed */
+      ret = _stream_array_is_valid (boxed ? boxed : specific, depth + 1);
+      break;
+    case 'a':
+      /* Newer versions also store the channel mask */
+      ret = boxed && (g_variant_is_of_type (boxed, G_VARIANT_TYPE
+              ("(uuuuums)")) || g_variant_is_of_type (boxed,
+              G_VARIANT_TYPE ("(uuuuumst)")));
+      break;
+    case 'v':
+      ret = boxed && g_variant_is_of_type (boxed,
+          G_VARIANT_TYPE (DISCOVERER_VIDEO_FORMAT));
+      break;
+    case 's':
+      ret = boxed && g_variant_is_of_type (boxed,
+          G_VARIANT_TYPE (DISCOVERER_SUBTITLE_FORMAT));
+      break;
+    case 'n':
+      ret = boxed && _stream_variant_is_valid (boxed, depth + 1);
+      break;
+    default:
+      break;
+  }
+
+done:
+  g_variant_unref (common);
+  if (specific)
+    g_variant_unref (specific);
+  if (boxed)
+    g_variant_unref (boxed);
+
+  return ret;
+}
+
+/* Deserializes the output of gst_discoverer_info_to_variant(), which can
+ * come from a corrupted or hostile file. gst_discoverer_info_from_variant()
+ * trusts the layout of what it reads, so the whole type tree is checked
+ * first */
+static GstDiscovererInfo *
+_discoverer_info_from_untrusted_variant (GVariant * variant)
+{
+  gboolean valid = FALSE;
+  GVariant *wrapped, *info, *stream;
+
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE_VARIANT))
+    return NULL;
+
+  wrapped = g_variant_get_variant (variant);
+  if (g_variant_is_of_type (wrapped, G_VARIANT_TYPE ("(vv)"))) {
+    g_variant_get (wrapped, "(@v@v)", &info, &stream);
+    valid = _boxed_variant_is_of_type (info, DISCOVERER_INFO_FORMAT) &&
+        _boxed_stream_is_valid (stream, 0);
+    g_variant_unref (info);
+    g_variant_unref (stream);
+  }
+  g_variant_unref (wrapped);
+
+  if (!valid) {
+    GST_INFO ("Unexpected serialized discoverer info layout");
+
+    return NULL;
+  }
+
+  return gst_discoverer_info_from_variant (variant);
+}
+
+static gchar *
+_discovery_cache_get_path (const gchar * uri)
+{
+  gchar *path, *checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1,
+      uri, -1);
+
+  path = g_build_filename (discovery_cache_dir, checksum, NULL);
+  g_free (checksum);
+
+  return path;
+}
+
+/* Whether @name is one of the names _discovery_cache_get_path() builds, the
+ * cache directory might be shared with other files */
+static gboolean
+_discovery_cache_is_entry (const gchar * name)
+{
+  gint i;
+
+  for (i = 0; name[i]; i++) {
+    if (!g_ascii_isxdigit (name[i]) || g_ascii_isupper (name[i]))
+      return FALSE;
+  }
+
+  return i == 40;
+}
+
+/* Returns: (transfer full) (nullable): The cached #GstDiscovererInfo of @uri
+ * if it is still valid */
+static GstDiscovererInfo *
+_discovery_cache_lookup (const gchar * uri)
+{
+  gsize length;
+  guint32 version;
+  gchar *path, *data;
+  const gchar *cached_uri;
+  guint64 size, mtime, cached_size, cached_mtime;
+  GVariant *variant, *info_variant;
+  GstDiscovererInfo *info = NULL;
+
+  if (!discovery_cache_dir)
+    return NULL;
+
+  if (!_discovery_cache_get_file_stamp (uri, &size, &mtime))
+    goto done;
+
+  path = _discovery_cache_get_path (uri);
+  if (!g_file_get_contents (path, &data, &length, NULL)) {
+    g_free (path);
+    goto done;
+  }
+
+  variant = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE
+          (DISCOVERY_CACHE_FORMAT), data, length, FALSE, g_free, data));
+  if (!g_variant_is_normal_form (variant)) {
+    GST_INFO ("Removing corrupted cached discoverer info of %s", uri);
+    g_unlink (path);
+    g_variant_unref (variant);
+    g_free (path);
+    goto done;
+  }
+
+  g_variant_get (variant, "(u&sttv)", &version, &cached_uri, &cached_size,
+      &cached_mtime, &info_variant);
+
+  if (version == DISCOVERY_CACHE_VERSION && !g_strcmp0 (uri, cached_uri)
+      && size == cached_size && mtime == cached_mtime) {
+    info = _discoverer_info_from_untrusted_variant (info_variant);
+    if (!info) {
+      GST_INFO ("Removing invalid cached discoverer info of %s", uri);
+      g_unlink (path);
+    }
+  } else {
+    GST_DEBUG ("Cached discoverer info for %s is outdated", uri);
+  }
+
+  g_variant_unref (info_variant);
+  g_variant_unref (variant);
+  g_free (path);
+
+done:
+  if (info) {
+    GST_DEBUG ("Discoverer info cache hit for %s", uri);
+    g_atomic_int_inc (&discovery_cache_hits);
+  } else {
+    g_atomic_int_inc (&discovery_cache_misses);
+  }
+
+  return info;
+}
+
+static void
+_discovery_cache_store (const gchar * uri, GstDiscovererInfo * info)
+{
+  gchar *path;
+  guint64 size, mtime;
+  GError *err = NULL;
+  GVariant *variant, *info_variant;
+
+  if (!discovery_cache_dir
+      || gst_discoverer_info_get_result (info) != GST_DISCOVERER_OK)
+    return;
+
+  if (!_discovery_cache_get_file_stamp (uri, &size, &mtime))
+    return;
+
+  info_variant = gst_discoverer_info_to_variant (info,
+      GST_DISCOVERER_SERIALIZE_ALL);
+  if (!info_variant) {
+    GST_INFO ("Could not serialize the discoverer info of %s", uri);
+    return;
+  }
+
+  g_variant_ref_sink (info_variant);
+  variant = g_variant_ref_sink (g_variant_new (DISCOVERY_CACHE_FORMAT,
+          DISCOVERY_CACHE_VERSION, uri, size, mtime, info_variant));
+  g_variant_unref (info_variant);
+
+  path = _discovery_cache_get_path (uri);
+  if (g_mkdir_with_parents (discovery_cache_dir, 0755) != 0 ||
+      !g_file_set_contents (path, g_variant_get_data (variant),
+          g_variant_get_size (variant), &err)) {
+    GST_INFO ("Could not cache the discoverer info of %s: %s", uri,
+        err ? err->message : g_strerror (errno));
+    g_clear_error (&err);
+  }
+
+  g_free (path);
+  g_variant_unref (variant);
+}
+
+static gboolean
+_discovery_cache_hit_cb (GstDiscovererInfo * info)
+{
+  asset_discovered (info, NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
 
 static void
 ges_uri_clip_asset_get_property (GObject * object, guint property_id,
@@ -114,19 +494,52 @@ ges_uri_clip_asset_set_property (GObject * object, guint property_id,
   }
 }
 
-static GESAssetLoadingReturn
-_start_loading (GESAsset * asset, GError ** error)
+/* Looks @uri up in the discovery cache, or starts discovering it, the
+ * result is passed to asset_discovered() from the main loop */
+static gboolean
+_discover_uri_async (const gchar * uri)
 {
-  gboolean ret;
-  const gchar *uri;
-  GESUriClipAssetClass *class = GES_URI_CLIP_ASSET_GET_CLASS (asset);
+  guint i;
+  DiscovererSlot *slot;
+  GstDiscovererInfo *info;
+
+  if (G_UNLIKELY (!n_discoverers))
+    return FALSE;
 
-  GST_DEBUG ("Started loading %p", asset);
+  info = _discovery_cache_lookup (uri);
+  if (info) {
+    /* Complete the loading from the main loop, as the discoverers do */
+    g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+        (GSourceFunc) _discovery_cache_hit_cb, info,
+        (GDestroyNotify) gst_discoverer_info_unref);
 
-  uri = ges_asset_get_id (asset);
+    return TRUE;
+  }
 
-  ret = gst_discoverer_discover_uri_async (class->discoverer, uri);
-  if (ret)
+  /* Dispatch to the least loaded discoverer */
+  slot = &discoverers[0];
+  for (i = 1; i < n_discoverers; i++) {
+    if (g_atomic_int_get (&discoverers[i].pending) <
+        g_atomic_int_get (&slot->pending))
+      slot = &discoverers[i];
+  }
+
+  GST_DEBUG ("Started discovering %s with discoverer %" G_GSIZE_FORMAT, uri,
+      (gsize) (slot - discoverers));
+
+  g_atomic_int_inc (&slot->pending);
+  if (gst_discoverer_discover_uri_async (slot->discoverer, uri))
+    return TRUE;
+
+  g_atomic_int_add (&slot->pending, -1);
+
+  return FALSE;
+}
+
+static GESAssetLoadingReturn
+_start_loading (GESAsset * asset, GError ** error)
+{
+  if (_discover_uri_async (ges_asset_get_id (asset)))
     return GES_ASSET_LOADING_ASYNC;
 
   return GES_ASSET_LOADING_ERROR;
@@ -188,9 +601,10 @@ _asset_proxied (GESAsset * self, const gchar * new_uri)
 static void
 ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 {
+  guint i;
   GError *err;
   GstClockTime timeout;
-  const gchar *timeout_str;
+  const gchar *timeout_str, *n_discoverers_str;
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   g_type_class_add_private (klass, sizeof (GESUriClipAssetPrivate));
 
@@ -224,13 +638,35 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
   if (errno)
     timeout = DEFAULT_DISCOVERY_TIMEOUT;
 
-  if (!discoverer) {
-    discoverer = gst_discoverer_new (timeout, &err);
-    if (!discoverer) {
-      GST_ERROR ("Could not create discoverer: %s", err->message);
-      g_error_free (err);
-      return;
+  if (!discoverers) {
+    n_discoverers = g_get_num_processors ();
+    n_discoverers_str = g_getenv ("GES_DISCOVERERS");
+    if (n_discoverers_str) {
+      guint64 n = g_ascii_strtoull (n_discoverers_str, NULL, 10);
+
+      if (n > 0 && n <= G_MAXUINT16)
+        n_discoverers = n;
     }
+
+    GST_INFO ("Using %u discoverers", n_discoverers);
+    discoverers = g_new0 (DiscovererSlot, n_discoverers);
+    for (i = 0; i < n_discoverers; i++) {
+      discoverers[i].discoverer = gst_discoverer_new (timeout, &err);
+      if (!discoverers[i].discoverer) {
+        GST_ERROR ("Could not create discoverer: %s", err->message);
+        g_error_free (err);
+        n_discoverers = i;
+        return;
+      }
+
+      g_signal_connect (discoverers[i].discoverer, "discovered",
+          G_CALLBACK (discoverer_discovered_cb), &discoverers[i]);
+
+      /* We just start the discoverers and let them live */
+      gst_discoverer_start (discoverers[i].discoverer);
+    }
+
+    discoverer = g_object_ref (discoverers[0].discoverer);
   }
 
   /* The class structure keeps weak pointers on the discoverers so they
@@ -257,11 +693,18 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
         (gpointer *) & klass->sync_discoverer);
   }
 
-  g_signal_connect (klass->discoverer, "discovered",
-      G_CALLBACK (discoverer_discovered_cb), NULL);
+  if (!discovery_cache_dir && g_strcmp0 (g_getenv ("GES_DISCOVERY_CACHE"),
+          "0")) {
+    const gchar *cache_dir = g_getenv ("GES_DISCOVERY_CACHE_DIR");
+
+    if (cache_dir)
+      discovery_cache_dir = g_strdup (cache_dir);
+    else
+      discovery_cache_dir = g_build_filename (g_get_user_cache_dir (),
+          "gstreamer-1.0", "ges", "discoverer", NULL);
+    GST_INFO ("Caching the discoverer infos in %s", discovery_cache_dir);
+  }
 
-  /* We just start the discoverer and let it live */
-  gst_discoverer_start (klass->discoverer);
   if (parent_newparent_table == NULL) {
     parent_newparent_table = g_hash_table_new_full (g_file_hash,
         (GEqualFunc) g_file_equal, gst_object_unref, gst_object_unref);
@@ -279,6 +722,7 @@ ges_uri_clip_asset_init (GESUriClipAsset * self)
   priv->info = NULL;
   priv->duration = GST_CLOCK_TIME_NONE;
   priv->is_image = FALSE;
+  priv->check_task = NULL;
 }
 
 static void
@@ -405,9 +849,62 @@ _set_meta_foreach (const GstTagList * tags, const gchar * tag,
   }
 }
 
+static gboolean
+_discoverer_info_matches (GstDiscovererInfo * info, GstDiscovererInfo * other)
+{
+  gboolean ret;
+  GList *audio, *video, *other_audio, *other_video;
+
+  audio = gst_discoverer_info_get_audio_streams (info);
+  video = gst_discoverer_info_get_video_streams (info);
+  other_audio = gst_discoverer_info_get_audio_streams (other);
+  other_video = gst_discoverer_info_get_video_streams (other);
+
+  ret = gst_discoverer_info_get_duration (info) ==
+      gst_discoverer_info_get_duration (other) &&
+      g_list_length (audio) == g_list_length (other_audio) &&
+      g_list_length (video) == g_list_length (other_video);
+
+  gst_discoverer_stream_info_list_free (audio);
+  gst_discoverer_stream_info_list_free (video);
+  gst_discoverer_stream_info_list_free (other_audio);
+  gst_discoverer_stream_info_list_free (other_video);
+
+  return ret;
+}
+
 static void
-discoverer_discovered_cb (GstDiscoverer * discoverer,
-    GstDiscovererInfo * info, GError * err, gpointer user_data)
+_asset_checked (GESUriClipAsset * self, GstDiscovererInfo * info,
+    GError * err)
+{
+  GError *error = NULL;
+  GTask *task = self->priv->check_task;
+  const gchar *uri = ges_asset_get_id (GES_ASSET (self));
+
+  self->priv->check_task = NULL;
+  if (gst_discoverer_info_get_result (info) != GST_DISCOVERER_OK) {
+    if (err)
+      error = g_error_copy (err);
+    else
+      error = g_error_new (GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_FAILED,
+          "Stream %s discovering failed (error code: %d)",
+          uri, gst_discoverer_info_get_result (info));
+  } else if (!_discoverer_info_matches (self->priv->info, info)) {
+    error = g_error_new (GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "The streams of %s do not match the serialized ones", uri);
+  }
+
+  GST_DEBUG_OBJECT (self, "Checked serialized info: %s",
+      error ? error->message : "OK");
+  if (error)
+    g_task_return_error (task, error);
+  else
+    g_task_return_boolean (task, TRUE);
+  g_object_unref (task);
+}
+
+static void
+asset_discovered (GstDiscovererInfo * info, GError * err)
 {
   GError *error = NULL;
   const GstTagList *tags;
@@ -416,6 +913,11 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
   GESUriClipAsset *mfs =
       GES_URI_CLIP_ASSET (ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri));
 
+  if (mfs->priv->check_task) {
+    _asset_checked (mfs, info, err);
+    return;
+  }
+
   tags = gst_discoverer_info_get_tags (info);
   if (tags)
     gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
@@ -440,6 +942,18 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
     g_error_free (error);
 }
 
+static void
+discoverer_discovered_cb (GstDiscoverer * discoverer,
+    GstDiscovererInfo * info, GError * err, DiscovererSlot * slot)
+{
+  g_atomic_int_add (&slot->pending, -1);
+
+  if (!err)
+    _discovery_cache_store (gst_discoverer_info_get_uri (info), info);
+
+  asset_discovered (info, err);
+}
+
 /* API implementation */
 /**
  * ges_uri_clip_asset_get_info:
@@ -584,7 +1098,12 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
     g_free (first_file_uri);
     g_free (first_file);
   } else {
-    info = gst_discoverer_discover_uri (discoverer, uri, &lerror);
+    info = _discovery_cache_lookup (uri);
+    if (!info) {
+      info = gst_discoverer_discover_uri (discoverer, uri, &lerror);
+      if (info && !lerror)
+        _discovery_cache_store (uri, info);
+    }
   }
 
   /* We might get a discoverer info but it might have a non-OK result. We
@@ -627,12 +1146,145 @@ void
 ges_uri_clip_asset_class_set_timeout (GESUriClipAssetClass * klass,
     GstClockTime timeout)
 {
+  guint i;
+
   g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
 
-  g_object_set (klass->discoverer, "timeout", timeout, NULL);
+  for (i = 0; i < n_discoverers; i++)
+    g_object_set (discoverers[i].discoverer, "timeout", timeout, NULL);
   g_object_set (klass->sync_discoverer, "timeout", timeout, NULL);
 }
 
+/**
+ * ges_uri_clip_asset_prewarm_cache:
+ * @uri: The URI of a local media file
+ * @error: (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Synchronously discovers @uri and stores the resulting #GstDiscovererInfo in
+ * the discovery cache, unless a valid one is already cached, so that later
+ * #GESUriClipAsset requests for @uri do not need to run a #GstDiscoverer.
+ *
+ * Returns: %TRUE if the #GstDiscovererInfo of @uri is cached, %FALSE
+ * otherwise
+ *
+ * Since: 1.16
+ */
+gboolean
+ges_uri_clip_asset_prewarm_cache (const gchar * uri, GError ** error)
+{
+  GError *lerror = NULL;
+  GstDiscovererInfo *info;
+
+  g_return_val_if_fail (uri, FALSE);
+
+  if (!discovery_cache_dir) {
+    g_set_error (error, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "The discovery cache is disabled");
+
+    return FALSE;
+  }
+
+  if (!gst_uri_has_protocol (uri, "file")) {
+    g_set_error (error, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Only local files can be cached, not %s", uri);
+
+    return FALSE;
+  }
+
+  info = _discovery_cache_lookup (uri);
+  if (info) {
+    gst_discoverer_info_unref (info);
+
+    return TRUE;
+  }
+
+  info = gst_discoverer_discover_uri (sync_discoverer, uri, &lerror);
+  if (info && !lerror
+      && gst_discoverer_info_get_result (info) != GST_DISCOVERER_OK) {
+    lerror = g_error_new (GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_FAILED,
+        "Stream %s discovering failed (error code: %d)", uri,
+        gst_discoverer_info_get_result (info));
+  }
+
+  if (!lerror)
+    _discovery_cache_store (uri, info);
+
+  if (info)
+    gst_discoverer_info_unref (info);
+
+  if (lerror) {
+    g_propagate_error (error, lerror);
+
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * ges_uri_clip_asset_invalidate_cache:
+ * @uri: (allow-none): The URI to remove from the discovery cache, or %NULL
+ * to clear the whole cache
+ *
+ * Removes the cached #GstDiscovererInfo of @uri, so that it is discovered
+ * again next time it is requested. Only the cache entries are removed from
+ * the cache directory, any other file in there is left untouched.
+ *
+ * Since: 1.16
+ */
+void
+ges_uri_clip_asset_invalidate_cache (const gchar * uri)
+{
+  GDir *dir;
+  gchar *path;
+  const gchar *name;
+
+  if (!discovery_cache_dir)
+    return;
+
+  if (uri) {
+    path = _discovery_cache_get_path (uri);
+    g_unlink (path);
+    g_free (path);
+
+    return;
+  }
+
+  dir = g_dir_open (discovery_cache_dir, 0, NULL);
+  if (!dir)
+    return;
+
+  while ((name = g_dir_read_name (dir))) {
+    if (!_discovery_cache_is_entry (name))
+      continue;
+
+    path = g_build_filename (discovery_cache_dir, name, NULL);
+    g_unlink (path);
+    g_free (path);
+  }
+  g_dir_close (dir);
+}
+
+/**
+ * ges_uri_clip_asset_get_cache_stats:
+ *
+ * Gets statistics about the discovery cache as a #GstStructure. "hits" is
+ * the number of times a valid #GstDiscovererInfo was found in the cache and
+ * "misses" the number of times a media file had to be discovered.
+ *
+ * Returns: (transfer full): The statistics of the discovery cache
+ *
+ * Since: 1.16
+ */
+GstStructure *
+ges_uri_clip_asset_get_cache_stats (void)
+{
+  return gst_structure_new ("discovery-cache-stats",
+      "hits", G_TYPE_UINT, g_atomic_int_get (&discovery_cache_hits),
+      "misses", G_TYPE_UINT, g_atomic_int_get (&discovery_cache_misses),
+      NULL);
+}
+
 /**
  * ges_uri_clip_asset_get_stream_assets:
  * @self: A #GESUriClipAsset
@@ -766,9 +1418,141 @@ ges_uri_source_asset_get_filesource_asset (GESUriSourceAsset * asset)
   return asset->priv->parent_asset;
 }
 
+/* Serializes the stream information of @self so that it can be restored
+ * with ges_uri_clip_asset_new_from_serialized_info() */
+gchar *
+ges_uri_clip_asset_serialize_info (GESUriClipAsset * self)
+{
+  gchar *ret;
+  guint64 size = 0, mtime = 0;
+  GVariant *variant, *info_variant;
+
+  if (!self->priv->info)
+    return NULL;
+
+  /* Lets the loader notice that the file changed since the project was
+   * saved, left to 0 when that can not be known */
+  _discovery_cache_get_file_stamp (ges_asset_get_id (GES_ASSET (self)),
+      &size, &mtime);
+
+  /* Tags are serialized as the asset metadatas */
+  info_variant = gst_discoverer_info_to_variant (self->priv->info,
+      GST_DISCOVERER_SERIALIZE_CAPS);
+  if (!info_variant)
+    return NULL;
+
+  g_variant_ref_sink (info_variant);
+  variant = g_variant_ref_sink (g_variant_new (SERIALIZED_INFO_FORMAT, size,
+          mtime, info_variant));
+  ret = g_base64_encode (g_variant_get_data (variant),
+      g_variant_get_size (variant));
+  g_variant_unref (variant);
+  g_variant_unref (info_variant);
+
+  return ret;
+}
+
+/* Creates a loaded asset for @uri from the output of
+ * ges_uri_clip_asset_serialize_info() without discovering it. Returns %NULL
+ * if @serialized_info is invalid or outdated, so that @uri gets discovered,
+ * or if @uri already has an asset. */
+GESAsset *
+ges_uri_clip_asset_new_from_serialized_info (const gchar * uri,
+    const gchar * serialized_info)
+{
+  gsize length;
+  guchar *data;
+  GESUriClipAsset *asset;
+  GstDiscovererInfo *info = NULL;
+  GVariant *variant, *info_variant;
+  guint64 size, mtime, serialized_size, serialized_mtime;
+
+  if (g_str_has_prefix (uri, GES_MULTI_FILE_URI_PREFIX) ||
+      ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri))
+    return NULL;
+
+  data = g_base64_decode (serialized_info, &length);
+  variant = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE
+          (SERIALIZED_INFO_FORMAT), data, length, FALSE, g_free, data));
+  if (!g_variant_is_normal_form (variant)) {
+    GST_INFO ("Corrupted serialized stream information for %s", uri);
+    g_variant_unref (variant);
+
+    return NULL;
+  }
+
+  g_variant_get (variant, "(ttv)", &serialized_size, &serialized_mtime,
+      &info_variant);
+  if (serialized_mtime && _discovery_cache_get_file_stamp (uri, &size,
+          &mtime) && (size != serialized_size || mtime != serialized_mtime))
+    GST_INFO ("%s changed since its stream information was serialized", uri);
+  else
+    info = _discoverer_info_from_untrusted_variant (info_variant);
+  g_variant_unref (info_variant);
+  g_variant_unref (variant);
+
+  if (!info) {
+    GST_INFO ("Not using the serialized stream information of %s", uri);
+
+    return NULL;
+  }
+
+  asset = g_object_new (GES_TYPE_URI_CLIP_ASSET, "id", uri,
+      "extractable-type", GES_TYPE_URI_CLIP, NULL);
+  ges_asset_cache_put (gst_object_ref (asset), NULL);
+  ges_uri_clip_asset_set_info (asset, info);
+  ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, NULL);
+  gst_discoverer_info_unref (info);
+
+  return GES_ASSET (asset);
+}
+
+/* Discovers the media file of an asset created with
+ * ges_uri_clip_asset_new_from_serialized_info() in the background, and
+ * fails if it does not match the serialized stream information */
+void
+ges_uri_clip_asset_check_info_async (GESUriClipAsset * self,
+    GAsyncReadyCallback callback, gpointer user_data)
+{
+  GTask *task = g_task_new (self, NULL, callback, user_data);
+
+  if (self->priv->check_task) {
+    g_task_return_new_error (task, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "%s is already being checked", ges_asset_get_id (GES_ASSET (self)));
+    g_object_unref (task);
+
+    return;
+  }
+
+  self->priv->check_task = task;
+  if (!_discover_uri_async (ges_asset_get_id (GES_ASSET (self)))) {
+    self->priv->check_task = NULL;
+    g_task_return_new_error (task, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not start discovering %s", ges_asset_get_id (GES_ASSET (self)));
+    g_object_unref (task);
+  }
+}
+
+gboolean
+ges_uri_clip_asset_check_info_finish (GESUriClipAsset * self,
+    GAsyncResult * result, GError ** error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 void
 _ges_uri_asset_cleanup (void)
 {
+  guint i;
+
+  for (i = 0; i < n_discoverers; i++)
+    g_object_unref (discoverers[i].discoverer);
+  g_clear_pointer (&discoverers, g_free);
+  n_discoverers = 0;
+
   g_clear_object (&discoverer);
   g_clear_object (&sync_discoverer);
+  g_clear_pointer (&discovery_cache_dir, g_free);
 }
@@ -86,6 +86,13 @@ void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *klass
                                                      GstClockTime timeout);
 GES_API
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
+GES_API
+gboolean ges_uri_clip_asset_prewarm_cache           (const gchar *uri,
+                                                     GError **error);
+GES_API
+void ges_uri_clip_asset_invalidate_cache            (const gchar *uri);
+GES_API
+GstStructure * ges_uri_clip_asset_get_cache_stats   (void);
 
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
 #define GES_URI_SOURCE_ASSET(obj) \
@@ -0,0 +1,582 @@
+/* GStreamer Editing Services
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * ges-video-blender.c: Crossfades and wipes between two video streams
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Blends the frames of its two sink pads, the first one being the stream
+ * the transition goes from, in the format they are negotiated in, avoiding
+ * the conversions to and from BGRA smptealpha and the compositor need.
+ * Frames are scaled and converted by the pads only when they do not match
+ * the output already. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#elif defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "ges-internal.h"
+#include "ges-video-blender.h"
+
+/* All components are 8 bits and each plane stores whole pixels, so the
+ * frames can be blended byte per byte */
+#define BLEND_FORMATS "{ I420, YV12, NV12, NV21, Y42B, Y444, Y41B, YUY2, " \
+    "UYVY, YVYU, AYUV, BGRA, RGBA, ARGB, ABGR, BGRx, RGBx, xRGB, xBGR, " \
+    "RGB, BGR, GRAY8 }"
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (BLEND_FORMATS))
+    );
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink_%u",
+    GST_PAD_SINK,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+enum
+{
+  PROP_0,
+  PROP_TRANSITION_TYPE,
+  PROP_POSITION,
+  PROP_BORDER,
+  PROP_INVERT,
+};
+
+/* Pads only scale their frames to the output size on top of the format
+ * conversion */
+typedef GstVideoAggregatorConvertPad GESVideoBlenderPad;
+typedef GstVideoAggregatorConvertPadClass GESVideoBlenderPadClass;
+
+static GType ges_video_blender_pad_get_type (void);
+G_DEFINE_TYPE (GESVideoBlenderPad, ges_video_blender_pad,
+    GST_TYPE_VIDEO_AGGREGATOR_CONVERT_PAD);
+
+static void
+ges_video_blender_pad_create_conversion_info (GstVideoAggregatorConvertPad *
+    pad, GstVideoAggregator * vagg, GstVideoInfo * conversion_info)
+{
+  GstVideoInfo info;
+
+  GST_VIDEO_AGGREGATOR_CONVERT_PAD_CLASS
+      (ges_video_blender_pad_parent_class)->create_conversion_info (pad, vagg,
+      conversion_info);
+
+  if (!conversion_info->finfo ||
+      GST_VIDEO_INFO_FORMAT (conversion_info) == GST_VIDEO_FORMAT_UNKNOWN)
+    return;
+
+  if (GST_VIDEO_INFO_WIDTH (conversion_info) ==
+      GST_VIDEO_INFO_WIDTH (&vagg->info) &&
+      GST_VIDEO_INFO_HEIGHT (conversion_info) ==
+      GST_VIDEO_INFO_HEIGHT (&vagg->info))
+    return;
+
+  gst_video_info_set_format (&info, GST_VIDEO_INFO_FORMAT (conversion_info),
+      GST_VIDEO_INFO_WIDTH (&vagg->info), GST_VIDEO_INFO_HEIGHT (&vagg->info));
+  info.chroma_site = conversion_info->chroma_site;
+  info.colorimetry = conversion_info->colorimetry;
+  info.par_n = conversion_info->par_n;
+  info.par_d = conversion_info->par_d;
+  info.fps_n = conversion_info->fps_n;
+  info.fps_d = conversion_info->fps_d;
+  info.interlace_mode = conversion_info->interlace_mode;
+
+  *conversion_info = info;
+}
+
+static void
+ges_video_blender_pad_class_init (GESVideoBlenderPadClass * klass)
+{
+  klass->create_conversion_info = ges_video_blender_pad_create_conversion_info;
+}
+
+static void
+ges_video_blender_pad_init (GESVideoBlenderPad * pad)
+{
+}
+
+#define parent_class ges_video_blender_parent_class
+G_DEFINE_TYPE (GESVideoBlender, ges_video_blender, GST_TYPE_VIDEO_AGGREGATOR);
+
+/* The component whose layout describes @plane */
+static guint
+_plane_component (const GstVideoFormatInfo * finfo, guint plane)
+{
+  guint c;
+
+  for (c = 0; c < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); c++) {
+    if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, c) == plane)
+      return c;
+  }
+
+  return 0;
+}
+
+/* Weight of the second input, in 1/256th, at @pos pixels from the side the
+ * wipe starts from */
+static inline guint
+_wipe_weight (gint pos, gdouble edge, gdouble border)
+{
+  gdouble v = edge - pos;
+
+  if (border <= 0)
+    return v > 0 ? 256 : 0;
+
+  return CLAMP (v * 256 / border, 0, 256);
+}
+
+/* The blending kernels work on bytes with a weight in 1/256th, so that
+ * a * (256 - w) + b * w always fits in 16 bits. 16 bytes are blended at once
+ * with SSE2 or NEON when available, the plain loops handle the remaining
+ * bytes and the other architectures. */
+static inline void
+_crossfade_row (guint8 * dest, const guint8 * a, const guint8 * b,
+    gsize size, guint weight)
+{
+  gsize i = 0;
+  guint iweight = 256 - weight;
+
+  if (weight == 0) {
+    memcpy (dest, a, size);
+    return;
+  } else if (weight == 256) {
+    memcpy (dest, b, size);
+    return;
+  }
+#if defined (__SSE2__)
+  {
+    __m128i zero = _mm_setzero_si128 ();
+    __m128i vweight = _mm_set1_epi16 (weight);
+    __m128i viweight = _mm_set1_epi16 (iweight);
+
+    for (; i + 16 <= size; i += 16) {
+      __m128i va = _mm_loadu_si128 ((const __m128i *) (a + i));
+      __m128i vb = _mm_loadu_si128 ((const __m128i *) (b + i));
+      __m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (va,
+                  zero), viweight), _mm_mullo_epi16 (_mm_unpacklo_epi8 (vb,
+                  zero), vweight));
+      __m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (va,
+                  zero), viweight), _mm_mullo_epi16 (_mm_unpackhi_epi8 (vb,
+                  zero), vweight));
+
+      _mm_storeu_si128 ((__m128i *) (dest + i),
+          _mm_packus_epi16 (_mm_srli_epi16 (lo, 8), _mm_srli_epi16 (hi, 8)));
+    }
+  }
+#elif defined (__ARM_NEON)
+  {
+    uint16x8_t vweight = vdupq_n_u16 (weight);
+    uint16x8_t viweight = vdupq_n_u16 (iweight);
+
+    for (; i + 16 <= size; i += 16) {
+      uint8x16_t va = vld1q_u8 (a + i);
+      uint8x16_t vb = vld1q_u8 (b + i);
+      uint16x8_t lo = vmulq_u16 (vmovl_u8 (vget_low_u8 (va)), viweight);
+      uint16x8_t hi = vmulq_u16 (vmovl_u8 (vget_high_u8 (va)), viweight);
+
+      lo = vmlaq_u16 (lo, vmovl_u8 (vget_low_u8 (vb)), vweight);
+      hi = vmlaq_u16 (hi, vmovl_u8 (vget_high_u8 (vb)), vweight);
+      vst1q_u8 (dest + i, vcombine_u8 (vshrn_n_u16 (lo, 8),
+              vshrn_n_u16 (hi, 8)));
+    }
+  }
+#endif
+
+  for (; i < size; i++)
+    dest[i] = (a[i] * iweight + b[i] * weight) >> 8;
+}
+
+static inline void
+_blend_row (guint8 * dest, const guint8 * a, const guint8 * b,
+    const guint16 * weights, gsize size)
+{
+  gsize i = 0;
+
+#if defined (__SSE2__)
+  {
+    __m128i zero = _mm_setzero_si128 ();
+    __m128i full = _mm_set1_epi16 (256);
+
+    for (; i + 16 <= size; i += 16) {
+      __m128i va = _mm_loadu_si128 ((const __m128i *) (a + i));
+      __m128i vb = _mm_loadu_si128 ((const __m128i *) (b + i));
+      __m128i wlo = _mm_loadu_si128 ((const __m128i *) (weights + i));
+      __m128i whi = _mm_loadu_si128 ((const __m128i *) (weights + i + 8));
+      __m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (va,
+                  zero), _mm_sub_epi16 (full, wlo)),
+          _mm_mullo_epi16 (_mm_unpacklo_epi8 (vb, zero), wlo));
+      __m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (va,
+                  zero), _mm_sub_epi16 (full, whi)),
+          _mm_mullo_epi16 (_mm_unpackhi_epi8 (vb, zero), whi));
+
+      _mm_storeu_si128 ((__m128i *) (dest + i),
+          _mm_packus_epi16 (_mm_srli_epi16 (lo, 8), _mm_srli_epi16 (hi, 8)));
+    }
+  }
+#elif defined (__ARM_NEON)
+  {
+    uint16x8_t full = vdupq_n_u16 (256);
+
+    for (; i + 16 <= size; i += 16) {
+      uint8x16_t va = vld1q_u8 (a + i);
+      uint8x16_t vb = vld1q_u8 (b + i);
+      uint16x8_t wlo = vld1q_u16 (weights + i);
+      uint16x8_t whi = vld1q_u16 (weights + i + 8);
+      uint16x8_t lo = vmulq_u16 (vmovl_u8 (vget_low_u8 (va)),
+          vsubq_u16 (full, wlo));
+      uint16x8_t hi = vmulq_u16 (vmovl_u8 (vget_high_u8 (va)),
+          vsubq_u16 (full, whi));
+
+      lo = vmlaq_u16 (lo, vmovl_u8 (vget_low_u8 (vb)), wlo);
+      hi = vmlaq_u16 (hi, vmovl_u8 (vget_high_u8 (vb)), whi);
+      vst1q_u8 (dest + i, vcombine_u8 (vshrn_n_u16 (lo, 8),
+              vshrn_n_u16 (hi, 8)));
+    }
+  }
+#endif
+
+  for (; i < size; i++)
+    dest[i] = (a[i] * (256 - weights[i]) + b[i] * weights[i]) >> 8;
+}
+
+/* Computes the weight of each byte of the rows of @plane for horizontal
+ * wipes */
+static void
+_fill_column_weights (GESVideoBlender * self, GstVideoFrame * out,
+    guint plane, gdouble edge, gdouble border, gboolean invert)
+{
+  gsize i;
+  const GstVideoFormatInfo *finfo = out->info.finfo;
+  guint c = _plane_component (finfo, plane);
+  gint width = GST_VIDEO_FRAME_WIDTH (out);
+  gint pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, c);
+  gint w_sub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, c);
+  gsize row_size = GST_VIDEO_FRAME_COMP_WIDTH (out, c) * pstride;
+
+  if (self->n_weights < row_size) {
+    self->weights = g_renew (guint16, self->weights, row_size);
+    self->n_weights = row_size;
+  }
+
+  for (i = 0; i < row_size; i++) {
+    gint x = MIN ((gint) (i / pstride) << w_sub, width - 1);
+
+    self->weights[i] = _wipe_weight (invert ? width - 1 - x : x, edge, border);
+  }
+}
+
+static void
+_blend_frames (GESVideoBlender * self, GstVideoFrame * out,
+    GstVideoFrame * a, GstVideoFrame * b, GESVideoStandardTransitionType type,
+    gdouble position, guint border, gboolean invert)
+{
+  guint plane;
+  gdouble size, soft = 0, edge = 0;
+  gint width = GST_VIDEO_FRAME_WIDTH (out);
+  gint height = GST_VIDEO_FRAME_HEIGHT (out);
+  const GstVideoFormatInfo *finfo = out->info.finfo;
+
+  if (type != GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
+    /* The border is expressed in 1/65536th of the wipe, as for smpte */
+    size = type == GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_TB ?
+        height : width;
+    soft = (gdouble) border * size / 65536;
+    edge = position * (size + soft);
+  }
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (out); plane++) {
+    gint row;
+    guint c = _plane_component (finfo, plane);
+    gint h_sub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, c);
+    gsize row_size = GST_VIDEO_FRAME_COMP_WIDTH (out, c) *
+        GST_VIDEO_FRAME_COMP_PSTRIDE (out, c);
+    gint dstride = GST_VIDEO_FRAME_PLANE_STRIDE (out, plane);
+    gint astride = GST_VIDEO_FRAME_PLANE_STRIDE (a, plane);
+    gint bstride = GST_VIDEO_FRAME_PLANE_STRIDE (b, plane);
+    guint8 *dest = GST_VIDEO_FRAME_PLANE_DATA (out, plane);
+    const guint8 *srca = GST_VIDEO_FRAME_PLANE_DATA (a, plane);
+    const guint8 *srcb = GST_VIDEO_FRAME_PLANE_DATA (b, plane);
+
+    switch (type) {
+      case GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE:
+      {
+        guint weight = position * 256 + 0.5;
+
+        for (row = 0; row < GST_VIDEO_FRAME_COMP_HEIGHT (out, c); row++)
+          _crossfade_row (dest + row * dstride, srca + row * astride,
+              srcb + row * bstride, row_size, weight);
+        break;
+      }
+      case GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_TB:
+        for (row = 0; row < GST_VIDEO_FRAME_COMP_HEIGHT (out, c); row++) {
+          gint y = MIN (row << h_sub, height - 1);
+
+          _crossfade_row (dest + row * dstride, srca + row * astride,
+              srcb + row * bstride, row_size,
+              _wipe_weight (invert ? height - 1 - y : y, edge, soft));
+        }
+        break;
+      default:
+        _fill_column_weights (self, out, plane, edge, soft, invert);
+        for (row = 0; row < GST_VIDEO_FRAME_COMP_HEIGHT (out, c); row++)
+          _blend_row (dest + row * dstride, srca + row * astride,
+              srcb + row * bstride, self->weights, row_size);
+        break;
+    }
+  }
+}
+
+static void
+_fill_black (GstVideoFrame * frame)
+{
+  gint x, y;
+  guint8 *line;
+  gint width = GST_VIDEO_FRAME_WIDTH (frame);
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  /* Opaque black in the AYUV or ARGB unpack format of the frame */
+  guint8 black[4] = { 0xff, 0, 0, 0 };
+
+  if (GST_VIDEO_FORMAT_INFO_IS_YUV (finfo)) {
+    black[1] = 16;
+    black[2] = black[3] = 128;
+  }
+
+  line = g_malloc (width * 4);
+  for (x = 0; x < width; x++)
+    memcpy (line + x * 4, black, 4);
+
+  for (y = 0; y < GST_VIDEO_FRAME_HEIGHT (frame); y++)
+    finfo->pack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, line, 0, frame->data,
+        frame->info.stride, frame->info.chroma_site, y, width);
+
+  g_free (line);
+}
+
+static GstFlowReturn
+ges_video_blender_aggregate_frames (GstVideoAggregator * vagg,
+    GstBuffer * outbuf)
+{
+  GList *tmp;
+  guint n = 0;
+  GstVideoFrame out;
+  GstClockTime timestamp = GST_BUFFER_PTS (outbuf);
+  GstVideoFrame *frames[2] = { NULL, NULL };
+  GESVideoBlender *self = GES_VIDEO_BLENDER (vagg);
+  GstSegment *segment =
+      &GST_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (vagg))->segment;
+
+  if (GST_CLOCK_TIME_IS_VALID (timestamp))
+    gst_object_sync_values (GST_OBJECT (self),
+        gst_segment_to_stream_time (segment, GST_FORMAT_TIME, timestamp));
+
+  if (!gst_video_frame_map (&out, &vagg->info, outbuf, GST_MAP_WRITE))
+    return GST_FLOW_ERROR;
+
+  GST_OBJECT_LOCK (vagg);
+  for (tmp = GST_ELEMENT (vagg)->sinkpads; tmp && n < 2; tmp = tmp->next)
+    frames[n++] = gst_video_aggregator_pad_get_prepared_frame (tmp->data);
+
+  if (frames[0] && frames[1])
+    _blend_frames (self, &out, frames[0], frames[1], self->type,
+        self->position, self->border, self->invert);
+  else if (frames[0] || frames[1])
+    gst_video_frame_copy (&out, frames[0] ? frames[0] : frames[1]);
+  else
+    _fill_black (&out);
+  GST_OBJECT_UNLOCK (vagg);
+
+  gst_video_frame_unmap (&out);
+
+  return GST_FLOW_OK;
+}
+
+static GstPad *
+ges_video_blender_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps)
+{
+  guint16 n_pads;
+
+  GST_OBJECT_LOCK (element);
+  n_pads = element->numsinkpads;
+  GST_OBJECT_UNLOCK (element);
+
+  if (n_pads >= 2) {
+    GST_INFO_OBJECT (element, "Only two streams can be blended");
+
+    return NULL;
+  }
+
+  return GST_ELEMENT_CLASS (parent_class)->request_new_pad (element, templ,
+      name, caps);
+}
+
+static void
+ges_video_blender_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESVideoBlender *self = GES_VIDEO_BLENDER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (property_id) {
+    case PROP_TRANSITION_TYPE:
+      self->type = g_value_get_enum (value);
+      break;
+    case PROP_POSITION:
+      self->position = g_value_get_double (value);
+      break;
+    case PROP_BORDER:
+      self->border = g_value_get_uint (value);
+      break;
+    case PROP_INVERT:
+      self->invert = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+ges_video_blender_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESVideoBlender *self = GES_VIDEO_BLENDER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (property_id) {
+    case PROP_TRANSITION_TYPE:
+      g_value_set_enum (value, self->type);
+      break;
+    case PROP_POSITION:
+      g_value_set_double (value, self->position);
+      break;
+    case PROP_BORDER:
+      g_value_set_uint (value, self->border);
+      break;
+    case PROP_INVERT:
+      g_value_set_boolean (value, self->invert);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+ges_video_blender_finalize (GObject * object)
+{
+  g_free (GES_VIDEO_BLENDER (object)->weights);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+ges_video_blender_class_init (GESVideoBlenderClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstVideoAggregatorClass *vagg_class = GST_VIDEO_AGGREGATOR_CLASS (klass);
+
+  gobject_class->set_property = ges_video_blender_set_property;
+  gobject_class->get_property = ges_video_blender_get_property;
+  gobject_class->finalize = ges_video_blender_finalize;
+
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (ges_video_blender_request_new_pad);
+  vagg_class->aggregate_frames =
+      GST_DEBUG_FUNCPTR (ges_video_blender_aggregate_frames);
+
+  g_object_class_install_property (gobject_class, PROP_TRANSITION_TYPE,
+      g_param_spec_enum ("transition-type", "Transition type",
+          "The type of the transition", GES_VIDEO_STANDARD_TRANSITION_TYPE_TYPE,
+          GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE, G_PARAM_READWRITE));
+
+  g_object_class_install_property (gobject_class, PROP_POSITION,
+      g_param_spec_double ("position", "Position",
+          "Progress of the transition, from only showing the first stream "
+          "to only showing the second one", 0.0, 1.0, 0.0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE));
+
+  g_object_class_install_property (gobject_class, PROP_BORDER,
+      g_param_spec_uint ("border", "Border",
+          "The width of the soft edge of wipes, in 1/65536th of the wipe",
+          0, G_MAXUINT, 0, G_PARAM_READWRITE));
+
+  g_object_class_install_property (gobject_class, PROP_INVERT,
+      g_param_spec_boolean ("invert", "Invert",
+          "Whether wipes go from right to left and bottom to top", FALSE,
+          G_PARAM_READWRITE));
+
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &src_template, GST_TYPE_AGGREGATOR_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &sink_template, ges_video_blender_pad_get_type ());
+
+  gst_element_class_set_static_metadata (element_class, "Video blender",
+      "Filter/Editor/Video/Compositor",
+      "Crossfades and wipes between two video streams in their own format",
+      "agent <agent@local>");
+}
+
+static void
+ges_video_blender_init (GESVideoBlender * self)
+{
+  self->type = GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE;
+  self->position = 0.0;
+  self->border = 0;
+  self->invert = FALSE;
+  self->weights = NULL;
+  self->n_weights = 0;
+}
+
+/* Wipes the blender does not implement are left to smptealpha, it also
+ * handles %GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE as the bar wipe
+ * smptealpha is created with */
+gboolean
+ges_video_blender_supports_transition_type (GESVideoStandardTransitionType
+    type)
+{
+  return type == GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE ||
+      type == GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE ||
+      type == GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR ||
+      type == GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_TB;
+}
+
+gboolean
+ges_video_blender_supports_caps (const GstCaps * caps)
+{
+  gboolean res;
+  GstCaps *template_caps = gst_static_pad_template_get_caps (&src_template);
+
+  res = gst_caps_can_intersect (caps, template_caps);
+  gst_caps_unref (template_caps);
+
+  return res;
+}
@@ -0,0 +1,66 @@
+/* GStreamer Editing Services
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_VIDEO_BLENDER_H_
+#define _GES_VIDEO_BLENDER_H_
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/video/gstvideoaggregator.h>
+
+#include "ges-enums.h"
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_VIDEO_BLENDER             (ges_video_blender_get_type ())
+#define GES_VIDEO_BLENDER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_VIDEO_BLENDER, GESVideoBlender))
+#define GES_VIDEO_BLENDER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_VIDEO_BLENDER, GESVideoBlenderClass))
+#define GES_IS_VIDEO_BLENDER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_VIDEO_BLENDER))
+#define GES_IS_VIDEO_BLENDER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_VIDEO_BLENDER))
+
+typedef struct _GESVideoBlender GESVideoBlender;
+typedef struct _GESVideoBlenderClass GESVideoBlenderClass;
+
+struct _GESVideoBlender
+{
+  GstVideoAggregator parent;
+
+  GESVideoStandardTransitionType type;
+  gdouble position;
+  guint border;
+  gboolean invert;
+
+  /* Per byte weights of the second input for the current row */
+  guint16 *weights;
+  gsize n_weights;
+};
+
+struct _GESVideoBlenderClass
+{
+  GstVideoAggregatorClass parent_class;
+};
+
+G_GNUC_INTERNAL GType ges_video_blender_get_type (void);
+G_GNUC_INTERNAL gboolean
+ges_video_blender_supports_transition_type (GESVideoStandardTransitionType type);
+G_GNUC_INTERNAL gboolean
+ges_video_blender_supports_caps (const GstCaps * caps);
+
+G_END_DECLS
+#endif /* _GES_VIDEO_BLENDER_H_ */
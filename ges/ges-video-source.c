@@ -59,6 +59,26 @@
  *  <entry>The desired height for that source. Set to 0 if size is not mandatory, will be set to height of the current track.</entry>
  * </row>
  * <row>
+ *  <entry role="property_type"><link linkend="gint"><type>gint</type></link></entry>
+ *  <entry role="property_name"><link linkend="GESVideoSource--crop-left">crop-left</link></entry>
+ *  <entry>The number of pixels to crop from the left of the source, rounded down to an even number.</entry>
+ * </row>
+ * <row>
+ *  <entry role="property_type"><link linkend="gint"><type>gint</type></link></entry>
+ *  <entry role="property_name"><link linkend="GESVideoSource--crop-right">crop-right</link></entry>
+ *  <entry>The number of pixels to crop from the right of the source.</entry>
+ * </row>
+ * <row>
+ *  <entry role="property_type"><link linkend="gint"><type>gint</type></link></entry>
+ *  <entry role="property_name"><link linkend="GESVideoSource--crop-top">crop-top</link></entry>
+ *  <entry>The number of pixels to crop from the top of the source, rounded down to an even number.</entry>
+ * </row>
+ * <row>
+ *  <entry role="property_type"><link linkend="gint"><type>gint</type></link></entry>
+ *  <entry role="property_name"><link linkend="GESVideoSource--crop-bottom">crop-bottom</link></entry>
+ *  <entry>The number of pixels to crop from the bottom of the source.</entry>
+ * </row>
+ * <row>
  *  <entry role="property_type"><link linkend="GstDeinterlaceModes"><type>GstDeinterlaceModes</type></link></entry>
  *  <entry role="property_name"><link linkend="GESVideoSource--deinterlace-mode">deinterlace-mode</link></entry>
  *  <entry>Deinterlace Mode</entry>
@@ -85,15 +105,39 @@
 #include "ges-track-element.h"
 #include "ges-video-source.h"
 #include "ges-layer.h"
+#include "ges-uri-asset.h"
 #include "gstframepositioner.h"
 
 #define parent_class ges_video_source_parent_class
 G_DEFINE_ABSTRACT_TYPE (GESVideoSource, ges_video_source, GES_TYPE_SOURCE);
 
+/* The conversion elements that are only plugged when the media needs them */
+typedef enum
+{
+  CHAIN_CONVERT = 1 << 0,
+  CHAIN_DEINTERLACE = 1 << 1,
+  CHAIN_SCALE = 1 << 2,
+  CHAIN_RATE = 1 << 3,
+  CHAIN_ALL = CHAIN_CONVERT | CHAIN_DEINTERLACE | CHAIN_SCALE | CHAIN_RATE
+} ChainElements;
+
 struct _GESVideoSourcePrivate
 {
   GstFramePositioner *positioner;
   GstElement *capsfilter;
+
+  /* queue ! [videoconvert] ! [deinterlace] ! framepositioner ! [videoscale]
+   * ! [videorate] ! capsfilter, we own a reference on the optional
+   * elements so that they can be plugged back */
+  GstElement *queue;
+  GstElement *videoconvert;
+  GstElement *deinterlace;
+  GstElement *videoscale;
+  GstElement *videorate;
+
+  ChainElements plugged;
+  ChainElements pending;        /* Waiting for the chain to be idle */
+  GESTrack *track;              /* Whose restriction caps we follow */
 };
 
 /* TrackElement VMethods */
@@ -122,6 +166,251 @@ post_missing_element_message (GstElement * element, const gchar * name)
   gst_element_post_message (element, msg);
 }
 
+/* Checks which conversion elements the stream of the asset needs to match
+ * what the track expects */
+static ChainElements
+_get_needed_elements (GESVideoSource * self)
+{
+  gint width, height, fps_n, fps_d, par_n, par_d;
+  GESAsset *asset;
+  GESTrack *track;
+  GstCaps *restriction;
+  GstStructure *structure;
+  GstDiscovererStreamInfo *info;
+  GstDiscovererVideoInfo *vinfo;
+  ChainElements needed = 0;
+  gboolean cropping;
+  gint pos_width, pos_height;
+
+  track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+  asset = ges_extractable_get_asset (GES_EXTRACTABLE (self));
+
+  /* Without knowing the media we can not tell */
+  if (!track || !GES_IS_URI_SOURCE_ASSET (asset))
+    return CHAIN_ALL;
+
+  info = ges_uri_source_asset_get_stream_info (GES_URI_SOURCE_ASSET (asset));
+  if (!GST_IS_DISCOVERER_VIDEO_INFO (info))
+    return CHAIN_ALL;
+
+  vinfo = GST_DISCOVERER_VIDEO_INFO (info);
+  if (gst_discoverer_video_info_is_interlaced (vinfo) &&
+      self->priv->deinterlace)
+    needed |= CHAIN_DEINTERLACE;
+
+  g_object_get (track, "restriction-caps", &restriction, NULL);
+  if (!restriction || gst_caps_is_empty (restriction) ||
+      gst_caps_is_any (restriction)) {
+    if (restriction)
+      gst_caps_unref (restriction);
+
+    return needed ? needed | CHAIN_CONVERT : 0;
+  }
+
+  structure = gst_caps_get_structure (restriction, 0);
+
+  /* Same rules as the framepositioner uses to fill the capsfilter */
+  if (gst_structure_get_int (structure, "width", &width) &&
+      gst_structure_get_int (structure, "height", &height) &&
+      (!ges_track_get_mixing (track) ||
+          !self->priv->positioner->scale_in_compositor)) {
+    const GESUriClipAsset *clip_asset =
+        ges_uri_source_asset_get_filesource_asset (GES_URI_SOURCE_ASSET
+        (asset));
+
+    GST_OBJECT_LOCK (self->priv->positioner);
+    cropping = self->priv->positioner->crop_left ||
+        self->priv->positioner->crop_right ||
+        self->priv->positioner->crop_top ||
+        self->priv->positioner->crop_bottom;
+    pos_width = self->priv->positioner->width;
+    pos_height = self->priv->positioner->height;
+    GST_OBJECT_UNLOCK (self->priv->positioner);
+
+    /* Proxies are usually smaller than the media, cropped frames need to be
+     * scaled back to the track size, and so do the frames of the clips
+     * resized by the user as no compositor scales them */
+    if ((clip_asset && ges_asset_get_proxy (GES_ASSET (clip_asset))) ||
+        width != (gint) gst_discoverer_video_info_get_width (vinfo) ||
+        height != (gint) gst_discoverer_video_info_get_height (vinfo) ||
+        (pos_width && pos_width != width) ||
+        (pos_height && pos_height != height) || cropping)
+      needed |= CHAIN_SCALE;
+  }
+
+  if (gst_structure_get_fraction (structure, "pixel-aspect-ratio", &par_n,
+          &par_d) &&
+      gst_util_fraction_compare (par_n, par_d,
+          gst_discoverer_video_info_get_par_num (vinfo),
+          gst_discoverer_video_info_get_par_denom (vinfo)))
+    needed |= CHAIN_SCALE;
+
+  /* Images and variable framerate streams report a 0 framerate */
+  if (gst_structure_get_fraction (structure, "framerate", &fps_n, &fps_d) &&
+      (!gst_discoverer_video_info_get_framerate_num (vinfo) ||
+          gst_util_fraction_compare (fps_n, fps_d,
+              gst_discoverer_video_info_get_framerate_num (vinfo),
+              gst_discoverer_video_info_get_framerate_denom (vinfo))))
+    needed |= CHAIN_RATE;
+
+  /* deinterlace and videoscale only handle some formats, when mixing the
+   * compositor converts to the format of the track */
+  if (needed & (CHAIN_DEINTERLACE | CHAIN_SCALE) ||
+      (gst_structure_has_field (structure, "format") &&
+          !ges_track_get_mixing (track)))
+    needed |= CHAIN_CONVERT;
+
+  gst_caps_unref (restriction);
+
+  return needed;
+}
+
+/* (Un)links the elements of the chain made of @elements */
+static void
+_link_chain (GESVideoSource * self, ChainElements elements, gboolean link)
+{
+  GESVideoSourcePrivate *priv = self->priv;
+  GstElement *chain[] = {
+    priv->queue,
+    elements & CHAIN_CONVERT ? priv->videoconvert : NULL,
+    elements & CHAIN_DEINTERLACE ? priv->deinterlace : NULL,
+    GST_ELEMENT (priv->positioner),
+    elements & CHAIN_SCALE ? priv->videoscale : NULL,
+    elements & CHAIN_RATE ? priv->videorate : NULL,
+    priv->capsfilter
+  };
+  GstElement *prev = NULL;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (chain); i++) {
+    if (!chain[i])
+      continue;
+
+    if (prev && link)
+      gst_element_link_pads_full (prev, "src", chain[i], "sink",
+          GST_PAD_LINK_CHECK_NOTHING);
+    else if (prev)
+      gst_element_unlink (prev, chain[i]);
+    prev = chain[i];
+  }
+}
+
+static void
+_replug (GESVideoSource * self)
+{
+  guint i;
+  ChainElements wanted = self->priv->pending;
+  GESVideoSourcePrivate *priv = self->priv;
+  GstElement *topbin = ges_track_element_get_element (GES_TRACK_ELEMENT (self));
+  struct
+  {
+    ChainElements flag;
+    GstElement *element;
+  } optional[] = {
+    {CHAIN_CONVERT, priv->videoconvert},
+    {CHAIN_DEINTERLACE, priv->deinterlace},
+    {CHAIN_SCALE, priv->videoscale},
+    {CHAIN_RATE, priv->videorate},
+  };
+
+  if (wanted == priv->plugged)
+    return;
+
+  GST_DEBUG_OBJECT (self, "Replugging the conversion chain: %x -> %x",
+      priv->plugged, wanted);
+
+  _link_chain (self, priv->plugged, FALSE);
+  for (i = 0; i < G_N_ELEMENTS (optional); i++) {
+    if (!optional[i].element)
+      continue;
+
+    if ((priv->plugged & optional[i].flag) && !(wanted & optional[i].flag)) {
+      gst_bin_remove (GST_BIN (topbin), optional[i].element);
+      gst_element_set_state (optional[i].element, GST_STATE_NULL);
+    } else if (!(priv->plugged & optional[i].flag) &&
+        (wanted & optional[i].flag)) {
+      gst_bin_add (GST_BIN (topbin), optional[i].element);
+    }
+  }
+
+  _link_chain (self, wanted, TRUE);
+  for (i = 0; i < G_N_ELEMENTS (optional); i++) {
+    if (optional[i].element && (wanted & optional[i].flag))
+      gst_element_sync_state_with_parent (optional[i].element);
+  }
+
+  priv->plugged = wanted;
+}
+
+static GstPadProbeReturn
+_queue_idle_cb (GstPad * pad, GstPadProbeInfo * info, GESVideoSource * self)
+{
+  _replug (self);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
+/* Only plugs the conversion elements the media needs, replugging from the
+ * streaming thread when the source is running */
+static void
+_update_chain (GESVideoSource * self)
+{
+  GstPad *srcpad;
+  GstElement *topbin = ges_track_element_get_element (GES_TRACK_ELEMENT (self));
+
+  if (!topbin)
+    return;
+
+  self->priv->pending = _get_needed_elements (self);
+  if (self->priv->pending == self->priv->plugged)
+    return;
+
+  if (GST_STATE (topbin) <= GST_STATE_READY &&
+      GST_STATE_PENDING (topbin) == GST_STATE_VOID_PENDING) {
+    _replug (self);
+
+    return;
+  }
+
+  srcpad = gst_element_get_static_pad (self->priv->queue, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_IDLE,
+      (GstPadProbeCallback) _queue_idle_cb, gst_object_ref (self),
+      gst_object_unref);
+  gst_object_unref (srcpad);
+}
+
+static void
+_restriction_caps_changed_cb (GESTrack * track, GParamSpec * arg G_GNUC_UNUSED,
+    GESVideoSource * self)
+{
+  _update_chain (self);
+}
+
+static void
+_positioner_changed_cb (GstFramePositioner * positioner,
+    GParamSpec * arg G_GNUC_UNUSED, GESVideoSource * self)
+{
+  _update_chain (self);
+}
+
+static void
+_track_changed_cb (GESVideoSource * self, GParamSpec * arg G_GNUC_UNUSED,
+    gpointer unused)
+{
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+
+  if (self->priv->track)
+    g_signal_handlers_disconnect_by_func (self->priv->track,
+        _restriction_caps_changed_cb, self);
+
+  self->priv->track = track;
+  if (track)
+    g_signal_connect (track, "notify::restriction-caps",
+        G_CALLBACK (_restriction_caps_changed_cb), self);
+
+  _update_chain (self);
+}
+
 static GstElement *
 ges_video_source_create_element (GESTrackElement * trksrc)
 {
@@ -133,7 +422,9 @@ ges_video_source_create_element (GESTrackElement * trksrc)
   GstElement *positioner, *videoscale, *videorate, *capsfilter, *videoconvert,
       *deinterlace;
   const gchar *positioner_props[] =
-      { "alpha", "posx", "posy", "width", "height", NULL };
+      { "alpha", "posx", "posy", "width", "height", "crop-left", "crop-right",
+    "crop-top", "crop-bottom", NULL
+  };
   const gchar *deinterlace_props[] = { "mode", "fields", "tff", NULL };
 
   if (!source_class->create_source)
@@ -180,12 +471,34 @@ ges_video_source_create_element (GESTrackElement * trksrc)
         ges_source_create_topbin ("videosrcbin", sub_element, queue,
         videoconvert, deinterlace, positioner, videoscale, videorate,
         capsfilter, NULL);
+    self->priv->deinterlace = gst_object_ref (deinterlace);
   }
 
   self->priv->positioner = GST_FRAME_POSITIONNER (positioner);
   self->priv->positioner->scale_in_compositor =
       !GES_VIDEO_SOURCE_GET_CLASS (self)->ABI.abi.disable_scale_in_compositor;
   self->priv->capsfilter = capsfilter;
+  self->priv->queue = queue;
+  self->priv->videoconvert = gst_object_ref (videoconvert);
+  self->priv->videoscale = gst_object_ref (videoscale);
+  self->priv->videorate = gst_object_ref (videorate);
+  self->priv->plugged = CHAIN_ALL;
+
+  /* The asset and the track are not known yet */
+  g_signal_connect (self, "notify::track", G_CALLBACK (_track_changed_cb),
+      NULL);
+  g_signal_connect (positioner, "notify::width",
+      G_CALLBACK (_positioner_changed_cb), self);
+  g_signal_connect (positioner, "notify::height",
+      G_CALLBACK (_positioner_changed_cb), self);
+  g_signal_connect (positioner, "notify::crop-left",
+      G_CALLBACK (_positioner_changed_cb), self);
+  g_signal_connect (positioner, "notify::crop-right",
+      G_CALLBACK (_positioner_changed_cb), self);
+  g_signal_connect (positioner, "notify::crop-top",
+      G_CALLBACK (_positioner_changed_cb), self);
+  g_signal_connect (positioner, "notify::crop-bottom",
+      G_CALLBACK (_positioner_changed_cb), self);
 
   return topbin;
 }
@@ -221,15 +534,37 @@ _lookup_child (GESTimelineElement * object,
   return res;
 }
 
+static void
+ges_video_source_dispose (GObject * object)
+{
+  GESVideoSourcePrivate *priv = GES_VIDEO_SOURCE (object)->priv;
+
+  if (priv->track) {
+    g_signal_handlers_disconnect_by_func (priv->track,
+        _restriction_caps_changed_cb, object);
+    priv->track = NULL;
+  }
+
+  gst_object_replace ((GstObject **) & priv->videoconvert, NULL);
+  gst_object_replace ((GstObject **) & priv->deinterlace, NULL);
+  gst_object_replace ((GstObject **) & priv->videoscale, NULL);
+  gst_object_replace ((GstObject **) & priv->videorate, NULL);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
 static void
 ges_video_source_class_init (GESVideoSourceClass * klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GESTrackElementClass *track_element_class = GES_TRACK_ELEMENT_CLASS (klass);
   GESTimelineElementClass *element_class = GES_TIMELINE_ELEMENT_CLASS (klass);
   GESVideoSourceClass *video_source_class = GES_VIDEO_SOURCE_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESVideoSourcePrivate));
 
+  object_class->dispose = ges_video_source_dispose;
+
   element_class->set_priority = _set_priority;
   element_class->lookup_child = _lookup_child;
 
@@ -78,17 +78,32 @@ _weak_notify_cb (GESTrack * track, GstElement * capsfilter)
       (GCallback) _track_restriction_changed_cb, capsfilter);
 }
 
+/* Builds "videotestsrc pattern=2 ! videorate ! capsfilter caps=video/x-raw"
+ * by hand as parsing the description is costly */
 static GstElement *
 create_element_for_raw_video_gap (GESTrack * track)
 {
-  GstElement *bin;
-  GstElement *capsfilter;
+  GstCaps *caps;
+  GstPad *pad;
+  GstElement *bin, *src, *rate, *capsfilter;
 
-  bin = gst_parse_bin_from_description
-      ("videotestsrc pattern=2 name=src ! videorate ! capsfilter name=gapfilter caps=video/x-raw",
-      TRUE, NULL);
+  bin = gst_bin_new (NULL);
+  src = gst_element_factory_make ("videotestsrc", "src");
+  rate = gst_element_factory_make ("videorate", NULL);
+  capsfilter = gst_element_factory_make ("capsfilter", "gapfilter");
+
+  g_object_set (src, "pattern", 2, NULL);
+  caps = gst_caps_new_empty_simple ("video/x-raw");
+  g_object_set (capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  gst_bin_add_many (GST_BIN (bin), src, rate, capsfilter, NULL);
+  gst_element_link_many (src, rate, capsfilter, NULL);
+
+  pad = gst_element_get_static_pad (capsfilter, "src");
+  gst_element_add_pad (bin, gst_ghost_pad_new ("src", pad));
+  gst_object_unref (pad);
 
-  capsfilter = gst_bin_get_by_name (GST_BIN (bin), "gapfilter");
   g_object_weak_ref (G_OBJECT (capsfilter), (GWeakNotify) _weak_notify_cb,
       track);
   g_signal_connect (track, "notify::restriction-caps",
@@ -96,8 +111,6 @@ create_element_for_raw_video_gap (GESTrack * track)
 
   _sync_capsfilter_with_track (track, capsfilter);
 
-  gst_object_unref (capsfilter);
-
   return bin;
 }
 
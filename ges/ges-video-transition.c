@@ -22,11 +22,17 @@
  * SECTION:gesvideotransition
  * @title: GESVideoTransition
  * @short_description: implements video crossfade transition
+ *
+ * Crossfades and bar wipes are blended in the format the sources are
+ * negotiated in. Other SMPTE wipes, and tracks restricted to formats that can
+ * not be blended natively, go through smptealpha and a compositor working in
+ * BGRA.
  */
 
 #include <ges/ges.h>
 #include "ges-internal.h"
 #include "ges-smart-video-mixer.h"
+#include "ges-video-blender.h"
 
 #include <gst/controller/gstdirectcontrolbinding.h>
 
@@ -52,6 +58,10 @@ struct _GESVideoTransitionPrivate
   /* these enable video interpolation */
   GstTimedValueControlSource *crossfade_control_source;
   GstTimedValueControlSource *smpte_control_source;
+  GstTimedValueControlSource *blend_control_source;
+
+  /* Blends natively when the type and format allow it */
+  GstElement *blender;
 
   /* so we can support changing between wipes */
   GstElement *smpte;
@@ -65,11 +75,26 @@ struct _GESVideoTransitionPrivate
   GstPad *mixer_ghosta;
   GstPad *mixer_ghostb;
 
-  /* This is in case the smpte doesn't exist yet */
+  /* This is in case the smpte doesn't exist yet, also kept up to date to
+   * switch between the blender and smptealpha */
   gint pending_border_value;
   gboolean pending_inverted;
 
   GstElement *positioner;
+
+  /* Elements between the ghost pads and the positioner */
+  GList *chain;
+  GstPad *sinka;
+  GstPad *sinkb;
+
+  /* Block both inputs while the chain is replaced in a running pipeline */
+  GRecMutex replug_lock;
+  gulong replug_probe_a;
+  gulong replug_probe_b;
+  gboolean blocked_a;
+  gboolean blocked_b;
+
+  GESTrack *track;
 };
 
 enum
@@ -93,6 +118,16 @@ static void
 ges_video_transition_duration_changed (GESTrackElement * self,
     guint64 duration);
 
+static void
+ges_video_transition_update_control_sources (GESVideoTransition * self,
+    GESVideoStandardTransitionType type);
+
+static void _restriction_caps_changed_cb (GESTrack * track, GParamSpec * arg,
+    GESVideoTransition * self);
+
+static void _track_changed_cb (GESVideoTransition * self, GParamSpec * arg,
+    gpointer unused);
+
 static GstElement *ges_video_transition_create_element (GESTrackElement * self);
 
 static void ges_video_transition_dispose (GObject * object);
@@ -194,6 +229,8 @@ ges_video_transition_init (GESVideoTransition * self)
 
   self->priv->crossfade_control_source = NULL;
   self->priv->smpte_control_source = NULL;
+  self->priv->blend_control_source = NULL;
+  self->priv->blender = NULL;
   self->priv->smpte = NULL;
   self->priv->mixer_sink = NULL;
   self->priv->mixer = NULL;
@@ -202,6 +239,7 @@ ges_video_transition_init (GESVideoTransition * self)
   self->priv->pending_type = GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE;
   self->priv->pending_border_value = 0;
   self->priv->pending_inverted = TRUE;
+  g_rec_mutex_init (&self->priv->replug_lock);
 }
 
 static void
@@ -222,6 +260,14 @@ release_mixer (GstElement ** mixer, GstPad ** sinka, GstPad ** sinkb)
   }
 }
 
+static void
+_release_control_sources (GESVideoTransitionPrivate * priv)
+{
+  gst_object_replace ((GstObject **) & priv->crossfade_control_source, NULL);
+  gst_object_replace ((GstObject **) & priv->smpte_control_source, NULL);
+  gst_object_replace ((GstObject **) & priv->blend_control_source, NULL);
+}
+
 static void
 ges_video_transition_dispose (GObject * object)
 {
@@ -230,20 +276,30 @@ ges_video_transition_dispose (GObject * object)
 
   GST_DEBUG ("disposing");
 
-  if (priv->crossfade_control_source) {
-    gst_object_unref (priv->crossfade_control_source);
-    priv->crossfade_control_source = NULL;
-  }
-
-  if (priv->smpte_control_source) {
-    gst_object_unref (priv->smpte_control_source);
-    priv->smpte_control_source = NULL;
-  }
+  g_rec_mutex_lock (&priv->replug_lock);
+  if (priv->replug_probe_a)
+    gst_pad_remove_probe (priv->sinka, priv->replug_probe_a);
+  if (priv->replug_probe_b)
+    gst_pad_remove_probe (priv->sinkb, priv->replug_probe_b);
+  priv->replug_probe_a = priv->replug_probe_b = 0;
+  g_rec_mutex_unlock (&priv->replug_lock);
 
+  _release_control_sources (priv);
   release_mixer (&priv->mixer, &priv->mixer_ghosta, &priv->mixer_ghostb);
+  gst_object_replace ((GstObject **) & priv->blender, NULL);
+  g_list_free (priv->chain);
+  priv->chain = NULL;
+
+  if (priv->track) {
+    g_signal_handlers_disconnect_by_func (priv->track,
+        _restriction_caps_changed_cb, self);
+    priv->track = NULL;
+  }
 
   g_signal_handlers_disconnect_by_func (GES_TRACK_ELEMENT (self),
       duration_changed_cb, NULL);
+  g_signal_handlers_disconnect_by_func (GES_TRACK_ELEMENT (self),
+      _track_changed_cb, NULL);
 
   G_OBJECT_CLASS (ges_video_transition_parent_class)->dispose (object);
 }
@@ -251,6 +307,8 @@ ges_video_transition_dispose (GObject * object)
 static void
 ges_video_transition_finalize (GObject * object)
 {
+  g_rec_mutex_clear (&GES_VIDEO_TRANSITION (object)->priv->replug_lock);
+
   G_OBJECT_CLASS (ges_video_transition_parent_class)->finalize (object);
 }
 
@@ -318,21 +376,12 @@ set_interpolation (GstObject * element, GESVideoTransitionPrivate * priv,
   return GST_TIMED_VALUE_CONTROL_SOURCE (control_source);
 }
 
-static GstElement *
-ges_video_transition_create_element (GESTrackElement * object)
+static void
+_create_smpte_chain (GESVideoTransition * self, GstBin * topbin)
 {
-  GstElement *topbin, *iconva, *iconvb, *oconv;
-  GstElement *mixer = NULL;
-  GstPad *sinka_target, *sinkb_target, *src_target, *sinka, *sinkb, *src;
-  GESVideoTransition *self;
-  GESVideoTransitionPrivate *priv;
-
-  self = GES_VIDEO_TRANSITION (object);
-  priv = self->priv;
-
-  GST_LOG ("creating a video bin");
-
-  topbin = gst_bin_new ("transition-bin");
+  GstElement *iconva, *iconvb, *oconv, *mixer;
+  GstPad *sinka_target, *sinkb_target;
+  GESVideoTransitionPrivate *priv = self->priv;
 
   iconva =
       gst_parse_bin_from_description
@@ -342,51 +391,42 @@ ges_video_transition_create_element (GESTrackElement * object)
       gst_parse_bin_from_description
       ("videoconvert ! capsfilter caps=\"video/x-raw,format=BGRA\"", TRUE,
       NULL);
-  priv->positioner =
-      gst_element_factory_make ("framepositioner", "frame_tagger");
-  g_object_set (priv->positioner, "zorder",
-      G_MAXUINT - GES_TIMELINE_ELEMENT_PRIORITY (self), NULL);
   oconv = gst_element_factory_make ("videoconvert", "tr-csp-output");
 
-  gst_bin_add_many (GST_BIN (topbin), iconva, iconvb, priv->positioner,
-      oconv, NULL);
+  gst_bin_add_many (topbin, iconva, iconvb, oconv, NULL);
 
   mixer =
       g_object_new (GES_TYPE_SMART_MIXER, "name",
       GES_TIMELINE_ELEMENT_NAME (self), NULL);
   g_object_set (GES_SMART_MIXER (mixer)->mixer, "background", 3, NULL);
   GES_SMART_MIXER (mixer)->disable_zorder_alpha = TRUE;
-  gst_bin_add (GST_BIN (topbin), mixer);
+  gst_bin_add (topbin, mixer);
+
+  priv->chain = g_list_append (priv->chain, iconva);
+  priv->chain = g_list_append (priv->chain, iconvb);
+  priv->chain = g_list_append (priv->chain, oconv);
+  priv->chain = g_list_append (priv->chain, mixer);
 
   priv->mixer_sinka =
-      (GstPad *) link_element_to_mixer_with_smpte (GST_BIN (topbin), iconva,
+      (GstPad *) link_element_to_mixer_with_smpte (topbin, iconva,
       mixer, GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR, NULL, priv,
       &priv->mixer_ghosta);
   priv->mixer_sinkb =
-      (GstPad *) link_element_to_mixer_with_smpte (GST_BIN (topbin), iconvb,
+      (GstPad *) link_element_to_mixer_with_smpte (topbin, iconvb,
       mixer, GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR, &priv->smpte,
       priv, &priv->mixer_ghostb);
   g_object_set (priv->mixer_sinka, "zorder", 0, NULL);
   g_object_set (priv->mixer_sinkb, "zorder", 1, NULL);
 
-  fast_element_link (mixer, priv->positioner);
-  fast_element_link (priv->positioner, oconv);
+  fast_element_link (mixer, oconv);
+  fast_element_link (oconv, priv->positioner);
 
   sinka_target = gst_element_get_static_pad (iconva, "sink");
   sinkb_target = gst_element_get_static_pad (iconvb, "sink");
-  src_target = gst_element_get_static_pad (oconv, "src");
-
-  sinka = gst_ghost_pad_new ("sinka", sinka_target);
-  sinkb = gst_ghost_pad_new ("sinkb", sinkb_target);
-  src = gst_ghost_pad_new ("src", src_target);
-
-  gst_element_add_pad (topbin, src);
-  gst_element_add_pad (topbin, sinka);
-  gst_element_add_pad (topbin, sinkb);
-
+  gst_ghost_pad_set_target (GST_GHOST_PAD (priv->sinka), sinka_target);
+  gst_ghost_pad_set_target (GST_GHOST_PAD (priv->sinkb), sinkb_target);
   gst_object_unref (sinka_target);
   gst_object_unref (sinkb_target);
-  gst_object_unref (src_target);
 
   /* set up interpolation */
 
@@ -396,6 +436,262 @@ ges_video_transition_create_element (GESTrackElement * object)
   priv->smpte_control_source =
       set_interpolation (GST_OBJECT (priv->smpte), priv, "position", FALSE);
   priv->mixer = gst_object_ref (mixer);
+}
+
+static void
+_create_blender_chain (GESVideoTransition * self, GstBin * topbin)
+{
+  GstPad *sinka_target, *sinkb_target;
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  priv->blender = gst_object_ref (g_object_new (GES_TYPE_VIDEO_BLENDER,
+          "transition-type", ges_video_transition_get_transition_type (self),
+          "border",
+          (guint) priv->pending_border_value, "invert",
+          !priv->pending_inverted, NULL));
+  gst_bin_add (topbin, priv->blender);
+  priv->chain = g_list_append (priv->chain, priv->blender);
+
+  sinka_target = gst_element_get_request_pad (priv->blender, "sink_%u");
+  sinkb_target = gst_element_get_request_pad (priv->blender, "sink_%u");
+  gst_ghost_pad_set_target (GST_GHOST_PAD (priv->sinka), sinka_target);
+  gst_ghost_pad_set_target (GST_GHOST_PAD (priv->sinkb), sinkb_target);
+  gst_object_unref (sinka_target);
+  gst_object_unref (sinkb_target);
+
+  fast_element_link (priv->blender, priv->positioner);
+
+  priv->blend_control_source =
+      set_interpolation (GST_OBJECT (priv->blender), priv, "position", FALSE);
+}
+
+static void
+_remove_chain (GESVideoTransition * self, GstBin * topbin)
+{
+  GList *tmp;
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (priv->sinka), NULL);
+  gst_ghost_pad_set_target (GST_GHOST_PAD (priv->sinkb), NULL);
+
+  _release_control_sources (priv);
+  release_mixer (&priv->mixer, &priv->mixer_ghosta, &priv->mixer_ghostb);
+  gst_object_replace ((GstObject **) & priv->blender, NULL);
+  priv->smpte = NULL;
+  priv->mixer_sinka = NULL;
+  priv->mixer_sinkb = NULL;
+
+  for (tmp = priv->chain; tmp; tmp = tmp->next) {
+    gst_element_set_state (tmp->data, GST_STATE_NULL);
+    gst_bin_remove (topbin, tmp->data);
+  }
+  g_list_free (priv->chain);
+  priv->chain = NULL;
+}
+
+/* The blender only implements some of the wipes, and only outputs the
+ * formats it can blend, which matters when no mixer converts the output to
+ * the format of the track */
+static gboolean
+_needs_smpte (GESVideoTransition * self)
+{
+  gboolean res;
+  GstCaps *restriction = NULL;
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+
+  if (!ges_video_blender_supports_transition_type
+      (ges_video_transition_get_transition_type (self)))
+    return TRUE;
+
+  if (!track || ges_track_get_mixing (track))
+    return FALSE;
+
+  g_object_get (track, "restriction-caps", &restriction, NULL);
+  res = restriction && !ges_video_blender_supports_caps (restriction);
+  if (restriction)
+    gst_caps_unref (restriction);
+
+  return res;
+}
+
+/* Sets the current type on the elements of the chain */
+static void
+_apply_transition_type (GESVideoTransition * self)
+{
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  ges_video_transition_update_control_sources (self, priv->type);
+
+  /* Until a pending replug is done, the blender keeps its previous type */
+  if (priv->blender) {
+    if (ges_video_blender_supports_transition_type (priv->type))
+      g_object_set (priv->blender, "transition-type", priv->type, NULL);
+  } else if (priv->smpte &&
+      priv->type != GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
+    g_object_set (priv->smpte, "type", (gint) priv->type, NULL);
+  }
+}
+
+/* Switches between the blender and the smptealpha based chain, if needed.
+ * Must be called while no data flows through the inputs */
+static void
+_replace_chain (GESVideoTransition * self)
+{
+  GList *tmp;
+  GstBin *topbin;
+  gboolean smpte = _needs_smpte (self);
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  if (priv->chain && smpte == (priv->mixer != NULL))
+    return;
+
+  GST_INFO_OBJECT (self, "Using %s", smpte ? "smptealpha" : "the blender");
+
+  topbin = GST_BIN (GST_ELEMENT_PARENT (priv->positioner));
+  _remove_chain (self, topbin);
+  if (smpte)
+    _create_smpte_chain (self, topbin);
+  else
+    _create_blender_chain (self, topbin);
+
+  for (tmp = priv->chain; tmp; tmp = tmp->next)
+    gst_element_sync_state_with_parent (tmp->data);
+
+  _apply_transition_type (self);
+}
+
+static GstPadProbeReturn
+_replug_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    GESVideoTransition * self)
+{
+  GstPadProbeReturn ret = GST_PAD_PROBE_OK;
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  g_rec_mutex_lock (&priv->replug_lock);
+  if (pad == priv->sinka)
+    priv->blocked_a = TRUE;
+  else
+    priv->blocked_b = TRUE;
+
+  /* The first blocked input waits for the other one */
+  if (priv->blocked_a && priv->blocked_b) {
+    _replace_chain (self);
+
+    if (pad == priv->sinka)
+      gst_pad_remove_probe (priv->sinkb, priv->replug_probe_b);
+    else
+      gst_pad_remove_probe (priv->sinka, priv->replug_probe_a);
+    priv->replug_probe_a = priv->replug_probe_b = 0;
+    priv->blocked_a = priv->blocked_b = FALSE;
+    ret = GST_PAD_PROBE_REMOVE;
+  }
+  g_rec_mutex_unlock (&priv->replug_lock);
+
+  return ret;
+}
+
+/* Switches between the blender and the smptealpha based chain. While
+ * running, the chain is only replaced once both inputs are idle */
+static void
+_update_chain (GESVideoTransition * self)
+{
+  gboolean running;
+  GstElement *topbin;
+  GESVideoTransitionPrivate *priv = self->priv;
+
+  if (!priv->positioner)
+    return;
+
+  g_rec_mutex_lock (&priv->replug_lock);
+  if (priv->replug_probe_a) {
+    /* The pending replug checks what is needed when it happens */
+    g_rec_mutex_unlock (&priv->replug_lock);
+    return;
+  }
+
+  if (priv->chain && _needs_smpte (self) == (priv->mixer != NULL)) {
+    g_rec_mutex_unlock (&priv->replug_lock);
+    return;
+  }
+
+  topbin = GST_ELEMENT_PARENT (priv->positioner);
+  GST_OBJECT_LOCK (topbin);
+  running = GST_STATE (topbin) > GST_STATE_READY ||
+      GST_STATE_PENDING (topbin) > GST_STATE_READY;
+  GST_OBJECT_UNLOCK (topbin);
+
+  if (!priv->chain || !running) {
+    _replace_chain (self);
+  } else {
+    GST_DEBUG_OBJECT (self, "Waiting for the inputs to be idle to replug");
+    priv->replug_probe_a = gst_pad_add_probe (priv->sinka,
+        GST_PAD_PROBE_TYPE_IDLE, (GstPadProbeCallback) _replug_probe_cb,
+        self, NULL);
+    priv->replug_probe_b = gst_pad_add_probe (priv->sinkb,
+        GST_PAD_PROBE_TYPE_IDLE, (GstPadProbeCallback) _replug_probe_cb,
+        self, NULL);
+  }
+  g_rec_mutex_unlock (&priv->replug_lock);
+}
+
+static void
+_restriction_caps_changed_cb (GESTrack * track, GParamSpec * arg G_GNUC_UNUSED,
+    GESVideoTransition * self)
+{
+  _update_chain (self);
+}
+
+static void
+_track_changed_cb (GESVideoTransition * self, GParamSpec * arg G_GNUC_UNUSED,
+    gpointer unused)
+{
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+
+  if (self->priv->track)
+    g_signal_handlers_disconnect_by_func (self->priv->track,
+        _restriction_caps_changed_cb, self);
+
+  self->priv->track = track;
+  if (track)
+    g_signal_connect (track, "notify::restriction-caps",
+        G_CALLBACK (_restriction_caps_changed_cb), self);
+
+  _update_chain (self);
+}
+
+static GstElement *
+ges_video_transition_create_element (GESTrackElement * object)
+{
+  GstElement *topbin;
+  GstPad *src_target, *src;
+  GESVideoTransition *self;
+  GESVideoTransitionPrivate *priv;
+
+  self = GES_VIDEO_TRANSITION (object);
+  priv = self->priv;
+
+  GST_LOG ("creating a video bin");
+
+  topbin = gst_bin_new ("transition-bin");
+
+  priv->positioner =
+      gst_element_factory_make ("framepositioner", "frame_tagger");
+  g_object_set (priv->positioner, "zorder",
+      G_MAXUINT - GES_TIMELINE_ELEMENT_PRIORITY (self), NULL);
+  gst_bin_add (GST_BIN (topbin), priv->positioner);
+
+  src_target = gst_element_get_static_pad (priv->positioner, "src");
+  src = gst_ghost_pad_new ("src", src_target);
+  priv->sinka = gst_ghost_pad_new_no_target ("sinka", GST_PAD_SINK);
+  priv->sinkb = gst_ghost_pad_new_no_target ("sinkb", GST_PAD_SINK);
+
+  gst_element_add_pad (topbin, src);
+  gst_element_add_pad (topbin, priv->sinka);
+  gst_element_add_pad (topbin, priv->sinkb);
+
+  gst_object_unref (src_target);
+
+  _update_chain (self);
 
   if (priv->pending_type)
     ges_video_transition_set_transition_type_internal (self,
@@ -408,6 +704,8 @@ ges_video_transition_create_element (GESTrackElement * object)
 
   g_signal_connect (object, "notify::duration",
       G_CALLBACK (duration_changed_cb), NULL);
+  g_signal_connect (object, "notify::track", G_CALLBACK (_track_changed_cb),
+      NULL);
 
   priv->pending_type = GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE;
 
@@ -426,6 +724,7 @@ link_element_to_mixer_with_smpte (GstBin * bin, GstElement * element,
       "type", (gint) type, "invert", (gboolean) priv->pending_inverted,
       "border", priv->pending_border_value, NULL);
   gst_bin_add (bin, smptealpha);
+  priv->chain = g_list_append (priv->chain, smptealpha);
 
   fast_element_link (element, smptealpha);
 
@@ -460,7 +759,10 @@ ges_video_transition_update_control_sources (GESVideoTransition * self,
       ges_timeline_element_get_duration (GES_TIMELINE_ELEMENT (self));
 
   GST_LOG ("updating controller");
-  if (type == GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
+  if (priv->blender) {
+    ges_video_transition_update_control_source (priv->blend_control_source,
+        duration, 0.0, 1.0);
+  } else if (type == GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
     ges_video_transition_update_control_source
         (priv->crossfade_control_source, duration, 1.0, 0.0);
     ges_video_transition_update_control_source (priv->smpte_control_source,
@@ -480,7 +782,9 @@ ges_video_transition_duration_changed (GESTrackElement * object,
 {
   GESVideoTransition *self = GES_VIDEO_TRANSITION (object);
 
+  g_rec_mutex_lock (&self->priv->replug_lock);
   ges_video_transition_update_control_sources (self, self->priv->type);
+  g_rec_mutex_unlock (&self->priv->replug_lock);
 }
 
 static inline void
@@ -489,11 +793,13 @@ ges_video_transition_set_border_internal (GESVideoTransition * self,
 {
   GESVideoTransitionPrivate *priv = self->priv;
 
-  if (!priv->smpte) {
-    priv->pending_border_value = value;
-    return;
-  }
-  g_object_set (priv->smpte, "border", value, NULL);
+  g_rec_mutex_lock (&priv->replug_lock);
+  priv->pending_border_value = value;
+  if (priv->smpte)
+    g_object_set (priv->smpte, "border", value, NULL);
+  else if (priv->blender)
+    g_object_set (priv->blender, "border", value, NULL);
+  g_rec_mutex_unlock (&priv->replug_lock);
 }
 
 static inline void
@@ -502,11 +808,13 @@ ges_video_transition_set_inverted_internal (GESVideoTransition *
 {
   GESVideoTransitionPrivate *priv = self->priv;
 
-  if (!priv->smpte) {
-    priv->pending_inverted = !inverted;
-    return;
-  }
-  g_object_set (priv->smpte, "invert", !inverted, NULL);
+  g_rec_mutex_lock (&priv->replug_lock);
+  priv->pending_inverted = !inverted;
+  if (priv->smpte)
+    g_object_set (priv->smpte, "invert", !inverted, NULL);
+  else if (priv->blender)
+    g_object_set (priv->blender, "invert", inverted, NULL);
+  g_rec_mutex_unlock (&priv->replug_lock);
 }
 
 static inline gboolean
@@ -517,7 +825,7 @@ ges_video_transition_set_transition_type_internal (GESVideoTransition
 
   GST_DEBUG ("%p %d => %d", self, priv->type, type);
 
-  if (!priv->mixer) {
+  if (!priv->positioner) {
     priv->pending_type = type;
     return TRUE;
   }
@@ -527,13 +835,14 @@ ges_video_transition_set_transition_type_internal (GESVideoTransition
     return TRUE;
   }
 
-  ges_video_transition_update_control_sources (self, type);
-
   priv->type = type;
+  priv->pending_type = GES_VIDEO_STANDARD_TRANSITION_TYPE_NONE;
 
-  if (type != GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE) {
-    g_object_set (priv->smpte, "type", (gint) type, NULL);
-  }
+  /* Only the type of the elements changes when the chain can be reused */
+  g_rec_mutex_lock (&priv->replug_lock);
+  _update_chain (self);
+  _apply_transition_type (self);
+  g_rec_mutex_unlock (&priv->replug_lock);
 
   return TRUE;
 }
@@ -569,13 +878,15 @@ ges_video_transition_set_border (GESVideoTransition * self, guint value)
 gint
 ges_video_transition_get_border (GESVideoTransition * self)
 {
-  gint value;
-
-  if (!self->priv->smpte) {
-    return -1;
-  }
+  gint value = -1;
+  GESVideoTransitionPrivate *priv = self->priv;
 
-  g_object_get (self->priv->smpte, "border", &value, NULL);
+  g_rec_mutex_lock (&priv->replug_lock);
+  if (priv->smpte)
+    g_object_get (priv->smpte, "border", &value, NULL);
+  else if (priv->blender)
+    g_object_get (priv->blender, "border", &value, NULL);
+  g_rec_mutex_unlock (&priv->replug_lock);
 
   return value;
 }
@@ -610,15 +921,19 @@ ges_video_transition_set_inverted (GESVideoTransition * self, gboolean inverted)
 gboolean
 ges_video_transition_is_inverted (GESVideoTransition * self)
 {
-  gboolean inverted;
+  gboolean inverted = FALSE;
+  GESVideoTransitionPrivate *priv = self->priv;
 
-  if (!self->priv->smpte) {
-    return FALSE;
+  g_rec_mutex_lock (&priv->replug_lock);
+  if (priv->smpte) {
+    g_object_get (priv->smpte, "invert", &inverted, NULL);
+    inverted = !inverted;
+  } else if (priv->blender) {
+    g_object_get (priv->blender, "invert", &inverted, NULL);
   }
+  g_rec_mutex_unlock (&priv->replug_lock);
 
-  g_object_get (self->priv->smpte, "invert", &inverted, NULL);
-
-  return !inverted;
+  return inverted;
 }
 
 /**
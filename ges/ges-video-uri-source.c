@@ -68,24 +68,12 @@ ges_video_uri_source_track_set_cb (GESVideoUriSource * self,
 static GstElement *
 ges_video_uri_source_create_source (GESTrackElement * trksrc)
 {
-  GESVideoUriSource *self;
-  GESTrack *track;
-  GstElement *decodebin;
-  const GstCaps *caps = NULL;
-
-  self = (GESVideoUriSource *) trksrc;
-
-  track = ges_track_element_get_track (trksrc);
-  if (track)
-    caps = ges_track_get_caps (track);
-
-  decodebin = self->priv->decodebin = gst_element_factory_make ("uridecodebin",
-      NULL);
+  GESVideoUriSource *self = (GESVideoUriSource *) trksrc;
 
-  g_object_set (decodebin, "caps", caps,
-      "expose-all-streams", FALSE, "uri", self->uri, NULL);
+  self->priv->decodebin = ges_source_create_uri_decoder (GES_SOURCE (trksrc),
+      self->uri);
 
-  return decodebin;
+  return self->priv->decodebin;
 }
 
 /* Extractable interface implementation */
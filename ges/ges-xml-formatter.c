@@ -51,8 +51,27 @@ struct _GESXmlFormatterPrivate
   guint nbelements;
 
   guint min_version;
+
+  /* The <asset> element being parsed, it is added once its children, like
+   * the serialized <stream-info>, have been parsed */
+  gchar *asset_id;
+  GType asset_type;
+  GstStructure *asset_properties;
+  gchar *asset_metadatas;
+  gchar *asset_proxy_id;
+  gchar *asset_stream_info;
 };
 
+static void
+_clear_current_asset (GESXmlFormatterPrivate * priv)
+{
+  g_clear_pointer (&priv->asset_id, g_free);
+  g_clear_pointer (&priv->asset_properties, gst_structure_free);
+  g_clear_pointer (&priv->asset_metadatas, g_free);
+  g_clear_pointer (&priv->asset_proxy_id, g_free);
+  g_clear_pointer (&priv->asset_stream_info, g_free);
+}
+
 static inline void
 _parse_ges_element (GMarkupParseContext * context, const gchar * element_name,
     const gchar ** attribute_names, const gchar ** attribute_values,
@@ -317,15 +336,38 @@ _parse_asset (GMarkupParseContext * context, const gchar * element_name,
         "element '%s', %s not an extractable_type'",
         element_name, extractable_type_name);
   else {
-    GstStructure *props = NULL;
+    GESXmlFormatterPrivate *priv = self->priv;
+
+    _clear_current_asset (priv);
+    priv->asset_id = g_strdup (id);
+    priv->asset_type = extractable_type;
     if (properties)
-      props = gst_structure_from_string (properties, NULL);
+      priv->asset_properties = gst_structure_from_string (properties, NULL);
+    priv->asset_metadatas = g_strdup (metadatas);
+    priv->asset_proxy_id = g_strdup (proxy_id);
+  }
+}
+
+static inline void
+_parse_stream_info (GMarkupParseContext * context, const gchar * element_name,
+    const gchar ** attribute_names, const gchar ** attribute_values,
+    GESXmlFormatter * self, GError ** error)
+{
+  const gchar *data;
+
+  if (!g_markup_collect_attributes (element_name, attribute_names,
+          attribute_values, error, G_MARKUP_COLLECT_STRING, "data", &data,
+          G_MARKUP_COLLECT_INVALID))
+    return;
 
-    ges_base_xml_formatter_add_asset (GES_BASE_XML_FORMATTER (self), id,
-        extractable_type, props, metadatas, proxy_id, error);
-    if (props)
-      gst_structure_free (props);
+  if (!self->priv->asset_id) {
+    g_set_error (error, G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT,
+        "element '%s' outside of an asset", element_name);
+    return;
   }
+
+  g_free (self->priv->asset_stream_info);
+  self->priv->asset_stream_info = g_strdup (data);
 }
 
 
@@ -774,6 +816,9 @@ _parse_element_start (GMarkupParseContext * context, const gchar * element_name,
   else if (g_strcmp0 (element_name, "asset") == 0)
     _parse_asset (context, element_name, attribute_names, attribute_values,
         self, error);
+  else if (g_strcmp0 (element_name, "stream-info") == 0)
+    _parse_stream_info (context, element_name, attribute_names,
+        attribute_values, self, error);
   else if (g_strcmp0 (element_name, "track") == 0)
     _parse_track (context, element_name, attribute_names,
         attribute_values, self, error);
@@ -806,8 +851,16 @@ static void
 _parse_element_end (GMarkupParseContext * context,
     const gchar * element_name, gpointer self, GError ** error)
 {
-  /*GESXmlFormatterPrivate *priv = _GET_PRIV (self); */
-  if (g_strcmp0 (element_name, "ges") == 0 && GES_FORMATTER (self)->project) {
+  GESXmlFormatterPrivate *priv = _GET_PRIV (self);
+
+  if (g_strcmp0 (element_name, "asset") == 0 && priv->asset_id) {
+    ges_base_xml_formatter_add_asset (GES_BASE_XML_FORMATTER (self),
+        priv->asset_id, priv->asset_type, priv->asset_properties,
+        priv->asset_metadatas, priv->asset_proxy_id, priv->asset_stream_info,
+        error);
+    _clear_current_asset (priv);
+  } else if (g_strcmp0 (element_name, "ges") == 0
+      && GES_FORMATTER (self)->project) {
     gchar *version = g_strdup_printf ("%d.%d",
         API_VERSION, GES_XML_FORMATTER (self)->priv->min_version);
 
@@ -935,7 +988,7 @@ _serialize_properties (GObject * object, const gchar * fieldname, ...)
 static inline void
 _save_assets (GESXmlFormatter * self, GString * str, GESProject * project)
 {
-  char *properties, *metas;
+  char *properties, *metas, *stream_info;
   GESAsset *asset, *proxy;
   GList *assets, *tmp;
 
@@ -966,7 +1019,19 @@ _save_assets (GESXmlFormatter * self, GString * str, GESProject * project)
 
       self->priv->min_version = MAX (self->priv->min_version, 3);
     }
-    g_string_append (str, "/>\n");
+
+    /* Older versions ignore the unknown children so that does not require
+     * bumping the format version */
+    stream_info = GES_IS_URI_CLIP_ASSET (asset) ?
+        ges_uri_clip_asset_serialize_info (GES_URI_CLIP_ASSET (asset)) : NULL;
+    if (stream_info) {
+      append_escaped (str,
+          g_markup_printf_escaped (">\n        <stream-info data='%s'/>\n"
+              "      </asset>\n", stream_info));
+      g_free (stream_info);
+    } else {
+      g_string_append (str, "/>\n");
+    }
     g_free (properties);
     g_free (metas);
   }
@@ -1609,6 +1674,7 @@ _dispose (GObject * object)
 {
   g_clear_pointer (&GES_XML_FORMATTER (object)->priv->element_id,
       (GDestroyNotify) g_hash_table_unref);
+  _clear_current_asset (GES_XML_FORMATTER (object)->priv);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -51,6 +51,7 @@
 #include <ges/ges-clip-asset.h>
 #include <ges/ges-track-element-asset.h>
 #include <ges/ges-uri-asset.h>
+#include <ges/ges-proxy-generator.h>
 #include <ges/ges-project.h>
 #include <ges/ges-extractable.h>
 #include <ges/ges-base-xml-formatter.h>
@@ -21,6 +21,7 @@
 #include "config.h"
 #endif
 
+#include <string.h>
 #include <gst/gst.h>
 #include <gst/video/video.h>
 
@@ -36,6 +37,19 @@ static void gst_frame_positioner_get_property (GObject * object,
     guint property_id, GValue * value, GParamSpec * pspec);
 static GstFlowReturn gst_frame_positioner_transform_ip (GstBaseTransform *
     trans, GstBuffer * buf);
+static GstFlowReturn gst_frame_positioner_transform (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer * outbuf);
+static GstFlowReturn
+gst_frame_positioner_prepare_output_buffer (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer ** outbuf);
+static GstCaps *gst_frame_positioner_transform_caps (GstBaseTransform * trans,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter);
+static gboolean gst_frame_positioner_set_caps (GstBaseTransform * trans,
+    GstCaps * incaps, GstCaps * outcaps);
+static gboolean gst_frame_positioner_decide_allocation (GstBaseTransform *
+    trans, GstQuery * query);
+static void gst_frame_positioner_before_transform (GstBaseTransform * trans,
+    GstBuffer * buf);
 
 static gboolean
 gst_frame_positioner_meta_init (GstMeta * meta, gpointer params,
@@ -51,9 +65,17 @@ enum
   PROP_POSY,
   PROP_ZORDER,
   PROP_WIDTH,
-  PROP_HEIGHT
+  PROP_HEIGHT,
+  PROP_CROP_LEFT,
+  PROP_CROP_RIGHT,
+  PROP_CROP_TOP,
+  PROP_CROP_BOTTOM
 };
 
+/* The crop origin is kept on even coordinates so that it does not split the
+ * chroma samples of subsampled formats */
+#define CROP_ALIGN(v) ((v) & ~1)
+
 static GstStaticPadTemplate gst_frame_positioner_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -266,6 +288,18 @@ gst_frame_positioner_class_init (GstFramePositionerClass * klass)
   gobject_class->dispose = gst_frame_positioner_dispose;
   base_transform_class->transform_ip =
       GST_DEBUG_FUNCPTR (gst_frame_positioner_transform_ip);
+  base_transform_class->transform =
+      GST_DEBUG_FUNCPTR (gst_frame_positioner_transform);
+  base_transform_class->prepare_output_buffer =
+      GST_DEBUG_FUNCPTR (gst_frame_positioner_prepare_output_buffer);
+  base_transform_class->transform_caps =
+      GST_DEBUG_FUNCPTR (gst_frame_positioner_transform_caps);
+  base_transform_class->set_caps =
+      GST_DEBUG_FUNCPTR (gst_frame_positioner_set_caps);
+  base_transform_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_frame_positioner_decide_allocation);
+  base_transform_class->before_transform =
+      GST_DEBUG_FUNCPTR (gst_frame_positioner_before_transform);
 
   /**
    * gstframepositioner:alpha:
@@ -326,6 +360,48 @@ gst_frame_positioner_class_init (GstFramePositionerClass * klass)
       g_param_spec_int ("height", "height", "height of the source",
           0, MAX_PIXELS, 0, G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE));
 
+  /**
+   * gesframepositioner:crop-left:
+   *
+   * The number of pixels to crop from the left of the frames, rounded down
+   * to an even number.
+   */
+  g_object_class_install_property (gobject_class, PROP_CROP_LEFT,
+      g_param_spec_int ("crop-left", "crop left",
+          "Pixels to crop from the left of the source", 0, MAX_PIXELS, 0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE));
+
+  /**
+   * gesframepositioner:crop-right:
+   *
+   * The number of pixels to crop from the right of the frames.
+   */
+  g_object_class_install_property (gobject_class, PROP_CROP_RIGHT,
+      g_param_spec_int ("crop-right", "crop right",
+          "Pixels to crop from the right of the source", 0, MAX_PIXELS, 0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE));
+
+  /**
+   * gesframepositioner:crop-top:
+   *
+   * The number of pixels to crop from the top of the frames, rounded down
+   * to an even number.
+   */
+  g_object_class_install_property (gobject_class, PROP_CROP_TOP,
+      g_param_spec_int ("crop-top", "crop top",
+          "Pixels to crop from the top of the source", 0, MAX_PIXELS, 0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE));
+
+  /**
+   * gesframepositioner:crop-bottom:
+   *
+   * The number of pixels to crop from the bottom of the frames.
+   */
+  g_object_class_install_property (gobject_class, PROP_CROP_BOTTOM,
+      g_param_spec_int ("crop-bottom", "crop bottom",
+          "Pixels to crop from the bottom of the source", 0, MAX_PIXELS, 0,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE));
+
   gst_element_class_set_static_metadata (GST_ELEMENT_CLASS (klass),
       "frame positioner", "Metadata",
       "This element provides with tagging facilities",
@@ -352,6 +428,13 @@ gst_frame_positioner_init (GstFramePositioner * framepositioner)
 
   framepositioner->par_n = -1;
   framepositioner->par_d = 1;
+
+  framepositioner->crop_left = framepositioner->crop_right = 0;
+  framepositioner->crop_top = framepositioner->crop_bottom = 0;
+  framepositioner->crop_x = framepositioner->crop_y = 0;
+  gst_video_info_init (&framepositioner->in_info);
+  gst_video_info_init (&framepositioner->out_info);
+  framepositioner->use_video_meta = FALSE;
 }
 
 void
@@ -360,6 +443,7 @@ gst_frame_positioner_set_property (GObject * object, guint property_id,
 {
   GstFramePositioner *framepositioner = GST_FRAME_POSITIONNER (object);
   gboolean track_mixing = TRUE;
+  gboolean recrop = FALSE;
 
   if (framepositioner->current_track)
     track_mixing = ges_track_get_mixing (framepositioner->current_track);
@@ -389,11 +473,31 @@ gst_frame_positioner_set_property (GObject * object, guint property_id,
       gst_frame_positioner_update_properties (framepositioner, track_mixing,
           0, 0);
       break;
+    case PROP_CROP_LEFT:
+      framepositioner->crop_left = g_value_get_int (value);
+      recrop = TRUE;
+      break;
+    case PROP_CROP_RIGHT:
+      framepositioner->crop_right = g_value_get_int (value);
+      recrop = TRUE;
+      break;
+    case PROP_CROP_TOP:
+      framepositioner->crop_top = g_value_get_int (value);
+      recrop = TRUE;
+      break;
+    case PROP_CROP_BOTTOM:
+      framepositioner->crop_bottom = g_value_get_int (value);
+      recrop = TRUE;
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
   }
   GST_OBJECT_UNLOCK (framepositioner);
+
+  /* The size of the output changes */
+  if (recrop)
+    gst_base_transform_reconfigure_src (GST_BASE_TRANSFORM (object));
 }
 
 void
@@ -426,6 +530,18 @@ gst_frame_positioner_get_property (GObject * object, guint property_id,
       real_height = (pos->height > 0) ? pos->height : pos->track_height;
       g_value_set_int (value, real_height);
       break;
+    case PROP_CROP_LEFT:
+      g_value_set_int (value, pos->crop_left);
+      break;
+    case PROP_CROP_RIGHT:
+      g_value_set_int (value, pos->crop_right);
+      break;
+    case PROP_CROP_TOP:
+      g_value_set_int (value, pos->crop_top);
+      break;
+    case PROP_CROP_BOTTOM:
+      g_value_set_int (value, pos->crop_bottom);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -473,6 +589,8 @@ gst_frame_positioner_meta_init (GstMeta * meta, gpointer params,
   smeta->alpha = 0.0;
   smeta->posx = smeta->posy = smeta->height = smeta->width = 0;
   smeta->zorder = 0;
+  smeta->crop_left = smeta->crop_right = 0;
+  smeta->crop_top = smeta->crop_bottom = 0;
 
   return TRUE;
 }
@@ -496,22 +614,222 @@ gst_frame_positioner_meta_transform (GstBuffer * dest, GstMeta * meta,
     dmeta->width = smeta->width;
     dmeta->height = smeta->height;
     dmeta->zorder = smeta->zorder;
+    dmeta->crop_left = smeta->crop_left;
+    dmeta->crop_right = smeta->crop_right;
+    dmeta->crop_top = smeta->crop_top;
+    dmeta->crop_bottom = smeta->crop_bottom;
   }
 
   return TRUE;
 }
 
-static GstFlowReturn
-gst_frame_positioner_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+/* The component whose layout describes @plane */
+static guint
+_plane_component (const GstVideoFormatInfo * finfo, guint plane)
+{
+  guint c;
+
+  for (c = 0; c < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); c++) {
+    if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, c) == plane)
+      return c;
+  }
+
+  return 0;
+}
+
+/* Offset of the first cropped pixel from the start of @plane */
+static gsize
+_crop_offset (GstFramePositioner * pos, guint plane, gint stride)
+{
+  const GstVideoFormatInfo *finfo = pos->in_info.finfo;
+  guint c = _plane_component (finfo, plane);
+
+  return GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, c, pos->crop_y) * stride +
+      GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, c, pos->crop_x) *
+      GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, c);
+}
+
+/* Limits the crop of a @size pixels dimension so that at least one pixel
+ * is left, returns the number of cropped pixels */
+static gint
+_clamp_crop (gint size, gint start, gint end, gint * clamped_start)
+{
+  start = MIN (CROP_ALIGN (start), CROP_ALIGN (size - 1));
+  end = MIN (end, size - 1 - start);
+
+  if (clamped_start)
+    *clamped_start = start;
+
+  return start + end;
+}
+
+static GstCaps *
+gst_frame_positioner_transform_caps (GstBaseTransform * trans,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter)
+{
+  guint i;
+  GstCaps *res;
+  gint left, right, top, bottom;
+  GstFramePositioner *pos = GST_FRAME_POSITIONNER (trans);
+
+  GST_OBJECT_LOCK (pos);
+  left = pos->crop_left;
+  right = pos->crop_right;
+  top = pos->crop_top;
+  bottom = pos->crop_bottom;
+  GST_OBJECT_UNLOCK (pos);
+
+  res = gst_caps_copy (caps);
+  for (i = 0; (left || right || top || bottom) &&
+      i < gst_caps_get_size (res); i++) {
+    gint v;
+    GstStructure *structure = gst_caps_get_structure (res, i);
+
+    /* Frames are smaller downstream */
+    if (gst_structure_get_int (structure, "width", &v))
+      gst_structure_set (structure, "width", G_TYPE_INT,
+          direction == GST_PAD_SINK ? v - _clamp_crop (v, left, right, NULL) :
+          v + CROP_ALIGN (left) + right, NULL);
+    if (gst_structure_get_int (structure, "height", &v))
+      gst_structure_set (structure, "height", G_TYPE_INT,
+          direction == GST_PAD_SINK ? v - _clamp_crop (v, top, bottom, NULL) :
+          v + CROP_ALIGN (top) + bottom, NULL);
+  }
+
+  if (filter) {
+    GstCaps *tmp = gst_caps_intersect_full (filter, res,
+        GST_CAPS_INTERSECT_FIRST);
+
+    gst_caps_unref (res);
+    res = tmp;
+  }
+
+  return res;
+}
+
+static gboolean
+gst_frame_positioner_set_caps (GstBaseTransform * trans, GstCaps * incaps,
+    GstCaps * outcaps)
+{
+  gboolean cropping;
+  GstFramePositioner *pos = GST_FRAME_POSITIONNER (trans);
+
+  if (!gst_video_info_from_caps (&pos->in_info, incaps) ||
+      !gst_video_info_from_caps (&pos->out_info, outcaps)) {
+    GST_ERROR_OBJECT (pos, "Invalid caps %" GST_PTR_FORMAT " -> %"
+        GST_PTR_FORMAT, incaps, outcaps);
+
+    return FALSE;
+  }
+
+  if (pos->out_info.width > pos->in_info.width ||
+      pos->out_info.height > pos->in_info.height) {
+    GST_ERROR_OBJECT (pos, "Can not output frames bigger than the input");
+
+    return FALSE;
+  }
+
+  cropping = pos->in_info.width != pos->out_info.width ||
+      pos->in_info.height != pos->out_info.height;
+  if (cropping && (GST_VIDEO_FORMAT_INFO_IS_TILED (pos->in_info.finfo) ||
+          GST_VIDEO_FORMAT_INFO_HAS_PALETTE (pos->in_info.finfo) ||
+          GST_VIDEO_FORMAT_INFO_FLAGS (pos->in_info.finfo) &
+          GST_VIDEO_FORMAT_FLAG_COMPLEX)) {
+    GST_ERROR_OBJECT (pos, "Can not crop %s frames",
+        GST_VIDEO_INFO_NAME (&pos->in_info));
+
+    return FALSE;
+  }
+
+  /* The properties might have changed since the caps were computed, the
+   * origin is only kept where the negotiated size still fits */
+  GST_OBJECT_LOCK (pos);
+  _clamp_crop (pos->in_info.width, pos->crop_left, pos->crop_right,
+      &pos->crop_x);
+  _clamp_crop (pos->in_info.height, pos->crop_top, pos->crop_bottom,
+      &pos->crop_y);
+  pos->crop_x = CROP_ALIGN (MIN (pos->crop_x,
+          pos->in_info.width - pos->out_info.width));
+  pos->crop_y = CROP_ALIGN (MIN (pos->crop_y,
+          pos->in_info.height - pos->out_info.height));
+  GST_OBJECT_UNLOCK (pos);
+
+  /* Only cropping needs new buffers, the metadata is added in place */
+  gst_base_transform_set_in_place (trans, !cropping);
+
+  return TRUE;
+}
+
+static gboolean
+gst_frame_positioner_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query)
+{
+  GstFramePositioner *pos = GST_FRAME_POSITIONNER (trans);
+
+  pos->use_video_meta =
+      gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+  return
+      GST_BASE_TRANSFORM_CLASS
+      (gst_frame_positioner_parent_class)->decide_allocation (trans, query);
+}
+
+static void
+gst_frame_positioner_before_transform (GstBaseTransform * trans,
+    GstBuffer * buf)
 {
-  GstFramePositionerMeta *meta;
-  GstFramePositioner *framepositioner = GST_FRAME_POSITIONNER (trans);
   GstClockTime timestamp = GST_BUFFER_TIMESTAMP (buf);
 
-  if (GST_CLOCK_TIME_IS_VALID (timestamp)) {
+  /* Before the output is negotiated, so that crop changes apply on that
+   * very buffer */
+  if (GST_CLOCK_TIME_IS_VALID (timestamp))
     gst_object_sync_values (GST_OBJECT (trans), timestamp);
+}
+
+static GstFlowReturn
+gst_frame_positioner_prepare_output_buffer (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer ** outbuf)
+{
+  guint i;
+  GstVideoMeta *vmeta;
+  gsize offset[GST_VIDEO_MAX_PLANES];
+  gint stride[GST_VIDEO_MAX_PLANES];
+  GstFramePositioner *pos = GST_FRAME_POSITIONNER (trans);
+
+  if (gst_base_transform_is_in_place (trans) || !pos->use_video_meta)
+    return
+        GST_BASE_TRANSFORM_CLASS
+        (gst_frame_positioner_parent_class)->prepare_output_buffer (trans,
+        inbuf, outbuf);
+
+  /* Share the memory of the input frame, only describing the cropped
+   * area in the video meta */
+  *outbuf = gst_buffer_copy (inbuf);
+  vmeta = gst_buffer_get_video_meta (*outbuf);
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (&pos->in_info); i++) {
+    offset[i] = vmeta ? vmeta->offset[i] :
+        GST_VIDEO_INFO_PLANE_OFFSET (&pos->in_info, i);
+    stride[i] = vmeta ? vmeta->stride[i] :
+        GST_VIDEO_INFO_PLANE_STRIDE (&pos->in_info, i);
+    offset[i] += _crop_offset (pos, i, stride[i]);
   }
 
+  if (vmeta)
+    gst_buffer_remove_meta (*outbuf, (GstMeta *) vmeta);
+  gst_buffer_add_video_meta_full (*outbuf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_INFO_FORMAT (&pos->out_info),
+      GST_VIDEO_INFO_WIDTH (&pos->out_info),
+      GST_VIDEO_INFO_HEIGHT (&pos->out_info),
+      GST_VIDEO_INFO_N_PLANES (&pos->out_info), offset, stride);
+
+  return GST_FLOW_OK;
+}
+
+static void
+_add_meta (GstFramePositioner * framepositioner, GstBuffer * buf)
+{
+  GstFramePositionerMeta *meta;
+
   meta =
       (GstFramePositionerMeta *) gst_buffer_add_meta (buf,
       gst_frame_positioner_get_info (), NULL);
@@ -525,5 +843,73 @@ gst_frame_positioner_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
   meta->zorder = framepositioner->zorder;
   GST_OBJECT_UNLOCK (framepositioner);
 
+  if (framepositioner->in_info.width != framepositioner->out_info.width ||
+      framepositioner->in_info.height != framepositioner->out_info.height) {
+    meta->crop_left = framepositioner->crop_x;
+    meta->crop_top = framepositioner->crop_y;
+    meta->crop_right = framepositioner->in_info.width -
+        framepositioner->out_info.width - framepositioner->crop_x;
+    meta->crop_bottom = framepositioner->in_info.height -
+        framepositioner->out_info.height - framepositioner->crop_y;
+  }
+}
+
+static GstFlowReturn
+gst_frame_positioner_transform (GstBaseTransform * trans, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  guint i;
+  GstVideoFrame in, out;
+  GstFramePositioner *pos = GST_FRAME_POSITIONNER (trans);
+
+  /* Downstream can not handle frames with strides and offsets, copy the
+   * cropped area */
+  if (!pos->use_video_meta) {
+    if (!gst_video_frame_map (&in, &pos->in_info, inbuf, GST_MAP_READ))
+      goto invalid_buffer;
+
+    if (!gst_video_frame_map (&out, &pos->out_info, outbuf, GST_MAP_WRITE)) {
+      gst_video_frame_unmap (&in);
+      goto invalid_buffer;
+    }
+
+    for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (&out); i++) {
+      gint row;
+      guint c = _plane_component (pos->out_info.finfo, i);
+      gint sstride = GST_VIDEO_FRAME_PLANE_STRIDE (&in, i);
+      gint dstride = GST_VIDEO_FRAME_PLANE_STRIDE (&out, i);
+      gsize row_size =
+          GST_VIDEO_FRAME_COMP_WIDTH (&out, c) *
+          GST_VIDEO_FRAME_COMP_PSTRIDE (&out, c);
+      const guint8 *src = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&in, i)
+          + _crop_offset (pos, i, sstride);
+      guint8 *dest = GST_VIDEO_FRAME_PLANE_DATA (&out, i);
+
+      for (row = 0; row < GST_VIDEO_FRAME_COMP_HEIGHT (&out, c); row++)
+        memcpy (dest + row * dstride, src + row * sstride, row_size);
+    }
+
+    gst_video_frame_unmap (&out);
+    gst_video_frame_unmap (&in);
+  }
+
+  _add_meta (pos, outbuf);
+
+  return GST_FLOW_OK;
+
+invalid_buffer:
+  {
+    GST_ELEMENT_ERROR (pos, STREAM, FAILED, (NULL),
+        ("Could not map the frames to crop"));
+
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_frame_positioner_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  _add_meta (GST_FRAME_POSITIONNER (trans), buf);
+
   return GST_FLOW_OK;
 }
@@ -21,6 +21,7 @@
 #define _GST_FRAME_POSITIONNER_H_
 
 #include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
 #include <ges/ges-track-element.h>
 #include <ges/ges-track.h>
 
@@ -60,6 +61,18 @@ struct _GstFramePositioner
   gint par_n;
   gint par_d;
 
+  /* The area of the source frames that is kept, cropping is done without
+   * copying when downstream supports GstVideoMeta */
+  gint crop_left;
+  gint crop_right;
+  gint crop_top;
+  gint crop_bottom;
+  gint crop_x;                  /* Origin of the negotiated crop */
+  gint crop_y;
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  gboolean use_video_meta;
+
   /*  This should never be made public, no padding needed */
 };
 
@@ -77,6 +90,12 @@ struct _GstFramePositionerMeta {
   gint height;
   gint width;
   guint zorder;
+
+  /* What was cropped from the frame the buffer comes from */
+  gint crop_left;
+  gint crop_right;
+  gint crop_top;
+  gint crop_bottom;
 };
 
 G_GNUC_INTERNAL void ges_frame_positioner_set_source_and_filter (GstFramePositioner *pos,
@@ -27,6 +27,7 @@
 
 #include "nleobject.h"
 #include "nleghostpad.h"
+#include "nleintervaltree.h"
 #include "nlesource.h"
 #include "nlecomposition.h"
 #include "nleoperation.h"
@@ -52,6 +52,8 @@ enum
 {
   PROP_0,
   PROP_DEACTIVATED_ELEMENTS_STATE,
+  PROP_SKIPPED_STACK_UPDATES,
+  PROP_LOOKAHEAD,
   PROP_LAST,
 };
 
@@ -105,6 +107,15 @@ typedef struct
   NleUpdateStackReason reason;
 } UpdateCompositionData;
 
+/* A source of the next stack being prerolled by the lookahead */
+typedef struct
+{
+  NleObject *object;
+  gulong probe_id;
+  gboolean prerolled;
+  gboolean used;
+} LookaheadObject;
+
 typedef struct _Action
 {
   GCClosure closure;
@@ -128,6 +139,11 @@ struct _NleCompositionPrivate
   GList *objects_stop;
   GHashTable *objects_hash;
 
+  /* Interval index of the objects in objects_start, used to find the objects
+   * playing at a given time without walking the lists.
+   * Same threading constraints as the lists */
+  NleIntervalTree *objects_tree;
+
   /* List of NleObject to be inserted or removed from the composition on the
    * next commit */
   GHashTable *pending_io;
@@ -200,6 +216,37 @@ struct _NleCompositionPrivate
   gboolean tearing_down_stack;
 
   NleUpdateStackReason updating_reason;
+
+  /* TRUE if objects overlapping the current stack have been added, removed
+   * or modified since the beginning of the current commit */
+  gboolean stack_dirty;
+  /* Number of commits that did not touch the current stack so the pipeline
+   * did not need to be updated */
+  guint skipped_stack_updates;
+
+  /* Lookahead of the next stack (see the 'lookahead' property):
+   *  - lookahead_bin: holds the sources of the next stack while they
+   *    preroll, its state is locked
+   *  - lookahead_objects: the #LookaheadObject being prerolled
+   *  - lookahead_seek: the toplevel seek the next stack has been prepared
+   *    for, it has to match the one used when switching to it
+   *  - lookahead_pool: single worker prerolling the sources
+   *  - lookahead_running: whether the worker is prerolling the
+   *    lookahead_objects, lookahead_cancelled makes it stop waiting for them
+   *    and lookahead_cond is signalled when it is done, all protected by
+   *    lookahead_lock
+   *
+   * Those are only touched from the composition thread or while the task is
+   * stopped, the lookahead property itself is accessed atomically */
+  gboolean lookahead;
+  GstElement *lookahead_bin;
+  GList *lookahead_objects;
+  GstEvent *lookahead_seek;
+  GThreadPool *lookahead_pool;
+  GMutex lookahead_lock;
+  GCond lookahead_cond;
+  gboolean lookahead_running;
+  gboolean lookahead_cancelled;
 };
 
 #define ACTION_CALLBACK(__action) (((GCClosure*) (__action))->callback)
@@ -207,6 +254,7 @@ struct _NleCompositionPrivate
 static guint _signals[LAST_SIGNAL] = { 0 };
 
 static GParamSpec *nleobject_properties[NLEOBJECT_PROP_LAST];
+static GParamSpec *properties[PROP_LAST];
 
 #define OBJECT_IN_ACTIVE_SEGMENT(comp,element)      \
   ((NLE_OBJECT_START(element) < comp->priv->current_stack_stop) &&  \
@@ -259,6 +307,8 @@ static void _deactivate_stack (NleComposition * comp,
     gboolean flush_downstream);
 static gboolean _set_real_eos_seqnum_from_seek (NleComposition * comp,
     GstEvent * event);
+static gboolean _set_real_eos_seqnum (NleComposition * comp,
+    gint stack_seqnum);
 static void _emit_commited_signal_func (NleComposition * comp, gpointer udata);
 static void _restart_task (NleComposition * comp);
 static void
@@ -266,6 +316,10 @@ _add_action (NleComposition * comp, GCallback func, gpointer data,
     gint priority);
 static gboolean
 _is_ready_to_restart_task (NleComposition * comp, GstEvent * event);
+static void _start_lookahead (NleComposition * comp);
+static void _lookahead_prepare_func (NleComposition * comp,
+    NleComposition * unused);
+static void _stop_lookahead (NleComposition * comp);
 
 
 /* COMP_REAL_START: actual position to start current playback at. */
@@ -605,6 +659,7 @@ _process_pending_entries (NleComposition * comp)
         deactivated_stack = TRUE;
 
         _deactivate_stack (comp, TRUE);
+        priv->stack_dirty = TRUE;
       }
 
       _nle_composition_remove_object (comp, object);
@@ -619,16 +674,34 @@ _process_pending_entries (NleComposition * comp)
 }
 
 
+/* Marks the stack as needing to be updated if [start, stop] touches it */
+static inline void
+_check_dirty_interval (NleComposition * comp, GstClockTime start,
+    GstClockTime stop)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (priv->stack_dirty)
+    return;
+
+  if (!GST_CLOCK_TIME_IS_VALID (priv->current_stack_start) ||
+      !GST_CLOCK_TIME_IS_VALID (priv->current_stack_stop) ||
+      (start <= priv->current_stack_stop && stop >= priv->current_stack_start))
+    priv->stack_dirty = TRUE;
+}
+
 static inline gboolean
-_commit_values (NleComposition * comp)
+_commit_values (NleComposition * comp, GList ** commited_objects)
 {
   GList *tmp;
   gboolean commited = FALSE;
   NleCompositionPrivate *priv = comp->priv;
 
   for (tmp = priv->objects_start; tmp; tmp = tmp->next) {
-    if (nle_object_commit (tmp->data, TRUE))
+    if (nle_object_commit (tmp->data, TRUE)) {
       commited = TRUE;
+      *commited_objects = g_list_prepend (*commited_objects, tmp->data);
+    }
   }
 
   GST_DEBUG_OBJECT (comp, "Linking up commit vmethod");
@@ -640,22 +713,64 @@ _commit_values (NleComposition * comp)
 static gboolean
 _commit_all_values (NleComposition * comp)
 {
+  GList *tmp, *commited_objects = NULL, *moved_objects = NULL;
+  guint n_moved = 0;
   NleCompositionPrivate *priv = comp->priv;
 
   priv->next_base_time = 0;
+  priv->stack_dirty = FALSE;
 
+  /* Objects prerolled for the next stack might be removed or moved */
+  _stop_lookahead (comp);
   _process_pending_entries (comp);
 
-  if (_commit_values (comp) == FALSE) {
+  if (_commit_values (comp, &commited_objects) == FALSE) {
 
     return FALSE;;
   }
 
-  /* The topology of the composition might have changed, update the lists */
-  priv->objects_start = g_list_sort
-      (priv->objects_start, (GCompareFunc) objects_start_compare);
-  priv->objects_stop = g_list_sort
-      (priv->objects_stop, (GCompareFunc) objects_stop_compare);
+  /* Only reposition the objects whose timing actually changed */
+  for (tmp = commited_objects; tmp; tmp = tmp->next) {
+    NleObject *object = tmp->data;
+    GstClockTime prev_start, prev_stop;
+
+    nle_interval_tree_lookup (priv->objects_tree, object, &prev_start,
+        &prev_stop);
+
+    if (nle_interval_tree_update (priv->objects_tree, object, object->start,
+            object->stop, object->priority)) {
+      moved_objects = g_list_prepend (moved_objects, object);
+      n_moved++;
+
+      _check_dirty_interval (comp, prev_start, prev_stop);
+    }
+
+    /* Active/inpoint changes also need the stack to be updated */
+    _check_dirty_interval (comp, object->start, object->stop);
+  }
+  g_list_free (commited_objects);
+
+  /* Moving an object in the lists is O(n) whereas sorting them is
+   * O(n log n), only resort them when many objects moved */
+  if (n_moved > g_bit_storage (nle_interval_tree_size (priv->objects_tree))) {
+    GST_DEBUG_OBJECT (comp, "%u objects moved, resorting", n_moved);
+
+    priv->objects_start = g_list_sort
+        (priv->objects_start, (GCompareFunc) objects_start_compare);
+    priv->objects_stop = g_list_sort
+        (priv->objects_stop, (GCompareFunc) objects_stop_compare);
+  } else {
+    for (tmp = moved_objects; tmp; tmp = tmp->next) {
+      priv->objects_start = g_list_remove (priv->objects_start, tmp->data);
+      priv->objects_start = g_list_insert_sorted (priv->objects_start,
+          tmp->data, (GCompareFunc) objects_start_compare);
+
+      priv->objects_stop = g_list_remove (priv->objects_stop, tmp->data);
+      priv->objects_stop = g_list_insert_sorted (priv->objects_stop,
+          tmp->data, (GCompareFunc) objects_stop_compare);
+    }
+  }
+  g_list_free (moved_objects);
 
   return TRUE;
 }
@@ -956,6 +1071,42 @@ nle_composition_handle_message (GstBin * bin, GstMessage * message)
   GST_BIN_CLASS (parent_class)->handle_message (bin, message);
 }
 
+static void
+nle_composition_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NleComposition *comp = (NleComposition *) object;
+
+  switch (prop_id) {
+    case PROP_LOOKAHEAD:
+      g_atomic_int_set (&comp->priv->lookahead, g_value_get_boolean (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+nle_composition_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  NleComposition *comp = (NleComposition *) object;
+
+  switch (prop_id) {
+    case PROP_SKIPPED_STACK_UPDATES:
+      g_value_set_uint (value,
+          g_atomic_int_get (&comp->priv->skipped_stack_updates));
+      break;
+    case PROP_LOOKAHEAD:
+      g_value_set_boolean (value, g_atomic_int_get (&comp->priv->lookahead));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 nle_composition_class_init (NleCompositionClass * klass)
 {
@@ -979,6 +1130,8 @@ nle_composition_class_init (NleCompositionClass * klass)
 
   gobject_class->dispose = GST_DEBUG_FUNCPTR (nle_composition_dispose);
   gobject_class->finalize = GST_DEBUG_FUNCPTR (nle_composition_finalize);
+  gobject_class->set_property = nle_composition_set_property;
+  gobject_class->get_property = nle_composition_get_property;
 
   gstelement_class->change_state = nle_composition_change_state;
 
@@ -1000,6 +1153,34 @@ nle_composition_class_init (NleCompositionClass * klass)
   nleobject_properties[NLEOBJECT_PROP_DURATION] =
       g_object_class_find_property (gobject_class, "duration");
 
+  /**
+   * NleComposition:skipped-stack-updates:
+   *
+   * The number of commits which did not modify any object in the currently
+   * playing stack, and thus did not require the pipeline to be updated.
+   */
+  properties[PROP_SKIPPED_STACK_UPDATES] =
+      g_param_spec_uint ("skipped-stack-updates", "Skipped stack updates",
+      "Number of commits that did not require the stack to be updated",
+      0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+  g_object_class_install_property (gobject_class, PROP_SKIPPED_STACK_UPDATES,
+      properties[PROP_SKIPPED_STACK_UPDATES]);
+
+  /**
+   * NleComposition:lookahead:
+   *
+   * Whether the sources of the next stack should be prerolled and seeked
+   * in the background while the current stack is playing, so that
+   * switching to it does not stall the pipeline. This is mostly useful when
+   * rendering, and only applies to forward playback.
+   */
+  properties[PROP_LOOKAHEAD] =
+      g_param_spec_boolean ("lookahead", "Lookahead",
+      "Preroll the next stack while the current one is playing",
+      FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+  g_object_class_install_property (gobject_class, PROP_LOOKAHEAD,
+      properties[PROP_LOOKAHEAD]);
+
   _signals[COMMITED_SIGNAL] =
       g_signal_new ("commited", G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_FIRST,
       0, NULL, NULL, g_cclosure_marshal_generic, G_TYPE_NONE, 1,
@@ -1054,10 +1235,16 @@ nle_composition_init (NleComposition * comp)
   g_rec_mutex_init (&comp->task_rec_lock);
 
   priv->objects_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->objects_tree = nle_interval_tree_new ();
 
   g_mutex_init (&priv->actions_lock);
   g_cond_init (&priv->actions_cond);
 
+  g_mutex_init (&priv->lookahead_lock);
+  g_cond_init (&priv->lookahead_cond);
+  priv->lookahead_pool = g_thread_pool_new ((GFunc) _lookahead_prepare_func,
+      comp, 1, FALSE, NULL);
+
   priv->pending_io = g_hash_table_new_full (g_direct_hash, g_direct_equal,
       gst_object_unref, NULL);
 
@@ -1066,6 +1253,10 @@ nle_composition_init (NleComposition * comp)
   priv->current_bin = gst_bin_new ("current-bin");
   gst_bin_add (GST_BIN (comp), priv->current_bin);
 
+  priv->lookahead_bin = gst_bin_new ("lookahead-bin");
+  gst_element_set_locked_state (priv->lookahead_bin, TRUE);
+  gst_bin_add (GST_BIN (comp), priv->lookahead_bin);
+
   nle_composition_reset (comp);
 
   priv->nle_event_pad_func = GST_PAD_EVENTFUNC (NLE_OBJECT_SRC (comp));
@@ -1104,6 +1295,8 @@ nle_composition_dispose (GObject * object)
 
   priv->dispose_has_run = TRUE;
 
+  _stop_lookahead (comp);
+
   g_list_foreach (priv->objects_start, _remove_each_nleobj, comp);
   g_list_free (priv->objects_start);
 
@@ -1138,12 +1331,17 @@ nle_composition_finalize (GObject * object)
   }
 
   g_hash_table_destroy (priv->objects_hash);
+  nle_interval_tree_free (priv->objects_tree);
 
   gst_segment_free (priv->segment);
   gst_segment_free (priv->outside_segment);
 
   g_rec_mutex_clear (&comp->task_rec_lock);
 
+  g_thread_pool_free (priv->lookahead_pool, TRUE, TRUE);
+  g_mutex_clear (&priv->lookahead_lock);
+  g_cond_clear (&priv->lookahead_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 
   g_mutex_clear (&priv->actions_lock);
@@ -1219,6 +1417,7 @@ nle_composition_reset (NleComposition * comp)
   priv->next_eos_seqnum = 0;
   priv->flush_seqnum = 0;
 
+  _stop_lookahead (comp);
   _empty_bin (GST_BIN_CAST (priv->current_bin));
 
   GST_DEBUG_OBJECT (comp, "Composition now resetted");
@@ -1819,69 +2018,44 @@ nle_composition_ghost_pad_set_target (NleComposition * comp, GstPad * target)
   }
 }
 
+static gboolean
+_object_is_active (NleObject * object, gpointer udata)
+{
+  return NLE_OBJECT_ACTIVE (object);
+}
+
 static void
 refine_start_stop_in_region_above_priority (NleComposition * composition,
     GstClockTime timestamp, GstClockTime start,
     GstClockTime stop,
     GstClockTime * rstart, GstClockTime * rstop, guint32 priority)
 {
-  GList *tmp;
-  NleObject *object;
-  GstClockTime nstart = start, nstop = stop;
+  GstClockTime nstart = start, nstop = stop, found;
+  NleIntervalTree *tree = composition->priv->objects_tree;
 
   GST_DEBUG_OBJECT (composition,
       "timestamp:%" GST_TIME_FORMAT " start: %" GST_TIME_FORMAT " stop: %"
       GST_TIME_FORMAT " priority:%u", GST_TIME_ARGS (timestamp),
       GST_TIME_ARGS (start), GST_TIME_ARGS (stop), priority);
 
-  for (tmp = composition->priv->objects_start; tmp; tmp = tmp->next) {
-    object = (NleObject *) tmp->data;
-
-    GST_LOG_OBJECT (object, "START %" GST_TIME_FORMAT "--%" GST_TIME_FORMAT,
-        GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop));
-
-    if ((object->priority >= priority) || (!NLE_OBJECT_ACTIVE (object)))
-      continue;
-
-    if (object->start <= timestamp)
-      continue;
+  /* First active object with a higher priority starting before stop */
+  found = nle_interval_tree_first_start_in (tree, timestamp, nstop, priority,
+      (NleIntervalTreeFilterFunc) _object_is_active, NULL);
+  if (GST_CLOCK_TIME_IS_VALID (found)) {
+    nstop = found;
 
-    if (object->start >= nstop)
-      continue;
-
-    nstop = object->start;
-
-    GST_DEBUG_OBJECT (composition,
-        "START Found %s [prio:%u] at %" GST_TIME_FORMAT,
-        GST_OBJECT_NAME (object), object->priority,
-        GST_TIME_ARGS (object->start));
-
-    break;
+    GST_DEBUG_OBJECT (composition, "START Found object at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (found));
   }
 
-  for (tmp = composition->priv->objects_stop; tmp; tmp = tmp->next) {
-    object = (NleObject *) tmp->data;
-
-    GST_LOG_OBJECT (object, "STOP %" GST_TIME_FORMAT "--%" GST_TIME_FORMAT,
-        GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop));
-
-    if ((object->priority >= priority) || (!NLE_OBJECT_ACTIVE (object)))
-      continue;
-
-    if (object->stop >= timestamp)
-      continue;
-
-    if (object->stop <= nstart)
-      continue;
+  /* Last active object with a higher priority stopping after start */
+  found = nle_interval_tree_last_stop_in (tree, nstart, timestamp, priority,
+      (NleIntervalTreeFilterFunc) _object_is_active, NULL);
+  if (GST_CLOCK_TIME_IS_VALID (found)) {
+    nstart = found;
 
-    nstart = object->stop;
-
-    GST_DEBUG_OBJECT (composition,
-        "STOP Found %s [prio:%u] at %" GST_TIME_FORMAT,
-        GST_OBJECT_NAME (object), object->priority,
-        GST_TIME_ARGS (object->start));
-
-    break;
+    GST_DEBUG_OBJECT (composition, "STOP Found object at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (found));
   }
 
   if (*rstart)
@@ -2008,64 +2182,23 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
       "timestamp:%" GST_TIME_FORMAT ", priority:%u, activeonly:%d",
       GST_TIME_ARGS (timestamp), priority, activeonly);
 
-  GST_LOG ("objects_start:%p objects_stop:%p", comp->priv->objects_start,
-      comp->priv->objects_stop);
-
-  if (reverse) {
-    for (tmp = comp->priv->objects_stop; tmp; tmp = g_list_next (tmp)) {
-      NleObject *object = (NleObject *) tmp->data;
+  if (activeonly)
+    stack = nle_interval_tree_stab (comp->priv->objects_tree, timestamp,
+        reverse, priority, (NleIntervalTreeFilterFunc) _object_is_active, NULL);
+  else
+    stack = nle_interval_tree_stab (comp->priv->objects_tree, timestamp,
+        reverse, priority, NULL, NULL);
 
-      GST_LOG_OBJECT (object,
-          "start: %" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT " , duration:%"
-          GST_TIME_FORMAT ", priority:%u, active:%d",
-          GST_TIME_ARGS (object->start), GST_TIME_ARGS (object->stop),
-          GST_TIME_ARGS (object->duration), object->priority, object->active);
-
-      if (object->stop >= timestamp) {
-        if ((object->start < timestamp) &&
-            (object->priority >= priority) &&
-            ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
-          GST_LOG_OBJECT (comp, "adding %s: sorted to the stack",
-              GST_OBJECT_NAME (object));
-          stack = g_list_insert_sorted (stack, object,
-              (GCompareFunc) priority_comp);
-          if (NLE_IS_OPERATION (object))
-            nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
-        }
-      } else {
-        GST_LOG_OBJECT (comp, "too far, stopping iteration");
-        first_out_of_stack = object->stop;
-        break;
-      }
-    }
-  } else {
-    for (tmp = comp->priv->objects_start; tmp; tmp = g_list_next (tmp)) {
-      NleObject *object = (NleObject *) tmp->data;
+  for (tmp = stack; tmp; tmp = tmp->next)
+    GST_LOG_OBJECT (comp, "adding %s to the stack",
+        GST_OBJECT_NAME (tmp->data));
 
-      GST_LOG_OBJECT (object,
-          "start: %" GST_TIME_FORMAT " , stop:%" GST_TIME_FORMAT " , duration:%"
-          GST_TIME_FORMAT ", priority:%u", GST_TIME_ARGS (object->start),
-          GST_TIME_ARGS (object->stop), GST_TIME_ARGS (object->duration),
-          object->priority);
-
-      if (object->start <= timestamp) {
-        if ((object->stop > timestamp) &&
-            (object->priority >= priority) &&
-            ((!activeonly) || (NLE_OBJECT_ACTIVE (object)))) {
-          GST_LOG_OBJECT (comp, "adding %s: sorted to the stack",
-              GST_OBJECT_NAME (object));
-          stack = g_list_insert_sorted (stack, object,
-              (GCompareFunc) priority_comp);
-          if (NLE_IS_OPERATION (object))
-            nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
-        }
-      } else {
-        GST_LOG_OBJECT (comp, "too far, stopping iteration");
-        first_out_of_stack = object->start;
-        break;
-      }
-    }
-  }
+  if (reverse)
+    first_out_of_stack =
+        nle_interval_tree_previous_stop (comp->priv->objects_tree, timestamp);
+  else
+    first_out_of_stack =
+        nle_interval_tree_next_start (comp->priv->objects_tree, timestamp);
 
   /* Insert the expandables */
   if (G_LIKELY (timestamp < NLE_OBJECT_STOP (comp)))
@@ -2074,8 +2207,6 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
           GST_OBJECT_NAME (tmp->data));
       stack = g_list_insert_sorted (stack, tmp->data,
           (GCompareFunc) priority_comp);
-      if (NLE_IS_OPERATION (tmp->data))
-        nle_operation_update_base_time (NLE_OPERATION (tmp->data), timestamp);
     }
 
   /* convert that list to a stack */
@@ -2178,6 +2309,259 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
   return stack;
 }
 
+/*
+ * Lookahead:
+ *
+ * While a stack is playing, the sources of the next stack which are not part
+ * of the current one are seeked and set to PAUSED from a separate thread,
+ * in the lookahead bin. A blocking probe on their source pad keeps them from
+ * pushing anything before the composition switches to that stack. They are
+ * then moved to the current bin as is, instead of going through
+ * READY->PAUSED and being seeked on the composition thread, and unblocked
+ * once the new stack has been activated.
+ *
+ * WITH OBJECTS LOCK TAKEN
+ */
+static GstPadProbeReturn
+_lookahead_blocked_cb (GstPad * pad G_GNUC_UNUSED,
+    GstPadProbeInfo * info G_GNUC_UNUSED, gpointer udata G_GNUC_UNUSED)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+static gboolean
+_lookahead_cancelled (NleComposition * comp)
+{
+  gboolean cancelled;
+
+  g_mutex_lock (&comp->priv->lookahead_lock);
+  cancelled = comp->priv->lookahead_cancelled;
+  g_mutex_unlock (&comp->priv->lookahead_lock);
+
+  return cancelled;
+}
+
+/* Runs in the lookahead pool */
+static void
+_lookahead_prepare_func (NleComposition * comp, NleComposition * unused)
+{
+  GList *tmp;
+  NleCompositionPrivate *priv = comp->priv;
+
+  for (tmp = priv->lookahead_objects; tmp; tmp = tmp->next) {
+    GstStateChangeReturn ret;
+    LookaheadObject *lobj = tmp->data;
+    GstElement *element = GST_ELEMENT (lobj->object);
+
+    GST_DEBUG_OBJECT (comp, "Prerolling %s", GST_OBJECT_NAME (element));
+    ret = gst_element_set_state (element, GST_STATE_PAUSED);
+
+    /* Only the sources which are done prerolling can be used as is, keep
+     * checking whether the composition still needs them meanwhile */
+    while (ret == GST_STATE_CHANGE_ASYNC && !_lookahead_cancelled (comp))
+      ret = gst_element_get_state (element, NULL, NULL, 100 * GST_MSECOND);
+
+    lobj->prerolled = ret == GST_STATE_CHANGE_SUCCESS ||
+        ret == GST_STATE_CHANGE_NO_PREROLL;
+    GST_DEBUG_OBJECT (comp, "%s %s", GST_OBJECT_NAME (element),
+        lobj->prerolled ? "prerolled" : "did not preroll");
+  }
+
+  g_mutex_lock (&priv->lookahead_lock);
+  priv->lookahead_running = FALSE;
+  g_cond_broadcast (&priv->lookahead_cond);
+  g_mutex_unlock (&priv->lookahead_lock);
+}
+
+static gboolean
+_add_lookahead_source (GNode * node, NleComposition * comp)
+{
+  GstEvent *translated_seek;
+  LookaheadObject *lobj;
+  NleObject *object = (NleObject *) node->data;
+  NleCompositionPrivate *priv = comp->priv;
+
+  /* Objects of the current stack are already running */
+  if (!NLE_IS_SOURCE (object) || GST_OBJECT_PARENT (object))
+    return FALSE;
+
+  lobj = g_slice_new0 (LookaheadObject);
+  lobj->object = gst_object_ref (object);
+
+  /* Go to READY before being added to the lookahead bin, otherwise the
+   * object would commit itself */
+  gst_element_set_state (GST_ELEMENT (object), GST_STATE_READY);
+  gst_bin_add (GST_BIN (priv->lookahead_bin), GST_ELEMENT (object));
+
+  translated_seek = nle_object_translate_incoming_seek (object,
+      priv->lookahead_seek);
+  gst_element_send_event (GST_ELEMENT (object), translated_seek);
+
+  lobj->probe_id = gst_pad_add_probe (NLE_OBJECT_SRC (object),
+      GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      (GstPadProbeCallback) _lookahead_blocked_cb, NULL, NULL);
+
+  priv->lookahead_objects = g_list_prepend (priv->lookahead_objects, lobj);
+
+  return FALSE;
+}
+
+static void
+_start_lookahead (NleComposition * comp)
+{
+  GNode *stack;
+  guint highprio;
+  GstClockTime start = G_MAXUINT64, stop = G_MAXUINT64;
+  NleCompositionPrivate *priv = comp->priv;
+  GstClockTime timestamp = priv->current_stack_stop;
+
+  if (!g_atomic_int_get (&priv->lookahead) || priv->lookahead_seek ||
+      !priv->current || priv->segment->rate < 0.0 ||
+      !GST_CLOCK_TIME_IS_VALID (timestamp) ||
+      timestamp >= COMP_REAL_STOP (comp))
+    return;
+
+  /* Same as get_clean_toplevel_stack() but without reporting gaps, they
+   * will be when actually reaching them */
+  stack = get_stack_list (comp, timestamp, 0, TRUE, &start, &stop, &highprio);
+  if (!stack)
+    return;
+
+  refine_start_stop_in_region_above_priority (comp, timestamp, start, stop,
+      &start, &stop,
+      (highprio == 0) ? NLE_OBJECT_PRIORITY (stack->data) : highprio);
+
+  /* Same seek as the one get_new_seek_event() will create when switching
+   * to that stack */
+  if (GST_CLOCK_TIME_IS_VALID (priv->segment->stop))
+    stop = MIN (priv->segment->stop, stop);
+  priv->lookahead_seek = gst_event_new_seek (priv->segment->rate,
+      priv->segment->format, GST_SEEK_FLAG_ACCURATE | GST_SEEK_FLAG_FLUSH,
+      GST_SEEK_TYPE_SET, timestamp, GST_SEEK_TYPE_SET, stop);
+  gst_event_set_seqnum (priv->lookahead_seek, gst_util_seqnum_next ());
+
+  g_node_traverse (stack, G_IN_ORDER, G_TRAVERSE_ALL, -1,
+      (GNodeTraverseFunc) _add_lookahead_source, comp);
+  g_node_destroy (stack);
+
+  if (!priv->lookahead_objects) {
+    gst_event_unref (priv->lookahead_seek);
+    priv->lookahead_seek = NULL;
+
+    return;
+  }
+
+  GST_INFO_OBJECT (comp, "Prerolling %u sources for the stack starting at %"
+      GST_TIME_FORMAT, g_list_length (priv->lookahead_objects),
+      GST_TIME_ARGS (timestamp));
+
+  g_mutex_lock (&priv->lookahead_lock);
+  priv->lookahead_running = TRUE;
+  priv->lookahead_cancelled = FALSE;
+  g_mutex_unlock (&priv->lookahead_lock);
+  g_thread_pool_push (priv->lookahead_pool, comp, NULL);
+}
+
+/* Waits for the lookahead worker to be done with the lookahead objects,
+ * @cancel makes it stop waiting for the sources still prerolling */
+static void
+_wait_lookahead_worker (NleComposition * comp, gboolean cancel)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  g_mutex_lock (&priv->lookahead_lock);
+  if (cancel)
+    priv->lookahead_cancelled = TRUE;
+  while (priv->lookahead_running)
+    g_cond_wait (&priv->lookahead_cond, &priv->lookahead_lock);
+  g_mutex_unlock (&priv->lookahead_lock);
+}
+
+/* Leaves the object in the current bin if it has been used in the new stack,
+ * otherwise sets it back to READY outside of any bin */
+static void
+_free_lookahead_object (NleComposition * comp, LookaheadObject * lobj)
+{
+  if (!lobj->used) {
+    /* Make sure nothing gets pushed on the unlinked pad once unblocked */
+    gst_element_set_state (GST_ELEMENT (lobj->object), GST_STATE_READY);
+    gst_bin_remove (GST_BIN (comp->priv->lookahead_bin),
+        GST_ELEMENT (lobj->object));
+  }
+
+  gst_pad_remove_probe (NLE_OBJECT_SRC (lobj->object), lobj->probe_id);
+  gst_object_unref (lobj->object);
+  g_slice_free (LookaheadObject, lobj);
+}
+
+/* Unblocks the sources used in the new stack and discards the others */
+static void
+_stop_lookahead (NleComposition * comp)
+{
+  GList *tmp;
+  NleCompositionPrivate *priv = comp->priv;
+
+  _wait_lookahead_worker (comp, TRUE);
+
+  for (tmp = priv->lookahead_objects; tmp; tmp = tmp->next)
+    _free_lookahead_object (comp, tmp->data);
+  g_list_free (priv->lookahead_objects);
+  priv->lookahead_objects = NULL;
+
+  if (priv->lookahead_seek) {
+    gst_event_unref (priv->lookahead_seek);
+    priv->lookahead_seek = NULL;
+  }
+}
+
+/* Returns TRUE if the lookahead prerolled the next stack for @toplevel_seek */
+static gboolean
+_lookahead_matches (NleComposition * comp, GstEvent * toplevel_seek)
+{
+  GstEvent *seek = comp->priv->lookahead_seek;
+
+  return seek && GST_EVENT_SEQNUM (seek) == GST_EVENT_SEQNUM (toplevel_seek)
+      && gst_structure_is_equal (gst_event_get_structure (seek),
+      gst_event_get_structure (toplevel_seek));
+}
+
+/* Moves @object to the current bin if it has been prerolled by the
+ * lookahead, in which case it does not need to be seeked anymore */
+static gboolean
+_take_lookahead_object (NleComposition * comp, NleObject * object)
+{
+  GList *tmp;
+  LookaheadObject *lobj = NULL;
+  NleCompositionPrivate *priv = comp->priv;
+
+  for (tmp = priv->lookahead_objects; tmp; tmp = tmp->next) {
+    if (((LookaheadObject *) tmp->data)->object == object) {
+      lobj = tmp->data;
+      break;
+    }
+  }
+
+  if (!lobj)
+    return FALSE;
+
+  if (!lobj->prerolled) {
+    priv->lookahead_objects = g_list_delete_link (priv->lookahead_objects, tmp);
+    _free_lookahead_object (comp, lobj);
+
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (comp, "Using prerolled %s", GST_OBJECT_NAME (object));
+
+  gst_object_ref (object);
+  gst_bin_remove (GST_BIN (priv->lookahead_bin), GST_ELEMENT (object));
+  gst_bin_add (GST_BIN (priv->current_bin), GST_ELEMENT (object));
+  gst_object_unref (object);
+  lobj->used = TRUE;
+
+  return TRUE;
+}
+
 static GstPadProbeReturn
 _drop_all_cb (GstPad * pad G_GNUC_UNUSED,
     GstPadProbeInfo * info, NleComposition * comp)
@@ -2323,6 +2707,7 @@ _commit_func (NleComposition * comp, UpdateCompositionData * ucompo)
   if (!_commit_all_values (comp)) {
     GST_DEBUG_OBJECT (comp, "Nothing to commit, leaving");
 
+    _start_lookahead (comp);
     g_signal_emit (comp, _signals[COMMITED_SIGNAL], 0, FALSE);
     _post_start_composition_update_done (comp, ucompo->seqnum, ucompo->reason);
 
@@ -2342,6 +2727,29 @@ _commit_func (NleComposition * comp, UpdateCompositionData * ucompo)
     /* And update the pipeline at current position if needed */
     update_start_stop_duration (comp);
 
+    if (!priv->stack_dirty && priv->current &&
+        GST_CLOCK_TIME_IS_VALID (curpos) &&
+        curpos >= priv->current_stack_start &&
+        curpos < priv->current_stack_stop &&
+        g_atomic_int_get (&priv->real_eos_seqnum) != 1) {
+      GST_INFO_OBJECT (comp, "Current stack [%" GST_TIME_FORMAT " - %"
+          GST_TIME_FORMAT "] not touched by the commit, not updating it",
+          GST_TIME_ARGS (priv->current_stack_start),
+          GST_TIME_ARGS (priv->current_stack_stop));
+
+      g_atomic_int_inc (&priv->skipped_stack_updates);
+
+      /* Objects after the current stack might have been added or removed */
+      _set_real_eos_seqnum (comp, priv->next_eos_seqnum);
+      _start_lookahead (comp);
+
+      g_signal_emit (comp, _signals[COMMITED_SIGNAL], 0, TRUE);
+      _post_start_composition_update_done (comp, ucompo->seqnum,
+          ucompo->reason);
+
+      return;
+    }
+
     reverse = (priv->segment->rate < 0.0);
     if (!reverse) {
       GST_DEBUG_OBJECT (comp,
@@ -2373,10 +2781,15 @@ _update_pipeline_func (NleComposition * comp, UpdateCompositionData * ucompo)
   gboolean reverse;
   NleCompositionPrivate *priv = comp->priv;
 
-  _post_start_composition_update (comp, ucompo->seqnum, ucompo->reason);
-
   /* Set up a non-initial seek on current_stack_stop */
   reverse = (priv->segment->rate < 0.0);
+
+  /* Use the seqnum the next stack has been prerolled with, if any */
+  if (!reverse && priv->lookahead_seek)
+    ucompo->seqnum = GST_EVENT_SEQNUM (priv->lookahead_seek);
+
+  _post_start_composition_update (comp, ucompo->seqnum, ucompo->reason);
+
   if (!reverse) {
     GST_DEBUG_OBJECT (comp,
         "Setting segment->start to current_stack_stop:%" GST_TIME_FORMAT,
@@ -2706,12 +3119,16 @@ _relink_single_node (NleComposition * comp, GNode * node,
 
   srcpad = NLE_OBJECT_SRC (newobj);
 
-  gst_bin_add (GST_BIN (comp->priv->current_bin), GST_ELEMENT (newobj));
-  gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
+  /* Sources prerolled by the lookahead are already seeked and PAUSED */
+  if (!_take_lookahead_object (comp, newobj)) {
+    gst_bin_add (GST_BIN (comp->priv->current_bin), GST_ELEMENT (newobj));
+    gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
 
-  translated_seek = nle_object_translate_incoming_seek (newobj, toplevel_seek);
+    translated_seek =
+        nle_object_translate_incoming_seek (newobj, toplevel_seek);
 
-  gst_element_send_event (GST_ELEMENT (newobj), translated_seek);
+    gst_element_send_event (GST_ELEMENT (newobj), translated_seek);
+  }
 
   /* link to parent if needed.  */
   if (newparent) {
@@ -2888,13 +3305,19 @@ resync_state:
 /* WITH OBJECTS LOCK TAKEN */
 static gboolean
 _set_real_eos_seqnum_from_seek (NleComposition * comp, GstEvent * event)
+{
+  return _set_real_eos_seqnum (comp, gst_event_get_seqnum (event));
+}
+
+/* WITH OBJECTS LOCK TAKEN */
+static gboolean
+_set_real_eos_seqnum (NleComposition * comp, gint stack_seqnum)
 {
   GList *tmp;
 
   gboolean should_check_objects = FALSE;
   NleCompositionPrivate *priv = comp->priv;
   gboolean reverse = (priv->segment->rate < 0);
-  gint stack_seqnum = gst_event_get_seqnum (event);
 
   if (reverse && GST_CLOCK_TIME_IS_VALID (priv->current_stack_start))
     should_check_objects = TRUE;
@@ -2943,6 +3366,7 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   GstEvent *toplevel_seek;
 
+  gboolean res;
   GNode *stack = NULL;
   gboolean samestack = FALSE;
   gboolean updatestoponly = FALSE;
@@ -2984,6 +3408,11 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
   stack = get_clean_toplevel_stack (comp, &currenttime, &new_start, &new_stop);
   samestack = are_same_stacks (priv->current, stack);
 
+  /* The operations of the stack will start at currenttime */
+  if (stack)
+    g_node_traverse (stack, G_IN_ORDER, G_TRAVERSE_ALL, -1,
+        (GNodeTraverseFunc) update_base_time, &currenttime);
+
   /* set new current_stack_start/stop (the current zone over which the new stack
    * is valid) */
   if (priv->segment->rate >= 0.0) {
@@ -3022,6 +3451,12 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
   gst_event_set_seqnum (toplevel_seek, seqnum);
   _set_real_eos_seqnum_from_seek (comp, toplevel_seek);
 
+  /* Sources prerolled for another seek can not be used */
+  if (samestack || !_lookahead_matches (comp, toplevel_seek))
+    _stop_lookahead (comp);
+  else
+    _wait_lookahead_worker (comp, FALSE);
+
   _remove_update_actions (comp);
 
   /* If stacks are different, unlink/relink objects */
@@ -3050,6 +3485,7 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
       GST_INFO_OBJECT (comp,
           "No task set, it must have been stopped, returning");
       GST_OBJECT_UNLOCK (comp);
+      _stop_lookahead (comp);
       return FALSE;
     }
 
@@ -3059,10 +3495,17 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   /* Activate stack */
   if (!samestack)
-    return _activate_new_stack (comp);
+    res = _activate_new_stack (comp);
   else
-    return _seek_current_stack (comp, toplevel_seek,
+    res = _seek_current_stack (comp, toplevel_seek,
         _have_to_flush_downstream (update_reason));
+
+  /* Let the prerolled sources flow now that the stack is active, and start
+   * prerolling the next one */
+  _stop_lookahead (comp);
+  _start_lookahead (comp);
+
+  return res;
 }
 
 static gboolean
@@ -3071,7 +3514,8 @@ nle_composition_add_object (GstBin * bin, GstElement * element)
   NleObject *object;
   NleComposition *comp = (NleComposition *) bin;
 
-  if (element == comp->priv->current_bin) {
+  if (element == comp->priv->current_bin ||
+      element == comp->priv->lookahead_bin) {
     GST_INFO_OBJECT (comp, "Adding internal bin");
     return GST_BIN_CLASS (parent_class)->add_element (bin, element);
   }
@@ -3140,9 +3584,14 @@ _nle_composition_add_object (NleComposition * comp, NleObject * object)
   if (NLE_OBJECT_IS_EXPANDABLE (object)) {
     /* It doesn't get added to objects_start and objects_stop. */
     priv->expandables = g_list_prepend (priv->expandables, object);
+    priv->stack_dirty = TRUE;
     goto beach;
   }
 
+  /* Commit the object right away so it is inserted at its final position and
+   * not considered as moved during the rest of the composition commit */
+  nle_object_commit (object, TRUE);
+
   /* add it sorted to the objects list */
   priv->objects_start = g_list_insert_sorted
       (priv->objects_start, object, (GCompareFunc) objects_start_compare);
@@ -3158,7 +3607,11 @@ _nle_composition_add_object (NleComposition * comp, NleObject * object)
   priv->objects_stop = g_list_insert_sorted
       (priv->objects_stop, object, (GCompareFunc) objects_stop_compare);
 
-  /* Now the object is ready to be commited and then used */
+  nle_interval_tree_insert (priv->objects_tree, object, object->start,
+      object->stop, object->priority);
+  _check_dirty_interval (comp, object->start, object->stop);
+
+  /* Now the object is ready to be used */
 
 beach:
   return ret;
@@ -3176,7 +3629,8 @@ nle_composition_remove_object (GstBin * bin, GstElement * element)
   NleObject *object;
   NleComposition *comp = (NleComposition *) bin;
 
-  if (element == comp->priv->current_bin) {
+  if (element == comp->priv->current_bin ||
+      element == comp->priv->lookahead_bin) {
     GST_INFO_OBJECT (comp, "Removing internal bin");
     return GST_BIN_CLASS (parent_class)->remove_element (bin, element);
   }
@@ -3210,10 +3664,17 @@ _nle_composition_remove_object (NleComposition * comp, NleObject * object)
   if (NLE_OBJECT_IS_EXPANDABLE (object)) {
     /* Find it in the list */
     priv->expandables = g_list_remove (priv->expandables, object);
+    priv->stack_dirty = TRUE;
   } else {
+    GstClockTime start, stop;
+
+    if (nle_interval_tree_lookup (priv->objects_tree, object, &start, &stop))
+      _check_dirty_interval (comp, start, stop);
+
     /* remove it from the objects list and resort the lists */
     priv->objects_start = g_list_remove (priv->objects_start, object);
     priv->objects_stop = g_list_remove (priv->objects_stop, object);
+    nle_interval_tree_remove (priv->objects_tree, object);
     GST_LOG_OBJECT (object, "Removed from the objects start/stop list");
   }
 
@@ -0,0 +1,605 @@
+/* GStreamer
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * nleintervaltree.c: Interval index of the objects of a composition
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * NleIntervalTree is an AVL tree of [start, stop[ intervals ordered by
+ * start then priority. Each node is annotated with the min/max stop and
+ * min/max priority of its subtree so that the composition can find the
+ * objects playing at a given time (and the boundaries of the region where
+ * they are the only ones playing) without walking all of its children.
+ *
+ * The tree only keeps a copy of the timing values it has been given, it is
+ * the responsability of the user to call nle_interval_tree_update() when
+ * those change.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "nleintervaltree.h"
+
+typedef struct _Node Node;
+
+struct _Node
+{
+  gpointer data;
+
+  GstClockTime start;
+  GstClockTime stop;
+  guint32 priority;
+
+  /* Subtree annotations */
+  GstClockTime min_stop;
+  GstClockTime max_stop;
+  guint32 min_priority;
+  guint32 max_priority;
+  gint height;
+
+  Node *left;
+  Node *right;
+};
+
+struct _NleIntervalTree
+{
+  Node *root;
+
+  /* data -> Node */
+  GHashTable *nodes;
+};
+
+typedef struct
+{
+  GstClockTime timestamp;
+  gboolean reverse;
+
+  GstClockTime after;
+  GstClockTime before;
+  gboolean has_after;
+
+  guint32 priority;
+  gboolean check_priority;
+
+  NleIntervalTreeFilterFunc filter;
+  gpointer udata;
+} Query;
+
+#define HEIGHT(node) ((node) ? (node)->height : 0)
+
+static inline gint
+node_compare (Node * a, Node * b)
+{
+  if (a->start != b->start)
+    return a->start < b->start ? -1 : 1;
+
+  if (a->priority != b->priority)
+    return a->priority < b->priority ? -1 : 1;
+
+  if (a->data != b->data)
+    return GPOINTER_TO_SIZE (a->data) < GPOINTER_TO_SIZE (b->data) ? -1 : 1;
+
+  return 0;
+}
+
+static inline void
+node_fix (Node * node)
+{
+  Node *children[2] = { node->left, node->right };
+  guint i;
+
+  node->height = 1 + MAX (HEIGHT (node->left), HEIGHT (node->right));
+  node->min_stop = node->max_stop = node->stop;
+  node->min_priority = node->max_priority = node->priority;
+
+  for (i = 0; i < G_N_ELEMENTS (children); i++) {
+    Node *child = children[i];
+
+    if (!child)
+      continue;
+
+    node->min_stop = MIN (node->min_stop, child->min_stop);
+    node->max_stop = MAX (node->max_stop, child->max_stop);
+    node->min_priority = MIN (node->min_priority, child->min_priority);
+    node->max_priority = MAX (node->max_priority, child->max_priority);
+  }
+}
+
+static Node *
+rotate_right (Node * node)
+{
+  Node *pivot = node->left;
+
+  node->left = pivot->right;
+  pivot->right = node;
+
+  node_fix (node);
+  node_fix (pivot);
+
+  return pivot;
+}
+
+static Node *
+rotate_left (Node * node)
+{
+  Node *pivot = node->right;
+
+  node->right = pivot->left;
+  pivot->left = node;
+
+  node_fix (node);
+  node_fix (pivot);
+
+  return pivot;
+}
+
+static Node *
+node_balance (Node * node)
+{
+  gint balance;
+
+  node_fix (node);
+  balance = HEIGHT (node->left) - HEIGHT (node->right);
+
+  if (balance > 1) {
+    if (HEIGHT (node->left->left) < HEIGHT (node->left->right))
+      node->left = rotate_left (node->left);
+
+    return rotate_right (node);
+  } else if (balance < -1) {
+    if (HEIGHT (node->right->right) < HEIGHT (node->right->left))
+      node->right = rotate_right (node->right);
+
+    return rotate_left (node);
+  }
+
+  return node;
+}
+
+static Node *
+node_insert (Node * root, Node * node)
+{
+  if (!root)
+    return node;
+
+  if (node_compare (node, root) < 0)
+    root->left = node_insert (root->left, node);
+  else
+    root->right = node_insert (root->right, node);
+
+  return node_balance (root);
+}
+
+static Node *
+node_remove_min (Node * root, Node ** min)
+{
+  if (!root->left) {
+    *min = root;
+
+    return root->right;
+  }
+
+  root->left = node_remove_min (root->left, min);
+
+  return node_balance (root);
+}
+
+static Node *
+node_remove (Node * root, Node * node)
+{
+  gint cmp;
+
+  if (!root)
+    return NULL;
+
+  cmp = node_compare (node, root);
+  if (cmp < 0) {
+    root->left = node_remove (root->left, node);
+  } else if (cmp > 0) {
+    root->right = node_remove (root->right, node);
+  } else {
+    Node *successor = NULL, *right;
+
+    if (!root->right)
+      return root->left;
+
+    right = node_remove_min (root->right, &successor);
+    successor->left = root->left;
+    successor->right = right;
+    root = successor;
+  }
+
+  return node_balance (root);
+}
+
+static inline gboolean
+query_accepts (Query * query, Node * node)
+{
+  if (query->check_priority && node->priority >= query->priority)
+    return FALSE;
+
+  if (query->filter && !query->filter (node->data, query->udata))
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+node_stab (Node * node, Query * query, GPtrArray * res)
+{
+  if (!node)
+    return;
+
+  if (node->max_priority < query->priority)
+    return;
+
+  /* Forward: start <= timestamp < stop, reverse: start < timestamp <= stop */
+  if (query->reverse ? node->max_stop < query->timestamp :
+      node->max_stop <= query->timestamp)
+    return;
+
+  node_stab (node->left, query, res);
+
+  /* The node and its right subtree all start after timestamp */
+  if (query->reverse ? node->start >= query->timestamp :
+      node->start > query->timestamp)
+    return;
+
+  if (node->priority >= query->priority &&
+      (query->reverse ? node->stop >= query->timestamp :
+          node->stop > query->timestamp) &&
+      (!query->filter || query->filter (node->data, query->udata)))
+    g_ptr_array_add (res, node);
+
+  node_stab (node->right, query, res);
+}
+
+static gint
+stab_result_compare (Node ** a, Node ** b)
+{
+  if ((*a)->priority != (*b)->priority)
+    return (*a)->priority < (*b)->priority ? -1 : 1;
+
+  return node_compare (*a, *b);
+}
+
+/* Smallest start in ]after, before[ */
+static Node *
+node_first_start_in (Node * node, Query * query)
+{
+  Node *res;
+
+  if (!node)
+    return NULL;
+
+  if (query->check_priority && node->min_priority >= query->priority)
+    return NULL;
+
+  if (!query->has_after || node->start > query->after) {
+    if ((res = node_first_start_in (node->left, query)))
+      return res;
+
+    if (node->start < query->before && query_accepts (query, node))
+      return node;
+  }
+
+  if (node->start < query->before)
+    return node_first_start_in (node->right, query);
+
+  return NULL;
+}
+
+/* Biggest stop in ]after, before[, stops are not ordered in the tree so
+ * we can only prune using the subtree annotations */
+static void
+node_last_stop_in (Node * node, Query * query, Node ** best)
+{
+  if (!node)
+    return;
+
+  if (query->check_priority && node->min_priority >= query->priority)
+    return;
+
+  if (node->min_stop >= query->before)
+    return;
+
+  if (query->has_after && node->max_stop <= query->after)
+    return;
+
+  if (*best && node->max_stop <= (*best)->stop)
+    return;
+
+  /* All nodes on the right start (and thus stop) after node->start */
+  if (node->start < query->before)
+    node_last_stop_in (node->right, query, best);
+
+  if (node->stop < query->before &&
+      (!query->has_after || node->stop > query->after) &&
+      (!*best || node->stop > (*best)->stop) && query_accepts (query, node))
+    *best = node;
+
+  node_last_stop_in (node->left, query, best);
+}
+
+static void
+node_free (Node * node)
+{
+  g_slice_free (Node, node);
+}
+
+/**
+ * nle_interval_tree_new: (skip)
+ *
+ * Returns: A new empty #NleIntervalTree
+ */
+NleIntervalTree *
+nle_interval_tree_new (void)
+{
+  NleIntervalTree *tree = g_slice_new0 (NleIntervalTree);
+
+  tree->nodes = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) node_free);
+
+  return tree;
+}
+
+void
+nle_interval_tree_free (NleIntervalTree * tree)
+{
+  g_hash_table_unref (tree->nodes);
+  g_slice_free (NleIntervalTree, tree);
+}
+
+guint
+nle_interval_tree_size (NleIntervalTree * tree)
+{
+  return g_hash_table_size (tree->nodes);
+}
+
+gboolean
+nle_interval_tree_contains (NleIntervalTree * tree, gpointer data)
+{
+  return g_hash_table_contains (tree->nodes, data);
+}
+
+/**
+ * nle_interval_tree_lookup:
+ * @start: (out) (allow-none): The start @data has in @tree
+ * @stop: (out) (allow-none): The stop @data has in @tree
+ *
+ * Returns: %TRUE if @data is in @tree, %FALSE otherwise
+ */
+gboolean
+nle_interval_tree_lookup (NleIntervalTree * tree, gpointer data,
+    GstClockTime * start, GstClockTime * stop)
+{
+  Node *node = g_hash_table_lookup (tree->nodes, data);
+
+  if (!node)
+    return FALSE;
+
+  if (start)
+    *start = node->start;
+
+  if (stop)
+    *stop = node->stop;
+
+  return TRUE;
+}
+
+void
+nle_interval_tree_insert (NleIntervalTree * tree, gpointer data,
+    GstClockTime start, GstClockTime stop, guint32 priority)
+{
+  Node *node;
+
+  g_return_if_fail (!g_hash_table_contains (tree->nodes, data));
+
+  node = g_slice_new0 (Node);
+  node->data = data;
+  node->start = start;
+  node->stop = stop;
+  node->priority = priority;
+  node_fix (node);
+
+  g_hash_table_insert (tree->nodes, data, node);
+  tree->root = node_insert (tree->root, node);
+}
+
+gboolean
+nle_interval_tree_remove (NleIntervalTree * tree, gpointer data)
+{
+  Node *node = g_hash_table_lookup (tree->nodes, data);
+
+  if (!node)
+    return FALSE;
+
+  tree->root = node_remove (tree->root, node);
+  g_hash_table_remove (tree->nodes, data);
+
+  return TRUE;
+}
+
+/**
+ * nle_interval_tree_update:
+ *
+ * Repositions @data in @tree if its timing values changed.
+ *
+ * Returns: %TRUE if @data had to be moved, %FALSE otherwise
+ */
+gboolean
+nle_interval_tree_update (NleIntervalTree * tree, gpointer data,
+    GstClockTime start, GstClockTime stop, guint32 priority)
+{
+  Node *node = g_hash_table_lookup (tree->nodes, data);
+
+  g_return_val_if_fail (node, FALSE);
+
+  if (node->start == start && node->stop == stop && node->priority == priority)
+    return FALSE;
+
+  tree->root = node_remove (tree->root, node);
+
+  node->start = start;
+  node->stop = stop;
+  node->priority = priority;
+  node->left = node->right = NULL;
+  node_fix (node);
+
+  tree->root = node_insert (tree->root, node);
+
+  return TRUE;
+}
+
+/**
+ * nle_interval_tree_stab:
+ * @timestamp: The time to look at
+ * @reverse: Whether intervals are considered as ]start, stop] instead of
+ * [start, stop[
+ * @priority: The minimum priority of the intervals to return
+ * @filter: (allow-none): Function to filter the matching intervals
+ *
+ * Returns: (transfer container): The data of the intervals containing
+ * @timestamp sorted by priority.
+ */
+GList *
+nle_interval_tree_stab (NleIntervalTree * tree, GstClockTime timestamp,
+    gboolean reverse, guint32 priority, NleIntervalTreeFilterFunc filter,
+    gpointer udata)
+{
+  gint i;
+  GList *res = NULL;
+  GPtrArray *nodes = g_ptr_array_new ();
+  Query query = { 0, };
+
+  query.timestamp = timestamp;
+  query.reverse = reverse;
+  query.priority = priority;
+  query.filter = filter;
+  query.udata = udata;
+
+  node_stab (tree->root, &query, nodes);
+  g_ptr_array_sort (nodes, (GCompareFunc) stab_result_compare);
+
+  for (i = nodes->len - 1; i >= 0; i--)
+    res = g_list_prepend (res, ((Node *) g_ptr_array_index (nodes, i))->data);
+
+  g_ptr_array_free (nodes, TRUE);
+
+  return res;
+}
+
+/**
+ * nle_interval_tree_next_start:
+ *
+ * Returns: The smallest start strictly after @timestamp or
+ * #GST_CLOCK_TIME_NONE.
+ */
+GstClockTime
+nle_interval_tree_next_start (NleIntervalTree * tree, GstClockTime timestamp)
+{
+  Node *res;
+  Query query = { 0, };
+
+  query.after = timestamp;
+  query.has_after = TRUE;
+  query.before = GST_CLOCK_TIME_NONE;
+
+  res = node_first_start_in (tree->root, &query);
+
+  return res ? res->start : GST_CLOCK_TIME_NONE;
+}
+
+/**
+ * nle_interval_tree_previous_stop:
+ *
+ * Returns: The biggest stop strictly before @timestamp or
+ * #GST_CLOCK_TIME_NONE.
+ */
+GstClockTime
+nle_interval_tree_previous_stop (NleIntervalTree * tree,
+    GstClockTime timestamp)
+{
+  Node *best = NULL;
+  Query query = { 0, };
+
+  query.before = timestamp;
+  node_last_stop_in (tree->root, &query, &best);
+
+  return best ? best->stop : GST_CLOCK_TIME_NONE;
+}
+
+/**
+ * nle_interval_tree_first_start_in:
+ * @priority: Only intervals with a priority strictly smaller than that
+ * are considered.
+ *
+ * Returns: The smallest start in ]@after, @before[ of the intervals accepted
+ * by @filter, or #GST_CLOCK_TIME_NONE.
+ */
+GstClockTime
+nle_interval_tree_first_start_in (NleIntervalTree * tree, GstClockTime after,
+    GstClockTime before, guint32 priority, NleIntervalTreeFilterFunc filter,
+    gpointer udata)
+{
+  Node *res;
+  Query query = { 0, };
+
+  query.after = after;
+  query.has_after = TRUE;
+  query.before = before;
+  query.priority = priority;
+  query.check_priority = TRUE;
+  query.filter = filter;
+  query.udata = udata;
+
+  res = node_first_start_in (tree->root, &query);
+
+  return res ? res->start : GST_CLOCK_TIME_NONE;
+}
+
+/**
+ * nle_interval_tree_last_stop_in:
+ * @priority: Only intervals with a priority strictly smaller than that
+ * are considered.
+ *
+ * Returns: The biggest stop in ]@after, @before[ of the intervals accepted
+ * by @filter, or #GST_CLOCK_TIME_NONE.
+ */
+GstClockTime
+nle_interval_tree_last_stop_in (NleIntervalTree * tree, GstClockTime after,
+    GstClockTime before, guint32 priority, NleIntervalTreeFilterFunc filter,
+    gpointer udata)
+{
+  Node *best = NULL;
+  Query query = { 0, };
+
+  query.after = after;
+  query.has_after = TRUE;
+  query.before = before;
+  query.priority = priority;
+  query.check_priority = TRUE;
+  query.filter = filter;
+  query.udata = udata;
+
+  node_last_stop_in (tree->root, &query, &best);
+
+  return best ? best->stop : GST_CLOCK_TIME_NONE;
+}
@@ -0,0 +1,74 @@
+/* GStreamer
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * nleintervaltree.h: Header for the objects interval index
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __NLE_INTERVAL_TREE_H__
+#define __NLE_INTERVAL_TREE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _NleIntervalTree NleIntervalTree;
+
+/**
+ * NleIntervalTreeFilterFunc:
+ * @data: The data of an interval matching the query
+ * @udata: The user data passed to the query
+ *
+ * Returns: %TRUE if @data should be part of the result of the query.
+ */
+typedef gboolean (*NleIntervalTreeFilterFunc) (gpointer data, gpointer udata);
+
+NleIntervalTree *nle_interval_tree_new (void) G_GNUC_INTERNAL;
+void nle_interval_tree_free (NleIntervalTree * tree) G_GNUC_INTERNAL;
+
+guint nle_interval_tree_size (NleIntervalTree * tree) G_GNUC_INTERNAL;
+gboolean nle_interval_tree_contains (NleIntervalTree * tree,
+    gpointer data) G_GNUC_INTERNAL;
+gboolean nle_interval_tree_lookup (NleIntervalTree * tree, gpointer data,
+    GstClockTime * start, GstClockTime * stop) G_GNUC_INTERNAL;
+
+void nle_interval_tree_insert (NleIntervalTree * tree, gpointer data,
+    GstClockTime start, GstClockTime stop, guint32 priority) G_GNUC_INTERNAL;
+gboolean nle_interval_tree_remove (NleIntervalTree * tree,
+    gpointer data) G_GNUC_INTERNAL;
+gboolean nle_interval_tree_update (NleIntervalTree * tree, gpointer data,
+    GstClockTime start, GstClockTime stop, guint32 priority) G_GNUC_INTERNAL;
+
+GList *nle_interval_tree_stab (NleIntervalTree * tree,
+    GstClockTime timestamp, gboolean reverse, guint32 priority,
+    NleIntervalTreeFilterFunc filter, gpointer udata) G_GNUC_INTERNAL;
+
+GstClockTime nle_interval_tree_next_start (NleIntervalTree * tree,
+    GstClockTime timestamp) G_GNUC_INTERNAL;
+GstClockTime nle_interval_tree_previous_stop (NleIntervalTree * tree,
+    GstClockTime timestamp) G_GNUC_INTERNAL;
+
+GstClockTime nle_interval_tree_first_start_in (NleIntervalTree * tree,
+    GstClockTime after, GstClockTime before, guint32 priority,
+    NleIntervalTreeFilterFunc filter, gpointer udata) G_GNUC_INTERNAL;
+GstClockTime nle_interval_tree_last_stop_in (NleIntervalTree * tree,
+    GstClockTime after, GstClockTime before, guint32 priority,
+    NleIntervalTreeFilterFunc filter, gpointer udata) G_GNUC_INTERNAL;
+
+G_END_DECLS
+
+#endif /* __NLE_INTERVAL_TREE_H__ */
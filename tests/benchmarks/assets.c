@@ -0,0 +1,80 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2026> agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Requests already cached assets from an increasing number of threads */
+
+#include <ges/ges.h>
+
+#define NUM_REQUESTS 100000
+#define MAX_THREADS 8
+
+static GPtrArray *ids;
+
+static gpointer
+request_assets (gpointer udata)
+{
+  guint i;
+
+  for (i = 0; i < NUM_REQUESTS; i++) {
+    GESAsset *asset = ges_asset_request (GES_TYPE_TRANSITION_CLIP,
+        g_ptr_array_index (ids, i % ids->len), NULL);
+
+    g_assert (asset);
+    gst_object_unref (asset);
+  }
+
+  return NULL;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GList *assets, *tmp;
+  guint i, n_threads;
+  GThread *threads[MAX_THREADS];
+  GstClockTime start, end;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  /* The standard transitions are all in the cache after ges_init() */
+  ids = g_ptr_array_new_with_free_func (g_free);
+  assets = ges_list_assets (GES_TYPE_TRANSITION_CLIP);
+  for (tmp = assets; tmp; tmp = tmp->next)
+    g_ptr_array_add (ids, g_strdup (ges_asset_get_id (tmp->data)));
+  g_list_free (assets);
+
+  for (n_threads = 1; n_threads <= MAX_THREADS; n_threads *= 2) {
+    start = gst_util_get_timestamp ();
+    for (i = 0; i < n_threads; i++)
+      threads[i] = g_thread_new ("request", request_assets, NULL);
+    for (i = 0; i < n_threads; i++)
+      g_thread_join (threads[i]);
+    end = gst_util_get_timestamp ();
+
+    g_print ("%" GST_TIME_FORMAT " - %d requests of %d assets in %d threads\n",
+        GST_TIME_ARGS (end - start), NUM_REQUESTS * n_threads, ids->len,
+        n_threads);
+  }
+
+  g_ptr_array_unref (ids);
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2026> agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Compares the NleComposition stack lookup using the objects interval tree
+ * with the sorted list walk it replaced */
+
+#include <gst/gst.h>
+#include "nleintervaltree.h"
+
+#define NUM_OBJECTS 20000
+#define NUM_LAYERS 4
+#define NUM_LOOKUPS 1000
+
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime stop;
+  guint32 priority;
+} Object;
+
+static gint
+start_compare (Object * a, Object * b)
+{
+  if (a->start == b->start)
+    return a->priority < b->priority ? -1 : a->priority > b->priority;
+
+  return a->start < b->start ? -1 : 1;
+}
+
+static gint
+priority_compare (Object * a, Object * b)
+{
+  return a->priority < b->priority ? -1 : a->priority > b->priority;
+}
+
+static GList *
+list_stack (GList * objects_start, GstClockTime timestamp)
+{
+  GList *tmp, *stack = NULL;
+
+  for (tmp = objects_start; tmp; tmp = tmp->next) {
+    Object *object = tmp->data;
+
+    if (object->start > timestamp)
+      break;
+
+    if (object->stop > timestamp)
+      stack = g_list_insert_sorted (stack, object,
+          (GCompareFunc) priority_compare);
+  }
+
+  return stack;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  Object *objects;
+  GList *objects_start = NULL, *stack;
+  NleIntervalTree *tree;
+  GstClockTime start, end, duration, list_time = 0, tree_time = 0;
+
+  gst_init (&argc, &argv);
+
+  objects = g_new0 (Object, NUM_OBJECTS);
+  tree = nle_interval_tree_new ();
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_OBJECTS; i++) {
+    guint layer = i % NUM_LAYERS;
+
+    objects[i].priority = layer;
+    objects[i].start = (i / NUM_LAYERS) * GST_SECOND + layer * GST_MSECOND;
+    objects[i].stop = objects[i].start + GST_SECOND;
+    objects_start = g_list_prepend (objects_start, &objects[i]);
+  }
+  objects_start = g_list_sort (objects_start, (GCompareFunc) start_compare);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - building sorted list of %d objects\n",
+      GST_TIME_ARGS (end - start), NUM_OBJECTS);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_OBJECTS; i++)
+    nle_interval_tree_insert (tree, &objects[i], objects[i].start,
+        objects[i].stop, objects[i].priority);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - building interval tree of %d objects\n",
+      GST_TIME_ARGS (end - start), NUM_OBJECTS);
+
+  duration = (NUM_OBJECTS / NUM_LAYERS) * GST_SECOND;
+  for (i = 0; i < NUM_LOOKUPS; i++) {
+    /* Look at stacks in the last quarter of the composition */
+    GstClockTime timestamp = duration - (duration / 4) * i / NUM_LOOKUPS;
+    guint list_len, tree_len;
+
+    start = gst_util_get_timestamp ();
+    stack = list_stack (objects_start, timestamp);
+    end = gst_util_get_timestamp ();
+    list_time += end - start;
+    list_len = g_list_length (stack);
+    g_list_free (stack);
+
+    start = gst_util_get_timestamp ();
+    stack = nle_interval_tree_stab (tree, timestamp, FALSE, 0, NULL, NULL);
+    nle_interval_tree_next_start (tree, timestamp);
+    end = gst_util_get_timestamp ();
+    tree_time += end - start;
+    tree_len = g_list_length (stack);
+    g_list_free (stack);
+
+    g_assert_cmpint (list_len, ==, tree_len);
+  }
+
+  g_print ("%" GST_TIME_FORMAT " - %d stack lookups walking the list\n",
+      GST_TIME_ARGS (list_time), NUM_LOOKUPS);
+  g_print ("%" GST_TIME_FORMAT " - %d stack lookups in the interval tree\n",
+      GST_TIME_ARGS (tree_time), NUM_LOOKUPS);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_OBJECTS; i++)
+    nle_interval_tree_update (tree, &objects[i], objects[i].start + 1,
+        objects[i].stop + 1, objects[i].priority);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - moving %d objects in the interval tree\n",
+      GST_TIME_ARGS (end - start), NUM_OBJECTS);
+
+  nle_interval_tree_free (tree);
+  g_list_free (objects_start);
+  g_free (objects);
+
+  return 0;
+}
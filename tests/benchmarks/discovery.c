@@ -0,0 +1,202 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2026> agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Loads a project referencing NUM_FILES links to the same media file with
+ * different numbers of discoverers (set through GES_DISCOVERERS).
+ *
+ * Usage: discovery /path/to/a/media/file
+ */
+
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <ges/ges.h>
+
+#define NUM_FILES 1000
+
+static void
+project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GMainLoop * ml)
+{
+  g_main_loop_quit (ml);
+}
+
+static void
+error_loading_asset_cb (GESProject * project, GError * error, gchar * id,
+    GType extractable_type, guint * n_errors)
+{
+  *n_errors += 1;
+}
+
+/* Runs in the child processes */
+static gint
+load_project (const gchar * uri)
+{
+  GMainLoop *ml;
+  GESProject *project;
+  GESTimeline *timeline;
+  GstClockTime start, end;
+  guint n_errors = 0;
+
+  ml = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", G_CALLBACK (project_loaded_cb), ml);
+  g_signal_connect (project, "error-loading-asset",
+      G_CALLBACK (error_loading_asset_cb), &n_errors);
+
+  start = gst_util_get_timestamp ();
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (ml);
+  end = gst_util_get_timestamp ();
+
+  g_print ("%" GST_TIME_FORMAT " - loading %d files with %s discoverers"
+      " (%d errors)\n", GST_TIME_ARGS (end - start), NUM_FILES,
+      g_getenv ("GES_DISCOVERERS"), n_errors);
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (ml);
+
+  return 0;
+}
+
+static gchar *
+generate_project (const gchar * media, const gchar * dir)
+{
+  guint i;
+  gchar *path, *uri;
+  GString *xges = g_string_new ("<ges version='0.3'>\n  <project>\n"
+      "    <ressources>\n");
+
+  for (i = 0; i < NUM_FILES; i++) {
+    gchar *name = g_strdup_printf ("media-%04d", i);
+    GFile *link;
+
+    path = g_build_filename (dir, name, NULL);
+    link = g_file_new_for_path (path);
+    if (!g_file_make_symbolic_link (link, media, NULL, NULL))
+      g_error ("Could not create %s", path);
+    g_object_unref (link);
+
+    uri = gst_filename_to_uri (path, NULL);
+    g_string_append_printf (xges, "      <asset id='%s' "
+        "extractable-type-name='GESUriClip' />\n", uri);
+
+    g_free (uri);
+    g_free (path);
+    g_free (name);
+  }
+  g_string_append (xges, "    </ressources>\n    <timeline>\n"
+      "      <track caps='audio/x-raw' track-type='2' track-id='0' />\n"
+      "      <track caps='video/x-raw' track-type='4' track-id='1' />\n"
+      "    </timeline>\n  </project>\n</ges>\n");
+
+  path = g_build_filename (dir, "project.xges", NULL);
+  if (!g_file_set_contents (path, xges->str, -1, NULL))
+    g_error ("Could not write %s", path);
+
+  uri = gst_filename_to_uri (path, NULL);
+  g_free (path);
+  g_string_free (xges, TRUE);
+
+  return uri;
+}
+
+static void
+remove_files (const gchar * dir)
+{
+  guint i;
+  gchar *path;
+
+  for (i = 0; i < NUM_FILES; i++) {
+    gchar *name = g_strdup_printf ("media-%04d", i);
+
+    path = g_build_filename (dir, name, NULL);
+    g_unlink (path);
+    g_free (path);
+    g_free (name);
+  }
+
+  path = g_build_filename (dir, "project.xges", NULL);
+  g_unlink (path);
+  g_free (path);
+  g_rmdir (dir);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+  gchar *dir, *media, *uri;
+  guint n_discoverers[] = { 1, 2, 4, 8, 0 };
+
+  gst_init (&argc, &argv);
+
+  if (argc == 3 && g_strcmp0 (argv[1], "--load") == 0) {
+    ges_init ();
+
+    return load_project (argv[2]);
+  }
+
+  if (argc != 2) {
+    g_printerr ("Usage: %s /path/to/a/media/file\n", argv[0]);
+
+    return 1;
+  }
+
+  dir = g_dir_make_tmp ("ges-discovery-XXXXXX", NULL);
+  if (!dir)
+    g_error ("Could not create a temporary directory");
+
+  if (g_path_is_absolute (argv[1])) {
+    media = g_strdup (argv[1]);
+  } else {
+    gchar *cwd = g_get_current_dir ();
+
+    media = g_build_filename (cwd, argv[1], NULL);
+    g_free (cwd);
+  }
+  uri = generate_project (media, dir);
+
+  n_discoverers[G_N_ELEMENTS (n_discoverers) - 1] = g_get_num_processors ();
+  for (i = 0; i < G_N_ELEMENTS (n_discoverers); i++) {
+    gchar *n = g_strdup_printf ("%u", n_discoverers[i]);
+    gchar **envp = g_environ_setenv (g_get_environ (), "GES_DISCOVERERS", n,
+        TRUE);
+    gchar *child_argv[] = { argv[0], (gchar *) "--load", uri, NULL };
+    GError *err = NULL;
+
+    /* The discoverers are created once per process */
+    if (!g_spawn_sync (NULL, child_argv, envp, G_SPAWN_CHILD_INHERITS_STDIN,
+            NULL, NULL, NULL, NULL, NULL, &err)) {
+      g_printerr ("Could not run the benchmark: %s\n", err->message);
+      g_error_free (err);
+    }
+
+    g_strfreev (envp);
+    g_free (n);
+  }
+
+  remove_files (dir);
+  g_free (uri);
+  g_free (media);
+  g_free (dir);
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2026> agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Composites NUM_LAYERS layered uri sources of a 1080p media file and reports
+ * the CPU time spent per output frame, with opaque and translucent layers,
+ * for the compositor converting its inputs itself and with a videoconvert in
+ * front of each of its pads as the smart mixer used to do.
+ *
+ * Usage: mixing /path/to/a/1080p/media/file
+ */
+
+#include <time.h>
+#include <ges/ges.h>
+
+#define NUM_LAYERS 8
+#define NUM_FRAMES 150
+
+static void
+handoff_cb (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    guint * n_frames)
+{
+  *n_frames += 1;
+}
+
+static void
+run (GESAsset * asset, gdouble alpha, const gchar * desc)
+{
+  guint i, n_frames = 0;
+  clock_t cpu_start;
+  GstBus *bus;
+  GstCaps *caps;
+  GstMessage *message;
+  GstElement *sink;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string ("video/x-raw,width=1920,height=1080,"
+      "framerate=30/1");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, track);
+  for (i = 0; i < NUM_LAYERS; i++) {
+    GESClip *clip = ges_layer_add_asset (ges_timeline_append_layer (timeline),
+        asset, 0, 0, NUM_FRAMES * GST_SECOND / 30, GES_TRACK_TYPE_VIDEO);
+
+    ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT (clip),
+        "alpha", alpha, "posx", (gint) i * 40, "posy", (gint) i * 20, NULL);
+  }
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_set_timeline (pipeline, timeline);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_cb), &n_frames);
+  g_object_set (pipeline, "video-sink", sink, NULL);
+  ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_PREVIEW_VIDEO);
+
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  cpu_start = clock ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    g_error ("Error while compositing");
+
+  g_print ("%d layers with alpha %.1f, %s: %.2fms of CPU per frame\n",
+      NUM_LAYERS, alpha, desc, (gdouble) (clock () - cpu_start) * 1000 /
+      CLOCKS_PER_SEC / MAX (n_frames, 1));
+
+  gst_message_unref (message);
+  gst_object_unref (bus);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gchar *uri;
+  GESUriClipAsset *asset;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc != 2) {
+    g_printerr ("Usage: %s /path/to/a/1080p/media/file\n", argv[0]);
+    return 1;
+  }
+
+  uri = gst_filename_to_uri (argv[1], NULL);
+  asset = ges_uri_clip_asset_request_sync (uri, NULL);
+  g_free (uri);
+  if (!asset)
+    g_error ("Could not discover %s", argv[1]);
+
+  run (GES_ASSET (asset), 1.0, "compositor conversion");
+  run (GES_ASSET (asset), 0.5, "compositor conversion");
+
+  /* Checked by the smart mixer each time one of its pads is requested */
+  g_setenv ("GES_SMART_MIXER_CONVERT_PADS", "1", TRUE);
+  run (GES_ASSET (asset), 1.0, "videoconvert per pad");
+  run (GES_ASSET (asset), 0.5, "videoconvert per pad");
+
+  gst_object_unref (asset);
+
+  return 0;
+}
@@ -21,22 +21,70 @@
 #include <ges/ges.h>
 
 
-#define NUM_OBJECTS 1000
+#define NUM_EDITS 500
+#define NUM_RIPPLED_CLIPS 20000
+#define NUM_RIPPLES 100
 
-gint
-main (gint argc, gchar * argv[])
+static void
+edit_container (GESContainer * container, const gchar * what)
+{
+  guint i;
+  GstClockTime start, start_ripple, end, end_ripple, max_rippling_time = 0,
+      min_rippling_time = GST_CLOCK_TIME_NONE;
+
+  start_ripple = gst_util_get_timestamp ();
+  for (i = 1; i < NUM_EDITS + 1; i++) {
+    start = gst_util_get_timestamp ();
+    ges_container_edit (container, NULL, 0, GES_EDIT_MODE_NORMAL,
+        GES_EDGE_NONE, i * 1000);
+    end = gst_util_get_timestamp ();
+    max_rippling_time = MAX (max_rippling_time, end - start);
+    min_rippling_time = MIN (min_rippling_time, end - start);
+  }
+  end_ripple = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - rippling %d times, max: %"
+      GST_TIME_FORMAT " min: %" GST_TIME_FORMAT "%s\n",
+      GST_TIME_ARGS (end_ripple - start_ripple), i - 1,
+      GST_TIME_ARGS (max_rippling_time), GST_TIME_ARGS (min_rippling_time),
+      what);
+}
+
+static void
+shift_clips (GESTimeline * timeline, GESLayer * layer, gboolean transaction)
+{
+  GList *clips, *tmp;
+  GstClockTime start, end;
+
+  /* Move from the last clip so that we never overlap its follower */
+  clips = g_list_reverse (ges_layer_get_clips (layer));
+
+  start = gst_util_get_timestamp ();
+  if (transaction)
+    ges_timeline_begin_edit (timeline);
+  for (tmp = clips; tmp; tmp = tmp->next)
+    ges_timeline_element_set_start (tmp->data,
+        GES_TIMELINE_ELEMENT_START (tmp->data) + 500);
+  if (transaction)
+    ges_timeline_end_edit (timeline);
+  end = gst_util_get_timestamp ();
+
+  g_print ("%" GST_TIME_FORMAT " - shifting %d clips%s\n",
+      GST_TIME_ARGS (end - start), g_list_length (clips),
+      transaction ? " (in one edit transaction)" : "");
+
+  g_list_free_full (clips, gst_object_unref);
+}
+
+static void
+run_benchmark (GESAsset * asset, guint num_objects)
 {
   guint i;
-  GESAsset *asset;
   GESTimeline *timeline;
   GESLayer *layer;
   GESContainer *container;
-  GstClockTime start, start_ripple, end, end_ripple, max_rippling_time = 0,
-      min_rippling_time = GST_CLOCK_TIME_NONE;
+  GstClockTime start, end;
 
-  gst_init (&argc, &argv);
-  ges_init ();
-  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  g_print ("\n== %d clips ==\n", num_objects);
 
   layer = ges_layer_new ();
   timeline = ges_timeline_new_audio_video ();
@@ -46,52 +94,88 @@ main (gint argc, gchar * argv[])
   container = GES_CONTAINER (ges_layer_add_asset (layer, asset, 0,
           0, 1000, GES_TRACK_TYPE_UNKNOWN));
 
-  for (i = 1; i < NUM_OBJECTS; i++)
+  for (i = 1; i < num_objects; i++)
     ges_layer_add_asset (layer, asset, i * 1000, 0,
         1000, GES_TRACK_TYPE_UNKNOWN);
   end = gst_util_get_timestamp ();
   g_print ("%" GST_TIME_FORMAT " - adding %d clip to the timeline\n",
       GST_TIME_ARGS (end - start), i);
 
-  start_ripple = gst_util_get_timestamp ();
-  for (i = 1; i < 501; i++) {
-    start = gst_util_get_timestamp ();
-    ges_container_edit (container, NULL, 0, GES_EDIT_MODE_NORMAL,
-        GES_EDGE_NONE, i * 1000);
-    end = gst_util_get_timestamp ();
-    max_rippling_time = MAX (max_rippling_time, end - start);
-    min_rippling_time = MIN (min_rippling_time, end - start);
-  }
-  end_ripple = gst_util_get_timestamp ();
-  g_print ("%" GST_TIME_FORMAT " - rippling %d times, max: %"
-      GST_TIME_FORMAT " min: %" GST_TIME_FORMAT "\n",
-      GST_TIME_ARGS (end_ripple - start_ripple), i - 1,
-      GST_TIME_ARGS (max_rippling_time), GST_TIME_ARGS (min_rippling_time));
+  edit_container (container, "");
+
+  /* Each single move reindexes the timeline, only do it on small timelines */
+  if (num_objects <= 10000)
+    shift_clips (timeline, layer, FALSE);
+  shift_clips (timeline, layer, TRUE);
 
+  /* Every edit now goes through the snapping edges lookup */
+  ges_timeline_set_snapping_distance (timeline, 100);
+  edit_container (container, " (with snapping on)");
+  ges_timeline_set_snapping_distance (timeline, 0);
 
-  min_rippling_time = GST_CLOCK_TIME_NONE;
-  max_rippling_time = 0;
   ges_layer_set_auto_transition (layer, TRUE);
-  start_ripple = gst_util_get_timestamp ();
-  for (i = 1; i < 501; i++) {
-    start = gst_util_get_timestamp ();
-    ges_container_edit (container, NULL, 0, GES_EDIT_MODE_NORMAL,
+  edit_container (container, " (with auto-transition on)");
+
+  start = gst_util_get_timestamp ();
+  gst_object_unref (timeline);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
+      GST_TIME_ARGS (end - start));
+}
+
+static void
+ripple_first_clip (GESAsset * asset)
+{
+  guint i;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESContainer *container;
+  GstClockTime start, end, max_rippling_time = 0,
+      min_rippling_time = GST_CLOCK_TIME_NONE;
+
+  g_print ("\n== Rippling the first of %d clips ==\n", NUM_RIPPLED_CLIPS);
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  container = GES_CONTAINER (ges_layer_add_asset (layer, asset, 0,
+          0, 1000, GES_TRACK_TYPE_UNKNOWN));
+  for (i = 1; i < NUM_RIPPLED_CLIPS; i++)
+    ges_layer_add_asset (layer, asset, i * 1000, 0,
+        1000, GES_TRACK_TYPE_UNKNOWN);
+
+  start = gst_util_get_timestamp ();
+  for (i = 1; i < NUM_RIPPLES + 1; i++) {
+    GstClockTime edit_start = gst_util_get_timestamp ();
+
+    ges_container_edit (container, NULL, -1, GES_EDIT_MODE_RIPPLE,
         GES_EDGE_NONE, i * 1000);
     end = gst_util_get_timestamp ();
-    max_rippling_time = MAX (max_rippling_time, end - start);
-    min_rippling_time = MIN (min_rippling_time, end - start);
+    max_rippling_time = MAX (max_rippling_time, end - edit_start);
+    min_rippling_time = MIN (min_rippling_time, end - edit_start);
   }
-  end_ripple = gst_util_get_timestamp ();
   g_print ("%" GST_TIME_FORMAT " - rippling %d times, max: %"
-      GST_TIME_FORMAT " min: %" GST_TIME_FORMAT " (with auto-transition on)\n",
-      GST_TIME_ARGS (end_ripple - start_ripple), i - 1,
+      GST_TIME_FORMAT " min: %" GST_TIME_FORMAT "\n",
+      GST_TIME_ARGS (end - start), NUM_RIPPLES,
       GST_TIME_ARGS (max_rippling_time), GST_TIME_ARGS (min_rippling_time));
 
-  start = gst_util_get_timestamp ();
   gst_object_unref (timeline);
-  end = gst_util_get_timestamp ();
-  g_print ("%" GST_TIME_FORMAT " - freeing the timeline\n",
-      GST_TIME_ARGS (end - start));
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GESAsset *asset;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  run_benchmark (asset, 1000);
+  run_benchmark (asset, 10000);
+  run_benchmark (asset, 100000);
+  ripple_first_clip (asset);
+
+  gst_object_unref (asset);
 
   return 0;
 }
@@ -0,0 +1,195 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2026> agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Renders a transition between two 1080p sources and reports the CPU time
+ * spent per output frame, for natively blended and smptealpha based
+ * transitions. The cost of the blending itself is then measured on its own,
+ * against the sources alone, for the blender and for the smptealpha and
+ * compositor chain it replaces. */
+
+#include <time.h>
+#include <ges/ges.h>
+
+#define NUM_FRAMES 150
+
+#define BLEND_SOURCE "videotestsrc num-buffers=%d pattern=%s ! " \
+    "video/x-raw,format=I420,width=1920,height=1080,framerate=30/1"
+#define SMPTE_INPUT " ! videoconvert ! video/x-raw,format=BGRA ! " \
+    "smptealpha type=bar-wipe-lr position=%f ! m."
+
+static void
+handoff_cb (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    guint * n_frames)
+{
+  *n_frames += 1;
+}
+
+static void
+run (GESVideoStandardTransitionType type, const gchar * name)
+{
+  GList *tmp, *clips;
+  guint n_frames = 0;
+  clock_t cpu_start;
+  GstBus *bus;
+  GstCaps *caps;
+  GstMessage *message;
+  GstElement *sink;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string ("video/x-raw,width=1920,height=1080,"
+      "framerate=30/1");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, track);
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  /* The transition covers all but the first frame */
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, NUM_FRAMES * GST_SECOND / 30,
+      GES_TRACK_TYPE_VIDEO);
+  ges_layer_add_asset (layer, asset, GST_SECOND / 30, 0,
+      NUM_FRAMES * GST_SECOND / 30, GES_TRACK_TYPE_VIDEO);
+  gst_object_unref (asset);
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data))
+      g_object_set (tmp->data, "vtype", type, NULL);
+  }
+  g_list_free_full (clips, gst_object_unref);
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_set_timeline (pipeline, timeline);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_cb), &n_frames);
+  g_object_set (pipeline, "video-sink", sink, NULL);
+  ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_PREVIEW_VIDEO);
+
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  cpu_start = clock ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    g_error ("Error while rendering the transition");
+
+  g_print ("%s: %.2fms of CPU per frame\n", name,
+      (gdouble) (clock () - cpu_start) * 1000 / CLOCKS_PER_SEC /
+      MAX (n_frames, 1));
+
+  gst_message_unref (message);
+  gst_object_unref (bus);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+/* CPU time spent running @description until EOS, in milliseconds */
+static gdouble
+run_description (const gchar * description)
+{
+  clock_t cpu_start;
+  GstBus *bus;
+  GstMessage *message;
+  GstElement *pipeline;
+  GError *error = NULL;
+
+  pipeline = gst_parse_launch (description, &error);
+  if (!pipeline)
+    g_error ("Could not create pipeline: %s", error->message);
+
+  bus = gst_element_get_bus (pipeline);
+  cpu_start = clock ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    g_error ("Error while running %s", description);
+
+  gst_message_unref (message);
+  gst_object_unref (bus);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return (gdouble) (clock () - cpu_start) * 1000 / CLOCKS_PER_SEC;
+}
+
+/* Crossfades go through smptealpha too, as a noop, and the crossfade-ratio
+ * of the compositor pads */
+static void
+run_blend (const gchar * nick, gdouble smpte_position,
+    const gchar * compositor_properties)
+{
+  gchar *description;
+  gdouble sources, blender, smpte;
+
+  description = g_strdup_printf (BLEND_SOURCE " ! fakesink sync=false "
+      BLEND_SOURCE " ! fakesink sync=false", NUM_FRAMES, "black",
+      NUM_FRAMES, "white");
+  sources = run_description (description);
+  g_free (description);
+
+  description = g_strdup_printf ("gesvideoblender name=m transition-type=%s "
+      "position=0.5 ! fakesink sync=false " BLEND_SOURCE " ! m. "
+      BLEND_SOURCE " ! m.", nick, NUM_FRAMES, "black", NUM_FRAMES, "white");
+  blender = run_description (description);
+  g_free (description);
+
+  /* Same chain as GESVideoTransition uses for the types the blender does
+   * not handle */
+  description = g_strdup_printf ("compositor name=m background=3 %s ! "
+      "videoconvert ! video/x-raw,format=I420 ! fakesink sync=false "
+      BLEND_SOURCE SMPTE_INPUT " " BLEND_SOURCE SMPTE_INPUT,
+      compositor_properties, NUM_FRAMES, "black", smpte_position,
+      NUM_FRAMES, "white", smpte_position);
+  smpte = run_description (description);
+  g_free (description);
+
+  g_print ("%s blending: %.2fms per frame with the blender, %.2fms with "
+      "smptealpha\n", nick, MAX (blender - sources, 0) / NUM_FRAMES,
+      MAX (smpte - sources, 0) / NUM_FRAMES);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  run (GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE, "crossfade");
+  run (GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR, "bar-wipe-lr");
+  run (GES_VIDEO_STANDARD_TRANSITION_TYPE_IRIS_RECT, "iris-rect (smptealpha)");
+
+  run_blend ("crossfade", 0.0, "sink_0::crossfade-ratio=0.5");
+  run_blend ("bar-wipe-lr", 0.5, "");
+
+  return 0;
+}
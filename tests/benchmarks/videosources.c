@@ -0,0 +1,142 @@
+/* Gstreamer Editing Services
+ *
+ * Copyright (C) <2026> agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Composites NUM_LAYERS layers of the same media file and reports the
+ * preroll latency and the CPU time spent per video source, with the track
+ * restriction caps matching the media (lean source chains) and forcing a
+ * different size and framerate (full conversion chains).
+ *
+ * Usage: videosources /path/to/a/media/file
+ */
+
+#include <time.h>
+#include <ges/ges.h>
+
+#define NUM_LAYERS 10
+
+static void
+run (GESAsset * asset, const gchar * restriction, const gchar * desc)
+{
+  guint i;
+  clock_t cpu_start;
+  GstBus *bus;
+  GstMessage *message;
+  GstCaps *caps;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GstClockTime start, prerolled, end;
+
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string (restriction);
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+
+  timeline = ges_timeline_new ();
+  ges_timeline_add_track (timeline, track);
+  for (i = 0; i < NUM_LAYERS; i++)
+    ges_layer_add_asset (ges_timeline_append_layer (timeline), asset, 0, 0,
+        GST_CLOCK_TIME_NONE, GES_TRACK_TYPE_VIDEO);
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_pipeline_new ();
+  ges_pipeline_set_timeline (pipeline, timeline);
+  g_object_set (pipeline, "video-sink",
+      gst_parse_bin_from_description ("fakesink sync=false", TRUE, NULL),
+      NULL);
+  ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_PREVIEW_VIDEO);
+
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  cpu_start = clock ();
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED);
+  gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+      GST_CLOCK_TIME_NONE);
+  prerolled = gst_util_get_timestamp ();
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  end = gst_util_get_timestamp ();
+
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    g_error ("Error while playing with %s", restriction);
+
+  g_print ("%s: preroll %" GST_TIME_FORMAT " - playback %" GST_TIME_FORMAT
+      " - %.2fms of CPU per source\n", desc, GST_TIME_ARGS (prerolled - start),
+      GST_TIME_ARGS (end - prerolled),
+      (gdouble) (clock () - cpu_start) * 1000 / CLOCKS_PER_SEC / NUM_LAYERS);
+
+  gst_message_unref (message);
+  gst_object_unref (bus);
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gchar *uri, *restriction;
+  GESUriClipAsset *asset;
+  GstDiscovererVideoInfo *info;
+  const GList *streams;
+
+  gst_init (&argc, &argv);
+  ges_init ();
+
+  if (argc != 2) {
+    g_printerr ("Usage: %s /path/to/a/media/file\n", argv[0]);
+    return 1;
+  }
+
+  uri = gst_filename_to_uri (argv[1], NULL);
+  asset = ges_uri_clip_asset_request_sync (uri, NULL);
+  g_free (uri);
+  if (!asset)
+    g_error ("Could not discover %s", argv[1]);
+
+  streams = ges_uri_clip_asset_get_stream_assets (asset);
+  for (; streams; streams = streams->next) {
+    GstDiscovererStreamInfo *sinfo =
+        ges_uri_source_asset_get_stream_info (streams->data);
+
+    if (GST_IS_DISCOVERER_VIDEO_INFO (sinfo))
+      break;
+  }
+  if (!streams)
+    g_error ("%s has no video stream", argv[1]);
+
+  info = GST_DISCOVERER_VIDEO_INFO (ges_uri_source_asset_get_stream_info
+      (streams->data));
+  restriction = g_strdup_printf ("video/x-raw,width=%d,height=%d,"
+      "framerate=%d/%d", gst_discoverer_video_info_get_width (info),
+      gst_discoverer_video_info_get_height (info),
+      gst_discoverer_video_info_get_framerate_num (info),
+      gst_discoverer_video_info_get_framerate_denom (info));
+
+  run (GES_ASSET (asset), restriction, "matching restriction caps");
+  run (GES_ASSET (asset), "video/x-raw,width=320,height=240,framerate=5/1",
+      "converting restriction caps");
+
+  g_free (restriction);
+  gst_object_unref (asset);
+
+  return 0;
+}
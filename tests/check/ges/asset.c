@@ -23,6 +23,7 @@
 #include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 static GMainLoop *mainloop;
 
@@ -197,6 +198,70 @@ GST_START_TEST (test_proxy_asset)
 
 GST_END_TEST;
 
+static void
+proxy_generated_cb (GESProxyGenerator * generator, GAsyncResult * res,
+    GESAsset ** proxy)
+{
+  GError *error = NULL;
+
+  *proxy = ges_proxy_generator_generate_finish (generator, res, &error);
+  fail_unless (*proxy, "Could not generate proxy: %s",
+      error ? error->message : "");
+
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_proxy_generator)
+{
+  GESAsset *asset, *proxy = NULL, *proxy1 = NULL;
+  GESProxyGenerator *generator;
+  gchar *uri = ges_test_file_uri ("audio_video.ogg");
+  gchar *dir = g_dir_make_tmp ("ges-proxies-XXXXXX", NULL);
+  gchar *location;
+
+  ges_init ();
+
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  fail_unless (asset);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  generator = ges_proxy_generator_new ();
+  g_object_set (generator, "output-directory", dir, "height", 32, NULL);
+
+  ges_proxy_generator_generate_async (generator, GES_URI_CLIP_ASSET (asset),
+      NULL, (GAsyncReadyCallback) proxy_generated_cb, &proxy);
+  g_main_loop_run (mainloop);
+
+  fail_unless (GES_IS_URI_CLIP_ASSET (proxy));
+  fail_unless (ges_asset_get_proxy (asset) == proxy);
+  fail_unless (ges_asset_get_proxy_target (proxy) == asset);
+  /* Proxies keep the timing of the original files */
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (GES_URI_CLIP_ASSET
+          (proxy)), ges_uri_clip_asset_get_duration (GES_URI_CLIP_ASSET
+          (asset)));
+
+  /* The proxy is reused */
+  ges_proxy_generator_generate_async (generator, GES_URI_CLIP_ASSET (asset),
+      NULL, (GAsyncReadyCallback) proxy_generated_cb, &proxy1);
+  g_main_loop_run (mainloop);
+  fail_unless (proxy1 == proxy);
+
+  location = g_filename_from_uri (ges_asset_get_id (proxy), NULL, NULL);
+  g_unlink (location);
+  g_rmdir (dir);
+
+  gst_object_unref (proxy1);
+  gst_object_unref (proxy);
+  gst_object_unref (asset);
+  gst_object_unref (generator);
+  g_main_loop_unref (mainloop);
+  g_free (location);
+  g_free (dir);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -216,6 +281,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_transition_change_asset);
   tcase_add_test (tc_chain, test_uri_clip_change_asset);
   tcase_add_test (tc_chain, test_proxy_asset);
+  tcase_add_test (tc_chain, test_proxy_generator);
 
   return s;
 }
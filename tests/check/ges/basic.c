@@ -23,6 +23,7 @@
 
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 
 GST_START_TEST (test_ges_scenario)
@@ -691,6 +692,146 @@ GST_START_TEST (test_ges_pipeline_change_state)
 
 GST_END_TEST;
 
+GST_START_TEST (test_ges_pipeline_switch_mode)
+{
+  GstState state;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new_audio_video ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  pipeline = ges_test_create_pipeline (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  ges_timeline_commit (timeline);
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  /* Toggling the previewed streams does not tear the pipeline down */
+  fail_unless (ges_pipeline_set_mode (pipeline,
+          GES_PIPELINE_MODE_PREVIEW_AUDIO));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_PAUSED);
+  fail_unless (ges_pipeline_get_mode (pipeline) ==
+      GES_PIPELINE_MODE_PREVIEW_AUDIO);
+
+  fail_unless (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_PREVIEW));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_PAUSED);
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static GstEncodingProfile *
+_create_raw_matroska_profile (void)
+{
+  GstCaps *caps;
+  GstEncodingContainerProfile *profile;
+
+  caps = gst_caps_new_empty_simple ("video/x-matroska");
+  profile = gst_encoding_container_profile_new ("mkv", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("video/x-raw");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("audio/x-raw");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_audio_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) profile;
+}
+
+GST_START_TEST (test_ges_pipeline_switch_to_render)
+{
+  GstState state;
+  gchar *path, *uri;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GstEncodingProfile *profile;
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new_audio_video ();
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  pipeline = ges_test_create_pipeline (timeline);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  path = g_build_filename (g_get_tmp_dir (), "ges-switch-to-render.mkv",
+      NULL);
+  uri = gst_filename_to_uri (path, NULL);
+  profile = _create_raw_matroska_profile ();
+  fail_unless (ges_pipeline_set_render_settings (pipeline, uri, profile));
+  gst_object_unref (profile);
+
+  ges_timeline_commit (timeline);
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  /* Starting an export from a running preview keeps the pipeline paused */
+  fail_unless (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_RENDER));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_PAUSED);
+  fail_unless (ges_pipeline_get_mode (pipeline) == GES_PIPELINE_MODE_RENDER);
+
+  fail_unless (ges_pipeline_set_mode (pipeline, GES_PIPELINE_MODE_PREVIEW));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_PAUSED);
+
+  /* Smart rendering goes through NULL, the pipeline has to be restarted */
+  fail_unless (ges_pipeline_set_mode (pipeline,
+          GES_PIPELINE_MODE_SMART_RENDER));
+  fail_unless (ges_pipeline_get_mode (pipeline) ==
+      GES_PIPELINE_MODE_SMART_RENDER);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_NULL);
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (pipeline);
+  g_unlink (path);
+  g_free (path);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_ges_timeline_element_name)
 {
   GESClip *clip, *clip1, *clip2, *clip3, *clip4, *clip5;
@@ -773,6 +914,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_ges_timeline_remove_track);
   tcase_add_test (tc_chain, test_ges_timeline_multiple_tracks);
   tcase_add_test (tc_chain, test_ges_pipeline_change_state);
+  tcase_add_test (tc_chain, test_ges_pipeline_switch_mode);
+  tcase_add_test (tc_chain, test_ges_pipeline_switch_to_render);
   tcase_add_test (tc_chain, test_ges_timeline_element_name);
 
   return s;
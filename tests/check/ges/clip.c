@@ -19,8 +19,10 @@
 
 #include "test-utils.h"
 #include "../../../ges/ges-structured-interface.h"
+#include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 GST_START_TEST (test_object_properties)
 {
@@ -677,6 +679,204 @@ GST_START_TEST (test_effects_priorities)
 
 GST_END_TEST;
 
+GST_START_TEST (test_timeline_copy)
+{
+  GList *layers, *clips, *effects;
+  GESClip *clip, *clip1, *copied;
+  GESTimeline *timeline, *copy;
+  GESLayer *layer;
+  GESTrackElement *effect;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", 10, "in-point", 5, "duration", 20, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  effect = GES_TRACK_ELEMENT (ges_effect_new ("agingtv"));
+  fail_unless (ges_container_add (GES_CONTAINER (clip),
+          GES_TIMELINE_ELEMENT (effect)));
+
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip1, "start", 30, "duration", 10, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip1));
+
+  copy = timeline_copy (timeline);
+  fail_unless_equals_int (g_list_length (copy->tracks), 2);
+  layers = ges_timeline_get_layers (copy);
+  fail_unless_equals_int (g_list_length (layers), 2);
+  fail_unless_equals_int (ges_layer_get_priority (layers->data), 0);
+  fail_unless (ges_layer_get_auto_transition (layers->data));
+  fail_unless_equals_int (ges_layer_get_priority (layers->next->data), 1);
+  fail_if (ges_layer_get_auto_transition (layers->next->data));
+
+  clips = ges_layer_get_clips (layers->data);
+  fail_unless_equals_int (g_list_length (clips), 2);
+  copied = clips->data;
+  fail_if (copied == clip);
+  fail_unless_equals_uint64 (_START (copied), 10);
+  fail_unless_equals_uint64 (_INPOINT (copied), 5);
+  fail_unless_equals_uint64 (_DURATION (copied), 20);
+  fail_unless_equals_int (g_list_length (GES_CONTAINER_CHILDREN (copied)), 3);
+  effects = ges_clip_get_top_effects (copied);
+  fail_unless_equals_int (g_list_length (effects), 1);
+  fail_if (effects->data == effect);
+  g_list_free_full (effects, gst_object_unref);
+  fail_unless_equals_uint64 (_START (clips->next->data), 30);
+  g_list_free_full (clips, gst_object_unref);
+  g_list_free_full (layers, gst_object_unref);
+
+  gst_object_unref (copy);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_timeline_copy_transitions)
+{
+  GList *layers, *clips, *tmp;
+  GESClip *clip, *clip1;
+  GESTimeline *timeline, *copy;
+  GESTransitionClip *transition = NULL;
+  GESLayer *layer;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", 0, "duration", 20, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip1, "start", 10, "duration", 20, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip1));
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data))
+      transition = tmp->data;
+  }
+  fail_unless (transition);
+  g_object_set (transition, "vtype",
+      GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR, NULL);
+  g_list_free_full (clips, gst_object_unref);
+
+  /* The copied transition is reused instead of a default one being added */
+  copy = timeline_copy (timeline);
+  layers = ges_timeline_get_layers (copy);
+  clips = ges_layer_get_clips (layers->data);
+  fail_unless_equals_int (g_list_length (clips), 3);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    GESVideoStandardTransitionType vtype;
+
+    if (!GES_IS_TRANSITION_CLIP (tmp->data))
+      continue;
+
+    g_object_get (tmp->data, "vtype", &vtype, NULL);
+    fail_unless_equals_int (vtype,
+        GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_LR);
+  }
+  g_list_free_full (clips, gst_object_unref);
+  g_list_free_full (layers, gst_object_unref);
+
+  gst_object_unref (copy);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static void
+_segmented_render_done_cb (GESPipeline * pipeline, GAsyncResult * result,
+    GMainLoop * loop)
+{
+  GError *error = NULL;
+
+  fail_unless (ges_pipeline_render_segmented_finish (pipeline, result,
+          &error), "Could not render: %s", error ? error->message : "");
+  g_main_loop_quit (loop);
+}
+
+static GstEncodingProfile *
+_create_raw_quicktime_profile (void)
+{
+  GstCaps *caps;
+  GstEncodingContainerProfile *profile;
+
+  caps = gst_caps_new_empty_simple ("video/quicktime");
+  profile = gst_encoding_container_profile_new ("mov", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("video/x-raw,format=UYVY");
+  gst_encoding_container_profile_add_profile (profile,
+      (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL, NULL,
+          0));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) profile;
+}
+
+GST_START_TEST (test_render_segmented)
+{
+  GstCaps *caps;
+  gchar *path, *uri;
+  GMainLoop *loop;
+  GESLayer *layer;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESUriClipAsset *asset;
+  GstEncodingProfile *profile;
+  GError *error = NULL;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string ("video/x-raw,width=64,height=48,"
+      "framerate=25/1");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+  fail_unless (ges_layer_add_asset (layer, ges_asset_request
+          (GES_TYPE_TEST_CLIP, NULL, NULL), 0, 0, GST_SECOND,
+          GES_TRACK_TYPE_UNKNOWN));
+
+  pipeline = ges_test_create_pipeline (timeline);
+  path = g_build_filename (g_get_tmp_dir (), "ges-segmented-render.mov",
+      NULL);
+  uri = gst_filename_to_uri (path, NULL);
+  profile = _create_raw_quicktime_profile ();
+  fail_unless (ges_pipeline_set_render_settings (pipeline, uri, profile));
+  gst_encoding_profile_unref (profile);
+
+  loop = g_main_loop_new (NULL, FALSE);
+  ges_pipeline_render_segmented_async (pipeline, 3, 2, NULL,
+      (GAsyncReadyCallback) _segmented_render_done_cb, loop);
+  g_main_loop_run (loop);
+  g_main_loop_unref (loop);
+
+  /* The segments are joined back into the duration of the timeline */
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_unless (asset, "Could not discover %s: %s", uri,
+      error ? error->message : "");
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (asset), GST_SECOND);
+  gst_object_unref (asset);
+
+  gst_object_unref (pipeline);
+  g_unlink (path);
+  g_free (path);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -699,6 +899,9 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_clip_refcount_remove_child);
   tcase_add_test (tc_chain, test_clip_find_track_element);
   tcase_add_test (tc_chain, test_effects_priorities);
+  tcase_add_test (tc_chain, test_timeline_copy);
+  tcase_add_test (tc_chain, test_timeline_copy_transitions);
+  tcase_add_test (tc_chain, test_render_segmented);
 
   return s;
 }
@@ -1401,6 +1401,137 @@ GST_START_TEST (test_layer_activate_automatic_transition)
 
 GST_END_TEST;
 
+static guint
+count_transitions (GESLayer * layer, GstClockTime start,
+    GstClockTime duration)
+{
+  GList *objects, *tmp;
+  guint n_transitions = 0;
+
+  objects = ges_layer_get_clips (layer);
+  for (tmp = objects; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data) && _START (tmp->data) == start &&
+        _DURATION (tmp->data) == duration)
+      n_transitions++;
+  }
+  g_list_free_full (objects, gst_object_unref);
+
+  return n_transitions;
+}
+
+GST_START_TEST (test_automatic_transition_long_clip)
+{
+  guint i;
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layers[4];
+  GESTimelineElement *long_clip, *src, *src1;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  fail_unless (GES_IS_ASSET (asset));
+
+  timeline = ges_timeline_new_audio_video ();
+  ges_timeline_set_auto_transition (timeline, TRUE);
+
+  for (i = 0; i < G_N_ELEMENTS (layers); i++) {
+    layers[i] = ges_timeline_append_layer (timeline);
+    fail_unless (ges_layer_get_auto_transition (layers[i]));
+    fail_unless (ges_layer_add_asset (layers[i], asset, 0, 0, 1000,
+            GES_TRACK_TYPE_UNKNOWN));
+    fail_unless (ges_layer_add_asset (layers[i], asset, 500, 0, 1000,
+            GES_TRACK_TYPE_UNKNOWN));
+  }
+  ges_timeline_commit (timeline);
+
+  for (i = 0; i < G_N_ELEMENTS (layers); i++)
+    assert_equals_int (count_transitions (layers[i], 500, 500), 2);
+
+  /*
+   * 2000_________________long_clip_________________10000
+   *                                 9000____src_____10500
+   *                                                       20000__src1__21000
+   */
+  long_clip = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layers[2], asset,
+          2000, 0, 8000, GES_TRACK_TYPE_UNKNOWN));
+  src = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layers[2], asset, 9000,
+          0, 1500, GES_TRACK_TYPE_UNKNOWN));
+  src1 = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layers[2], asset, 20000,
+          0, 1000, GES_TRACK_TYPE_UNKNOWN));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layers[2], 9000, 1000), 2);
+
+  /* Overlapping the long clip from far after its start */
+  fail_unless (ges_timeline_element_set_start (src1, 10200));
+  ges_timeline_commit (timeline);
+  assert_equals_uint64 (_START (src1), 10200);
+  assert_equals_int (count_transitions (layers[2], 10200, 300), 2);
+  assert_equals_int (count_transitions (layers[2], 9000, 1000), 2);
+
+  /* Moving the long clip to another layer, and then so that it overlaps the
+   * clip at 500 there */
+  fail_unless (ges_timeline_element_set_start (src, 12000));
+  fail_unless (ges_timeline_element_set_start (src1, 15000));
+  fail_unless (ges_clip_move_to_layer (GES_CLIP (long_clip), layers[3]));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layers[2], 9000, 1000), 0);
+  assert_equals_int (count_transitions (layers[2], 10200, 300), 0);
+
+  fail_unless (ges_timeline_element_set_start (long_clip, 1200));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layers[3], 1200, 300), 2);
+
+  for (i = 0; i < G_N_ELEMENTS (layers); i++)
+    assert_equals_int (count_transitions (layers[i], 500, 500), 2);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_automatic_transition_track_removed)
+{
+  GList *tracks, *tmp;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESTrack *audio_track = NULL;
+  GESTimelineElement *src;
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  fail_unless (GES_IS_ASSET (asset));
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, 1000,
+          GES_TRACK_TYPE_UNKNOWN));
+  src = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layer, asset, 500, 0,
+          1000, GES_TRACK_TYPE_UNKNOWN));
+  ges_timeline_commit (timeline);
+  assert_equals_int (count_transitions (layer, 500, 500), 2);
+
+  tracks = ges_timeline_get_tracks (timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    if (GES_IS_AUDIO_TRACK (tmp->data))
+      audio_track = tmp->data;
+  }
+  fail_unless (audio_track != NULL);
+  fail_unless (ges_timeline_remove_track (timeline, audio_track));
+  g_list_free_full (tracks, gst_object_unref);
+
+  /* The edges of the removed track are gone, editing only goes through
+   * the ones of the video track */
+  fail_unless (ges_timeline_element_set_start (src, 300));
+  ges_timeline_commit (timeline);
+  fail_unless (count_transitions (layer, 300, 700) >= 1);
+
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_layer_meta_string)
 {
   GESTimeline *timeline;
@@ -1819,6 +1950,72 @@ GST_START_TEST (test_layer_get_clips_in_interval)
 
 GST_END_TEST;
 
+static void
+clip_added_cb (GESLayer * layer, GESClip * clip, GList ** added)
+{
+  *added = g_list_append (*added, clip);
+}
+
+GST_START_TEST (test_layer_add_clips)
+{
+  guint i;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESClip *clips[4];
+  GList *objects, *added = NULL, *to_add = NULL;
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_layer_new ();
+  ges_timeline_add_layer (timeline, layer);
+  g_signal_connect (layer, "clip-added", G_CALLBACK (clip_added_cb), &added);
+
+  /* Added in the reverse order of their starts */
+  for (i = 0; i < G_N_ELEMENTS (clips); i++) {
+    clips[i] = (GESClip *) ges_test_clip_new ();
+    g_object_set (clips[i], "start", 100 * i, "duration", 10, NULL);
+    to_add = g_list_prepend (to_add, clips[i]);
+  }
+
+  fail_unless (ges_layer_add_clips (layer, to_add));
+  g_list_free (to_add);
+
+  assert_equals_int (g_list_length (added), G_N_ELEMENTS (clips));
+  for (i = 0; i < G_N_ELEMENTS (clips); i++) {
+    fail_unless (g_list_nth_data (added, i) == clips[i]);
+    fail_unless (ges_clip_get_layer (clips[i]) == layer);
+    gst_object_unref (layer);
+    fail_unless (GES_TIMELINE_ELEMENT_TIMELINE (clips[i]) == timeline);
+  }
+  g_list_free (added);
+
+  /* Clips get resorted when they move */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clips[0]), 250);
+  objects = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (objects), G_N_ELEMENTS (clips));
+  fail_unless (g_list_nth_data (objects, 0) == clips[1]);
+  fail_unless (g_list_nth_data (objects, 1) == clips[2]);
+  fail_unless (g_list_nth_data (objects, 2) == clips[0]);
+  fail_unless (g_list_nth_data (objects, 3) == clips[3]);
+  g_list_free_full (objects, gst_object_unref);
+
+  objects = ges_layer_get_clips_in_interval (layer, 205, 255);
+  assert_equals_int (g_list_length (objects), 2);
+  fail_unless (objects->data == clips[2]);
+  fail_unless (objects->next->data == clips[0]);
+  g_list_free_full (objects, gst_object_unref);
+
+  /* A long clip is found from far after its start */
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clips[1]), 1000);
+  objects = ges_layer_get_clips_in_interval (layer, 900, 1000);
+  assert_equals_int (g_list_length (objects), 1);
+  fail_unless (objects->data == clips[1]);
+  g_list_free_full (objects, gst_object_unref);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -1839,6 +2036,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_single_layer_automatic_transition);
   tcase_add_test (tc_chain, test_multi_layer_automatic_transition);
   tcase_add_test (tc_chain, test_layer_activate_automatic_transition);
+  tcase_add_test (tc_chain, test_automatic_transition_long_clip);
+  tcase_add_test (tc_chain, test_automatic_transition_track_removed);
   tcase_add_test (tc_chain, test_layer_meta_string);
   tcase_add_test (tc_chain, test_layer_meta_boolean);
   tcase_add_test (tc_chain, test_layer_meta_int);
@@ -1853,6 +2052,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_layer_meta_register);
   tcase_add_test (tc_chain, test_layer_meta_foreach);
   tcase_add_test (tc_chain, test_layer_get_clips_in_interval);
+  tcase_add_test (tc_chain, test_layer_add_clips);
 
   return s;
 }
@@ -23,6 +23,8 @@
 #include <gst/check/gstcheck.h>
 
 #include <ges/ges-smart-adder.h>
+#include "../../../ges/ges-smart-video-mixer.h"
+#include "../../../ges/gstframepositioner.h"
 
 static GMainLoop *main_loop;
 
@@ -52,6 +54,211 @@ GST_START_TEST (simple_smart_adder_test)
 
 GST_END_TEST;
 
+GST_START_TEST (simple_smart_mixer_test)
+{
+  GstPad *requested_pad, *target;
+  GstElement *parent;
+  GESTrack *track = GES_TRACK (ges_video_track_new ());
+  GstElement *smart_mixer = ges_smart_mixer_new (track);
+
+  fail_unless (GES_IS_SMART_MIXER (smart_mixer));
+  fail_unless (GST_IS_ELEMENT (GES_SMART_MIXER (smart_mixer)->mixer));
+
+  requested_pad = gst_element_get_request_pad (smart_mixer, "sink_%u");
+  fail_unless (GST_IS_PAD (requested_pad));
+
+  /* The compositor converts its inputs itself, no converter in between */
+  target = gst_ghost_pad_get_target (GST_GHOST_PAD (requested_pad));
+  parent = gst_pad_get_parent_element (target);
+  fail_unless (parent == GES_SMART_MIXER (smart_mixer)->mixer);
+  gst_object_unref (parent);
+  gst_object_unref (target);
+
+  gst_element_release_request_pad (smart_mixer, requested_pad);
+  gst_object_unref (requested_pad);
+  gst_object_unref (smart_mixer);
+  gst_object_unref (track);
+}
+
+GST_END_TEST;
+
+static void
+_mixer_pad_notify_cb (GstPad * pad, GParamSpec * pspec, GHashTable * counts)
+{
+  g_hash_table_insert (counts, (gpointer) pspec->name,
+      GUINT_TO_POINTER (GPOINTER_TO_UINT (g_hash_table_lookup (counts,
+                  pspec->name)) + 1));
+}
+
+static GstPadProbeReturn
+_move_on_second_buffer_cb (GstPad * pad, GstPadProbeInfo * info,
+    gint * n_buffers)
+{
+  if (++(*n_buffers) == 2)
+    g_object_set (GST_PAD_PARENT (pad), "posx", 10, NULL);
+
+  return GST_PAD_PROBE_OK;
+}
+
+#define assert_set_times(counts,name,times) \
+  assert_equals_int (GPOINTER_TO_UINT (g_hash_table_lookup (counts, name)), \
+      times)
+
+GST_START_TEST (smart_mixer_only_sets_changed_properties)
+{
+  GstBus *bus;
+  GstMessage *message;
+  GHashTable *counts;
+  gint n_buffers = 0;
+  GstPad *requested_pad, *mixer_pad, *pad;
+  GstElement *pipeline, *src, *positioner, *sink, *smart_mixer;
+  GESTrack *track = GES_TRACK (ges_video_track_new ());
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("videotestsrc", NULL);
+  g_object_set (src, "num-buffers", 3, NULL);
+  positioner = gst_element_factory_make ("framepositioner", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  smart_mixer = ges_smart_mixer_new (track);
+  gst_bin_add_many (GST_BIN (pipeline), src, positioner, smart_mixer, sink,
+      NULL);
+  fail_unless (gst_element_link_many (src, positioner, NULL));
+  fail_unless (gst_element_link (smart_mixer, sink));
+
+  requested_pad = gst_element_get_request_pad (smart_mixer, "sink_%u");
+  pad = gst_element_get_static_pad (positioner, "src");
+  fail_unless (gst_pad_link (pad, requested_pad) == GST_PAD_LINK_OK);
+  gst_object_unref (pad);
+
+  pad = gst_element_get_static_pad (positioner, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) _move_on_second_buffer_cb, &n_buffers, NULL);
+  gst_object_unref (pad);
+
+  counts = g_hash_table_new (g_str_hash, g_str_equal);
+  mixer_pad = gst_ghost_pad_get_target (GST_GHOST_PAD (requested_pad));
+  g_signal_connect (mixer_pad, "notify", G_CALLBACK (_mixer_pad_notify_cb),
+      counts);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  /* Everything is set for the first buffer, then only what moved */
+  assert_equals_int (n_buffers, 3);
+  assert_set_times (counts, "alpha", 1);
+  assert_set_times (counts, "zorder", 1);
+  assert_set_times (counts, "xpos", 2);
+  assert_set_times (counts, "ypos", 1);
+  assert_set_times (counts, "width", 1);
+  assert_set_times (counts, "height", 1);
+
+  g_signal_handlers_disconnect_by_func (mixer_pad, _mixer_pad_notify_cb,
+      counts);
+  g_hash_table_unref (counts);
+  gst_object_unref (mixer_pad);
+  gst_object_unref (requested_pad);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  gst_object_unref (track);
+}
+
+GST_END_TEST;
+
+static GstSample *
+_run_crop_pipeline (const gchar * crops)
+{
+  GstBus *bus;
+  GstSample *sample;
+  GstMessage *message;
+  GstElement *pipeline, *sink;
+  gchar *desc = g_strdup_printf ("videotestsrc num-buffers=1 ! "
+      "video/x-raw,format=I420,width=64,height=48 ! framepositioner %s ! "
+      "fakesink name=sink", crops);
+
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_object_get (sink, "last-sample", &sample, NULL);
+  fail_unless (sample != NULL);
+
+  gst_object_unref (sink);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  return sample;
+}
+
+static void
+_check_crop (GstSample * sample, gint width, gint height, gint left,
+    gint right, gint top, gint bottom)
+{
+  gint v;
+  GstFramePositionerMeta *meta;
+  GstStructure *structure =
+      gst_caps_get_structure (gst_sample_get_caps (sample), 0);
+
+  fail_unless (gst_structure_get_int (structure, "width", &v));
+  assert_equals_int (v, width);
+  fail_unless (gst_structure_get_int (structure, "height", &v));
+  assert_equals_int (v, height);
+
+  meta = (GstFramePositionerMeta *)
+      gst_buffer_get_meta (gst_sample_get_buffer (sample),
+      g_type_from_name ("GstFramePositionerApi"));
+  fail_unless (meta != NULL);
+  assert_equals_int (meta->crop_left, left);
+  assert_equals_int (meta->crop_right, right);
+  assert_equals_int (meta->crop_top, top);
+  assert_equals_int (meta->crop_bottom, bottom);
+}
+
+GST_START_TEST (positioner_crop_test)
+{
+  GstSample *sample;
+
+  /* The left crop is rounded down to keep the chroma aligned */
+  sample = _run_crop_pipeline ("crop-left=11 crop-right=4 crop-top=6 "
+      "crop-bottom=2");
+  _check_crop (sample, 50, 40, 10, 4, 6, 2);
+  gst_sample_unref (sample);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (positioner_crop_too_big_test)
+{
+  GstSample *sample;
+
+  /* At least one pixel is always left */
+  sample = _run_crop_pipeline ("crop-left=100 crop-right=4 crop-top=50 "
+      "crop-bottom=50");
+  _check_crop (sample, 1, 1, 62, 1, 46, 1);
+  gst_sample_unref (sample);
+}
+
+GST_END_TEST;
+
 static void
 message_received_cb (GstBus * bus, GstMessage * message, GstPipeline * pipeline)
 {
@@ -214,6 +421,10 @@ ges_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, simple_smart_adder_test);
+  tcase_add_test (tc_chain, simple_smart_mixer_test);
+  tcase_add_test (tc_chain, smart_mixer_only_sets_changed_properties);
+  tcase_add_test (tc_chain, positioner_crop_test);
+  tcase_add_test (tc_chain, positioner_crop_too_big_test);
   tcase_add_test (tc_chain, simple_audio_mixed_with_pipeline);
   tcase_add_test (tc_chain, audio_video_mixed_with_pipeline);
 
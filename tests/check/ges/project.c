@@ -21,6 +21,7 @@
 #include "test-utils.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 #include <gst/controller/gstdirectcontrolbinding.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
 
@@ -128,6 +129,424 @@ GST_START_TEST (test_project_add_assets)
 
 GST_END_TEST;
 
+static void
+assets_loading_progress_cb (GESProject * project, guint n_loaded,
+    guint n_assets, guint * progress)
+{
+  fail_unless (n_loaded <= n_assets);
+  progress[0] = n_loaded;
+  progress[1] = n_assets;
+}
+
+static void
+assets_created_cb (GESProject * project, GAsyncResult * res,
+    gboolean * created)
+{
+  GError *error = NULL;
+
+  *created = ges_project_create_assets_finish (project, res, &error);
+  fail_unless (error == NULL);
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_project_create_assets_async)
+{
+  GList *assets;
+  GESProject *project;
+  gboolean created = FALSE;
+  guint progress[2] = { 0, 0 };
+  gchar *uri = ges_test_get_audio_video_uri ();
+  const gchar *ids[] = { NULL, uri, NULL, uri };
+  GType types[] = { GES_TYPE_TEST_CLIP, GES_TYPE_URI_CLIP,
+    GES_TYPE_TEST_CLIP, GES_TYPE_URI_CLIP
+  };
+
+  ges_init ();
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  project = GES_PROJECT (ges_asset_request (GES_TYPE_TIMELINE, NULL, NULL));
+  fail_unless (GES_IS_PROJECT (project));
+
+  g_signal_connect (project, "assets-loading-progress",
+      (GCallback) assets_loading_progress_cb, progress);
+  ges_project_create_assets_async (project, ids, types, G_N_ELEMENTS (ids),
+      NULL, (GAsyncReadyCallback) assets_created_cb, &created);
+  g_main_loop_run (mainloop);
+  g_main_loop_unref (mainloop);
+
+  fail_unless (created);
+  /* Duplicated ids are only requested once */
+  assets = ges_project_list_assets (project, GES_TYPE_CLIP);
+  assert_equals_int (g_list_length (assets), 2);
+  g_list_free_full (assets, gst_object_unref);
+  fail_unless (progress[1] <= 2);
+  assert_equals_int (progress[0], progress[1]);
+
+  g_signal_handlers_disconnect_by_func (project,
+      (GCallback) assets_loading_progress_cb, progress);
+  gst_object_unref (project);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+static gchar *
+copy_test_file (const gchar * filename, const gchar * dir, const gchar * name)
+{
+  GFile *src, *dest;
+  gchar *path, *uri;
+
+  uri = ges_test_file_uri (filename);
+  src = g_file_new_for_uri (uri);
+  g_free (uri);
+
+  path = g_build_filename (dir, name, NULL);
+  dest = g_file_new_for_path (path);
+  fail_unless (g_file_copy (src, dest, G_FILE_COPY_NONE, NULL, NULL, NULL,
+          NULL));
+  uri = gst_filename_to_uri (path, NULL);
+
+  g_object_unref (src);
+  g_object_unref (dest);
+  g_free (path);
+
+  return uri;
+}
+
+#define STREAM_INFO_MARKUP "<stream-info data='"
+
+/* Replaces the serialized stream information of @contents with what
+ * @func returns for each of them */
+static gchar *
+_rewrite_stream_infos (const gchar * contents, gchar * (*func) (const gchar *))
+{
+  const gchar *data, *end;
+  GString *res = g_string_new (NULL);
+
+  while ((data = strstr (contents, STREAM_INFO_MARKUP))) {
+    gchar *info, *rewritten;
+
+    data += strlen (STREAM_INFO_MARKUP);
+    end = strchr (data, '\'');
+    fail_unless (end != NULL);
+
+    g_string_append_len (res, contents, data - contents);
+    info = g_strndup (data, end - data);
+    rewritten = func (info);
+    g_string_append (res, rewritten);
+    g_free (rewritten);
+    g_free (info);
+    contents = end;
+  }
+  g_string_append (res, contents);
+
+  return g_string_free (res, FALSE);
+}
+
+/* Forgets the size and modification time of the file, as for the files
+ * those can not be known for */
+static gchar *
+_clear_file_stamp (const gchar * serialized_info)
+{
+  gsize length;
+  gchar *ret;
+  guchar *data;
+  GVariant *variant, *info_variant, *cleared;
+
+  data = g_base64_decode (serialized_info, &length);
+  variant = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE
+          ("(ttv)"), data, length, FALSE, g_free, data));
+  g_variant_get_child (variant, 2, "v", &info_variant);
+  cleared = g_variant_ref_sink (g_variant_new ("(ttv)", (guint64) 0,
+          (guint64) 0, info_variant));
+  ret = g_base64_encode (g_variant_get_data (cleared),
+      g_variant_get_size (cleared));
+
+  g_variant_unref (cleared);
+  g_variant_unref (info_variant);
+  g_variant_unref (variant);
+
+  return ret;
+}
+
+static gchar *
+_corrupt_stream_info (const gchar * serialized_info)
+{
+  gsize length;
+  gchar *ret;
+  guchar *data = g_base64_decode (serialized_info, &length);
+
+  /* Keep the file stamp, scramble the stream information */
+  memset (data + 16, 0xff, length - 16);
+  ret = g_base64_encode (data, length);
+  g_free (data);
+
+  return ret;
+}
+
+/* Keeps the file stamp and the outer layout of the discoverer info, with an
+ * audio stream that does not have the expected fields */
+static gchar *
+_malform_stream_info (const gchar * serialized_info)
+{
+  gsize length;
+  gchar *ret;
+  guchar *data;
+  guint64 size, mtime;
+  GVariant *variant, *info, *common, *audio, *stream, *malformed;
+
+  data = g_base64_decode (serialized_info, &length);
+  variant = g_variant_ref_sink (g_variant_new_from_data (G_VARIANT_TYPE
+          ("(ttv)"), data, length, FALSE, g_free, data));
+  g_variant_get (variant, "(ttv)", &size, &mtime, NULL);
+
+  info = g_variant_new ("(mstbmsb)", NULL, (guint64) GST_SECOND, TRUE, NULL,
+      FALSE);
+  common = g_variant_new ("(msmsmsms)", NULL, "audio/x-raw", NULL, NULL);
+  audio = g_variant_new ("(s)", "not the audio fields");
+  stream = g_variant_new ("(yvv)", 'a', common, audio);
+  malformed = g_variant_ref_sink (g_variant_new ("(ttv)", size, mtime,
+          g_variant_new_variant (g_variant_new ("(vv)", info, stream))));
+  ret = g_base64_encode (g_variant_get_data (malformed),
+      g_variant_get_size (malformed));
+
+  g_variant_unref (malformed);
+  g_variant_unref (variant);
+
+  return ret;
+}
+
+static void
+asset_mismatch_cb (GESProject * project, GESAsset * asset, GError * error,
+    GESAsset ** mismatching)
+{
+  fail_unless (g_error_matches (error, GES_ERROR, GES_ERROR_ASSET_LOADING));
+  *mismatching = asset;
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_project_lazy_loading)
+{
+  GList *clips;
+  gsize length;
+  gchar **split;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *mismatching = NULL;
+  gchar *dir, *xges, *contents, *rewritten, *av_uri, *audio_uri,
+      *project_uri;
+
+  dir = g_dir_make_tmp ("ges-lazy-loading-XXXXXX", NULL);
+  fail_unless (dir != NULL);
+  av_uri = copy_test_file ("audio_video.ogg", dir, "media-av.ogg");
+  audio_uri = copy_test_file ("audio_only.ogg", dir, "media-audio.ogg");
+
+  /* Save a project referencing the audio/video file */
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (av_uri, NULL));
+  fail_unless (asset != NULL);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+          GES_TRACK_TYPE_UNKNOWN) != NULL);
+  gst_object_unref (asset);
+
+  xges = g_build_filename (dir, "project.xges", NULL);
+  project_uri = gst_filename_to_uri (xges, NULL);
+  fail_unless (ges_timeline_save_to_uri (timeline, project_uri, NULL, TRUE,
+          NULL));
+  gst_object_unref (timeline);
+
+  /* Point it to the audio only file, which does not match the serialized
+   * stream information anymore. The file stamps are cleared, otherwise the
+   * change is noticed right away. */
+  fail_unless (g_file_get_contents (xges, &contents, &length, NULL));
+  split = g_strsplit (contents, "media-av.ogg", -1);
+  g_free (contents);
+  contents = g_strjoinv ("media-audio.ogg", split);
+  g_strfreev (split);
+  rewritten = _rewrite_stream_infos (contents, _clear_file_stamp);
+  fail_unless (g_file_set_contents (xges, rewritten, -1, NULL));
+  g_free (rewritten);
+  g_free (contents);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (project_uri);
+  ges_project_set_lazy_loading (project, TRUE);
+  fail_unless (ges_project_get_lazy_loading (project));
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "asset-mismatch", (GCallback) asset_mismatch_cb,
+      &mismatching);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  /* The clip was created from the serialized stream information */
+  fail_unless (mismatching == NULL);
+  layer = GES_LAYER (timeline->layers->data);
+  clips = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (clips), 1);
+  assert_equals_string (ges_asset_get_id (ges_extractable_get_asset
+          (GES_EXTRACTABLE (clips->data))), audio_uri);
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (clips->data)), 2);
+  g_list_free_full (clips, gst_object_unref);
+
+  /* And the mismatch is reported once the file gets discovered */
+  g_main_loop_run (mainloop);
+  fail_unless (mismatching != NULL);
+  assert_equals_string (ges_asset_get_id (mismatching), audio_uri);
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+
+  g_unlink (xges);
+  g_free (xges);
+  xges = g_build_filename (dir, "media-av.ogg", NULL);
+  g_unlink (xges);
+  g_free (xges);
+  xges = g_build_filename (dir, "media-audio.ogg", NULL);
+  g_unlink (xges);
+  g_free (xges);
+  g_rmdir (dir);
+
+  g_free (project_uri);
+  g_free (audio_uri);
+  g_free (av_uri);
+  g_free (dir);
+}
+
+GST_END_TEST;
+
+static void
+asset_loading_cb (GESProject * project, GESAsset * asset, gboolean * loading)
+{
+  *loading = TRUE;
+}
+
+/* Saves a project using @media, renames the file, optionally changing its
+ * modification time if @touch is %TRUE, rewrites the stream information
+ * of the project with @func, and returns whether the file had to be
+ * discovered when loading the project again */
+static gboolean
+_load_rewritten_project (const gchar * media, gboolean touch,
+    gchar * (*func) (const gchar *))
+{
+  GList *clips;
+  gsize length;
+  gchar **split;
+  GFile *file;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *mismatching = NULL;
+  gboolean discovered = FALSE;
+  gchar *dir, *xges, *contents, *rewritten, *uri, *path, *loaded_path,
+      *project_uri;
+
+  dir = g_dir_make_tmp ("ges-lazy-loading-XXXXXX", NULL);
+  fail_unless (dir != NULL);
+  uri = copy_test_file (media, dir, "media.ogg");
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  fail_unless (asset != NULL);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+          GES_TRACK_TYPE_UNKNOWN) != NULL);
+  gst_object_unref (asset);
+
+  xges = g_build_filename (dir, "project.xges", NULL);
+  project_uri = gst_filename_to_uri (xges, NULL);
+  fail_unless (ges_timeline_save_to_uri (timeline, project_uri, NULL, TRUE,
+          NULL));
+  gst_object_unref (timeline);
+
+  /* Renaming keeps the size and modification time of the file, and the
+   * new URI has no asset yet */
+  path = g_build_filename (dir, "media.ogg", NULL);
+  loaded_path = g_build_filename (dir, "media-loaded.ogg", NULL);
+  fail_unless (g_rename (path, loaded_path) == 0);
+  if (touch) {
+    file = g_file_new_for_path (loaded_path);
+    fail_unless (g_file_set_attribute_uint64 (file,
+            G_FILE_ATTRIBUTE_TIME_MODIFIED, g_get_real_time () / G_USEC_PER_SEC
+            + 10, G_FILE_QUERY_INFO_NONE, NULL, NULL));
+    g_object_unref (file);
+  }
+
+  fail_unless (g_file_get_contents (xges, &contents, &length, NULL));
+  split = g_strsplit (contents, "media.ogg", -1);
+  g_free (contents);
+  contents = g_strjoinv ("media-loaded.ogg", split);
+  g_strfreev (split);
+  rewritten = func ? _rewrite_stream_infos (contents, func) :
+      g_strdup (contents);
+  fail_unless (g_file_set_contents (xges, rewritten, -1, NULL));
+  g_free (rewritten);
+  g_free (contents);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (project_uri);
+  ges_project_set_lazy_loading (project, TRUE);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "asset-loading", (GCallback) asset_loading_cb,
+      &discovered);
+  g_signal_connect (project, "asset-mismatch", (GCallback) asset_mismatch_cb,
+      &mismatching);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+  fail_unless (mismatching == NULL);
+
+  layer = GES_LAYER (timeline->layers->data);
+  clips = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (clips), 1);
+  g_list_free_full (clips, gst_object_unref);
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+
+  g_unlink (xges);
+  g_unlink (loaded_path);
+  g_rmdir (dir);
+
+  g_free (xges);
+  g_free (path);
+  g_free (loaded_path);
+  g_free (project_uri);
+  g_free (uri);
+  g_free (dir);
+
+  return discovered;
+}
+
+GST_START_TEST (test_project_lazy_loading_stream_info_checks)
+{
+  /* The serialized stream information is used when the file did not
+   * change */
+  fail_if (_load_rewritten_project ("audio_video.ogg", FALSE, NULL));
+
+  /* A file modified since the project was saved gets discovered */
+  fail_unless (_load_rewritten_project ("audio_video.ogg", TRUE, NULL));
+
+  /* So does a file with corrupted stream information, instead of making
+   * the loader crash */
+  fail_unless (_load_rewritten_project ("audio_video.ogg", FALSE,
+          _corrupt_stream_info));
+
+  /* Or with a well formed discoverer info holding unexpected streams */
+  fail_unless (_load_rewritten_project ("audio_video.ogg", FALSE,
+          _malform_stream_info));
+}
+
+GST_END_TEST;
+
 static void
 error_loading_asset_cb (GESProject * project, GError * error, gchar * id,
     GType extractable_type, GMainLoop * mainloop)
@@ -739,10 +1158,15 @@ ges_suite (void)
   }
 
   suite_add_tcase (s, tc_chain);
+  /* Do not leave the discovered test files in the user cache */
+  g_setenv ("GES_DISCOVERY_CACHE", "0", TRUE);
   ges_init ();
 
   tcase_add_test (tc_chain, test_project_simple);
   tcase_add_test (tc_chain, test_project_add_assets);
+  tcase_add_test (tc_chain, test_project_create_assets_async);
+  tcase_add_test (tc_chain, test_project_lazy_loading);
+  tcase_add_test (tc_chain, test_project_lazy_loading_stream_info_checks);
   tcase_add_test (tc_chain, test_project_load_xges);
   tcase_add_test (tc_chain, test_project_add_properties);
   tcase_add_test (tc_chain, test_project_auto_transition);
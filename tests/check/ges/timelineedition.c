@@ -1495,6 +1495,145 @@ GST_START_TEST (test_scaling)
 
 GST_END_TEST;
 
+static void
+_count_notify_cb (GObject * object, GParamSpec * pspec, guint * count)
+{
+  *count += 1;
+}
+
+GST_START_TEST (test_edit_transaction)
+{
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESTimelineElement *c1, *c2, *c3;
+  guint n_duration_notifies = 0;
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  c1 = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layer, asset, 0, 0, 100,
+          GES_TRACK_TYPE_UNKNOWN));
+  c2 = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layer, asset, 100, 0, 100,
+          GES_TRACK_TYPE_UNKNOWN));
+  c3 = GES_TIMELINE_ELEMENT (ges_layer_add_asset (layer, asset, 200, 0, 100,
+          GES_TRACK_TYPE_UNKNOWN));
+  assert_equals_uint64 (_DURATION (timeline), 300);
+
+  g_signal_connect (timeline, "notify::duration",
+      G_CALLBACK (_count_notify_cb), &n_duration_notifies);
+
+  /* All the moves are indexed at once and the duration is only updated
+   * when the transaction ends */
+  ges_timeline_begin_edit (timeline);
+  fail_unless (ges_timeline_element_set_start (c3, 1000));
+  fail_unless (ges_timeline_element_set_start (c2, 500));
+  fail_unless (ges_timeline_element_set_start (c1, 300));
+  assert_equals_int (n_duration_notifies, 0);
+  fail_unless (ges_timeline_end_edit (timeline));
+
+  assert_equals_int (n_duration_notifies, 1);
+  assert_equals_uint64 (_DURATION (timeline), 1100);
+  DEEP_CHECK (c1, 300, 0, 100);
+  DEEP_CHECK (c2, 500, 0, 100);
+  DEEP_CHECK (c3, 1000, 0, 100);
+
+  /* Transactions can be nested, only the outermost one ends the edit */
+  ges_timeline_begin_edit (timeline);
+  ges_timeline_begin_edit (timeline);
+  fail_unless (ges_timeline_element_set_start (c1, 0));
+  fail_unless (ges_timeline_end_edit (timeline));
+  assert_equals_int (n_duration_notifies, 1);
+  fail_unless (ges_timeline_element_set_start (c3, 200));
+  fail_unless (ges_timeline_end_edit (timeline));
+  assert_equals_int (n_duration_notifies, 2);
+  assert_equals_uint64 (_DURATION (timeline), 600);
+
+  /* Make c1 and c2 overlap, then try to put c3 over them which would lead
+   * to 3 overlapping clips: the whole transaction is rolled back */
+  ges_layer_set_auto_transition (layer, TRUE);
+  fail_unless (ges_timeline_element_set_start (c2, 50));
+  DEEP_CHECK (c2, 50, 0, 100);
+
+  ges_timeline_begin_edit (timeline);
+  fail_unless (ges_timeline_element_set_duration (c1, 80));
+  ges_timeline_element_set_start (c3, 60);
+  fail_if (ges_timeline_end_edit (timeline));
+
+  DEEP_CHECK (c1, 0, 0, 100);
+  DEEP_CHECK (c2, 50, 0, 100);
+  DEEP_CHECK (c3, 200, 0, 100);
+  assert_equals_uint64 (_DURATION (timeline), 300);
+
+  gst_object_unref (asset);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_ripple_reuses_context)
+{
+  GESTimeline *timeline;
+  GESLayer *layer, *layer1;
+  GESAsset *asset;
+  GESContainer *c0, *c1, *c2, *other;
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  /**
+   * Our timeline
+   *
+   * layer  0-------10-------20-------30
+   *        |  c0   |   c1   |   c2   |
+   * layer1      5--------15
+   *             | other  |
+   */
+  c0 = GES_CONTAINER (ges_layer_add_asset (layer, asset, 0, 0, 10,
+          GES_TRACK_TYPE_UNKNOWN));
+  c1 = GES_CONTAINER (ges_layer_add_asset (layer, asset, 10, 0, 10,
+          GES_TRACK_TYPE_UNKNOWN));
+  c2 = GES_CONTAINER (ges_layer_add_asset (layer, asset, 20, 0, 10,
+          GES_TRACK_TYPE_UNKNOWN));
+  other = GES_CONTAINER (ges_layer_add_asset (layer1, asset, 5, 0, 10,
+          GES_TRACK_TYPE_UNKNOWN));
+
+  fail_unless (ges_container_edit (c1, NULL, -1, GES_EDIT_MODE_RIPPLE,
+          GES_EDGE_NONE, 20));
+  DEEP_CHECK (c0, 0, 0, 10);
+  DEEP_CHECK (c1, 20, 0, 10);
+  DEEP_CHECK (c2, 30, 0, 10);
+  DEEP_CHECK (other, 5, 0, 10);
+
+  fail_unless (ges_container_edit (c1, NULL, -1, GES_EDIT_MODE_RIPPLE,
+          GES_EDGE_NONE, 25));
+  DEEP_CHECK (c1, 25, 0, 10);
+  DEEP_CHECK (c2, 35, 0, 10);
+  DEEP_CHECK (other, 5, 0, 10);
+
+  /* c1 now starts before other, which has to be rippled too */
+  fail_unless (ges_container_edit (c1, NULL, -1, GES_EDIT_MODE_RIPPLE,
+          GES_EDGE_NONE, 2));
+  DEEP_CHECK (c1, 2, 0, 10);
+  DEEP_CHECK (c2, 12, 0, 10);
+  DEEP_CHECK (other, 5, 0, 10);
+
+  fail_unless (ges_container_edit (c1, NULL, -1, GES_EDIT_MODE_RIPPLE,
+          GES_EDGE_NONE, 4));
+  DEEP_CHECK (c0, 0, 0, 10);
+  DEEP_CHECK (c1, 4, 0, 10);
+  DEEP_CHECK (c2, 14, 0, 10);
+  DEEP_CHECK (other, 7, 0, 10);
+
+  gst_object_unref (asset);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -1516,6 +1655,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_groups);
   tcase_add_test (tc_chain, test_snapping_groups);
   tcase_add_test (tc_chain, test_scaling);
+  tcase_add_test (tc_chain, test_edit_transaction);
+  tcase_add_test (tc_chain, test_ripple_reuses_context);
 
   return s;
 }
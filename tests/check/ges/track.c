@@ -18,6 +18,7 @@
  */
 
 #include "test-utils.h"
+#include "../../../ges/ges-internal.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
 
@@ -87,6 +88,399 @@ GST_START_TEST (test_update_restriction_caps)
 
 GST_END_TEST;
 
+static void
+_get_gap_pool_stats (GESTrack * track, guint * hits, guint * misses)
+{
+  GstStructure *stats;
+
+  g_object_get (track, "gap-pool-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint (stats, "hits", hits));
+  fail_unless (gst_structure_get_uint (stats, "misses", misses));
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (test_gap_pool)
+{
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip;
+  guint hits, misses, prev_hits, prev_misses;
+
+  track = GES_TRACK (ges_audio_track_new ());
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  ges_layer_add_asset (layer, asset, 0, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  clip = ges_layer_add_asset (layer, asset, 20, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (ges_timeline_commit (timeline));
+  _get_gap_pool_stats (track, &prev_hits, &prev_misses);
+  fail_unless (prev_misses > 0);
+
+  /* The gap between the clips vanishes and can be reused for the one at
+   * the end of the track */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+          10));
+  fail_unless (ges_timeline_commit (timeline));
+  _get_gap_pool_stats (track, &hits, &misses);
+  assert_equals_int (misses, prev_misses);
+  fail_unless (hits > prev_hits);
+
+  /* Both gaps are back, no new gap filler is needed */
+  prev_hits = hits;
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+          20));
+  fail_unless (ges_timeline_commit (timeline));
+  _get_gap_pool_stats (track, &hits, &misses);
+  assert_equals_int (misses, prev_misses);
+  fail_unless (hits > prev_hits);
+
+  gst_object_unref (asset);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static GstElement *
+_get_composition (GESTrack * track)
+{
+  GList *tmp;
+
+  for (tmp = GST_BIN_CHILDREN (track); tmp; tmp = tmp->next) {
+    GstElementFactory *factory = gst_element_get_factory (tmp->data);
+
+    if (factory && !g_strcmp0 (GST_OBJECT_NAME (factory), "nlecomposition"))
+      return tmp->data;
+  }
+
+  fail_unless (FALSE, "No composition in %" GST_PTR_FORMAT, track);
+  return NULL;
+}
+
+/* Returns the active gap filler of @track starting at @start */
+static GstElement *
+_find_gap (GESTrack * track, GstClockTime start)
+{
+  GList *tmp;
+  GstElement *gap = NULL;
+  GstElement *composition = _get_composition (track);
+
+  for (tmp = GST_BIN_CHILDREN (composition); tmp; tmp = tmp->next) {
+    guint prio;
+    gboolean active;
+    GstClockTime nle_start;
+
+    g_object_get (tmp->data, "priority", &prio, "active", &active, "start",
+        &nle_start, NULL);
+    if (prio == 1 && active && nle_start == start) {
+      fail_unless (gap == NULL);
+      gap = tmp->data;
+    }
+  }
+
+  return gap;
+}
+
+GST_START_TEST (test_gap_retimed)
+{
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip;
+  GstElement *gap;
+  GstClockTime duration;
+  guint n_children;
+
+  track = GES_TRACK (ges_audio_track_new ());
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  ges_layer_add_asset (layer, asset, 0, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  clip = ges_layer_add_asset (layer, asset, 20, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (ges_timeline_commit (timeline));
+  gap = _find_gap (track, 10);
+  fail_unless (gap != NULL);
+  g_object_get (gap, "duration", &duration, NULL);
+  assert_equals_uint64 (duration, 10);
+  n_children = g_list_length (GST_BIN_CHILDREN (_get_composition (track)));
+
+  /* Moving the clip retimes the gap in front of it instead of replacing it */
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+          25));
+  fail_unless (ges_timeline_commit (timeline));
+  fail_unless (_find_gap (track, 10) == gap);
+  g_object_get (gap, "duration", &duration, NULL);
+  assert_equals_uint64 (duration, 15);
+
+  fail_unless (ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip),
+          15));
+  fail_unless (ges_timeline_commit (timeline));
+  fail_unless (_find_gap (track, 10) == gap);
+  g_object_get (gap, "duration", &duration, NULL);
+  assert_equals_uint64 (duration, 5);
+
+  /* No gap filler was added to the composition */
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (_get_composition
+              (track))), n_children);
+
+  gst_object_unref (asset);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static void
+_get_decoder_pool_stats (GESTrack * track, guint * created, guint * reused)
+{
+  GstStructure *stats;
+
+  g_object_get (track, "decoder-pool-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint (stats, "created", created));
+  fail_unless (gst_structure_get_uint (stats, "reused", reused));
+  gst_structure_free (stats);
+}
+
+static void
+_seek_and_wait (GESPipeline * pipeline, GstClockTime position)
+{
+  fail_unless (gst_element_seek_simple (GST_ELEMENT (pipeline),
+          GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+          position));
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+}
+
+GST_START_TEST (test_decoder_pool)
+{
+  gchar *uri;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  guint created, reused;
+
+  track = GES_TRACK (ges_audio_track_new ());
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  uri = ges_test_get_audio_only_uri ();
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  fail_unless (asset != NULL);
+  g_free (uri);
+
+  /* Two parts of the same file that are never played at the same time */
+  ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND, GES_TRACK_TYPE_AUDIO);
+  ges_layer_add_asset (layer, asset, GST_SECOND, GST_SECOND, GST_SECOND,
+      GES_TRACK_TYPE_AUDIO);
+  gst_object_unref (asset);
+  fail_unless (ges_timeline_commit (timeline));
+
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_unless (gst_element_set_state (GST_ELEMENT (pipeline),
+          GST_STATE_PAUSED) != GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  _get_decoder_pool_stats (track, &created, &reused);
+  assert_equals_int (created, 1);
+  assert_equals_int (reused, 0);
+
+  /* Going back to the first clip borrows the decoder released by one of
+   * the clips instead of opening the file again */
+  _seek_and_wait (pipeline, GST_SECOND + GST_SECOND / 2);
+  _seek_and_wait (pipeline, GST_SECOND / 2);
+  _get_decoder_pool_stats (track, &created, &reused);
+  fail_unless (created <= 2);
+  fail_unless (reused > 0);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (pipeline),
+          GST_STATE_NULL) != GST_STATE_CHANGE_FAILURE);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static gboolean
+_is_passed_through (GESTrackElement * source)
+{
+  GstPad *srcpad, *target;
+  GstElement *parent;
+  gboolean ret;
+
+  srcpad = gst_element_get_static_pad (ges_track_element_get_element (source),
+      "src");
+  target = gst_ghost_pad_get_target (GST_GHOST_PAD (srcpad));
+  parent = gst_pad_get_parent_element (target);
+  ret = GES_IS_POOLED_DECODER (parent);
+
+  gst_object_unref (parent);
+  gst_object_unref (target);
+  gst_object_unref (srcpad);
+
+  return ret;
+}
+
+GST_START_TEST (test_passthrough)
+{
+  gchar *uri;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip, *clip1;
+  GESTrackElement *source, *source1, *effect;
+  GstCaps *caps;
+
+  track = GES_TRACK (ges_audio_track_new ());
+  caps = gst_caps_from_string ("audio/x-raw");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  uri = ges_test_get_audio_only_uri ();
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  fail_unless (asset != NULL);
+  g_free (uri);
+
+  clip = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_AUDIO);
+  clip1 = ges_layer_add_asset (layer, asset, GST_SECOND, 0, GST_SECOND,
+      GES_TRACK_TYPE_AUDIO);
+  gst_object_unref (asset);
+  fail_unless (ges_timeline_commit (timeline));
+  source = ges_clip_find_track_element (clip, track, GES_TYPE_SOURCE);
+  source1 = ges_clip_find_track_element (clip1, track, GES_TYPE_SOURCE);
+
+  caps = gst_caps_from_string ("audio/x-vorbis");
+  track_set_passthrough_caps (track, caps);
+  fail_unless (_is_passed_through (source));
+  fail_unless (_is_passed_through (source1));
+
+  /* A modified source has to be decoded, the others stay untouched */
+  ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT (source),
+      "volume", 0.5, NULL);
+  track_set_passthrough_caps (track, caps);
+  fail_if (_is_passed_through (source));
+  fail_unless (_is_passed_through (source1));
+
+  /* Edits are taken into account when commiting */
+  effect = GES_TRACK_ELEMENT (ges_effect_new ("audioecho"));
+  fail_unless (ges_container_add (GES_CONTAINER (clip1),
+          GES_TIMELINE_ELEMENT (effect)));
+  ges_timeline_commit (timeline);
+  fail_if (_is_passed_through (source1));
+
+  fail_unless (ges_container_remove (GES_CONTAINER (clip1),
+          GES_TIMELINE_ELEMENT (effect)));
+  ges_timeline_commit (timeline);
+  fail_unless (_is_passed_through (source1));
+  gst_caps_unref (caps);
+
+  /* Formats the streams do not match never pass through */
+  caps = gst_caps_from_string ("audio/x-opus");
+  track_set_passthrough_caps (track, caps);
+  fail_if (_is_passed_through (source1));
+  gst_caps_unref (caps);
+
+  track_set_passthrough_caps (track, NULL);
+  fail_if (_is_passed_through (source));
+  fail_if (_is_passed_through (source1));
+
+  gst_object_unref (source);
+  gst_object_unref (source1);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_passthrough_commit_while_playing)
+{
+  gchar *uri;
+  GstBus *bus;
+  GstPad *pad, *sinkpad;
+  GESTrack *track;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESAsset *asset;
+  GESClip *clip;
+  GESTrackElement *source, *effect;
+  GstElement *pipeline, *sink;
+  GstMessage *message;
+  GstCaps *caps;
+
+  track = GES_TRACK (ges_audio_track_new ());
+  caps = gst_caps_from_string ("audio/x-raw");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  uri = ges_test_get_audio_only_uri ();
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (uri, NULL));
+  fail_unless (asset != NULL);
+  g_free (uri);
+
+  clip = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_AUDIO);
+  gst_object_unref (asset);
+  fail_unless (ges_timeline_commit (timeline));
+  source = ges_clip_find_track_element (clip, track, GES_TYPE_SOURCE);
+
+  caps = gst_caps_from_string ("audio/x-vorbis");
+  track_set_passthrough_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_unless (_is_passed_through (source));
+
+  pipeline = gst_pipeline_new (NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", TRUE, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), GST_ELEMENT (timeline), sink, NULL);
+  pad = ges_timeline_get_pad_for_track (timeline, track);
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless (gst_pad_link (pad, sinkpad) == GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  /* The running source keeps passing its stream through until it gets
+   * restarted with its decoder, instead of being relinked under its feet */
+  effect = GES_TRACK_ELEMENT (ges_effect_new ("audioecho"));
+  fail_unless (ges_container_add (GES_CONTAINER (clip),
+          GES_TIMELINE_ELEMENT (effect)));
+  fail_unless (ges_timeline_commit (timeline));
+
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+  fail_if (_is_passed_through (source));
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (source);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -101,6 +495,11 @@ ges_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_update_restriction_caps);
+  tcase_add_test (tc_chain, test_gap_pool);
+  tcase_add_test (tc_chain, test_gap_retimed);
+  tcase_add_test (tc_chain, test_decoder_pool);
+  tcase_add_test (tc_chain, test_passthrough);
+  tcase_add_test (tc_chain, test_passthrough_commit_while_playing);
 
   return s;
 }
@@ -167,6 +167,171 @@ GST_START_TEST (test_transition_properties)
 GST_END_TEST;
 
 
+static gboolean
+_contains_type (GstElement * bin, const gchar * type_name)
+{
+  GValue item = G_VALUE_INIT;
+  gboolean found = FALSE;
+  GstIterator *it = gst_bin_iterate_recurse (GST_BIN (bin));
+
+  while (!found && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    found = !g_strcmp0 (G_OBJECT_TYPE_NAME (g_value_get_object (&item)),
+        type_name);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return found;
+}
+
+GST_START_TEST (test_transition_blender)
+{
+  GESVideoTransition *transition = ges_video_transition_new ();
+  GstElement *nleobject =
+      ges_track_element_get_nleobject (GES_TRACK_ELEMENT (transition));
+
+  gst_object_ref_sink (transition);
+
+  /* Crossfades and bar wipes are blended natively */
+  ges_video_transition_set_transition_type (transition,
+      GES_VIDEO_STANDARD_TRANSITION_TYPE_CROSSFADE);
+  fail_unless (_contains_type (nleobject, "GESVideoBlender"));
+  fail_if (_contains_type (nleobject, "GstSMPTEAlpha"));
+
+  ges_video_transition_set_border (transition, 42);
+  ges_video_transition_set_inverted (transition, TRUE);
+
+  ges_video_transition_set_transition_type (transition,
+      GES_VIDEO_STANDARD_TRANSITION_TYPE_IRIS_RECT);
+  fail_if (_contains_type (nleobject, "GESVideoBlender"));
+  fail_unless (_contains_type (nleobject, "GstSMPTEAlpha"));
+
+  /* The settings follow the switch */
+  assert_equals_int (ges_video_transition_get_border (transition), 42);
+  fail_unless (ges_video_transition_is_inverted (transition));
+
+  ges_video_transition_set_transition_type (transition,
+      GES_VIDEO_STANDARD_TRANSITION_TYPE_BAR_WIPE_TB);
+  fail_unless (_contains_type (nleobject, "GESVideoBlender"));
+  fail_if (_contains_type (nleobject, "GstSMPTEAlpha"));
+
+  gst_object_unref (transition);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_transition_blender_crossfade)
+{
+  GstBus *bus;
+  guint8 *data;
+  GstMapInfo map;
+  GstSample *sample;
+  GstMessage *message;
+  GstElement *pipeline, *sink;
+
+  pipeline = gst_parse_launch ("gesvideoblender name=blender position=0.5 "
+      "! fakesink name=sink "
+      "videotestsrc pattern=black num-buffers=1 "
+      "! video/x-raw,format=I420,width=16,height=16 ! blender. "
+      "videotestsrc pattern=white num-buffers=1 "
+      "! video/x-raw,format=I420,width=16,height=16 ! blender.", NULL);
+  fail_unless (pipeline != NULL);
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  fail_unless (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS);
+  gst_message_unref (message);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_object_get (sink, "last-sample", &sample, NULL);
+  fail_unless (sample != NULL);
+
+  /* Halfway between the black and white lumas, blended in I420 */
+  fail_unless (gst_buffer_map (gst_sample_get_buffer (sample), &map,
+          GST_MAP_READ));
+  data = map.data;
+  assert_equals_int (data[0], (16 + 235) / 2);
+  gst_buffer_unmap (gst_sample_get_buffer (sample), &map);
+
+  gst_sample_unref (sample);
+  gst_object_unref (sink);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_transition_replug_while_running)
+{
+  GList *clips, *tmp;
+  GstBus *bus;
+  GstCaps *caps;
+  GstMessage *message;
+  GESTrack *track;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESTransitionClip *transition = NULL;
+  GESAsset *asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  timeline = ges_timeline_new ();
+  track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string ("video/x-raw,width=32,height=24,"
+      "framerate=25/1");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+  ges_layer_set_auto_transition (layer, TRUE);
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+          GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer, asset, GST_SECOND / 2, 0,
+          GST_SECOND, GES_TRACK_TYPE_UNKNOWN));
+  gst_object_unref (asset);
+
+  clips = ges_layer_get_clips (layer);
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    if (GES_IS_TRANSITION_CLIP (tmp->data))
+      transition = tmp->data;
+  }
+  fail_unless (transition != NULL);
+  ges_timeline_commit (timeline);
+
+  pipeline = ges_test_create_pipeline (timeline);
+  bus = gst_element_get_bus (GST_ELEMENT (pipeline));
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+
+  /* The blender is replaced by smptealpha while prerolled */
+  g_object_set (transition, "vtype",
+      GES_VIDEO_STANDARD_TRANSITION_TYPE_IRIS_RECT, NULL);
+
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (message != NULL);
+  fail_unless (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS);
+  gst_message_unref (message);
+
+  fail_unless (_contains_type (GST_ELEMENT (pipeline), "GstSMPTEAlpha"));
+  fail_if (_contains_type (GST_ELEMENT (pipeline), "GESVideoBlender"));
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  g_list_free_full (clips, gst_object_unref);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
 
 static Suite *
 ges_suite (void)
@@ -184,6 +349,9 @@ ges_suite (void)
 
   tcase_add_test (tc_chain, test_transition_basic);
   tcase_add_test (tc_chain, test_transition_properties);
+  tcase_add_test (tc_chain, test_transition_blender);
+  tcase_add_test (tc_chain, test_transition_blender_crossfade);
+  tcase_add_test (tc_chain, test_transition_replug_while_running);
 
   return s;
 }
@@ -20,6 +20,7 @@
 #include "test-utils.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 /* This test uri will eventually have to be fixed */
 #define TEST_URI "http://nowhere/blahblahblah"
@@ -259,6 +260,217 @@ GST_START_TEST (test_filesource_images)
 
 GST_END_TEST;
 
+static void
+_get_cache_stats (guint * hits, guint * misses)
+{
+  GstStructure *stats = ges_uri_clip_asset_get_cache_stats ();
+
+  fail_unless (gst_structure_get_uint (stats, "hits", hits));
+  fail_unless (gst_structure_get_uint (stats, "misses", misses));
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (test_discovery_cache)
+{
+  guint hits, misses, hits0, misses0;
+  gchar *uri = ges_test_file_uri ("audio_only.ogg");
+
+  ges_uri_clip_asset_invalidate_cache (NULL);
+  _get_cache_stats (&hits0, &misses0);
+
+  /* Nothing cached yet, the file is discovered */
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 0);
+  assert_equals_int (misses - misses0, 1);
+
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 1);
+  assert_equals_int (misses - misses0, 1);
+
+  /* Requesting the asset uses the cached info */
+  fail_unless (GES_IS_URI_CLIP_ASSET (ges_uri_clip_asset_request_sync (uri,
+              NULL)));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 2);
+  assert_equals_int (misses - misses0, 1);
+
+  ges_uri_clip_asset_invalidate_cache (uri);
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 2);
+  assert_equals_int (misses - misses0, 2);
+
+  /* Only local files are cached */
+  fail_if (ges_uri_clip_asset_prewarm_cache (TEST_URI, NULL));
+
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_discovery_cache_corrupted)
+{
+  gsize length;
+  guint hits, misses, hits0, misses0;
+  gchar *uri = ges_test_file_uri ("audio_only.ogg");
+  gchar *checksum, *path, *contents;
+
+  ges_uri_clip_asset_invalidate_cache (NULL);
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  path = g_build_filename (g_getenv ("GES_DISCOVERY_CACHE_DIR"), checksum,
+      NULL);
+  g_free (checksum);
+
+  /* A truncated cache entry is ignored and replaced */
+  fail_unless (g_file_get_contents (path, &contents, &length, NULL));
+  fail_unless (g_file_set_contents (path, contents, length / 2, NULL));
+  _get_cache_stats (&hits0, &misses0);
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 0);
+  assert_equals_int (misses - misses0, 1);
+
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 1);
+
+  /* So is one with garbage instead of the discoverer info */
+  memset (contents + length / 2, 0xff, length - length / 2);
+  fail_unless (g_file_set_contents (path, contents, length, NULL));
+  _get_cache_stats (&hits0, &misses0);
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 0);
+  assert_equals_int (misses - misses0, 1);
+
+  g_free (contents);
+  g_free (path);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_discovery_cache_foreign_files)
+{
+  guint hits, misses, hits0, misses0;
+  gchar *uri = ges_test_file_uri ("audio_only.ogg");
+  gchar *path = g_build_filename (g_getenv ("GES_DISCOVERY_CACHE_DIR"),
+      "notes.txt", NULL);
+
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  fail_unless (g_file_set_contents (path, "Not a cache entry", -1, NULL));
+
+  /* Clearing the cache only removes its entries */
+  ges_uri_clip_asset_invalidate_cache (NULL);
+  fail_unless (g_file_test (path, G_FILE_TEST_EXISTS));
+
+  _get_cache_stats (&hits0, &misses0);
+  fail_unless (ges_uri_clip_asset_prewarm_cache (uri, NULL));
+  _get_cache_stats (&hits, &misses);
+  assert_equals_int (hits - hits0, 0);
+  assert_equals_int (misses - misses0, 1);
+
+  fail_unless (g_unlink (path) == 0);
+  g_free (path);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+static gboolean
+_has_child (GESTrackElement * source, const gchar * name)
+{
+  GstElement *child =
+      gst_bin_get_by_name (GST_BIN (ges_track_element_get_element (source)),
+      name);
+
+  if (!child)
+    return FALSE;
+
+  gst_object_unref (child);
+  return TRUE;
+}
+
+GST_START_TEST (test_filesource_conversion_elements)
+{
+  GESTrack *track;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESAsset *asset;
+  GESClip *clip;
+  GESTrackElement *source;
+  GstDiscovererStreamInfo *info;
+  gint width, height;
+  GstCaps *caps;
+
+  track = GES_TRACK (ges_video_track_new ());
+  /* Without mixing the track size is forced by the source itself */
+  ges_track_set_mixing (track, FALSE);
+  caps = gst_caps_from_string ("video/x-raw");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline, track));
+  layer = ges_timeline_append_layer (timeline);
+
+  asset = GES_ASSET (ges_uri_clip_asset_request_sync (av_uri, NULL));
+  fail_unless (asset != NULL);
+  clip = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_VIDEO);
+  gst_object_unref (asset);
+  source = ges_clip_find_track_element (clip, track, GES_TYPE_VIDEO_SOURCE);
+  fail_unless (source != NULL);
+
+  /* Nothing to convert */
+  fail_if (_has_child (source, "track-element-videoconvert"));
+  fail_if (_has_child (source, "track-element-videoscale"));
+  fail_if (_has_child (source, "track-element-videorate"));
+
+  /* The media is not 1fps nor 7x5 */
+  caps = gst_caps_from_string ("video/x-raw,framerate=1/1");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_unless (_has_child (source, "track-element-videorate"));
+  fail_if (_has_child (source, "track-element-videoscale"));
+
+  caps = gst_caps_from_string ("video/x-raw,width=7,height=5");
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_unless (_has_child (source, "track-element-videoscale"));
+  fail_unless (_has_child (source, "track-element-videoconvert"));
+  fail_if (_has_child (source, "track-element-videorate"));
+
+  /* Resizing the source needs scaling even if the track matches the media */
+  info = ges_uri_source_asset_get_stream_info (GES_URI_SOURCE_ASSET
+      (ges_extractable_get_asset (GES_EXTRACTABLE (source))));
+  width = gst_discoverer_video_info_get_width (GST_DISCOVERER_VIDEO_INFO
+      (info));
+  height = gst_discoverer_video_info_get_height (GST_DISCOVERER_VIDEO_INFO
+      (info));
+  caps = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, width,
+      "height", G_TYPE_INT, height, NULL);
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  fail_if (_has_child (source, "track-element-videoscale"));
+
+  ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT (source),
+      "width", width / 2, "height", height / 2, NULL);
+  fail_unless (_has_child (source, "track-element-videoscale"));
+
+  ges_timeline_element_set_child_properties (GES_TIMELINE_ELEMENT (source),
+      "width", width, "height", height, NULL);
+  fail_if (_has_child (source, "track-element-videoscale"));
+
+  gst_object_unref (source);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
 
 static Suite *
 ges_suite (void)
@@ -271,6 +483,10 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_filesource_basic);
   tcase_add_test (tc_chain, test_filesource_images);
   tcase_add_test (tc_chain, test_filesource_properties);
+  tcase_add_test (tc_chain, test_discovery_cache);
+  tcase_add_test (tc_chain, test_discovery_cache_corrupted);
+  tcase_add_test (tc_chain, test_discovery_cache_foreign_files);
+  tcase_add_test (tc_chain, test_filesource_conversion_elements);
 
   return s;
 }
@@ -279,9 +495,14 @@ int
 main (int argc, char **argv)
 {
   int nf;
+  gchar *cache_dir;
 
   Suite *s;
 
+  /* Do not use the user discovery cache */
+  cache_dir = g_dir_make_tmp ("ges-discovery-cache-XXXXXX", NULL);
+  g_setenv ("GES_DISCOVERY_CACHE_DIR", cache_dir, TRUE);
+
   gst_check_init (&argc, &argv);
 
   ges_init ();
@@ -297,6 +518,9 @@ main (int argc, char **argv)
 
   nf = gst_check_run_suite (s, "ges", __FILE__);
 
+  ges_uri_clip_asset_invalidate_cache (NULL);
+  g_rmdir (cache_dir);
+  g_free (cache_dir);
   g_free (av_uri);
   g_free (image_uri);
 
@@ -297,6 +297,96 @@ GST_START_TEST (test_remove_last_object)
 
 GST_END_TEST;
 
+GST_START_TEST (test_skip_update_outside_current_stack)
+{
+  GstBin *composition;
+  GstElement *source1, *source2, *source3, *audiotestsrc, *fakesink,
+      *pipeline;
+  GstBus *bus;
+  GstMessage *message;
+  gboolean ret;
+  guint skipped;
+  GstClockTime duration;
+
+  pipeline = GST_ELEMENT (gst_pipeline_new (NULL));
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+
+  composition = GST_BIN (gst_element_factory_make ("nlecomposition",
+          "composition"));
+
+  g_signal_connect (composition, "query-position",
+      G_CALLBACK (_query_position_cb), pipeline);
+
+  gst_element_set_state (GST_ELEMENT (composition), GST_STATE_READY);
+
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add_many (GST_BIN (pipeline), GST_ELEMENT (composition), fakesink,
+      NULL);
+  gst_element_link (GST_ELEMENT (composition), fakesink);
+
+  source1 = gst_element_factory_make ("nlesource", "source1");
+  audiotestsrc = gst_element_factory_make ("audiotestsrc", "audiotestsrc1");
+  gst_bin_add (GST_BIN (source1), audiotestsrc);
+  g_object_set (source1, "start", (guint64) 0 * GST_SECOND,
+      "duration", 10 * GST_SECOND, "inpoint", (guint64) 0, "priority", 1, NULL);
+  nle_composition_add (composition, source1);
+
+  source2 = gst_element_factory_make ("nlesource", "source2");
+  audiotestsrc = gst_element_factory_make ("audiotestsrc", "audiotestsrc2");
+  gst_bin_add (GST_BIN (source2), audiotestsrc);
+  g_object_set (source2, "start", (guint64) 10 * GST_SECOND,
+      "duration", 10 * GST_SECOND, "inpoint", (guint64) 0, "priority", 1, NULL);
+  nle_composition_add (composition, source2);
+
+  commit_and_wait (GST_ELEMENT (composition), &ret);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PAUSED)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_mini_object_unref (GST_MINI_OBJECT (message));
+
+  g_object_get (composition, "skipped-stack-updates", &skipped, NULL);
+  fail_unless_equals_int (skipped, 0);
+
+  /* Adding an object after the current [0s - 10s] stack does not require
+   * the pipeline to be updated */
+  source3 = gst_element_factory_make ("nlesource", "source3");
+  audiotestsrc = gst_element_factory_make ("audiotestsrc", "audiotestsrc3");
+  gst_bin_add (GST_BIN (source3), audiotestsrc);
+  g_object_set (source3, "start", (guint64) 20 * GST_SECOND,
+      "duration", 10 * GST_SECOND, "inpoint", (guint64) 0, "priority", 1, NULL);
+  nle_composition_add (composition, source3);
+  commit_and_wait (GST_ELEMENT (composition), &ret);
+
+  g_object_get (composition, "skipped-stack-updates", &skipped, "duration",
+      &duration, NULL);
+  fail_unless_equals_int (skipped, 1);
+  fail_unless_equals_uint64 (duration, 30 * GST_SECOND);
+
+  /* Same when moving it */
+  g_object_set (source3, "start", (guint64) 25 * GST_SECOND, NULL);
+  commit_and_wait (GST_ELEMENT (composition), &ret);
+  g_object_get (composition, "skipped-stack-updates", &skipped, "duration",
+      &duration, NULL);
+  fail_unless_equals_int (skipped, 2);
+  fail_unless_equals_uint64 (duration, 35 * GST_SECOND);
+
+  /* And removing it */
+  fail_unless (nle_composition_remove (composition, source3));
+  g_object_get (composition, "skipped-stack-updates", &skipped, "duration",
+      &duration, NULL);
+  fail_unless_equals_int (skipped, 3);
+  fail_unless_equals_uint64 (duration, 20 * GST_SECOND);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_dispose_on_commit)
 {
   GstElement *composition;
@@ -447,6 +537,7 @@ gnonlin_suite (void)
   tcase_add_test (tc_chain, test_change_object_start_stop_in_current_stack);
   tcase_add_test (tc_chain, test_remove_invalid_object);
   tcase_add_test (tc_chain, test_remove_last_object);
+  tcase_add_test (tc_chain, test_skip_update_outside_current_stack);
 
   tcase_add_test (tc_chain, test_dispose_on_commit);
 
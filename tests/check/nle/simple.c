@@ -187,8 +187,43 @@ test_time_duration_full (void)
   gst_object_unref (comp);
 }
 
+/* Records the bins source2 is added to, and its state and pending state at
+ * that time */
 static void
-test_one_after_other_full (void)
+_deep_element_added_cb (GstBin * bin, GstBin * sub_bin, GstElement * element,
+    GList ** additions)
+{
+  if (g_strcmp0 (GST_OBJECT_NAME (element), "source2"))
+    return;
+
+  *additions = g_list_append (*additions, g_strdup_printf ("%s:%s:%s",
+          GST_OBJECT_NAME (sub_bin),
+          gst_element_state_get_name (GST_STATE (element)),
+          gst_element_state_get_name (GST_STATE_PENDING (element))));
+}
+
+static void
+_check_source2_additions (GList ** additions, gboolean lookahead)
+{
+  if (lookahead) {
+    /* Prerolled aside then moved to the current stack once done
+     * prerolling */
+    assert_equals_int (g_list_length (*additions), 2);
+    assert_equals_string ((*additions)->data,
+        "lookahead-bin:READY:VOID_PENDING");
+    assert_equals_string ((*additions)->next->data,
+        "current-bin:PAUSED:VOID_PENDING");
+  } else {
+    assert_equals_int (g_list_length (*additions), 1);
+    fail_unless (g_str_has_prefix ((*additions)->data, "current-bin:"));
+  }
+
+  g_list_free_full (*additions, g_free);
+  *additions = NULL;
+}
+
+static void
+test_one_after_other_full (gboolean lookahead)
 {
   GstElement *pipeline;
   GstElement *comp, *sink, *source1, *source2;
@@ -197,6 +232,7 @@ test_one_after_other_full (void)
   GstMessage *message;
   gboolean carry_on = TRUE;
   GstPad *sinkpad;
+  GList *additions = NULL;
 
   gboolean ret = FALSE;
 
@@ -205,6 +241,9 @@ test_one_after_other_full (void)
       gst_element_factory_make_or_warn ("nlecomposition", "test_composition");
   gst_element_set_state (comp, GST_STATE_READY);
   fail_if (comp == NULL);
+  g_object_set (comp, "lookahead", lookahead, NULL);
+  g_signal_connect (pipeline, "deep-element-added",
+      G_CALLBACK (_deep_element_added_cb), &additions);
 
   /*
      Source 1
@@ -314,6 +353,7 @@ test_one_after_other_full (void)
           GST_STATE_READY) == GST_STATE_CHANGE_FAILURE);
 
   fail_if (collect->expected_segments != NULL);
+  _check_source2_additions (&additions, lookahead);
 
   GST_DEBUG ("Resetted pipeline to READY");
 
@@ -362,11 +402,14 @@ test_one_after_other_full (void)
   }
 
   fail_if (collect->expected_segments != NULL);
+  _check_source2_additions (&additions, lookahead);
 
   gst_object_unref (GST_OBJECT (sinkpad));
 
   fail_if (gst_element_set_state (GST_ELEMENT (pipeline),
           GST_STATE_NULL) == GST_STATE_CHANGE_FAILURE);
+  g_signal_handlers_disconnect_by_func (pipeline, _deep_element_added_cb,
+      &additions);
 
   ASSERT_OBJECT_REFCOUNT_BETWEEN (pipeline, "main pipeline", 1, 2);
   gst_object_unref (pipeline);
@@ -738,7 +781,14 @@ GST_END_TEST;
 
 GST_START_TEST (test_one_after_other)
 {
-  test_one_after_other_full ();
+  test_one_after_other_full (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_one_after_other_lookahead)
+{
+  test_one_after_other_full (TRUE);
 }
 
 GST_END_TEST;
@@ -774,6 +824,7 @@ gnonlin_suite (void)
   tcase_add_test (tc_chain, test_time_duration);
   tcase_add_test (tc_chain, test_simplest);
   tcase_add_test (tc_chain, test_one_after_other);
+  tcase_add_test (tc_chain, test_one_after_other_lookahead);
   tcase_add_test (tc_chain, test_one_under_another);
   tcase_add_test (tc_chain, test_one_bin_after_other);
   return s;